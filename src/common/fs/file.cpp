@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2021 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 #include "common/fs/file.h"
@@ -13,6 +15,7 @@
 #ifdef _WIN32
 #include <io.h>
 #include <share.h>
+#include <windows.h>
 #else
 #include <unistd.h>
 #endif
@@ -452,4 +455,47 @@ s64 IOFile::Tell() const {
     return ftello(file);
 }
 
+size_t IOFile::ReadBytesAt(void* data, size_t size, s64 offset) const {
+    auto* out = static_cast<u8*>(data);
+    size_t total_read = 0;
+
+#ifdef _WIN32
+    const auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(fileno(file)));
+    if (handle == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+
+    while (total_read < size) {
+        const auto position = static_cast<u64>(offset) + total_read;
+        const auto to_read = static_cast<DWORD>(
+            std::min<size_t>(size - total_read, std::numeric_limits<DWORD>::max()));
+
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(position);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+        DWORD bytes_read = 0;
+        if (!ReadFile(handle, out + total_read, to_read, &bytes_read, &overlapped) ||
+            bytes_read == 0) {
+            break;
+        }
+        total_read += bytes_read;
+    }
+#else
+    while (total_read < size) {
+        const auto result = pread(fileno(file), out + total_read, size - total_read,
+                                  static_cast<off_t>(offset + static_cast<s64>(total_read)));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            break;
+        }
+        total_read += static_cast<size_t>(result);
+    }
+#endif
+
+    return total_read;
+}
+
 } // namespace Common::FS
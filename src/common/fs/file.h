@@ -260,6 +260,37 @@ public:
         }
     }
 
+    /**
+     * Reads a span of T data from a file at the given offset.
+     * Unlike ReadSpan, this function does not use or modify the stream position,
+     * and may be called concurrently from multiple threads on the same file.
+     *
+     * Stream reads must be preceded by a Seek once this function has been used,
+     * as the underlying OS file pointer is not guaranteed to be preserved on all platforms.
+     *
+     * Failures occur when:
+     * - The file is not open
+     * - The opened file lacks read permissions
+     * - Attempting to read beyond the end-of-file
+     *
+     * @tparam T Data type
+     *
+     * @param data Span of T data
+     * @param offset Offset in bytes from the beginning of the file
+     *
+     * @returns Count of T data successfully read.
+     */
+    template <typename T>
+    [[nodiscard]] size_t ReadSpanAt(std::span<T> data, s64 offset) const {
+        static_assert(std::is_trivially_copyable_v<T>, "Data type must be trivially copyable.");
+
+        if (!IsOpen()) {
+            return 0;
+        }
+
+        return ReadBytesAt(data.data(), data.size_bytes(), offset) / sizeof(T);
+    }
+
     /**
      * Reads a span of T data from a file sequentially.
      * This function reads from the current position of the file pointer and
@@ -449,6 +480,8 @@ public:
     [[nodiscard]] s64 Tell() const;
 
 private:
+    [[nodiscard]] size_t ReadBytesAt(void* data, size_t size, s64 offset) const;
+
     std::filesystem::path file_path;
     FileAccessMode file_access_mode{};
     FileType file_type{};
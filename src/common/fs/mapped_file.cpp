@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "common/fs/mapped_file.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Common::FS {
+
+MappedFile::MappedFile() = default;
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    Open(path);
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::filesystem::path& path) {
+    Close();
+
+#ifdef _WIN32
+    const HANDLE file_handle =
+        CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        LOG_ERROR(Common_Filesystem, "Failed to open the file at path={}, error={}",
+                  PathToUTF8String(path), GetLastError());
+        return false;
+    }
+
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file_handle);
+        return false;
+    }
+
+    const HANDLE mapping_handle =
+        CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file_handle);
+    if (mapping_handle == nullptr) {
+        LOG_ERROR(Common_Filesystem, "Failed to create a file mapping for path={}, error={}",
+                  PathToUTF8String(path), GetLastError());
+        return false;
+    }
+
+    // The view keeps the mapping object alive, so the handle can be released immediately.
+    void* const view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping_handle);
+    if (view == nullptr) {
+        LOG_ERROR(Common_Filesystem, "Failed to map the file at path={}, error={}",
+                  PathToUTF8String(path), GetLastError());
+        return false;
+    }
+
+    base = static_cast<u8*>(view);
+    size = static_cast<u64>(file_size.QuadPart);
+#else
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR(Common_Filesystem, "Failed to open the file at path={}, error={}",
+                  PathToUTF8String(path), strerror(errno));
+        return false;
+    }
+
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+
+    const auto file_size = static_cast<size_t>(file_stat.st_size);
+
+    // The mapping keeps its own reference to the file, so the descriptor can be closed.
+    void* const view = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) {
+        LOG_ERROR(Common_Filesystem, "Failed to map the file at path={}, error={}",
+                  PathToUTF8String(path), strerror(errno));
+        return false;
+    }
+
+    base = static_cast<u8*>(view);
+    size = file_size;
+#endif
+
+    return true;
+}
+
+void MappedFile::Close() {
+    if (!IsOpen()) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+#else
+    munmap(base, static_cast<size_t>(size));
+#endif
+
+    base = nullptr;
+    size = 0;
+}
+
+size_t MappedFile::ReadAt(std::span<u8> data, u64 offset) const {
+    if (!IsOpen() || offset >= size) {
+        return 0;
+    }
+
+    const auto read_size = static_cast<size_t>(std::min<u64>(data.size(), size - offset));
+    std::memcpy(data.data(), base + offset, read_size);
+    return read_size;
+}
+
+} // namespace Common::FS
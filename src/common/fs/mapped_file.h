@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+
+namespace Common::FS {
+
+/**
+ * A read-only view of an entire file mapped into the address space of the process.
+ *
+ * Reads from a mapped file are plain memory copies, do not require an open file handle
+ * and may be performed concurrently from any number of threads.
+ *
+ * Note that I/O errors on the underlying storage (e.g. removable media being disconnected or
+ * the file being truncated by another process) are reported as access violations rather than
+ * short reads, which is why mapping is only used where explicitly requested.
+ */
+class MappedFile {
+public:
+    YUZU_NON_COPYABLE(MappedFile);
+    YUZU_NON_MOVEABLE(MappedFile);
+
+    MappedFile();
+
+    /**
+     * Maps the file at the given path. The mapping state can be checked with IsOpen().
+     *
+     * @param path Filesystem path
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+
+    ~MappedFile();
+
+    /**
+     * Maps the file at the given path, unmapping any previously mapped file.
+     *
+     * @param path Filesystem path
+     *
+     * @returns True if the file was successfully mapped.
+     */
+    bool Open(const std::filesystem::path& path);
+
+    /// Unmaps the file, if mapped.
+    void Close();
+
+    /**
+     * Checks whether the file is mapped.
+     *
+     * @returns True if the file is mapped, false otherwise.
+     */
+    [[nodiscard]] bool IsOpen() const {
+        return base != nullptr;
+    }
+
+    /**
+     * Gets the size of the mapped file.
+     *
+     * @returns The size of the mapped file, or 0 if no file is mapped.
+     */
+    [[nodiscard]] u64 GetSize() const {
+        return size;
+    }
+
+    /**
+     * Gets a view of the whole mapped file, valid until it is closed.
+     *
+     * @returns The contents of the mapped file, or an empty span if no file is mapped.
+     */
+    [[nodiscard]] std::span<const u8> GetData() const {
+        return {base, static_cast<size_t>(size)};
+    }
+
+    /**
+     * Reads bytes from the mapped file at the given offset.
+     *
+     * @param data Destination buffer
+     * @param offset Offset in bytes from the beginning of the file
+     *
+     * @returns Count of bytes successfully read.
+     */
+    [[nodiscard]] size_t ReadAt(std::span<u8> data, u64 offset) const;
+
+private:
+    u8* base{};
+    u64 size{};
+};
+
+} // namespace Common::FS
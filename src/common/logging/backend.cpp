@@ -1,9 +1,12 @@
 // SPDX-FileCopyrightText: 2014 Citra Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <climits>
+#include <cstring>
+#include <memory>
 #include <thread>
 
 #include <fmt/format.h>
@@ -21,6 +24,7 @@
 #include "common/thread.h"
 
 #include "common/logging/backend.h"
+#include "common/logging/deferred_message_ring.h"
 #include "common/logging/log.h"
 #include "common/logging/log_entry.h"
 #include "common/logging/text_formatter.h"
@@ -201,6 +205,8 @@ public:
         filter.ParseFilterString(Settings::values.log_filter.GetValue());
         instance = std::unique_ptr<Impl, decltype(&Deleter)>(new Impl(log_dir / LOG_FILE, filter),
                                                              Deleter);
+        instance->SetDeferredFormattingEnabled(
+            Settings::values.deferred_log_formatting.GetValue());
         initialization_in_progress_suppress_logging = false;
     }
 
@@ -226,6 +232,10 @@ public:
         color_console_backend.SetEnabled(enabled);
     }
 
+    void SetDeferredFormattingEnabled(bool enabled) {
+        deferred_formatting_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
     void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, std::string&& message) {
         if (!filter.CheckMessage(log_class, log_level)) {
@@ -235,6 +245,44 @@ public:
             CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
     }
 
+    bool PushDeferredEntry(Class log_class, Level log_level, const char* filename,
+                           unsigned int line_num, const char* function, const char* format,
+                           DeferredFormatFunction format_function,
+                           const unsigned char* packed_args, std::size_t packed_args_size) {
+        if (!deferred_formatting_enabled.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (!filter.CheckMessage(log_class, log_level)) {
+            return true;
+        }
+
+        DeferredMessageRing::Record record{
+            .timestamp = GetTimestamp(),
+            .log_class = log_class,
+            .log_level = log_level,
+            .filename = filename,
+            .line_num = line_num,
+            .function = function,
+            .format = format,
+            .format_function = format_function,
+            .packed_args{},
+        };
+        std::memcpy(record.packed_args.data(), packed_args, packed_args_size);
+        deferred_messages.Push(record);
+
+        // Only wake the logging thread when it is waiting, it drains the ring on every wake up.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (deferred_waiting.load(std::memory_order_relaxed) &&
+            deferred_waiting.exchange(false, std::memory_order_relaxed)) {
+            message_queue.EmplaceWait(Entry{});
+        }
+        return true;
+    }
+
+    u64 GetDroppedDeferredEntryCount() const {
+        return deferred_messages.GetDroppedCount();
+    }
+
 private:
     Impl(const std::filesystem::path& file_backend_filename, const Filter& filter_)
         : filter{filter_}, file_backend{file_backend_filename} {}
@@ -249,20 +297,83 @@ private:
                 ForEachBackend([&entry](Backend& backend) { backend.Write(entry); });
             };
             while (!stop_token.stop_requested()) {
+                WriteDeferredEntries(std::chrono::microseconds::max());
+                // Deferred messages pushed after this point push an empty entry to wake us up.
+                deferred_waiting.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                WriteDeferredEntries(std::chrono::microseconds::max());
+
                 message_queue.PopWait(entry, stop_token);
                 if (entry.filename != nullptr) {
+                    WriteDeferredEntries(entry.timestamp);
                     write_logs();
                 }
             }
             // Drain the logging queue. Only writes out up to MAX_LOGS_TO_WRITE to prevent a
             // case where a system is repeatedly spamming logs even on close.
             int max_logs_to_write = filter.IsDebug() ? INT_MAX : 100;
-            while (max_logs_to_write-- && message_queue.TryPop(entry)) {
-                write_logs();
+            while (max_logs_to_write > 0 && message_queue.TryPop(entry)) {
+                if (entry.filename != nullptr) {
+                    max_logs_to_write -= WriteDeferredEntries(entry.timestamp, max_logs_to_write);
+                    write_logs();
+                    --max_logs_to_write;
+                }
+            }
+            if (max_logs_to_write > 0) {
+                WriteDeferredEntries(std::chrono::microseconds::max(), max_logs_to_write);
             }
         });
     }
 
+    /**
+     * Writes the deferred messages logged up to the given time, so they reach the backends in
+     * the same order as the messages formatted on the logging threads.
+     * Returns the number of messages written.
+     */
+    int WriteDeferredEntries(std::chrono::microseconds until, int max_count = INT_MAX) {
+        int count = 0;
+        while (count < max_count &&
+               (has_pending_deferred_entry || PopDeferredEntry(pending_deferred_entry))) {
+            if (pending_deferred_entry.timestamp > until) {
+                has_pending_deferred_entry = true;
+                break;
+            }
+            has_pending_deferred_entry = false;
+            ForEachBackend([this](Backend& backend) { backend.Write(pending_deferred_entry); });
+            ++count;
+        }
+        return count;
+    }
+
+    bool PopDeferredEntry(Entry& entry) {
+        // Report dropped messages in place of the first message following them.
+        const u64 dropped_count = deferred_messages.GetDroppedCount();
+        if (dropped_count != reported_dropped_count) {
+            const u64 newly_dropped_count = dropped_count - reported_dropped_count;
+            reported_dropped_count = dropped_count;
+            entry = CreateEntry(Class::Log, Level::Warning, TrimSourcePath(__FILE__), __LINE__,
+                                __func__,
+                                fmt::format("Dropped {} deferred log messages",
+                                            newly_dropped_count));
+            return true;
+        }
+
+        DeferredMessageRing::Record record;
+        if (!deferred_messages.TryPop(record)) {
+            return false;
+        }
+        entry = Entry{
+            .timestamp = record.timestamp,
+            .log_class = record.log_class,
+            .log_level = record.log_level,
+            .filename = record.filename,
+            .line_num = record.line_num,
+            .function = record.function,
+            .message = record.format_function(record.format, record.packed_args.data()),
+        };
+        return true;
+    }
+
     void StopBackendThread() {
         backend_thread.request_stop();
         if (backend_thread.joinable()) {
@@ -272,14 +383,18 @@ private:
         ForEachBackend([](Backend& backend) { backend.Flush(); });
     }
 
-    Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
-                      const char* function, std::string&& message) const {
+    std::chrono::microseconds GetTimestamp() const {
         using std::chrono::duration_cast;
         using std::chrono::microseconds;
         using std::chrono::steady_clock;
 
+        return duration_cast<microseconds>(steady_clock::now() - time_origin);
+    }
+
+    Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
+                      const char* function, std::string&& message) const {
         return {
-            .timestamp = duration_cast<microseconds>(steady_clock::now() - time_origin),
+            .timestamp = GetTimestamp(),
             .log_class = log_class,
             .log_level = log_level,
             .filename = filename,
@@ -313,6 +428,12 @@ private:
 #endif
 
     MPSCQueue<Entry> message_queue{};
+    DeferredMessageRing deferred_messages{};
+    std::atomic_bool deferred_formatting_enabled{};
+    std::atomic_bool deferred_waiting{};
+    Entry pending_deferred_entry{};
+    bool has_pending_deferred_entry{};
+    u64 reported_dropped_count{};
     std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
     std::jthread backend_thread;
 };
@@ -342,6 +463,14 @@ void SetColorConsoleBackendEnabled(bool enabled) {
     Impl::Instance().SetColorConsoleBackendEnabled(enabled);
 }
 
+void SetDeferredFormattingEnabled(bool enabled) {
+    Impl::Instance().SetDeferredFormattingEnabled(enabled);
+}
+
+u64 GetDroppedDeferredMessageCount() {
+    return Impl::Instance().GetDroppedDeferredEntryCount();
+}
+
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args) {
@@ -350,4 +479,16 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                                    fmt::vformat(format, args));
     }
 }
+
+bool FmtLogMessageDeferredImpl(Class log_class, Level log_level, const char* filename,
+                               unsigned int line_num, const char* function, const char* format,
+                               DeferredFormatFunction format_function,
+                               const unsigned char* packed_args, std::size_t packed_args_size) {
+    if (initialization_in_progress_suppress_logging) {
+        return true;
+    }
+    return Impl::Instance().PushDeferredEntry(log_class, log_level, filename, line_num, function,
+                                              format, format_function, packed_args,
+                                              packed_args_size);
+}
 } // namespace Common::Log
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "common/common_types.h"
 #include "common/logging/filter.h"
 
 namespace Common::Log {
@@ -25,4 +26,14 @@ void DisableLoggingInTests();
 void SetGlobalFilter(const Filter& filter);
 
 void SetColorConsoleBackendEnabled(bool enabled);
+
+/**
+ * Enables formatting messages whose arguments are all trivially copyable on the logging thread.
+ * Such messages are queued without blocking the caller, and are dropped oldest first when the
+ * logging thread falls behind.
+ */
+void SetDeferredFormattingEnabled(bool enabled);
+
+/// Gets the number of deferred messages dropped since the logging backend was initialized.
+u64 GetDroppedDeferredMessageCount();
 } // namespace Common::Log
@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+#include "common/common_types.h"
+#include "common/logging/log.h"
+#include "common/logging/types.h"
+
+namespace Common::Log {
+
+/**
+ * Preallocated ring of messages whose formatting is deferred to the logging thread.
+ * Producers never block or allocate: when the ring is full, the oldest message is discarded.
+ */
+class DeferredMessageRing {
+public:
+    static constexpr std::size_t Capacity = 4096;
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    struct Record {
+        std::chrono::microseconds timestamp;
+        Class log_class{};
+        Level log_level{};
+        const char* filename = nullptr;
+        unsigned int line_num = 0;
+        const char* function = nullptr;
+        const char* format = nullptr;
+        DeferredFormatFunction format_function = nullptr;
+        std::array<unsigned char, DeferredLogArgsSize> packed_args;
+    };
+
+    DeferredMessageRing() : slots{std::make_unique<Slot[]>(Capacity)} {
+        for (std::size_t i = 0; i < Capacity; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    void Push(const Record& record) {
+        // A producer preempted between claiming and publishing a slot can stall the ring, so
+        // give up after a bounded number of attempts rather than spinning on it.
+        for (std::size_t attempt = 0; attempt < MaxPushAttempts; attempt++) {
+            std::size_t position = enqueue_position.load(std::memory_order_relaxed);
+            Slot& slot = slots[position & (Capacity - 1)];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+            if (sequence == position) {
+                if (enqueue_position.compare_exchange_weak(position, position + 1,
+                                                           std::memory_order_relaxed)) {
+                    slot.record = record;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return;
+                }
+            } else if (sequence < position) {
+                // The ring is full, drop the oldest message to make room.
+                Record discarded;
+                if (TryPop(discarded)) {
+                    dropped_count.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        dropped_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool TryPop(Record& record) {
+        std::size_t position = dequeue_position.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[position & (Capacity - 1)];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+            if (sequence == position + 1) {
+                if (dequeue_position.compare_exchange_weak(position, position + 1,
+                                                           std::memory_order_relaxed)) {
+                    record = slot.record;
+                    slot.sequence.store(position + Capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (sequence < position + 1) {
+                return false;
+            } else {
+                position = dequeue_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    u64 GetDroppedCount() const {
+        return dropped_count.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::size_t MaxPushAttempts = 64;
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        Record record;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    alignas(128) std::atomic<std::size_t> enqueue_position{};
+    alignas(128) std::atomic<std::size_t> dequeue_position{};
+    alignas(128) std::atomic<u64> dropped_count{};
+};
+
+} // namespace Common::Log
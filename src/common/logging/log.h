@@ -4,7 +4,13 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include <fmt/format.h>
 
@@ -22,14 +28,82 @@ constexpr const char* TrimSourcePath(std::string_view source) {
     return source.data() + idx;
 }
 
+/// Maximum total size of the arguments of a message whose formatting can be deferred.
+constexpr std::size_t DeferredLogArgsSize = 64;
+
+/**
+ * Whether a message argument can be copied by value and formatted later on the logging thread.
+ * Only types which do not refer to memory owned by the caller qualify.
+ */
+template <typename T>
+struct IsDeferrableLogArg : std::bool_constant<std::is_arithmetic_v<T> || std::is_enum_v<T>> {};
+
+/// Formats a message from its format string and packed arguments.
+using DeferredFormatFunction = std::string (*)(const char* format, const unsigned char* args);
+
+namespace Detail {
+
+template <typename... Args>
+constexpr std::array<std::size_t, sizeof...(Args)> PackedArgOffsets() {
+    std::array<std::size_t, sizeof...(Args)> offsets{};
+    [[maybe_unused]] std::size_t offset = 0;
+    [[maybe_unused]] std::size_t index = 0;
+    ((offsets[index++] = offset, offset += sizeof(Args)), ...);
+    return offsets;
+}
+
+template <typename... Args, std::size_t... I>
+std::string FormatPackedArgs(const char* format, [[maybe_unused]] const unsigned char* packed_args,
+                             std::index_sequence<I...>) {
+    [[maybe_unused]] constexpr auto offsets = PackedArgOffsets<Args...>();
+    std::tuple<Args...> args{};
+    (std::memcpy(&std::get<I>(args), packed_args + offsets[I], sizeof(Args)), ...);
+    return fmt::vformat(format, fmt::make_format_args(std::get<I>(args)...));
+}
+
+} // namespace Detail
+
+/// Formats a deferred message from the arguments packed by FmtLogMessage.
+template <typename... Args>
+std::string FormatDeferredMessage(const char* format, const unsigned char* packed_args) {
+    return Detail::FormatPackedArgs<Args...>(format, packed_args,
+                                             std::index_sequence_for<Args...>{});
+}
+
 /// Logs a message to the global logger, using fmt
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args);
 
+/**
+ * Queues a message to be formatted by the logging thread, without blocking or allocating.
+ *
+ * @returns False if deferred formatting is disabled and the message must be formatted now.
+ */
+bool FmtLogMessageDeferredImpl(Class log_class, Level log_level, const char* filename,
+                               unsigned int line_num, const char* function, const char* format,
+                               DeferredFormatFunction format_function,
+                               const unsigned char* packed_args, std::size_t packed_args_size);
+
 template <typename... Args>
 void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, const char* format, const Args&... args) {
+    // Only take the size of deferrable arguments, others may be arrays of unknown bound.
+    if constexpr ((IsDeferrableLogArg<Args>::value && ...)) {
+        constexpr std::size_t packed_args_size = (sizeof(Args) + ... + 0);
+        if constexpr (packed_args_size <= DeferredLogArgsSize) {
+            std::array<unsigned char, DeferredLogArgsSize> packed_args{};
+            [[maybe_unused]] std::size_t offset = 0;
+            ((std::memcpy(packed_args.data() + offset, &args, sizeof(Args)),
+              offset += sizeof(Args)),
+             ...);
+            if (FmtLogMessageDeferredImpl(log_class, log_level, filename, line_num, function,
+                                          format, &FormatDeferredMessage<Args...>,
+                                          packed_args.data(), packed_args_size)) {
+                return;
+            }
+        }
+    }
     FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
                       fmt::make_format_args(args...));
 }
@@ -62,6 +62,7 @@ SWITCHABLE(AntiAliasing, false);
 SWITCHABLE(AspectRatio, true);
 SWITCHABLE(AstcDecodeMode, true);
 SWITCHABLE(AstcRecompression, true);
+SWITCHABLE(AstcRecompressionQuality, true);
 SWITCHABLE(AudioMode, true);
 SWITCHABLE(CpuBackend, true);
 SWITCHABLE(CpuAccuracy, true);
@@ -384,6 +385,26 @@ struct Values {
                                                                   AstcRecompression::Bc3,
                                                                   "astc_recompression",
                                                                   Category::RendererAdvanced};
+    SwitchableSetting<AstcRecompressionQuality, true> astc_recompression_quality{
+        linkage,
+        AstcRecompressionQuality::High,
+        AstcRecompressionQuality::Fast,
+        AstcRecompressionQuality::High,
+        "astc_recompression_quality",
+        Category::RendererAdvanced};
+    SwitchableSetting<bool> use_astc_disk_cache{linkage, false, "use_astc_disk_cache",
+                                                Category::RendererAdvanced,
+                                                Specialization::Paired, false, true};
+    SwitchableSetting<u32, true> astc_disk_cache_size{linkage,
+                                                      2048,
+                                                      256,
+                                                      65536,
+                                                      "astc_disk_cache_size",
+                                                      Category::RendererAdvanced,
+                                                      Specialization::Countable,
+                                                      true,
+                                                      true,
+                                                      &use_astc_disk_cache};
     SwitchableSetting<VramUsageMode, true> vram_usage_mode{linkage,
                                                            VramUsageMode::Conservative,
                                                            VramUsageMode::Conservative,
@@ -584,6 +605,9 @@ struct Values {
     Setting<bool> dump_macros{
         linkage, false, "dump_macros", Category::DebuggingGraphics, Specialization::Default, false};
     Setting<bool> enable_fs_access_log{linkage, false, "enable_fs_access_log", Category::Debugging};
+    Setting<bool> verify_nca_integrity{linkage, false, "verify_nca_integrity", Category::Debugging};
+    Setting<bool> memory_map_game_files{linkage, false, "memory_map_game_files",
+                                        Category::Debugging};
     Setting<bool> reporting_services{
         linkage, false, "reporting_services", Category::Debugging, Specialization::Default, false};
     Setting<bool> quest_flag{linkage, false, "quest_flag", Category::Debugging};
@@ -593,6 +617,8 @@ struct Values {
                                     Category::DebuggingGraphics};
     Setting<bool> extended_logging{
         linkage, false, "extended_logging", Category::Debugging, Specialization::Default, false};
+    Setting<bool> deferred_log_formatting{linkage, false, "deferred_log_formatting",
+                                          Category::Debugging};
     Setting<bool> use_debug_asserts{linkage, false, "use_debug_asserts", Category::Debugging};
     Setting<bool> use_auto_stub{
         linkage, false, "use_auto_stub", Category::Debugging, Specialization::Default, false};
@@ -3,22 +3,33 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <type_traits>
 #include <vector>
-#include <queue>
 
+#include "common/common_types.h"
 #include "common/polyfill_thread.h"
 #include "common/thread.h"
 #include "common/unique_function.h"
 
 namespace Common {
 
+/**
+ * Pool of worker threads executing queued tasks.
+ *
+ * Every worker owns a queue. Tasks are distributed round-robin across the queues, or pushed to
+ * the worker's own queue when queued from one of the workers. Workers run the tasks in their own
+ * queue in order and steal from the back of the other queues when they run out of work, so a
+ * pool with a single worker executes tasks in the order they were queued.
+ */
 template <class StateType = void>
 class StatefulThreadWorker {
     static constexpr bool with_state = !std::is_same_v<StateType, void>;
@@ -33,42 +44,49 @@ class StatefulThreadWorker {
         std::conditional_t<with_state, UniqueFunction<void, StateType*>, UniqueFunction<void>>;
     using StateMaker = std::conditional_t<with_state, std::function<StateType()>, DummyCallable>;
 
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
 public:
     explicit StatefulThreadWorker(size_t num_workers, std::string name, StateMaker func = {})
-        : workers_queued{num_workers}, thread_name{std::move(name)} {
-        const auto lambda = [this, func](std::stop_token stop_token) {
+        : queues{std::make_unique<WorkerQueue[]>(std::max<size_t>(num_workers, 1))},
+          num_queues{std::max<size_t>(num_workers, 1)},
+          workers_queued{num_workers}, thread_name{std::move(name)} {
+        const auto lambda = [this, func](std::stop_token stop_token, size_t index) {
             Common::SetCurrentThreadName(thread_name.c_str());
+            CurrentWorker() = {this, index};
             {
                 [[maybe_unused]] std::conditional_t<with_state, StateType, int> state{func()};
                 while (!stop_token.stop_requested()) {
                     Task task;
-                    {
-                        std::unique_lock lock{queue_mutex};
-                        if (requests.empty()) {
-                            wait_condition.notify_all();
-                        }
+                    if (!TryPop(index, task) && !TrySteal(index, task)) {
+                        std::unique_lock lock{sleep_mutex};
+                        ++num_sleeping;
                         Common::CondvarWait(condition, lock, stop_token,
-                                            [this] { return !requests.empty(); });
-                        if (stop_token.stop_requested()) {
-                            break;
-                        }
-                        task = std::move(requests.front());
-                        requests.pop();
+                                            [this] { return num_pending.load() > 0; });
+                        --num_sleeping;
+                        continue;
                     }
                     if constexpr (with_state) {
                         task(&state);
                     } else {
                         task();
                     }
-                    ++work_done;
+                    if (++work_done >= work_scheduled.load()) {
+                        std::scoped_lock lock{wait_mutex};
+                        wait_condition.notify_all();
+                    }
                 }
             }
             ++workers_stopped;
+            std::scoped_lock lock{wait_mutex};
             wait_condition.notify_all();
         };
         threads.reserve(num_workers);
         for (size_t i = 0; i < num_workers; ++i) {
-            threads.emplace_back(lambda);
+            threads.emplace_back(lambda, i);
         }
     }
 
@@ -79,12 +97,37 @@ public:
     StatefulThreadWorker(StatefulThreadWorker&&) = delete;
 
     void QueueWork(Task work) {
+        ++work_scheduled;
         {
-            std::unique_lock lock{queue_mutex};
-            requests.emplace(std::move(work));
-            ++work_scheduled;
+            WorkerQueue& queue = queues[NextQueueIndex()];
+            std::scoped_lock lock{queue.mutex};
+            queue.tasks.push_back(std::move(work));
+        }
+        ++num_pending;
+        WakeWorkers(1);
+    }
+
+    /// Queues several tasks at once, taking each worker queue lock at most once.
+    void QueueWork(std::vector<Task>&& works) {
+        const size_t num_works = works.size();
+        if (num_works == 0) {
+            return;
+        }
+        work_scheduled += num_works;
+
+        // Hand out contiguous chunks of the batch, so workers can start on it without stealing.
+        const size_t first_queue = NextQueueIndex();
+        const size_t chunk_size = (num_works + num_queues - 1) / num_queues;
+        for (size_t begin = 0, i = 0; begin < num_works; begin += chunk_size, ++i) {
+            const size_t end = std::min(begin + chunk_size, num_works);
+            WorkerQueue& queue = queues[(first_queue + i) % num_queues];
+            std::scoped_lock lock{queue.mutex};
+            for (size_t work = begin; work < end; ++work) {
+                queue.tasks.push_back(std::move(works[work]));
+            }
         }
-        condition.notify_one();
+        num_pending += static_cast<s64>(num_works);
+        WakeWorkers(num_works);
     }
 
     void WaitForRequests(std::stop_token stop_token = {}) {
@@ -93,16 +136,99 @@ public:
                 thread.request_stop();
             }
         });
-        std::unique_lock lock{queue_mutex};
+        std::unique_lock lock{wait_mutex};
         wait_condition.wait(lock, [this] {
             return workers_stopped >= workers_queued || work_done >= work_scheduled;
         });
     }
 
 private:
-    std::queue<Task> requests;
-    std::mutex queue_mutex;
+    struct WorkerIdentity {
+        const void* owner;
+        size_t index;
+    };
+
+    static WorkerIdentity& CurrentWorker() {
+        thread_local WorkerIdentity identity{};
+        return identity;
+    }
+
+    size_t NextQueueIndex() {
+        if (const WorkerIdentity& worker = CurrentWorker(); worker.owner == this) {
+            return worker.index;
+        }
+        return next_queue.fetch_add(1, std::memory_order_relaxed) % num_queues;
+    }
+
+    void WakeWorkers(size_t num_works) {
+        // Workers increment num_sleeping before checking num_pending, so either they observe the
+        // new work or we observe them going to sleep.
+        if (num_sleeping.load() == 0) {
+            return;
+        }
+        std::scoped_lock lock{sleep_mutex};
+        if (num_works == 1) {
+            condition.notify_one();
+        } else {
+            condition.notify_all();
+        }
+    }
+
+    bool TryPop(size_t index, Task& task) {
+        WorkerQueue& queue = queues[index];
+        std::scoped_lock lock{queue.mutex};
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        --num_pending;
+        return true;
+    }
+
+    bool TrySteal(size_t index, Task& task) {
+        WorkerQueue* busy_queue = nullptr;
+        for (size_t offset = 1; offset < num_queues; ++offset) {
+            WorkerQueue& queue = queues[(index + offset) % num_queues];
+            std::unique_lock lock{queue.mutex, std::try_to_lock};
+            if (!lock) {
+                if (!busy_queue) {
+                    busy_queue = &queue;
+                }
+                continue;
+            }
+            if (StealBack(queue, task)) {
+                return true;
+            }
+        }
+        // Pending work behind busy locks would wake the worker right away, wait for one instead
+        // of spinning through the queues again.
+        if (!busy_queue) {
+            return false;
+        }
+        std::scoped_lock lock{busy_queue->mutex};
+        return StealBack(*busy_queue, task);
+    }
+
+    /// Takes the last task of a queue, its lock must be held.
+    bool StealBack(WorkerQueue& queue, Task& task) {
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        --num_pending;
+        return true;
+    }
+
+    std::unique_ptr<WorkerQueue[]> queues;
+    size_t num_queues;
+    std::atomic<size_t> next_queue{};
+    std::atomic<s64> num_pending{};
+    std::atomic<size_t> num_sleeping{};
+    std::mutex sleep_mutex;
     std::condition_variable_any condition;
+    std::mutex wait_mutex;
     std::condition_variable wait_condition;
     std::atomic<size_t> work_scheduled{};
     std::atomic<size_t> work_done{};
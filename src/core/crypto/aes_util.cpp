@@ -2,12 +2,19 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <array>
+#include <cstring>
 #include <mbedtls/cipher.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/crypto/aes_util.h"
 #include "core/crypto/key_manager.h"
 
+#ifdef ARCHITECTURE_x86_64
+#include <immintrin.h>
+#include "common/swap.h"
+#include "common/x64/cpu_detect.h"
+#endif
+
 namespace Core::Crypto {
 namespace {
 using NintendoTweak = std::array<u8, 16>;
@@ -20,6 +27,195 @@ NintendoTweak CalculateNintendoTweak(std::size_t sector_id) {
     }
     return out;
 }
+
+constexpr std::size_t AesBlockSize = 0x10;
+
+// Expanded AES-128 round keys, laid out as consumed by the AES instructions.
+struct AesRoundKeys {
+    alignas(16) std::array<std::array<u8, AesBlockSize>, 11> keys;
+};
+
+enum class FastPathMode {
+    None,
+    CTR,
+    XTS,
+};
+
+#ifdef ARCHITECTURE_x86_64
+
+#ifdef _MSC_VER
+#define AES_NI_TARGET
+#else
+#define AES_NI_TARGET __attribute__((target("aes,sse4.1")))
+#endif
+
+// Number of blocks kept in flight, to hide the latency of the AES instructions.
+constexpr std::size_t PipelineBlocks = 8;
+
+bool HasAesNi() {
+    static const bool has_aes = [] {
+        const auto& caps = Common::GetCPUCaps();
+        return caps.aes && caps.sse4_1;
+    }();
+    return has_aes;
+}
+
+template <int Rcon>
+AES_NI_TARGET __m128i ExpandKeyStep(__m128i key) {
+    const __m128i assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, Rcon), 0xFF);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+AES_NI_TARGET void ExpandKey128(const u8* key, AesRoundKeys& enc, AesRoundKeys& dec) {
+    std::array<__m128i, 11> rk;
+    rk[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+    rk[1] = ExpandKeyStep<0x01>(rk[0]);
+    rk[2] = ExpandKeyStep<0x02>(rk[1]);
+    rk[3] = ExpandKeyStep<0x04>(rk[2]);
+    rk[4] = ExpandKeyStep<0x08>(rk[3]);
+    rk[5] = ExpandKeyStep<0x10>(rk[4]);
+    rk[6] = ExpandKeyStep<0x20>(rk[5]);
+    rk[7] = ExpandKeyStep<0x40>(rk[6]);
+    rk[8] = ExpandKeyStep<0x80>(rk[7]);
+    rk[9] = ExpandKeyStep<0x1B>(rk[8]);
+    rk[10] = ExpandKeyStep<0x36>(rk[9]);
+
+    for (std::size_t i = 0; i < rk.size(); ++i) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(enc.keys[i].data()), rk[i]);
+
+        // The equivalent inverse cipher uses the reversed schedule with InvMixColumns applied.
+        const __m128i dec_key = (i == 0 || i == 10) ? rk[10 - i] : _mm_aesimc_si128(rk[10 - i]);
+        _mm_store_si128(reinterpret_cast<__m128i*>(dec.keys[i].data()), dec_key);
+    }
+}
+
+template <bool Decrypt, std::size_t N>
+AES_NI_TARGET void CryptBlocks(const AesRoundKeys& round_keys, __m128i (&blocks)[N]) {
+    const auto* const rk = reinterpret_cast<const __m128i*>(round_keys.keys.data());
+
+    for (std::size_t i = 0; i < N; ++i) {
+        blocks[i] = _mm_xor_si128(blocks[i], _mm_load_si128(rk));
+    }
+    for (std::size_t round = 1; round < 10; ++round) {
+        const __m128i key = _mm_load_si128(rk + round);
+        for (std::size_t i = 0; i < N; ++i) {
+            blocks[i] =
+                Decrypt ? _mm_aesdec_si128(blocks[i], key) : _mm_aesenc_si128(blocks[i], key);
+        }
+    }
+    const __m128i last_key = _mm_load_si128(rk + 10);
+    for (std::size_t i = 0; i < N; ++i) {
+        blocks[i] = Decrypt ? _mm_aesdeclast_si128(blocks[i], last_key)
+                            : _mm_aesenclast_si128(blocks[i], last_key);
+    }
+}
+
+/// Transcodes data in CTR mode, advancing the big-endian counter in iv past every block used.
+AES_NI_TARGET void CtrTranscodeAesNi(const AesRoundKeys& keys, u8* iv, const u8* src,
+                                     std::size_t size, u8* dest) {
+    u64 counter_hi;
+    u64 counter_lo;
+    std::memcpy(&counter_hi, iv, sizeof(u64));
+    std::memcpy(&counter_lo, iv + sizeof(u64), sizeof(u64));
+    counter_hi = Common::swap64(counter_hi);
+    counter_lo = Common::swap64(counter_lo);
+
+    const auto next_counter = [&] {
+        const __m128i block = _mm_set_epi64x(static_cast<s64>(Common::swap64(counter_lo)),
+                                             static_cast<s64>(Common::swap64(counter_hi)));
+        if (++counter_lo == 0) {
+            ++counter_hi;
+        }
+        return block;
+    };
+
+    // Process whole pipelines of blocks.
+    for (; size >= PipelineBlocks * AesBlockSize; size -= PipelineBlocks * AesBlockSize) {
+        __m128i blocks[PipelineBlocks];
+        for (auto& block : blocks) {
+            block = next_counter();
+        }
+        CryptBlocks<false>(keys, blocks);
+        for (std::size_t i = 0; i < PipelineBlocks; ++i) {
+            const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src) + i);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest) + i,
+                             _mm_xor_si128(data, blocks[i]));
+        }
+        src += PipelineBlocks * AesBlockSize;
+        dest += PipelineBlocks * AesBlockSize;
+    }
+
+    // Process the remaining blocks, including any partial final block.
+    while (size > 0) {
+        __m128i blocks[1] = {next_counter()};
+        CryptBlocks<false>(keys, blocks);
+
+        const std::size_t length = std::min(size, AesBlockSize);
+        std::array<u8, AesBlockSize> block{};
+        std::memcpy(block.data(), src, length);
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block.data()));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(block.data()), _mm_xor_si128(data, blocks[0]));
+        std::memcpy(dest, block.data(), length);
+
+        src += length;
+        dest += length;
+        size -= length;
+    }
+
+    counter_hi = Common::swap64(counter_hi);
+    counter_lo = Common::swap64(counter_lo);
+    std::memcpy(iv, &counter_hi, sizeof(u64));
+    std::memcpy(iv + sizeof(u64), &counter_lo, sizeof(u64));
+}
+
+/// Multiplies an XTS tweak by the primitive element of GF(2^128).
+AES_NI_TARGET __m128i MultiplyTweak(__m128i tweak) {
+    const __m128i carry = _mm_and_si128(_mm_shuffle_epi32(_mm_srai_epi32(tweak, 31), 0x13),
+                                        _mm_set_epi32(0, 1, 0, 0x87));
+    return _mm_xor_si128(_mm_add_epi64(tweak, tweak), carry);
+}
+
+/// Transcodes one XTS data unit, whose size must be a multiple of the block size.
+template <bool Decrypt>
+AES_NI_TARGET void XtsTranscodeAesNi(const AesRoundKeys& data_keys,
+                                     const AesRoundKeys& tweak_keys, const u8* iv,
+                                     const u8* src, std::size_t size, u8* dest) {
+    __m128i tweak[1] = {_mm_loadu_si128(reinterpret_cast<const __m128i*>(iv))};
+    CryptBlocks<false>(tweak_keys, tweak);
+
+    std::size_t blocks_left = size / AesBlockSize;
+    while (blocks_left > 0) {
+        const std::size_t count = std::min(blocks_left, PipelineBlocks);
+
+        __m128i tweaks[PipelineBlocks];
+        __m128i blocks[PipelineBlocks];
+        for (std::size_t i = 0; i < PipelineBlocks; ++i) {
+            tweaks[i] = tweak[0];
+            tweak[0] = MultiplyTweak(tweak[0]);
+
+            blocks[i] = _mm_setzero_si128();
+            if (i < count) {
+                const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src) + i);
+                blocks[i] = _mm_xor_si128(data, tweaks[i]);
+            }
+        }
+        CryptBlocks<Decrypt>(data_keys, blocks);
+        for (std::size_t i = 0; i < count; ++i) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest) + i,
+                             _mm_xor_si128(blocks[i], tweaks[i]));
+        }
+
+        src += count * AesBlockSize;
+        dest += count * AesBlockSize;
+        blocks_left -= count;
+    }
+}
+
+#endif
+
 } // Anonymous namespace
 
 static_assert(static_cast<std::size_t>(Mode::CTR) ==
@@ -36,6 +232,14 @@ static_assert(static_cast<std::size_t>(Mode::XTS) ==
 struct CipherContext {
     mbedtls_cipher_context_t encryption_context;
     mbedtls_cipher_context_t decryption_context;
+
+    // State for the hardware accelerated path, used instead of mbedtls when the host supports it.
+    FastPathMode fast_path_mode = FastPathMode::None;
+    AesRoundKeys encryption_keys;
+    AesRoundKeys decryption_keys;
+    AesRoundKeys tweak_keys;
+    std::array<u8, AesBlockSize> encryption_iv{};
+    std::array<u8, AesBlockSize> decryption_iv{};
 };
 
 template <typename Key, std::size_t KeySize>
@@ -57,6 +261,22 @@ Crypto::AESCipher<Key, KeySize>::AESCipher(Key key, Mode mode)
     ASSERT(
         !mbedtls_cipher_setkey(&ctx->decryption_context, key.data(), KeySize * 8, MBEDTLS_DECRYPT));
     //"Failed to set key on mbedtls ciphers.");
+
+#ifdef ARCHITECTURE_x86_64
+    // Expand the keys once up front for the AES-NI path. XTS uses two AES-128 keys, the first
+    // for the data and the second for the tweak.
+    if (HasAesNi()) {
+        if (mode == Mode::CTR && KeySize == 0x10) {
+            ExpandKey128(key.data(), ctx->encryption_keys, ctx->decryption_keys);
+            ctx->fast_path_mode = FastPathMode::CTR;
+        } else if (mode == Mode::XTS && KeySize == 0x20) {
+            AesRoundKeys unused_keys;
+            ExpandKey128(key.data(), ctx->encryption_keys, ctx->decryption_keys);
+            ExpandKey128(key.data() + 0x10, ctx->tweak_keys, unused_keys);
+            ctx->fast_path_mode = FastPathMode::XTS;
+        }
+    }
+#endif
 }
 
 template <typename Key, std::size_t KeySize>
@@ -67,6 +287,25 @@ AESCipher<Key, KeySize>::~AESCipher() {
 
 template <typename Key, std::size_t KeySize>
 void AESCipher<Key, KeySize>::Transcode(const u8* src, std::size_t size, u8* dest, Op op) const {
+#ifdef ARCHITECTURE_x86_64
+    if (ctx->fast_path_mode == FastPathMode::CTR) {
+        // Encryption and decryption are the same operation, but each keeps its own counter.
+        auto& iv = op == Op::Encrypt ? ctx->encryption_iv : ctx->decryption_iv;
+        CtrTranscodeAesNi(ctx->encryption_keys, iv.data(), src, size, dest);
+        return;
+    }
+    if (ctx->fast_path_mode == FastPathMode::XTS && size % AesBlockSize == 0) {
+        if (op == Op::Encrypt) {
+            XtsTranscodeAesNi<false>(ctx->encryption_keys, ctx->tweak_keys,
+                                     ctx->encryption_iv.data(), src, size, dest);
+        } else {
+            XtsTranscodeAesNi<true>(ctx->decryption_keys, ctx->tweak_keys,
+                                    ctx->decryption_iv.data(), src, size, dest);
+        }
+        return;
+    }
+#endif
+
     auto* const context = op == Op::Encrypt ? &ctx->encryption_context : &ctx->decryption_context;
 
     mbedtls_cipher_reset(context);
@@ -111,6 +350,23 @@ void AESCipher<Key, KeySize>::XTSTranscode(const u8* src, std::size_t size, u8*
                                            std::size_t sector_id, std::size_t sector_size, Op op) {
     ASSERT_MSG(size % sector_size == 0, "XTS decryption size must be a multiple of sector size.");
 
+#ifdef ARCHITECTURE_x86_64
+    // Process every sector in one go, without going through the IV and cipher state.
+    if (ctx->fast_path_mode == FastPathMode::XTS && sector_size % AesBlockSize == 0) {
+        for (std::size_t i = 0; i < size; i += sector_size) {
+            const auto tweak = CalculateNintendoTweak(sector_id++);
+            if (op == Op::Encrypt) {
+                XtsTranscodeAesNi<false>(ctx->encryption_keys, ctx->tweak_keys, tweak.data(),
+                                         src + i, sector_size, dest + i);
+            } else {
+                XtsTranscodeAesNi<true>(ctx->decryption_keys, ctx->tweak_keys, tweak.data(),
+                                        src + i, sector_size, dest + i);
+            }
+        }
+        return;
+    }
+#endif
+
     for (std::size_t i = 0; i < size; i += sector_size) {
         SetIV(CalculateNintendoTweak(sector_id++));
         Transcode(src + i, sector_size, dest + i, op);
@@ -122,6 +378,11 @@ void AESCipher<Key, KeySize>::SetIV(std::span<const u8> data) {
     ASSERT_MSG((mbedtls_cipher_set_iv(&ctx->encryption_context, data.data(), data.size()) ||
                 mbedtls_cipher_set_iv(&ctx->decryption_context, data.data(), data.size())) == 0,
                "Failed to set IV on mbedtls ciphers.");
+
+    const std::size_t iv_size = std::min(data.size(), AesBlockSize);
+    ctx->encryption_iv = {};
+    std::memcpy(ctx->encryption_iv.data(), data.data(), iv_size);
+    ctx->decryption_iv = ctx->encryption_iv;
 }
 
 template class AESCipher<Key128>;
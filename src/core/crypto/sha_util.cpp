@@ -1,4 +1,235 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
-namespace Crypto {} // namespace Crypto
+#include <cstring>
+#include <mbedtls/sha256.h>
+
+#include "common/common_funcs.h"
+#include "core/crypto/sha_util.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include <immintrin.h>
+#include "common/x64/cpu_detect.h"
+#endif
+
+namespace Core::Crypto {
+namespace {
+
+void CalculateSHA256Generic(SHA256Hash& out, const u8* data, size_t size) {
+    mbedtls_sha256_ret(data, size, out.data(), 0);
+}
+
+#ifdef ARCHITECTURE_x86_64
+
+#ifdef _MSC_VER
+#define SHA_NI_TARGET
+#else
+#define SHA_NI_TARGET __attribute__((target("sha,sse4.1")))
+#endif
+
+constexpr std::array<u32, 8> InitialState = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+alignas(16) constexpr std::array<u32, 64> RoundConstants = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/// Blocks hashed together by CalculateSHA256Blocks. The rounds of a block depend on each other,
+/// hashing two independent blocks at once keeps the SHA unit busy during their latency.
+constexpr size_t InterleavedBlocks = 2;
+
+/// Extends the message schedule by four words in each lane.
+template <size_t Lanes>
+SHA_NI_TARGET void ScheduleSHA256Ni(__m128i (&cur)[Lanes], const __m128i (&next)[Lanes],
+                                    const __m128i (&next2)[Lanes], const __m128i (&prev)[Lanes]) {
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        cur[lane] = _mm_sha256msg1_epu32(cur[lane], next[lane]);
+        cur[lane] = _mm_add_epi32(cur[lane], _mm_alignr_epi8(prev[lane], next2[lane], 4));
+        cur[lane] = _mm_sha256msg2_epu32(cur[lane], prev[lane]);
+    }
+}
+
+/// Performs four rounds in each lane.
+template <size_t Lanes>
+SHA_NI_TARGET void RoundsSHA256Ni(__m128i (&abef)[Lanes], __m128i (&cdgh)[Lanes],
+                                  const __m128i (&w)[Lanes], size_t round) {
+    const __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(RoundConstants.data()) +
+                                     round);
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        const __m128i msg = _mm_add_epi32(w[lane], k);
+        cdgh[lane] = _mm_sha256rnds2_epu32(cdgh[lane], abef[lane], msg);
+        abef[lane] = _mm_sha256rnds2_epu32(abef[lane], cdgh[lane], _mm_shuffle_epi32(msg, 0x0E));
+    }
+}
+
+/**
+ * Compresses 64-byte chunks of several equally sized streams, each with its state held in the
+ * ABEF/CDGH layout used by sha256rnds2. The streams start stride bytes apart.
+ */
+template <size_t Lanes>
+SHA_NI_TARGET void CompressSHA256Ni(__m128i (&state_abef)[Lanes], __m128i (&state_cdgh)[Lanes],
+                                    const u8* data, size_t stride, size_t chunk_count) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    const auto load = [&](__m128i(&w)[Lanes], size_t offset) {
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            const auto* const source = data + lane * stride + offset;
+            w[lane] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+        }
+    };
+
+    // Work on copies, so the state stays in registers
+    __m128i abef[Lanes];
+    __m128i cdgh[Lanes];
+    std::memcpy(abef, state_abef, sizeof(abef));
+    std::memcpy(cdgh, state_cdgh, sizeof(cdgh));
+
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk, data += 64) {
+        __m128i abef_save[Lanes];
+        __m128i cdgh_save[Lanes];
+        std::memcpy(abef_save, abef, sizeof(abef));
+        std::memcpy(cdgh_save, cdgh, sizeof(cdgh));
+
+        __m128i w0[Lanes];
+        __m128i w1[Lanes];
+        __m128i w2[Lanes];
+        __m128i w3[Lanes];
+        load(w0, 0);
+        load(w1, 16);
+        load(w2, 32);
+        load(w3, 48);
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            w0[lane] = _mm_shuffle_epi8(w0[lane], byte_swap);
+            w1[lane] = _mm_shuffle_epi8(w1[lane], byte_swap);
+            w2[lane] = _mm_shuffle_epi8(w2[lane], byte_swap);
+            w3[lane] = _mm_shuffle_epi8(w3[lane], byte_swap);
+        }
+
+        RoundsSHA256Ni<Lanes>(abef, cdgh, w0, 0);
+        RoundsSHA256Ni<Lanes>(abef, cdgh, w1, 1);
+        RoundsSHA256Ni<Lanes>(abef, cdgh, w2, 2);
+        RoundsSHA256Ni<Lanes>(abef, cdgh, w3, 3);
+        for (size_t round = 4; round < 16; round += 4) {
+            ScheduleSHA256Ni<Lanes>(w0, w1, w2, w3);
+            RoundsSHA256Ni<Lanes>(abef, cdgh, w0, round);
+            ScheduleSHA256Ni<Lanes>(w1, w2, w3, w0);
+            RoundsSHA256Ni<Lanes>(abef, cdgh, w1, round + 1);
+            ScheduleSHA256Ni<Lanes>(w2, w3, w0, w1);
+            RoundsSHA256Ni<Lanes>(abef, cdgh, w2, round + 2);
+            ScheduleSHA256Ni<Lanes>(w3, w0, w1, w2);
+            RoundsSHA256Ni<Lanes>(abef, cdgh, w3, round + 3);
+        }
+
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            abef[lane] = _mm_add_epi32(abef[lane], abef_save[lane]);
+            cdgh[lane] = _mm_add_epi32(cdgh[lane], cdgh_save[lane]);
+        }
+    }
+    std::memcpy(state_abef, abef, sizeof(abef));
+    std::memcpy(state_cdgh, cdgh, sizeof(cdgh));
+}
+
+/// Hashes consecutive blocks of the given size, one per lane.
+template <size_t Lanes>
+SHA_NI_TARGET void CalculateSHA256Ni(SHA256Hash* out, const u8* data, size_t size) {
+    // Load the initial state, rearranged into ABEF/CDGH order.
+    const __m128i abcd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(InitialState.data()));
+    const __m128i efgh =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(InitialState.data() + 4));
+    const __m128i cdab = _mm_shuffle_epi32(abcd, 0xB1);
+    const __m128i hgfe = _mm_shuffle_epi32(efgh, 0x1B);
+    __m128i abef[Lanes];
+    __m128i cdgh[Lanes];
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        abef[lane] = _mm_alignr_epi8(cdab, hgfe, 8);
+        cdgh[lane] = _mm_blend_epi16(hgfe, cdab, 0xF0);
+    }
+
+    // Process all whole chunks.
+    const size_t whole_chunks = size / 64;
+    CompressSHA256Ni<Lanes>(abef, cdgh, data, size, whole_chunks);
+
+    // Pad the remaining data with the terminator and bit length.
+    std::array<std::array<u8, 128>, Lanes> tails{};
+    const size_t remaining = size % 64;
+    const size_t tail_size = remaining < 56 ? 64 : 128;
+    const u64 bit_length = static_cast<u64>(size) * 8;
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        auto& tail = tails[lane];
+        std::memcpy(tail.data(), data + lane * size + whole_chunks * 64, remaining);
+        tail[remaining] = 0x80;
+        for (size_t i = 0; i < 8; ++i) {
+            tail[tail_size - 1 - i] = static_cast<u8>(bit_length >> (i * 8));
+        }
+    }
+    CompressSHA256Ni<Lanes>(abef, cdgh, tails[0].data(), tails[0].size(), tail_size / 64);
+
+    // Rearrange the state back into ABCD/EFGH order and store it big-endian.
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        const __m128i feba = _mm_shuffle_epi32(abef[lane], 0x1B);
+        const __m128i dchg = _mm_shuffle_epi32(cdgh[lane], 0xB1);
+        const __m128i out_abcd = _mm_shuffle_epi8(_mm_blend_epi16(feba, dchg, 0xF0), byte_swap);
+        const __m128i out_efgh = _mm_shuffle_epi8(_mm_alignr_epi8(dchg, feba, 8), byte_swap);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out[lane].data()), out_abcd);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out[lane].data() + 16), out_efgh);
+    }
+}
+
+bool HasSHAExtensions() {
+    static const bool has_sha = [] {
+        const auto& caps = Common::GetCPUCaps();
+        return caps.sha && caps.sse4_1;
+    }();
+    return has_sha;
+}
+
+#endif
+
+void CalculateSHA256Impl(SHA256Hash& out, const u8* data, size_t size) {
+#ifdef ARCHITECTURE_x86_64
+    if (HasSHAExtensions()) {
+        CalculateSHA256Ni<1>(&out, data, size);
+        return;
+    }
+#endif
+    CalculateSHA256Generic(out, data, size);
+}
+
+} // Anonymous namespace
+
+SHA256Hash CalculateSHA256(std::span<const u8> data) {
+    SHA256Hash hash;
+    CalculateSHA256Impl(hash, data.data(), data.size());
+    return hash;
+}
+
+void CalculateSHA256Blocks(std::span<SHA256Hash> out_hashes, const u8* data, size_t block_size) {
+#ifdef ARCHITECTURE_x86_64
+    if (HasSHAExtensions()) {
+        size_t index = 0;
+        for (; index + InterleavedBlocks <= out_hashes.size(); index += InterleavedBlocks) {
+            CalculateSHA256Ni<InterleavedBlocks>(&out_hashes[index], data + index * block_size,
+                                                 block_size);
+        }
+        for (; index < out_hashes.size(); ++index) {
+            CalculateSHA256Ni<1>(&out_hashes[index], data + index * block_size, block_size);
+        }
+        return;
+    }
+#endif
+    for (auto& hash : out_hashes) {
+        CalculateSHA256Impl(hash, data, block_size);
+        data += block_size;
+    }
+}
+
+} // namespace Core::Crypto
@@ -3,17 +3,26 @@
 
 #pragma once
 
-#include "common/assert.h"
-#include "core/file_sys/vfs.h"
-#include "key_manager.h"
-#include "mbedtls/cipher.h"
+#include <array>
+#include <span>
 
-namespace Crypto {
-typedef std::array<u8, 0x20> SHA256Hash;
+#include "common/common_types.h"
 
-inline SHA256Hash operator"" _HASH(const char* data, size_t len) {
-    if (len != 0x40)
-        return {};
-}
+namespace Core::Crypto {
 
-} // namespace Crypto
+using SHA256Hash = std::array<u8, 0x20>;
+
+/// Calculates the SHA-256 hash of data.
+SHA256Hash CalculateSHA256(std::span<const u8> data);
+
+/**
+ * Calculates the SHA-256 hash of each of a run of consecutive, equally sized blocks.
+ * Uses the SHA extensions of the host CPU when they are available, hashing blocks in pairs to
+ * overlap the latency of their rounds.
+ * @param out_hashes Receives one hash per block.
+ * @param data Start of the first block, out_hashes.size() * block_size bytes in total.
+ * @param block_size Size of each block in bytes.
+ */
+void CalculateSHA256Blocks(std::span<SHA256Hash> out_hashes, const u8* data, size_t block_size);
+
+} // namespace Core::Crypto
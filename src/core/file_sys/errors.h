@@ -69,6 +69,8 @@ constexpr Result ResultInvalidNcaHeader1SignatureKeyGeneration{ErrorModule::FS,
 constexpr Result ResultInvalidCompressedStorageSize{ErrorModule::FS, 4547};
 constexpr Result ResultInvalidNcaMetaDataHashDataSize{ErrorModule::FS, 4548};
 constexpr Result ResultInvalidNcaMetaDataHashDataHash{ErrorModule::FS, 4549};
+constexpr Result ResultNonRealDataVerificationFailed{ErrorModule::FS, 4603};
+constexpr Result ResultUnclearedRealDataVerificationFailed{ErrorModule::FS, 4605};
 constexpr Result ResultUnexpectedInCompressedStorageA{ErrorModule::FS, 5324};
 constexpr Result ResultUnexpectedInCompressedStorageB{ErrorModule::FS, 5325};
 constexpr Result ResultUnexpectedInCompressedStorageC{ErrorModule::FS, 5326};
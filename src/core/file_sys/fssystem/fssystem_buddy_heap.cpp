@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <bit>
+
+#include "common/alignment.h"
+#include "common/div_ceil.h"
+#include "core/file_sys/fssystem/fssystem_buddy_heap.h"
+
+namespace FileSys {
+
+void FileSystemBuddyHeap::Initialize(void* address, size_t size, size_t block_size,
+                                     s32 order_max) {
+    // Check pre-conditions.
+    ASSERT(m_heap_start == nullptr);
+    ASSERT(address != nullptr);
+    ASSERT(std::has_single_bit(block_size));
+    ASSERT(0 < order_max && order_max < 0x80);
+    ASSERT(Common::IsAligned(size, block_size << order_max));
+
+    // Set our fields.
+    m_heap_start = static_cast<u8*>(address);
+    m_heap_size = size;
+    m_block_size = block_size;
+    m_order_max = order_max;
+    m_free_size = 0;
+    m_free_lists.assign(order_max + 1, PageList{});
+    m_free_orders.assign(size / block_size, -1);
+
+    // Register the whole heap as blocks of the largest order.
+    const size_t max_order_blocks = static_cast<size_t>(1) << order_max;
+    for (size_t block_index = 0; block_index < m_free_orders.size();
+         block_index += max_order_blocks) {
+        this->PushFront(order_max, block_index);
+    }
+}
+
+void FileSystemBuddyHeap::Finalize() {
+    m_heap_start = nullptr;
+    m_heap_size = 0;
+    m_free_size = 0;
+    m_free_lists.clear();
+    m_free_orders.clear();
+}
+
+void* FileSystemBuddyHeap::AllocateByOrder(s32 order) {
+    // Check pre-conditions.
+    ASSERT(m_heap_start != nullptr);
+    ASSERT(0 <= order && order <= m_order_max);
+
+    // Find the smallest order with a free block.
+    s32 found_order = order;
+    while (found_order <= m_order_max && m_free_lists[found_order].head == nullptr) {
+        ++found_order;
+    }
+    if (found_order > m_order_max) {
+        return nullptr;
+    }
+
+    // Take the block.
+    const size_t block_index = this->GetBlockIndex(m_free_lists[found_order].head);
+    this->Remove(found_order, block_index);
+
+    // Split the block, returning the upper halves to the free lists.
+    while (found_order > order) {
+        --found_order;
+        this->PushFront(found_order, block_index + (static_cast<size_t>(1) << found_order));
+    }
+
+    return this->GetPageEntry(block_index);
+}
+
+void FileSystemBuddyHeap::Free(void* ptr, s32 order) {
+    // Check pre-conditions.
+    ASSERT(m_heap_start != nullptr);
+    ASSERT(this->Contains(ptr));
+    ASSERT(0 <= order && order <= m_order_max);
+
+    size_t block_index = this->GetBlockIndex(ptr);
+    ASSERT(Common::IsAligned(block_index, static_cast<size_t>(1) << order));
+    ASSERT(m_free_orders[block_index] < 0);
+
+    // Merge with our buddy for as long as it is free.
+    while (order < m_order_max) {
+        const size_t buddy_index = block_index ^ (static_cast<size_t>(1) << order);
+        if (m_free_orders[buddy_index] != order) {
+            break;
+        }
+
+        this->Remove(order, buddy_index);
+        block_index = std::min(block_index, buddy_index);
+        ++order;
+    }
+
+    this->PushFront(order, block_index);
+}
+
+size_t FileSystemBuddyHeap::GetAllocatableSizeMax() const {
+    for (s32 order = m_order_max; order >= 0; --order) {
+        if (m_free_lists[order].head != nullptr) {
+            return this->GetBytesFromOrder(order);
+        }
+    }
+    return 0;
+}
+
+s32 FileSystemBuddyHeap::GetOrderFromBytes(size_t size) const {
+    ASSERT(m_heap_start != nullptr);
+
+    const size_t block_count = std::max<size_t>(Common::DivCeil(size, m_block_size), 1);
+    const s32 order = static_cast<s32>(std::bit_width(block_count - 1));
+    return order <= m_order_max ? order : -1;
+}
+
+void FileSystemBuddyHeap::PushFront(s32 order, size_t block_index) {
+    auto& list = m_free_lists[order];
+    auto* const entry = this->GetPageEntry(block_index);
+
+    entry->prev = nullptr;
+    entry->next = list.head;
+    if (list.head != nullptr) {
+        list.head->prev = entry;
+    }
+    list.head = entry;
+    ++list.count;
+
+    m_free_orders[block_index] = static_cast<s8>(order);
+    m_free_size += this->GetBytesFromOrder(order);
+}
+
+void FileSystemBuddyHeap::Remove(s32 order, size_t block_index) {
+    auto& list = m_free_lists[order];
+    auto* const entry = this->GetPageEntry(block_index);
+    ASSERT(m_free_orders[block_index] == order);
+
+    if (entry->prev != nullptr) {
+        entry->prev->next = entry->next;
+    } else {
+        list.head = entry->next;
+    }
+    if (entry->next != nullptr) {
+        entry->next->prev = entry->prev;
+    }
+    --list.count;
+
+    m_free_orders[block_index] = -1;
+    m_free_size -= this->GetBytesFromOrder(order);
+}
+
+} // namespace FileSys
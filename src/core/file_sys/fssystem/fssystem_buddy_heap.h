@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <vector>
+
+#include "common/assert.h"
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+
+namespace FileSys {
+
+class FileSystemBuddyHeap {
+    YUZU_NON_COPYABLE(FileSystemBuddyHeap);
+    YUZU_NON_MOVEABLE(FileSystemBuddyHeap);
+
+private:
+    struct PageEntry {
+        PageEntry* prev;
+        PageEntry* next;
+    };
+    static_assert(std::is_trivial_v<PageEntry>);
+
+    struct PageList {
+        PageEntry* head;
+        size_t count;
+    };
+
+public:
+    FileSystemBuddyHeap() = default;
+
+    void Initialize(void* address, size_t size, size_t block_size, s32 order_max);
+    void Finalize();
+
+    void* AllocateByOrder(s32 order);
+    void Free(void* ptr, s32 order);
+
+    bool Contains(const void* ptr) const {
+        const auto* const p = static_cast<const u8*>(ptr);
+        return m_heap_start <= p && p < m_heap_start + m_heap_size;
+    }
+
+    size_t GetTotalFreeSize() const {
+        return m_free_size;
+    }
+
+    size_t GetTotalSize() const {
+        return m_heap_size;
+    }
+
+    size_t GetAllocatableSizeMax() const;
+
+    size_t GetBlockSize() const {
+        return m_block_size;
+    }
+
+    s32 GetOrderMax() const {
+        return m_order_max;
+    }
+
+    size_t GetBytesFromOrder(s32 order) const {
+        ASSERT(0 <= order && order <= m_order_max);
+        return m_block_size << order;
+    }
+
+    s32 GetOrderFromBytes(size_t size) const;
+
+private:
+    size_t GetBlockIndex(const void* ptr) const {
+        return static_cast<size_t>(static_cast<const u8*>(ptr) - m_heap_start) / m_block_size;
+    }
+
+    PageEntry* GetPageEntry(size_t block_index) const {
+        return reinterpret_cast<PageEntry*>(m_heap_start + block_index * m_block_size);
+    }
+
+    void PushFront(s32 order, size_t block_index);
+    void Remove(s32 order, size_t block_index);
+
+private:
+    u8* m_heap_start{};
+    size_t m_heap_size{};
+    size_t m_block_size{};
+    s32 m_order_max{};
+    size_t m_free_size{};
+    std::vector<PageList> m_free_lists;
+    /// Order of the free block starting at each block index, or -1 if no free block starts there.
+    std::vector<s8> m_free_orders;
+};
+
+} // namespace FileSys
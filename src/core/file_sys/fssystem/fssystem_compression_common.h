@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "common/thread_worker.h"
 #include "core/hle/result.h"
 
 namespace FileSys {
@@ -40,4 +41,6 @@ constexpr bool IsUnknownType(CompressionType type) {
 
 } // namespace CompressionTypeUtility
 
+Common::ThreadWorker& GetDecompressionWorkers();
+
 } // namespace FileSys
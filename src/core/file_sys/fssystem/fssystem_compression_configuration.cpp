@@ -1,6 +1,9 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <thread>
+
 #include "common/lz4_compression.h"
 #include "core/file_sys/fssystem/fssystem_compression_configuration.h"
 
@@ -33,4 +36,11 @@ const NcaCompressionConfiguration& GetNcaCompressionConfiguration() {
     return configuration;
 }
 
+Common::ThreadWorker& GetDecompressionWorkers() {
+    static Common::ThreadWorker workers{std::max(std::thread::hardware_concurrency(), 2U) / 2,
+                                        "Decompression"};
+
+    return workers;
+}
+
 } // namespace FileSys
@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "common/settings.h"
 #include "core/file_sys/fssystem/fssystem_hierarchical_integrity_verification_storage.h"
 #include "core/file_sys/vfs/vfs_offset.h"
 
@@ -23,11 +24,14 @@ Result HierarchicalIntegrityVerificationStorage::Initialize(
     // Set member variables.
     m_max_layers = info.max_layers;
 
+    // Determine whether every layer should check its data against the layer above.
+    const bool is_verification_enabled = Settings::values.verify_nca_integrity.GetValue();
+
     // Initialize the top level verification storage.
     m_verify_storages[0]->Initialize(storage[HierarchicalStorageInformation::MasterStorage],
                                      storage[HierarchicalStorageInformation::Layer1Storage],
                                      static_cast<s64>(1) << info.info[0].block_order, HashSize,
-                                     false);
+                                     false, is_verification_enabled);
 
     // Ensure we don't leak state if further initialization goes wrong.
     ON_RESULT_FAILURE {
@@ -59,7 +63,7 @@ Result HierarchicalIntegrityVerificationStorage::Initialize(
         m_verify_storages[level + 1]->Initialize(
             std::move(buffer_storage), storage[level + 2],
             static_cast<s64>(1) << info.info[level + 1].block_order,
-            static_cast<s64>(1) << info.info[level].block_order, false);
+            static_cast<s64>(1) << info.info[level].block_order, false, is_verification_enabled);
 
         // Initialize the buffer storage.
         m_buffer_storages[level + 1] = m_verify_storages[level + 1];
@@ -75,7 +79,7 @@ Result HierarchicalIntegrityVerificationStorage::Initialize(
         m_verify_storages[level + 1]->Initialize(
             std::move(buffer_storage), storage[level + 2],
             static_cast<s64>(1) << info.info[level + 1].block_order,
-            static_cast<s64>(1) << info.info[level].block_order, true);
+            static_cast<s64>(1) << info.info[level].block_order, true, is_verification_enabled);
 
         // Initialize the buffer storage.
         m_buffer_storages[level + 1] = m_verify_storages[level + 1];
@@ -1,8 +1,15 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <vector>
+
 #include "common/alignment.h"
+#include "common/div_ceil.h"
+#include "common/logging/log.h"
+#include "core/crypto/sha_util.h"
+#include "core/file_sys/errors.h"
 #include "core/file_sys/fssystem/fssystem_integrity_verification_storage.h"
+#include "core/file_sys/fssystem/fssystem_pooled_buffer.h"
 
 namespace FileSys {
 
@@ -12,7 +19,8 @@ constexpr inline u32 ILog2(u32 val) {
 }
 
 void IntegrityVerificationStorage::Initialize(VirtualFile hs, VirtualFile ds, s64 verif_block_size,
-                                              s64 upper_layer_verif_block_size, bool is_real_data) {
+                                              s64 upper_layer_verif_block_size, bool is_real_data,
+                                              bool is_verification_enabled) {
     // Validate preconditions.
     ASSERT(verif_block_size >= HashSize);
 
@@ -40,11 +48,20 @@ void IntegrityVerificationStorage::Initialize(VirtualFile hs, VirtualFile ds, s6
 
     // Set data.
     m_is_real_data = is_real_data;
+
+    // If we should verify our data, track which blocks have been verified.
+    m_is_verification_enabled = is_verification_enabled;
+    if (m_is_verification_enabled) {
+        const size_t block_count = Common::DivCeil(m_data_storage->GetSize(),
+                                                   static_cast<size_t>(m_verification_block_size));
+        m_verified_blocks = std::make_unique<std::atomic<u64>[]>(Common::DivCeil(block_count, 64U));
+    }
 }
 
 void IntegrityVerificationStorage::Finalize() {
     m_hash_storage = VirtualFile();
     m_data_storage = VirtualFile();
+    m_verified_blocks.reset();
 }
 
 size_t IntegrityVerificationStorage::Read(u8* buffer, size_t size, size_t offset) const {
@@ -80,10 +97,101 @@ size_t IntegrityVerificationStorage::Read(u8* buffer, size_t size, size_t offset
         read_size = static_cast<size_t>(data_size - offset);
     }
 
+    // Verify the blocks we are about to read, if we should.
+    if (m_is_verification_enabled) {
+        if (R_FAILED(this->VerifyRange(offset, read_size))) {
+            return 0;
+        }
+    }
+
     // Perform the read.
     return m_data_storage->Read(buffer, read_size, offset);
 }
 
+Result IntegrityVerificationStorage::VerifyRange(s64 offset, s64 size) const {
+    // Determine the blocks covered by the access.
+    const s64 first_block = offset >> m_verification_block_order;
+    const s64 end_block =
+        (offset + size + m_verification_block_size - 1) >> m_verification_block_order;
+    const s64 batch_block_count_max = std::max<s64>(
+        static_cast<s64>(PooledBuffer::GetAllocatableSizeMax()) >> m_verification_block_order, 1);
+
+    s64 block = first_block;
+    while (block < end_block) {
+        // Skip blocks that were already verified.
+        if (this->IsBlockVerified(block)) {
+            ++block;
+            continue;
+        }
+
+        // Gather a run of unverified blocks, and verify them together.
+        s64 batch_end = block + 1;
+        while (batch_end < end_block && batch_end - block < batch_block_count_max &&
+               !this->IsBlockVerified(batch_end)) {
+            ++batch_end;
+        }
+        R_TRY(this->VerifyBlocks(block, batch_end - block));
+
+        block = batch_end;
+    }
+
+    R_SUCCEED();
+}
+
+Result IntegrityVerificationStorage::VerifyBlocks(s64 first_block, s64 block_count) const {
+    const s64 data_size = m_data_storage->GetSize();
+
+    while (block_count > 0) {
+        // Allocate a buffer for as many blocks as we can.
+        PooledBuffer pooled_buffer;
+        pooled_buffer.Allocate(static_cast<size_t>(block_count << m_verification_block_order),
+                               static_cast<size_t>(m_verification_block_size));
+        const s64 cur_block_count =
+            std::min<s64>(block_count, static_cast<s64>(pooled_buffer.GetSize()) >>
+                                           m_verification_block_order);
+        const s64 cur_size = cur_block_count << m_verification_block_order;
+
+        // Read the data, zero-padding the final block of the storage.
+        auto* const buffer = reinterpret_cast<u8*>(pooled_buffer.GetBuffer());
+        const s64 data_offset = first_block << m_verification_block_order;
+        const s64 read_size = std::min(cur_size, data_size - data_offset);
+        m_data_storage->Read(buffer, static_cast<size_t>(read_size),
+                             static_cast<size_t>(data_offset));
+        std::memset(buffer + read_size, 0, static_cast<size_t>(cur_size - read_size));
+
+        // Read the expected hashes.
+        std::vector<Core::Crypto::SHA256Hash> expected_hashes(cur_block_count);
+        m_hash_storage->Read(reinterpret_cast<u8*>(expected_hashes.data()),
+                             static_cast<size_t>(cur_block_count * HashSize),
+                             static_cast<size_t>(first_block * HashSize));
+
+        // Hash the blocks.
+        std::vector<Core::Crypto::SHA256Hash> hashes(cur_block_count);
+        Core::Crypto::CalculateSHA256Blocks(hashes, buffer,
+                                            static_cast<size_t>(m_verification_block_size));
+
+        // Compare the hashes, and mark the blocks that match as verified.
+        for (s64 i = 0; i < cur_block_count; ++i) {
+            if (hashes[i] != expected_hashes[i]) {
+                LOG_ERROR(Common_Filesystem,
+                          "Integrity verification failed for block {} (offset 0x{:X}, "
+                          "is_real_data={})",
+                          first_block + i, (first_block + i) << m_verification_block_order,
+                          m_is_real_data);
+                R_THROW(m_is_real_data ? ResultUnclearedRealDataVerificationFailed
+                                       : ResultNonRealDataVerificationFailed);
+            }
+            this->SetBlockVerified(first_block + i);
+        }
+
+        // Advance.
+        first_block += cur_block_count;
+        block_count -= cur_block_count;
+    }
+
+    R_SUCCEED();
+}
+
 size_t IntegrityVerificationStorage::GetSize() const {
     return m_data_storage->GetSize();
 }
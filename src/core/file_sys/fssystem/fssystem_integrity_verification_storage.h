@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <optional>
 
 #include "core/file_sys/fssystem/fs_i_storage.h"
@@ -31,7 +33,8 @@ public:
     }
 
     void Initialize(VirtualFile hs, VirtualFile ds, s64 verif_block_size,
-                    s64 upper_layer_verif_block_size, bool is_real_data);
+                    s64 upper_layer_verif_block_size, bool is_real_data,
+                    bool is_verification_enabled = false);
     void Finalize();
 
     virtual size_t Read(u8* buffer, size_t size, size_t offset) const override;
@@ -42,6 +45,18 @@ public:
     }
 
 private:
+    Result VerifyRange(s64 offset, s64 size) const;
+    Result VerifyBlocks(s64 first_block, s64 block_count) const;
+
+    bool IsBlockVerified(s64 block) const {
+        const auto word = m_verified_blocks[block / 64].load(std::memory_order_relaxed);
+        return (word & (1ULL << (block % 64))) != 0;
+    }
+
+    void SetBlockVerified(s64 block) const {
+        m_verified_blocks[block / 64].fetch_or(1ULL << (block % 64), std::memory_order_relaxed);
+    }
+
     static void SetValidationBit(BlockHash* hash) {
         ASSERT(hash != nullptr);
         hash->hash[HashSize - 1] |= 0x80;
@@ -60,6 +75,9 @@ private:
     s64 m_upper_layer_verification_block_size;
     s64 m_upper_layer_verification_block_order;
     bool m_is_real_data;
+    bool m_is_verification_enabled;
+    /// One bit per verification block, set once the block's hash has been checked.
+    std::unique_ptr<std::atomic<u64>[]> m_verified_blocks;
 };
 
 } // namespace FileSys
@@ -1336,7 +1336,8 @@ Result NcaFileSystemDriver::CreateCompressedStorage(VirtualFile* out,
         std::make_shared<OffsetVfsFile>(base_storage, table_offset, 0),
         std::make_shared<OffsetVfsFile>(base_storage, node_size, table_offset),
         std::make_shared<OffsetVfsFile>(base_storage, entry_size, table_offset + node_size),
-        header.entry_count, 64_KiB, 640_KiB, get_decompressor, 16_KiB, 16_KiB, 32));
+        header.entry_count, 64_KiB, 640_KiB, get_decompressor, CompressedStorage::CacheBlockSizeMax,
+        CompressedStorage::CacheSizeMax, CompressedStorage::CacheEntriesMax));
 
     // Potentially set the output compressed storage.
     if (out_cmp) {
@@ -1,7 +1,13 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <array>
+#include <bit>
+#include <mutex>
+
 #include "common/alignment.h"
+#include "common/virtual_buffer.h"
+#include "core/file_sys/fssystem/fssystem_buddy_heap.h"
 #include "core/file_sys/fssystem/fssystem_pooled_buffer.h"
 
 namespace FileSys {
@@ -20,6 +26,113 @@ constexpr size_t HeapAllocatableSizeMax = HeapBlockSize * (static_cast<size_t>(1
 constexpr size_t HeapAllocatableSizeMaxForLarge =
     HeapBlockSize * (static_cast<size_t>(1) << HeapOrderMaxForLarge);
 
+// The heap holds a few of the largest allocations at once.
+constexpr size_t HeapSize = HeapAllocatableSizeMaxForLarge * 4;
+
+// Blocks up to 64KiB are cached per thread, so that small buffers can be reused without taking
+// the heap lock.
+constexpr s32 ThreadCacheOrderMax = 4;
+
+class PooledBufferHeap {
+public:
+    PooledBufferHeap() : m_memory(HeapSize) {
+        m_heap.Initialize(m_memory.data(), HeapSize, HeapBlockSize, HeapOrderMaxForLarge);
+        m_free_size_peak = m_heap.GetTotalFreeSize();
+    }
+
+    char* Allocate(size_t* out_size, size_t target_size, size_t required_size) {
+        std::scoped_lock lk{m_mutex};
+
+        // Try to allocate, reducing the allocation down to the required size if we must.
+        const s32 target_order = m_heap.GetOrderFromBytes(target_size);
+        const s32 required_order = m_heap.GetOrderFromBytes(required_size);
+        for (s32 order = target_order; order >= required_order; --order) {
+            if (auto* const buffer = m_heap.AllocateByOrder(order); buffer != nullptr) {
+                if (order != target_order) {
+                    ++m_reduce_allocation_count;
+                }
+                m_free_size_peak = std::min(m_free_size_peak, m_heap.GetTotalFreeSize());
+
+                *out_size = m_heap.GetBytesFromOrder(order);
+                return static_cast<char*>(buffer);
+            }
+        }
+
+        // The heap can't satisfy the allocation. Waiting for blocks to be freed would stall the
+        // reader for longer than the host allocator takes, so the caller falls back to it.
+        ++m_fallback_count;
+        return nullptr;
+    }
+
+    void Free(char* buffer, s32 order) {
+        std::scoped_lock lk{m_mutex};
+        m_heap.Free(buffer, order);
+    }
+
+    bool Contains(const char* buffer) const {
+        return m_heap.Contains(buffer);
+    }
+
+    s32 GetOrderFromBytes(size_t size) const {
+        return m_heap.GetOrderFromBytes(size);
+    }
+
+    size_t GetBytesFromOrder(s32 order) const {
+        return m_heap.GetBytesFromOrder(order);
+    }
+
+    size_t GetUsedSizePeak() {
+        std::scoped_lock lk{m_mutex};
+        return m_heap.GetTotalSize() - m_free_size_peak;
+    }
+
+    size_t GetReduceAllocationCount() {
+        std::scoped_lock lk{m_mutex};
+        return m_reduce_allocation_count;
+    }
+
+    size_t GetFallbackCount() {
+        std::scoped_lock lk{m_mutex};
+        return m_fallback_count;
+    }
+
+    void ClearPeak() {
+        std::scoped_lock lk{m_mutex};
+        m_free_size_peak = m_heap.GetTotalFreeSize();
+        m_reduce_allocation_count = 0;
+        m_fallback_count = 0;
+    }
+
+private:
+    Common::VirtualBuffer<u8> m_memory;
+    FileSystemBuddyHeap m_heap;
+    std::mutex m_mutex;
+    size_t m_free_size_peak{};
+    size_t m_reduce_allocation_count{};
+    size_t m_fallback_count{};
+};
+
+PooledBufferHeap& GetHeap() {
+    // The heap is intentionally never destroyed, as exiting threads may return their cached
+    // blocks to it while static objects are being torn down.
+    static PooledBufferHeap* const heap = new PooledBufferHeap;
+    return *heap;
+}
+
+struct ThreadCache {
+    std::array<char*, ThreadCacheOrderMax + 1> blocks{};
+
+    ~ThreadCache() {
+        for (s32 order = 0; order <= ThreadCacheOrderMax; ++order) {
+            if (blocks[order] != nullptr) {
+                GetHeap().Free(blocks[order], order);
+            }
+        }
+    }
+};
+
+thread_local ThreadCache g_thread_cache;
+
 } // namespace
 
 size_t PooledBuffer::GetAllocatableSizeMaxCore(bool large) {
@@ -35,27 +148,94 @@ void PooledBuffer::AllocateCore(size_t ideal_size, size_t required_size, bool la
 
     const size_t target_size =
         std::min(std::max(ideal_size, required_size), GetAllocatableSizeMaxCore(large));
+    if (target_size == 0) {
+        return;
+    }
 
-    // Dummy implementation for allocate.
-    if (target_size > 0) {
-        m_buffer =
-            reinterpret_cast<char*>(::operator new(target_size, std::align_val_t{HeapBlockSize}));
-        m_size = target_size;
+    auto& heap = GetHeap();
+
+    // Try to take a block from our thread's cache.
+    if (const s32 target_order = heap.GetOrderFromBytes(target_size);
+        target_order <= ThreadCacheOrderMax) {
+        if (auto* const buffer = std::exchange(g_thread_cache.blocks[target_order], nullptr)) {
+            m_buffer = buffer;
+            m_size = heap.GetBytesFromOrder(target_order);
+            this->Shrink(target_size);
+            return;
+        }
+    }
 
-        // Ensure postconditions.
-        ASSERT(m_buffer != nullptr);
+    // Allocate from the heap.
+    if (auto* const buffer = heap.Allocate(std::addressof(m_size), target_size, required_size)) {
+        m_buffer = buffer;
+        this->Shrink(target_size);
+        return;
     }
+
+    // The heap is exhausted, so fall back to the host allocator.
+    m_buffer =
+        reinterpret_cast<char*>(::operator new(target_size, std::align_val_t{HeapBlockSize}));
+    m_size = target_size;
+
+    // Ensure postconditions.
+    ASSERT(m_buffer != nullptr);
 }
 
 void PooledBuffer::Shrink(size_t ideal_size) {
     ASSERT(ideal_size <= GetAllocatableSizeMaxCore(true));
 
-    // Shrinking to zero means that we have no buffer.
-    if (ideal_size == 0) {
+    // Check that there is anything to release.
+    if (m_buffer == nullptr || m_size <= ideal_size) {
+        return;
+    }
+
+    auto& heap = GetHeap();
+    if (heap.Contains(m_buffer)) {
+        // Repeatedly free the tail of our buffer until we're small enough.
+        const size_t new_size = Common::AlignUp(ideal_size, HeapBlockSize);
+        while (new_size < m_size) {
+            // Determine the size and order to free.
+            const size_t tail_align = m_size & (~m_size + 1);
+            const size_t free_size = std::min(std::bit_floor(m_size - new_size), tail_align);
+            const s32 free_order = heap.GetOrderFromBytes(free_size);
+            ASSERT(free_size == heap.GetBytesFromOrder(free_order));
+
+            // Keep the block in our thread's cache if there is room, otherwise free it.
+            auto* const free_buffer = m_buffer + m_size - free_size;
+            if (free_order <= ThreadCacheOrderMax &&
+                g_thread_cache.blocks[free_order] == nullptr) {
+                g_thread_cache.blocks[free_order] = free_buffer;
+            } else {
+                heap.Free(free_buffer, free_order);
+            }
+            m_size -= free_size;
+        }
+    } else if (ideal_size == 0) {
+        // Buffers from the host allocator can only be released as a whole.
         ::operator delete(m_buffer, std::align_val_t{HeapBlockSize});
+        m_size = 0;
+    }
+
+    // Shrinking to zero means that we have no buffer.
+    if (m_size == 0) {
         m_buffer = nullptr;
-        m_size = ideal_size;
     }
 }
 
+size_t GetPooledBufferUsedSizePeak() {
+    return GetHeap().GetUsedSizePeak();
+}
+
+size_t GetPooledBufferReduceAllocationCount() {
+    return GetHeap().GetReduceAllocationCount();
+}
+
+size_t GetPooledBufferFallbackCount() {
+    return GetHeap().GetFallbackCount();
+}
+
+void ClearPooledBufferPeak() {
+    GetHeap().ClearPeak();
+}
+
 } // namespace FileSys
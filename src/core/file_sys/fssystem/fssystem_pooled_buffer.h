@@ -92,4 +92,9 @@ private:
     size_t m_size;
 };
 
+size_t GetPooledBufferUsedSizePeak();
+size_t GetPooledBufferReduceAllocationCount();
+size_t GetPooledBufferFallbackCount();
+void ClearPooledBufferPeak();
+
 } // namespace FileSys
@@ -8,8 +8,11 @@
 #include "common/assert.h"
 #include "common/fs/file.h"
 #include "common/fs/fs.h"
+#include "common/fs/mapped_file.h"
 #include "common/fs/path_util.h"
+#include "common/literals.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
 #include "core/file_sys/vfs/vfs.h"
 #include "core/file_sys/vfs/vfs_real.h"
 
@@ -27,11 +30,17 @@
 namespace FileSys {
 
 namespace FS = Common::FS;
+using namespace Common::Literals;
 
 namespace {
 
+// Soft cap on the files kept open by the filesystem. Evicted files stay open until the readers
+// which pinned them are done, so up to one extra file per concurrent read can be open.
 constexpr size_t MaxOpenFiles = 512;
 
+// Read-only files at least this large (i.e. game images) are memory mapped when enabled.
+constexpr u64 MinMappedFileSize = 64_MiB;
+
 constexpr FS::FileAccessMode ModeFlagsToFileAccessMode(OpenMode mode) {
     switch (mode) {
     case OpenMode::Read:
@@ -206,9 +215,11 @@ std::unique_lock<std::mutex> RealVfsFilesystem::RefreshReference(const std::stri
     if (!reference.file) {
         this->EvictSingleReferenceLocked();
 
-        reference.file =
+        auto file =
             FS::FileOpen(path, ModeFlagsToFileAccessMode(perms), FS::FileType::BinaryFile);
-        if (reference.file) {
+        if (file) {
+            std::scoped_lock file_lk{reference.file_lock};
+            reference.file = std::move(file);
             num_open_files++;
         }
     }
@@ -219,6 +230,23 @@ std::unique_lock<std::mutex> RealVfsFilesystem::RefreshReference(const std::stri
     return lk;
 }
 
+std::shared_ptr<FS::IOFile> RealVfsFilesystem::AcquireFile(const std::string& path,
+                                                           OpenMode perms,
+                                                           FileReference& reference) {
+    // Pin the open file without taking the list lock. The returned reference keeps the file open
+    // even if it is evicted while the caller is still using it.
+    {
+        std::scoped_lock file_lk{reference.file_lock};
+        if (reference.file) {
+            reference.accessed.store(true, std::memory_order_relaxed);
+            return reference.file;
+        }
+    }
+
+    auto lk = this->RefreshReference(path, perms, reference);
+    return reference.file;
+}
+
 void RealVfsFilesystem::DropReference(std::unique_ptr<FileReference>&& reference) {
     std::scoped_lock lk{list_lock};
 
@@ -226,10 +254,7 @@ void RealVfsFilesystem::DropReference(std::unique_ptr<FileReference>&& reference
     this->RemoveReferenceFromListLocked(*reference);
 
     // Close the file.
-    if (reference->file) {
-        reference->file.reset();
-        num_open_files--;
-    }
+    this->CloseReferenceLocked(*reference);
 }
 
 void RealVfsFilesystem::EvictSingleReferenceLocked() {
@@ -237,20 +262,41 @@ void RealVfsFilesystem::EvictSingleReferenceLocked() {
         return;
     }
 
+    // Files read without the list lock are not moved to the front of the list on access,
+    // so give them a second chance before closing them.
+    for (size_t i = 0; i < num_open_files; i++) {
+        auto& candidate = open_references.back();
+        if (!candidate.accessed.exchange(false, std::memory_order_relaxed)) {
+            break;
+        }
+        open_references.pop_back();
+        open_references.push_front(candidate);
+    }
+
     // Get and remove from list.
     auto& reference = open_references.back();
     this->RemoveReferenceFromListLocked(reference);
 
     // Close the file.
-    if (reference.file) {
-        reference.file.reset();
-        num_open_files--;
-    }
+    this->CloseReferenceLocked(reference);
 
     // Reinsert into closed list.
     this->InsertReferenceIntoListLocked(reference);
 }
 
+void RealVfsFilesystem::CloseReferenceLocked(FileReference& reference) {
+    std::shared_ptr<FS::IOFile> file;
+    {
+        std::scoped_lock file_lk{reference.file_lock};
+        file = std::move(reference.file);
+    }
+
+    // Readers which pinned the file keep it open until they are done with it.
+    if (file) {
+        num_open_files--;
+    }
+}
+
 void RealVfsFilesystem::InsertReferenceIntoListLocked(FileReference& reference) {
     if (reference.file) {
         open_references.push_front(reference);
@@ -313,6 +359,17 @@ bool RealVfsFile::IsReadable() const {
 }
 
 std::size_t RealVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    // Read-only files never change underneath us, so they can be read positionally from any
+    // number of threads without serializing on the list lock or the shared file position.
+    if (False(perms & OpenMode::Write)) {
+        if (const auto* const mapped = GetMappedFile(); mapped != nullptr) {
+            return mapped->ReadAt(std::span{data, length}, offset);
+        }
+
+        const auto file = base.AcquireFile(path, perms, *reference);
+        return file ? file->ReadSpanAt(std::span{data, length}, static_cast<s64>(offset)) : 0;
+    }
+
     auto lk = base.RefreshReference(path, perms, *reference);
     if (!reference->file || !reference->file->Seek(static_cast<s64>(offset))) {
         return 0;
@@ -333,6 +390,29 @@ bool RealVfsFile::Rename(std::string_view name) {
     return base.MoveFile(path, parent_path + '/' + std::string(name)) != nullptr;
 }
 
+const FS::MappedFile* RealVfsFile::GetMappedFile() const {
+    std::call_once(mapped_file_flag, [this] {
+        if (!Settings::values.memory_map_game_files.GetValue()) {
+            return;
+        }
+#ifdef ANDROID
+        if (path[0] != '/') {
+            return;
+        }
+#endif
+        if ((size ? *size : FS::GetSize(path)) < MinMappedFileSize) {
+            return;
+        }
+
+        auto file = std::make_unique<FS::MappedFile>(path);
+        if (file->IsOpen()) {
+            mapped_file = std::move(file);
+        }
+    });
+
+    return mapped_file.get();
+}
+
 // TODO(DarkLordZach): MSVC would not let me combine the following two functions using 'if
 // constexpr' because there is a compile error in the branch not used.
 
@@ -3,22 +3,29 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <optional>
 #include <string_view>
 #include "common/intrusive_list.h"
+#include "common/spin_lock.h"
 #include "core/file_sys/fs_filesystem.h"
 #include "core/file_sys/vfs/vfs.h"
 
 namespace Common::FS {
 class IOFile;
+class MappedFile;
 }
 
 namespace FileSys {
 
 struct FileReference : public Common::IntrusiveListBaseNode<FileReference> {
     std::shared_ptr<Common::FS::IOFile> file{};
+    // Guards file for readers which do not hold the list lock. Writers must hold both.
+    Common::SpinLock file_lock{};
+    // Set by reads which bypass the list lock, so eviction can give the file a second chance.
+    std::atomic_bool accessed{};
 };
 
 class RealVfsFile;
@@ -51,12 +58,14 @@ private:
     ReferenceListType open_references;
     ReferenceListType closed_references;
     std::mutex list_lock;
-    size_t num_open_files{};
+    size_t num_open_files{}; ///< Files referenced by the open list, pinned files may outlive it
 
 private:
     friend class RealVfsFile;
     std::unique_lock<std::mutex> RefreshReference(const std::string& path, OpenMode perms,
                                                   FileReference& reference);
+    std::shared_ptr<Common::FS::IOFile> AcquireFile(const std::string& path, OpenMode perms,
+                                                    FileReference& reference);
     void DropReference(std::unique_ptr<FileReference>&& reference);
 
 private:
@@ -66,6 +75,7 @@ private:
 
 private:
     void EvictSingleReferenceLocked();
+    void CloseReferenceLocked(FileReference& reference);
     void InsertReferenceIntoListLocked(FileReference& reference);
     void RemoveReferenceFromListLocked(FileReference& reference);
 };
@@ -93,6 +103,8 @@ private:
                 const std::string& path, OpenMode perms = OpenMode::Read,
                 std::optional<u64> size = {});
 
+    const Common::FS::MappedFile* GetMappedFile() const;
+
     RealVfsFilesystem& base;
     std::unique_ptr<FileReference> reference;
     std::string path;
@@ -100,6 +112,8 @@ private:
     std::vector<std::string> path_components;
     std::optional<u64> size;
     OpenMode perms;
+    mutable std::once_flag mapped_file_flag;
+    mutable std::unique_ptr<Common::FS::MappedFile> mapped_file;
 };
 
 // An implementation of VfsDirectory that represents a directory on the user's computer.
@@ -29,6 +29,8 @@ void LoopProcess(Core::System& system) {
                                          std::make_shared<IAudioRendererManager>(system));
     server_manager->RegisterNamedService("hwopus",
                                          std::make_shared<IHardwareOpusDecoderManager>(system));
+    // The audio managers are not synchronized for concurrent requests, so they are handled on a
+    // single thread.
     ServerManager::RunServer(std::move(server_manager));
 }
 
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+#include "common/common_types.h"
+#include "common/polyfill_thread.h"
+
+namespace Service {
+
+/// Request counters of a dispatch queue, the latencies measure host time
+struct DispatchStatistics {
+    u64 requests{};
+    size_t queue_depth{}; ///< Items waiting for a host worker
+    size_t max_queue_depth{};
+    std::chrono::nanoseconds total_queue_time{};
+    std::chrono::nanoseconds max_queue_time{};
+    std::chrono::nanoseconds total_service_time{};
+    std::chrono::nanoseconds max_service_time{};
+};
+
+/**
+ * Queue of work items handed from the thread waiting for events to the host workers of a server.
+ * Items are taken in the order they were pushed, and every item taken is accounted once served.
+ */
+template <typename T>
+class DispatchQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        T item;
+        Clock::time_point queue_time;
+    };
+
+    /// Queues an item and wakes up one of the waiting workers.
+    void Push(T item) {
+        {
+            std::scoped_lock lk{m_mutex};
+            m_queue.push_back({std::move(item), Clock::now()});
+            m_statistics.max_queue_depth = std::max(m_statistics.max_queue_depth, m_queue.size());
+        }
+        m_cv.notify_one();
+    }
+
+    /// Waits for an item, returns nothing once a stop is requested.
+    std::optional<Entry> Pop(std::stop_token stop_token) {
+        std::unique_lock lk{m_mutex};
+        Common::CondvarWait(m_cv, lk, stop_token, [&] { return !m_queue.empty(); });
+        if (stop_token.stop_requested()) {
+            return std::nullopt;
+        }
+        Entry entry = std::move(m_queue.front());
+        m_queue.pop_front();
+        return entry;
+    }
+
+    /// Accounts an item taken from the queue, serviced between the given times.
+    void Account(Clock::time_point queue_time, Clock::time_point start_time,
+                 Clock::time_point end_time) {
+        const std::chrono::nanoseconds queue_time_ns = start_time - queue_time;
+        const std::chrono::nanoseconds service_time_ns = end_time - start_time;
+        std::scoped_lock lk{m_mutex};
+        ++m_statistics.requests;
+        m_statistics.total_queue_time += queue_time_ns;
+        m_statistics.max_queue_time = std::max(m_statistics.max_queue_time, queue_time_ns);
+        m_statistics.total_service_time += service_time_ns;
+        m_statistics.max_service_time = std::max(m_statistics.max_service_time, service_time_ns);
+    }
+
+    DispatchStatistics GetStatistics() const {
+        std::scoped_lock lk{m_mutex};
+        DispatchStatistics stats = m_statistics;
+        stats.queue_depth = m_queue.size();
+        return stats;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable_any m_cv;
+    std::deque<Entry> m_queue;
+    DispatchStatistics m_statistics{};
+};
+
+} // namespace Service
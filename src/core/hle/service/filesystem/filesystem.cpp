@@ -728,6 +728,8 @@ void LoopProcess(Core::System& system) {
     server_manager->RegisterNamedService("fsp-ldr", std::make_shared<FSP_LDR>(system));
     server_manager->RegisterNamedService("fsp:pr", std::make_shared<FSP_PR>(system));
     server_manager->RegisterNamedService("fsp-srv", std::move(FileSystemProxyFactory));
+    // The save data, RomFS and content factories and their caches are not synchronized, so
+    // requests are handled on a single thread.
     ServerManager::RunServer(std::move(server_manager));
 }
 
@@ -62,6 +62,7 @@ void LoopProcess(Core::System& system) {
     server_manager->RegisterNamedService("nvdrv:s", NvdrvInterfaceFactoryForSysmodules);
     server_manager->RegisterNamedService("nvdrv:t", NvdrvInterfaceFactoryForTesting);
     server_manager->RegisterNamedService("nvmemp", std::make_shared<NVMEMP>(system));
+    // The device files share unsynchronized state, so requests are handled on a single thread.
     ServerManager::RunServer(std::move(server_manager));
 }
 
@@ -1,6 +1,9 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <fmt/format.h>
+
+#include "common/logging/log.h"
 #include "common/scope_exit.h"
 
 #include "core/core.h"
@@ -90,8 +93,12 @@ ServerManager::~ServerManager() {
 
     // Wait for processing to stop.
     m_stopped.Wait();
+    const bool has_host_workers = !m_threads.empty();
     m_threads.clear();
 
+    // Report how the requests were serviced.
+    this->LogStatistics(has_host_workers);
+
     // Clean up ports.
     auto port_it = m_servers.begin();
     while (port_it != m_servers.end()) {
@@ -149,6 +156,7 @@ Result ServerManager::RegisterNamedService(const std::string& service_name,
 
     // We are taking ownership of the server port, so don't open it.
     auto* server = new Port(server_port, std::move(handler_factory));
+    m_service_names.push_back(service_name);
 
     // Begin tracking the server port.
     {
@@ -197,6 +205,7 @@ Result ServerManager::ManageNamedPort(const std::string& service_name,
 
     // Transfer ownership into a new port object.
     auto* server = new Port(std::addressof(port->GetServerPort()), std::move(handler_factory));
+    m_service_names.push_back(service_name);
 
     // Begin tracking the port.
     {
@@ -238,7 +247,7 @@ void ServerManager::StartAdditionalHostThreads(const char* name, size_t num_thre
     for (size_t i = 0; i < num_threads; i++) {
         auto thread_name = fmt::format("{}:{}", name, i + 1);
         m_threads.emplace_back(m_system.Kernel().RunOnHostCoreThread(
-            std::move(thread_name), [&] { this->LoopProcessImpl(); }));
+            std::move(thread_name), [&] { this->WorkerLoop(); }));
     }
 }
 
@@ -293,7 +302,13 @@ MultiWaitHolder* ServerManager::WaitSignaled() {
 Result ServerManager::Process(MultiWaitHolder* holder) {
     switch (static_cast<UserDataTag>(holder->GetUserData())) {
     case UserDataTag::Session:
-        R_RETURN(this->OnSessionEvent(static_cast<Session*>(holder)));
+        // Hand the request to the host workers, if there are any.
+        if (!m_threads.empty()) {
+            this->QueueSession(static_cast<Session*>(holder));
+            R_SUCCEED();
+        }
+        this->ProcessSession(static_cast<Session*>(holder), std::chrono::steady_clock::now());
+        R_SUCCEED();
     case UserDataTag::Port:
         R_RETURN(this->OnPortEvent(static_cast<Port*>(holder)));
     case UserDataTag::DeferEvent:
@@ -320,6 +335,54 @@ Result ServerManager::LoopProcessImpl() {
     R_SUCCEED();
 }
 
+void ServerManager::WorkerLoop() {
+    const auto stop_token = m_stop_source.get_token();
+
+    // Handle the requests of the signaled sessions until we are stopped.
+    while (const auto queued = m_dispatch_queue.Pop(stop_token)) {
+        this->ProcessSession(queued->item, queued->queue_time);
+    }
+}
+
+void ServerManager::QueueSession(Session* session) {
+    m_dispatch_queue.Push(session);
+}
+
+void ServerManager::ProcessSession(Session* session,
+                                   std::chrono::steady_clock::time_point queue_time) {
+    const auto start_time = std::chrono::steady_clock::now();
+    R_ASSERT(this->OnSessionEvent(session));
+    const auto end_time = std::chrono::steady_clock::now();
+
+    // Account the request.
+    m_dispatch_queue.Account(queue_time, start_time, end_time);
+}
+
+void ServerManager::LogStatistics(bool has_host_workers) const {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    const DispatchStatistics stats = m_dispatch_queue.GetStatistics();
+    if (stats.requests == 0) {
+        return;
+    }
+    const std::string name = fmt::format("{}", fmt::join(m_service_names, ", "));
+    const auto service_avg = duration_cast<microseconds>(stats.total_service_time).count() /
+                             static_cast<s64>(stats.requests);
+    const auto service_max = duration_cast<microseconds>(stats.max_service_time).count();
+    if (!has_host_workers) {
+        LOG_INFO(Service, "{}: {} requests, service time {}us avg {}us max", name,
+                 stats.requests, service_avg, service_max);
+        return;
+    }
+    LOG_INFO(Service,
+             "{}: {} requests, max queue depth {}, queue time {}us avg {}us max, "
+             "service time {}us avg {}us max",
+             name, stats.requests, stats.max_queue_depth,
+             duration_cast<microseconds>(stats.total_queue_time).count() /
+                 static_cast<s64>(stats.requests),
+             duration_cast<microseconds>(stats.max_queue_time).count(), service_avg, service_max);
+}
+
 Result ServerManager::OnPortEvent(Port* server) {
     // Accept a new server session.
     auto* server_port = static_cast<Kernel::KServerPort*>(server->GetNativeHandle());
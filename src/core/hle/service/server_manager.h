@@ -3,14 +3,17 @@
 
 #pragma once
 
+#include <chrono>
 #include <list>
 #include <mutex>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "common/polyfill_thread.h"
 #include "common/thread.h"
 #include "core/hle/result.h"
+#include "core/hle/service/dispatch_queue.h"
 #include "core/hle/service/hle_ipc.h"
 #include "core/hle/service/os/multi_wait.h"
 #include "core/hle/service/os/mutex.h"
@@ -48,6 +51,13 @@ public:
     Result ManageDeferral(Kernel::KEvent** out_event);
 
     Result LoopProcess();
+
+    /**
+     * Starts host threads handling the session requests of this server. The thread running
+     * LoopProcess then only waits for events and queues signaled sessions for them, so at most
+     * num_threads requests are serviced at once. A session is not waited on while one of its
+     * requests is in flight, so requests on the same session are still handled in order.
+     */
     void StartAdditionalHostThreads(const char* name, size_t num_threads);
 
     static void RunServer(std::unique_ptr<ServerManager>&& server);
@@ -59,6 +69,10 @@ private:
     Result Process(MultiWaitHolder* holder);
     bool WaitAndProcessImpl();
     Result LoopProcessImpl();
+    void WorkerLoop();
+    void QueueSession(Session* session);
+    void ProcessSession(Session* session, std::chrono::steady_clock::time_point queue_time);
+    void LogStatistics(bool has_host_workers) const;
 
     Result OnPortEvent(Port* port);
     Result OnSessionEvent(Session* session);
@@ -92,6 +106,10 @@ private:
     Common::Event m_stopped{};
     std::vector<std::jthread> m_threads{};
     std::stop_source m_stop_source{};
+
+    // Host worker dispatch
+    std::vector<std::string> m_service_names{};
+    DispatchQueue<Session*> m_dispatch_queue{};
 };
 
 } // namespace Service
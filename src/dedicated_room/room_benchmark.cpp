@@ -0,0 +1,445 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <fmt/format.h>
+#include "common/common_types.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "network/network.h"
+#include "network/room.h"
+#include "network/room_member.h"
+#include "network/room_pool.h"
+#include "network/verify_user.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum class TrafficType : std::size_t {
+    Proxy,
+    Ldn,
+    Chat,
+};
+constexpr std::size_t NumTrafficTypes = 3;
+constexpr std::array<const char*, NumTrafficTypes> TrafficTypeNames{"proxy", "ldn", "chat"};
+
+struct BenchmarkOptions {
+    u32 clients = 100;
+    u32 rooms = 1;
+    u32 event_threads = 0;
+    u16 port = Network::DefaultRoomPort;
+    u32 duration_seconds = 10;
+    u32 payload_size = 256;
+    /// Packets sent per second by every client, for each traffic type
+    std::array<double, NumTrafficTypes> rates{60.0, 60.0, 0.2};
+};
+
+/// Forwarding latencies of one traffic type, in microseconds.
+class LatencyRecorder {
+public:
+    void Record(u64 latency_us) {
+        std::scoped_lock lock{mutex};
+        samples.push_back(latency_us);
+    }
+
+    std::vector<u64> TakeSamples() {
+        std::scoped_lock lock{mutex};
+        return std::move(samples);
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<u64> samples;
+};
+
+struct Client {
+    std::unique_ptr<Network::RoomMember> member;
+    std::size_t room_index{};
+    Network::IPv4Address fake_ip{};
+    std::array<double, NumTrafficTypes> send_credit{};
+    Network::RoomMember::CallbackHandle<Network::ProxyPacket> proxy_handle;
+    Network::RoomMember::CallbackHandle<Network::LDNPacket> ldn_handle;
+    Network::RoomMember::CallbackHandle<Network::ChatEntry> chat_handle;
+};
+
+u64 TimestampNs() {
+    return static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch())
+            .count());
+}
+
+u64 LatencyUs(u64 sent_timestamp_ns) {
+    return (TimestampNs() - sent_timestamp_ns) / 1000;
+}
+
+/// Builds a payload starting with the current timestamp, padded to the requested size.
+std::vector<u8> MakePayload(u32 payload_size) {
+    std::vector<u8> payload(std::max<std::size_t>(payload_size, sizeof(u64)));
+    const u64 timestamp = TimestampNs();
+    std::memcpy(payload.data(), &timestamp, sizeof(timestamp));
+    return payload;
+}
+
+u64 ReadPayloadTimestamp(const std::vector<u8>& payload) {
+    u64 timestamp = 0;
+    if (payload.size() >= sizeof(timestamp)) {
+        std::memcpy(&timestamp, payload.data(), sizeof(timestamp));
+    }
+    return timestamp;
+}
+
+/// Returns the CPU time consumed by the whole process.
+std::chrono::microseconds GetProcessCpuTime() {
+#ifdef _WIN32
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time,
+                         &user_time)) {
+        return {};
+    }
+    const auto to_us = [](const FILETIME& time) {
+        return ((static_cast<u64>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10;
+    };
+    return std::chrono::microseconds(to_us(kernel_time) + to_us(user_time));
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    const auto to_us = [](const timeval& time) {
+        return static_cast<u64>(time.tv_sec) * 1'000'000 + static_cast<u64>(time.tv_usec);
+    };
+    return std::chrono::microseconds(to_us(usage.ru_utime) + to_us(usage.ru_stime));
+#endif
+}
+
+u64 Percentile(const std::vector<u64>& sorted_samples, double percentile) {
+    if (sorted_samples.empty()) {
+        return 0;
+    }
+    const auto index = static_cast<std::size_t>(percentile * sorted_samples.size());
+    return sorted_samples[std::min(index, sorted_samples.size() - 1)];
+}
+
+void PrintHelp(const char* argv0) {
+    fmt::print("Usage: {} [options]\n"
+               "--clients         The number of clients, spread over the rooms (default 100)\n"
+               "--rooms           The number of rooms, on consecutive ports (default 1)\n"
+               "--event-threads   The number of threads servicing the rooms when there are "
+               "several\n"
+               "--port            The port of the first room\n"
+               "--duration        Seconds of traffic to generate (default 10)\n"
+               "--payload-size    Bytes of proxy and LDN payload (default 256)\n"
+               "--proxy-rate      Unicast proxy packets per second per client (default 60)\n"
+               "--ldn-rate        Broadcast LDN packets per second per client (default 60)\n"
+               "--chat-rate       Chat messages per second per client (default 0.2)\n"
+               "-h, --help        Display this help and exit\n"
+               "-v, --version     Output version information and exit\n",
+               argv0);
+}
+
+} // Anonymous namespace
+
+/// Load generator measuring how much traffic the room server sustains with in-process clients.
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    int option_index = 0;
+    char* endarg;
+
+    static struct option long_options[] = {
+        {"clients", required_argument, 0, 'c'},
+        {"rooms", required_argument, 0, 'r'},
+        {"event-threads", required_argument, 0, 'x'},
+        {"port", required_argument, 0, 'p'},
+        {"duration", required_argument, 0, 'd'},
+        {"payload-size", required_argument, 0, 's'},
+        {"proxy-rate", required_argument, 0, 'P'},
+        {"ldn-rate", required_argument, 0, 'L'},
+        {"chat-rate", required_argument, 0, 'C'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    while (optind < argc) {
+        int arg =
+            getopt_long(argc, argv, "c:r:x:p:d:s:P:L:C:hv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'c':
+                options.clients = strtoul(optarg, &endarg, 0);
+                break;
+            case 'r':
+                options.rooms = strtoul(optarg, &endarg, 0);
+                break;
+            case 'x':
+                options.event_threads = strtoul(optarg, &endarg, 0);
+                break;
+            case 'p':
+                options.port = static_cast<u16>(strtoul(optarg, &endarg, 0));
+                break;
+            case 'd':
+                options.duration_seconds = strtoul(optarg, &endarg, 0);
+                break;
+            case 's':
+                options.payload_size = strtoul(optarg, &endarg, 0);
+                break;
+            case 'P':
+                options.rates[static_cast<std::size_t>(TrafficType::Proxy)] =
+                    strtod(optarg, &endarg);
+                break;
+            case 'L':
+                options.rates[static_cast<std::size_t>(TrafficType::Ldn)] =
+                    strtod(optarg, &endarg);
+                break;
+            case 'C':
+                options.rates[static_cast<std::size_t>(TrafficType::Chat)] =
+                    strtod(optarg, &endarg);
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                fmt::print("yuzu room benchmark {} {} Libnetwork: {}\n", Common::g_scm_branch,
+                           Common::g_scm_desc, Network::network_version);
+                return 0;
+            }
+        }
+    }
+
+    if (options.rooms == 0 || options.clients < 2 * options.rooms) {
+        fmt::print("Every room needs at least two clients!\n");
+        return -1;
+    }
+    const u32 clients_per_room = (options.clients + options.rooms - 1) / options.rooms;
+    if (clients_per_room > Network::MaxConcurrentConnections) {
+        fmt::print("At most {} clients fit in a room!\n", Network::MaxConcurrentConnections);
+        return -1;
+    }
+    if (options.port + options.rooms - 1 > UINT16_MAX) {
+        fmt::print("The rooms need to fit in the port range 0 - 65535!\n");
+        return -1;
+    }
+
+    // Keep the per-member join and leave messages out of the report.
+    Common::Log::Initialize();
+    Common::Log::Filter filter;
+    filter.ParseFilterString("*:Warning");
+    Common::Log::SetGlobalFilter(filter);
+    Common::Log::SetColorConsoleBackendEnabled(true);
+    Common::Log::Start();
+
+    Network::RoomNetwork network{};
+    network.Init();
+
+    // A single room runs on its own thread like a default yuzu-room, several share a pool.
+    std::vector<std::shared_ptr<Network::Room>> rooms;
+    std::unique_ptr<Network::RoomPool> room_pool;
+    const auto verify_backend = std::make_shared<Network::VerifyUser::NullBackend>();
+    if (options.rooms == 1) {
+        auto room = network.GetRoom().lock();
+        if (!room->Create("Benchmark", "", "127.0.0.1", options.port, "", clients_per_room, "",
+                          {}, verify_backend)) {
+            fmt::print("Failed to create room on port {}\n", options.port);
+            return -1;
+        }
+        rooms.push_back(std::move(room));
+    } else {
+        const u32 event_threads =
+            options.event_threads != 0
+                ? options.event_threads
+                : std::min(options.rooms, std::max(std::thread::hardware_concurrency(), 1U));
+        room_pool = std::make_unique<Network::RoomPool>(event_threads, verify_backend);
+        for (u32 i = 0; i < options.rooms; ++i) {
+            auto room = room_pool->CreateRoom({
+                .name = fmt::format("Benchmark #{}", i + 1),
+                .bind_address = "127.0.0.1",
+                .port = static_cast<u16>(options.port + i),
+                .max_connections = clients_per_room,
+            });
+            if (!room) {
+                fmt::print("Failed to create room on port {}\n", options.port + i);
+                return -1;
+            }
+            rooms.push_back(std::move(room));
+        }
+    }
+
+    std::array<LatencyRecorder, NumTrafficTypes> recorders;
+    const auto record = [&recorders](TrafficType type, u64 timestamp) {
+        recorders[static_cast<std::size_t>(type)].Record(LatencyUs(timestamp));
+    };
+
+    fmt::print("Joining {} clients to {} rooms...\n", options.clients, options.rooms);
+    std::vector<Client> clients(options.clients);
+    for (u32 i = 0; i < options.clients; ++i) {
+        Client& client = clients[i];
+        client.room_index = i % options.rooms;
+        client.member = std::make_unique<Network::RoomMember>();
+        client.proxy_handle = client.member->BindOnProxyPacketReceived(
+            [&record](const Network::ProxyPacket& packet) {
+                record(TrafficType::Proxy, ReadPayloadTimestamp(packet.data));
+            });
+        client.ldn_handle = client.member->BindOnLdnPacketReceived(
+            [&record](const Network::LDNPacket& packet) {
+                record(TrafficType::Ldn, ReadPayloadTimestamp(packet.data));
+            });
+        client.chat_handle = client.member->BindOnChatMessageReceived(
+            [&record](const Network::ChatEntry& entry) {
+                record(TrafficType::Chat, std::strtoull(entry.message.c_str(), nullptr, 10));
+            });
+        client.member->Join(fmt::format("bench-{:05}", i), "127.0.0.1",
+                            static_cast<u16>(options.port + client.room_index));
+    }
+
+    // Wait for the join requests to be answered.
+    const auto join_deadline = Clock::now() + std::chrono::seconds(30);
+    for (Client& client : clients) {
+        while (client.member->GetState() == Network::RoomMember::State::Joining &&
+               Clock::now() < join_deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (!client.member->IsConnected()) {
+            fmt::print("{} failed to join: {}\n", client.member->GetNickname(),
+                       Network::GetStateStr(client.member->GetState()));
+            return -1;
+        }
+        client.fake_ip = client.member->GetFakeIpAddress();
+    }
+
+    std::vector<std::vector<Network::IPv4Address>> room_fake_ips(options.rooms);
+    for (const Client& client : clients) {
+        room_fake_ips[client.room_index].push_back(client.fake_ip);
+    }
+
+    fmt::print("Generating traffic for {} seconds...\n", options.duration_seconds);
+    std::array<u64, NumTrafficTypes> sent{};
+    std::array<u64, NumTrafficTypes> expected{};
+    std::mt19937 random_gen{0};
+    const auto cpu_time_begin = GetProcessCpuTime();
+    const auto begin_time = Clock::now();
+    const auto end_time = begin_time + std::chrono::seconds(options.duration_seconds);
+    auto last_tick = begin_time;
+    while (Clock::now() < end_time) {
+        const auto now = Clock::now();
+        const double elapsed = std::chrono::duration<double>(now - last_tick).count();
+        last_tick = now;
+
+        for (Client& client : clients) {
+            const auto& fake_ips = room_fake_ips[client.room_index];
+            const u64 room_peers = fake_ips.size() - 1;
+            for (std::size_t type = 0; type < NumTrafficTypes; ++type) {
+                client.send_credit[type] += options.rates[type] * elapsed;
+                for (; client.send_credit[type] >= 1.0; client.send_credit[type] -= 1.0) {
+                    switch (static_cast<TrafficType>(type)) {
+                    case TrafficType::Proxy: {
+                        // Unicast to another member of the room
+                        std::uniform_int_distribution<std::size_t> dis(0, fake_ips.size() - 1);
+                        std::size_t index = dis(random_gen);
+                        if (fake_ips[index] == client.fake_ip) {
+                            index = (index + 1) % fake_ips.size();
+                        }
+                        const Network::IPv4Address destination = fake_ips[index];
+                        client.member->SendProxyPacket({
+                            .local_endpoint = {Network::Domain::INET, client.fake_ip, 1024},
+                            .remote_endpoint = {Network::Domain::INET, destination, 1024},
+                            .protocol = Network::Protocol::UDP,
+                            .broadcast = false,
+                            .data = MakePayload(options.payload_size),
+                        });
+                        ++expected[type];
+                        break;
+                    }
+                    case TrafficType::Ldn:
+                        client.member->SendLdnPacket({
+                            .type = Network::LDNPacketType::SyncNetwork,
+                            .local_ip = client.fake_ip,
+                            .remote_ip = Network::NoPreferredIP,
+                            .broadcast = true,
+                            .data = MakePayload(options.payload_size),
+                        });
+                        expected[type] += room_peers;
+                        break;
+                    case TrafficType::Chat:
+                        client.member->SendChatMessage(std::to_string(TimestampNs()));
+                        expected[type] += room_peers;
+                        break;
+                    }
+                    ++sent[type];
+                }
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // Let the packets in flight arrive before measuring.
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    const auto cpu_time = GetProcessCpuTime() - cpu_time_begin;
+    const double wall_seconds = std::chrono::duration<double>(Clock::now() - begin_time).count();
+
+    fmt::print("\n{:<8}{:>12}{:>12}{:>12}{:>14}{:>12}{:>12}\n", "type", "sent", "expected",
+               "received", "received/s", "p50 (us)", "p99 (us)");
+    u64 total_received = 0;
+    for (std::size_t type = 0; type < NumTrafficTypes; ++type) {
+        std::vector<u64> samples = recorders[type].TakeSamples();
+        std::sort(samples.begin(), samples.end());
+        total_received += samples.size();
+        fmt::print("{:<8}{:>12}{:>12}{:>12}{:>14.0f}{:>12}{:>12}\n", TrafficTypeNames[type],
+                   sent[type], expected[type], samples.size(), samples.size() / wall_seconds,
+                   Percentile(samples, 0.5), Percentile(samples, 0.99));
+    }
+
+    Network::RoomStatistics room_totals{};
+    for (const auto& room : rooms) {
+        const Network::RoomStatistics statistics = room->GetStatistics();
+        room_totals.events_handled += statistics.events_handled;
+        room_totals.handling_time_us += statistics.handling_time_us;
+        room_totals.max_handling_time_us =
+            std::max(room_totals.max_handling_time_us, statistics.max_handling_time_us);
+    }
+    fmt::print("\nProcess CPU time: {:.3f} s, {:.2f} us per delivered packet (clients included)\n",
+               cpu_time.count() / 1e6,
+               total_received == 0 ? 0.0 : static_cast<double>(cpu_time.count()) / total_received);
+    fmt::print("Room event handling: {} events, {:.2f} us average, {} us max\n",
+               room_totals.events_handled,
+               room_totals.events_handled == 0
+                   ? 0.0
+                   : static_cast<double>(room_totals.handling_time_us) / room_totals.events_handled,
+               room_totals.max_handling_time_us);
+
+    for (Client& client : clients) {
+        client.member->Unbind(client.proxy_handle);
+        client.member->Unbind(client.ldn_handle);
+        client.member->Unbind(client.chat_handle);
+        client.member->Leave();
+    }
+    clients.clear();
+    if (room_pool) {
+        room_pool->Destroy();
+    }
+    rooms.clear();
+    network.Shutdown();
+    return 0;
+}
@@ -1,13 +1,16 @@
 // SPDX-FileCopyrightText: Copyright 2017 Citra Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <regex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 // windows.h needs to be included before shellapi.h
@@ -24,6 +27,7 @@
 #include "common/fs/path_util.h"
 #include "common/logging/backend.h"
 #include "common/logging/log.h"
+#include "common/polyfill_thread.h"
 #include "common/scm_rev.h"
 #include "common/settings.h"
 #include "common/string_util.h"
@@ -31,6 +35,7 @@
 #include "network/announce_multiplayer_session.h"
 #include "network/network.h"
 #include "network/room.h"
+#include "network/room_pool.h"
 #include "network/verify_user.h"
 
 #ifdef ENABLE_WEB_SERVICE
@@ -61,6 +66,9 @@ static void PrintHelp(const char* argv0) {
              "--ban-list-file     The file for storing the room ban list\n"
              "--log-file          The file for storing the room log\n"
              "--enable-yuzu-mods Allow yuzu Community Moderators to moderate on your room\n"
+             "--room-count        The number of rooms to host, on consecutive ports\n"
+             "--event-threads     The number of threads servicing the rooms\n"
+             "--stats-interval    Seconds between logging the room statistics, 0 to disable\n"
              "-h, --help          Display this help and exit\n"
              "-v, --version       Output version information and exit\n",
              argv0);
@@ -175,6 +183,38 @@ static void SaveBanList(const Network::Room::BanList& ban_list, const std::strin
     }
 }
 
+static void LogRoomStatistics(const Network::Room& room) {
+    const Network::RoomStatistics statistics = room.GetStatistics();
+    const u64 average_handling_time_us =
+        statistics.events_handled == 0 ? 0
+                                       : statistics.handling_time_us / statistics.events_handled;
+    LOG_INFO(Network,
+             "Room {} (port {}): members={} rx={} packets/{} bytes tx={} packets/{} bytes "
+             "events={} handling avg={}us max={}us rtt avg={}ms max={}ms",
+             room.GetRoomInformation().name, room.GetRoomInformation().port,
+             statistics.member_count, statistics.packets_received, statistics.bytes_received,
+             statistics.packets_sent, statistics.bytes_sent, statistics.events_handled,
+             average_handling_time_us, statistics.max_handling_time_us,
+             statistics.average_round_trip_ms, statistics.max_round_trip_ms);
+}
+
+using RoomListFunction = std::function<std::vector<std::shared_ptr<Network::Room>>()>;
+
+/// Logs the statistics of the rooms every interval until stopped.
+static std::jthread StartStatisticsLogger(RoomListFunction get_rooms, u32 interval_seconds) {
+    if (interval_seconds == 0) {
+        return {};
+    }
+    return std::jthread([get_rooms = std::move(get_rooms),
+                         interval = std::chrono::seconds(interval_seconds)](std::stop_token token) {
+        while (!Common::StoppableTimedWait(token, interval)) {
+            for (const auto& room : get_rooms()) {
+                LogRoomStatistics(*room);
+            }
+        }
+    });
+}
+
 static void InitializeLogging(const std::string& log_file) {
     Common::Log::Initialize();
     Common::Log::SetColorConsoleBackendEnabled(true);
@@ -200,6 +240,9 @@ int main(int argc, char** argv) {
     u64 preferred_game_id = 0;
     u32 port = Network::DefaultRoomPort;
     u32 max_members = 16;
+    u32 room_count = 1;
+    u32 event_threads = 0;
+    u32 stats_interval = 0;
     bool enable_yuzu_mods = false;
 
     static struct option long_options[] = {
@@ -217,6 +260,9 @@ int main(int argc, char** argv) {
         {"ban-list-file", required_argument, 0, 'b'},
         {"log-file", required_argument, 0, 'l'},
         {"enable-yuzu-mods", no_argument, 0, 'e'},
+        {"room-count", required_argument, 0, 'c'},
+        {"event-threads", required_argument, 0, 'x'},
+        {"stats-interval", required_argument, 0, 'o'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
         {0, 0, 0, 0},
@@ -225,8 +271,8 @@ int main(int argc, char** argv) {
     InitializeLogging(log_file);
 
     while (optind < argc) {
-        int arg =
-            getopt_long(argc, argv, "n:d:s:p:m:w:g:u:t:a:i:l:hv", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "n:d:s:p:m:w:g:u:t:a:i:l:c:x:o:hv", long_options,
+                              &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'n':
@@ -271,6 +317,15 @@ int main(int argc, char** argv) {
             case 'e':
                 enable_yuzu_mods = true;
                 break;
+            case 'c':
+                room_count = strtoul(optarg, &endarg, 0);
+                break;
+            case 'x':
+                event_threads = strtoul(optarg, &endarg, 0);
+                break;
+            case 'o':
+                stats_interval = strtoul(optarg, &endarg, 0);
+                break;
             case 'h':
                 PrintHelp(argv[0]);
                 return 0;
@@ -310,6 +365,15 @@ int main(int argc, char** argv) {
         PrintHelp(argv[0]);
         return -1;
     }
+    if (room_count < 1 || port + room_count - 1 > UINT16_MAX) {
+        LOG_ERROR(Network, "room-count needs to be at least 1 and the rooms need to fit in the "
+                           "port range 0 - 65535!");
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    if (event_threads == 0) {
+        event_threads = std::min(room_count, std::max(std::thread::hardware_concurrency(), 1U));
+    }
     if (ban_list_file.empty()) {
         LOG_ERROR(Network, "Ban list file not set!\nThis should get set to load and save room ban "
                            "list.\nSet with --ban-list-file <file>");
@@ -365,7 +429,60 @@ int main(int argc, char** argv) {
 
     Network::RoomNetwork network{};
     network.Init();
-    if (auto room = network.GetRoom().lock()) {
+    if (room_count > 1) {
+        // Host every room in this process, serviced by a pool of event loop threads sharing the
+        // ban list and the verification backend.
+        Network::RoomPool room_pool{event_threads, std::move(verify_backend), ban_list};
+        std::vector<std::unique_ptr<Core::AnnounceMultiplayerSession>> announce_sessions;
+        for (u32 i = 0; i < room_count; ++i) {
+            const Network::RoomPool::RoomSettings settings{
+                .name = fmt::format("{} #{}", room_name, i + 1),
+                .description = room_description,
+                .bind_address = bind_address,
+                .port = static_cast<u16>(port + i),
+                .password = password,
+                .max_connections = max_members,
+                .host_username = username,
+                .preferred_game = {.name = preferred_game, .id = preferred_game_id},
+                .enable_yuzu_mods = enable_yuzu_mods,
+            };
+            const auto room = room_pool.CreateRoom(settings);
+            if (!room) {
+                LOG_INFO(Network, "Failed to create room on port {}", settings.port);
+                room_pool.Destroy();
+                network.Shutdown();
+                return -1;
+            }
+            if (announce) {
+                auto& session = announce_sessions.emplace_back(
+                    std::make_unique<Core::AnnounceMultiplayerSession>(room));
+                session->Start();
+            }
+        }
+        LOG_INFO(Network, "{} rooms are open on ports {} - {} with {} event threads. Close with "
+                          "Q+Enter...",
+                 room_count, port, port + room_count - 1, event_threads);
+        std::jthread statistics_logger = StartStatisticsLogger(
+            [&room_pool] { return room_pool.GetRooms(); }, stats_interval);
+        while (true) {
+            std::string in;
+            std::cin >> in;
+            if (in.size() > 0) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        statistics_logger = {};
+        for (auto& session : announce_sessions) {
+            session->Stop();
+        }
+        announce_sessions.clear();
+        // Save the ban list
+        if (!ban_list_file.empty()) {
+            SaveBanList(room_pool.GetBanList(), ban_list_file);
+        }
+        room_pool.Destroy();
+    } else if (auto room = network.GetRoom().lock()) {
         AnnounceMultiplayerRoom::GameInfo preferred_game_info{.name = preferred_game,
                                                               .id = preferred_game_id};
         if (!room->Create(room_name, room_description, bind_address, static_cast<u16>(port),
@@ -379,6 +496,8 @@ int main(int argc, char** argv) {
         if (announce) {
             announce_session->Start();
         }
+        std::jthread statistics_logger = StartStatisticsLogger(
+            [room] { return std::vector<std::shared_ptr<Network::Room>>{room}; }, stats_interval);
         while (room->GetState() == Network::Room::State::Open) {
             std::string in;
             std::cin >> in;
@@ -387,6 +506,7 @@ int main(int argc, char** argv) {
             }
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
+        statistics_logger = {};
         if (announce) {
             announce_session->Stop();
         }
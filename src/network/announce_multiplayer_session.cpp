@@ -19,19 +19,36 @@ namespace Core {
 // Time between room is announced to web_service
 static constexpr std::chrono::seconds announce_time_interval(15);
 
-AnnounceMultiplayerSession::AnnounceMultiplayerSession(Network::RoomNetwork& room_network_)
-    : room_network{room_network_} {
+/// Creates the backend announcing to the web service with the current credentials
+static std::unique_ptr<AnnounceMultiplayerRoom::Backend> MakeBackend() {
 #ifdef ENABLE_WEB_SERVICE
-    backend = std::make_unique<WebService::RoomJson>(Settings::values.web_api_url.GetValue(),
-                                                     Settings::values.yuzu_username.GetValue(),
-                                                     Settings::values.yuzu_token.GetValue());
+    return std::make_unique<WebService::RoomJson>(Settings::values.web_api_url.GetValue(),
+                                                  Settings::values.yuzu_username.GetValue(),
+                                                  Settings::values.yuzu_token.GetValue());
 #else
-    backend = std::make_unique<AnnounceMultiplayerRoom::NullBackend>();
+    return std::make_unique<AnnounceMultiplayerRoom::NullBackend>();
 #endif
 }
 
+AnnounceMultiplayerSession::AnnounceMultiplayerSession(Network::RoomNetwork& room_network_)
+    : room_network{&room_network_} {
+    backend = MakeBackend();
+}
+
+AnnounceMultiplayerSession::AnnounceMultiplayerSession(std::weak_ptr<Network::Room> room_)
+    : announced_room{std::move(room_)} {
+    backend = MakeBackend();
+}
+
+std::shared_ptr<Network::Room> AnnounceMultiplayerSession::GetRoom() const {
+    if (room_network) {
+        return room_network->GetRoom().lock();
+    }
+    return announced_room.lock();
+}
+
 WebService::WebResult AnnounceMultiplayerSession::Register() {
-    auto room = room_network.GetRoom().lock();
+    auto room = GetRoom();
     if (!room) {
         return WebService::WebResult{WebService::WebResult::Code::LibError,
                                      "Network is not initialized", ""};
@@ -120,7 +137,7 @@ void AnnounceMultiplayerSession::AnnounceMultiplayerLoop() {
     std::future<WebService::WebResult> future;
     while (!shutdown_event.WaitUntil(update_time)) {
         update_time += announce_time_interval;
-        auto room = room_network.GetRoom().lock();
+        auto room = GetRoom();
         if (!room) {
             break;
         }
@@ -154,11 +171,7 @@ bool AnnounceMultiplayerSession::IsRunning() const {
 void AnnounceMultiplayerSession::UpdateCredentials() {
     ASSERT_MSG(!IsRunning(), "Credentials can only be updated when session is not running");
 
-#ifdef ENABLE_WEB_SERVICE
-    backend = std::make_unique<WebService::RoomJson>(Settings::values.web_api_url.GetValue(),
-                                                     Settings::values.yuzu_username.GetValue(),
-                                                     Settings::values.yuzu_token.GetValue());
-#endif
+    backend = MakeBackend();
 }
 
 } // namespace Core
@@ -29,6 +29,8 @@ class AnnounceMultiplayerSession {
 public:
     using CallbackHandle = std::shared_ptr<std::function<void(const WebService::WebResult&)>>;
     AnnounceMultiplayerSession(Network::RoomNetwork& room_network_);
+    /// Announces the given room instead of the room of a RoomNetwork.
+    explicit AnnounceMultiplayerSession(std::weak_ptr<Network::Room> room_);
     ~AnnounceMultiplayerSession();
 
     /**
@@ -79,6 +81,7 @@ public:
     void UpdateCredentials();
 
 private:
+    std::shared_ptr<Network::Room> GetRoom() const;
     void UpdateBackendData(std::shared_ptr<Network::Room> room);
     void AnnounceMultiplayerLoop();
 
@@ -92,7 +95,8 @@ private:
 
     std::atomic_bool registered = false; ///< Whether the room has been registered
 
-    Network::RoomNetwork& room_network;
+    Network::RoomNetwork* room_network = nullptr; ///< Network of the room, if announcing its room
+    std::weak_ptr<Network::Room> announced_room;  ///< Room announced when there is no network
 };
 
 } // namespace Core
@@ -3,13 +3,20 @@
 
 #include <algorithm>
 #include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
 #include <iomanip>
 #include <mutex>
 #include <random>
 #include <regex>
 #include <shared_mutex>
 #include <sstream>
+#include <string_view>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include "common/assert.h"
 #include "common/logging/log.h"
 #include "enet/enet.h"
 #include "network/packet.h"
@@ -18,6 +25,38 @@
 
 namespace Network {
 
+/// Maximum number of events a room handles before the other rooms of its thread get serviced.
+constexpr u32 MaxEventsPerService = 256;
+
+/// Interval between samples of the round trip times of the members.
+constexpr std::chrono::seconds LatencySampleInterval{1};
+
+/// Offsets of the destination in a proxy packet, after the message type, the domain, IP and port
+/// of the local endpoint and the domain of the remote endpoint.
+constexpr std::size_t ProxyPacketRemoteIPOffset = 9;
+/// Offset of the broadcast flag, after the remote IP and port and the protocol.
+constexpr std::size_t ProxyPacketBroadcastOffset = 16;
+
+/// Offsets of the destination in a LDN packet, after the message type, LAN packet type and the
+/// local IP.
+constexpr std::size_t LdnPacketRemoteIPOffset = 6;
+constexpr std::size_t LdnPacketBroadcastOffset = 10;
+
+/**
+ * Reads the destination of a proxy or LDN packet in place, without copying the packet.
+ * @return False if the packet is too short to contain the destination.
+ */
+static bool ReadForwardDestination(const ENetPacket* packet, std::size_t remote_ip_offset,
+                                   std::size_t broadcast_offset, IPv4Address& remote_ip,
+                                   bool& broadcast) {
+    if (packet->dataLength <= broadcast_offset) {
+        return false;
+    }
+    std::memcpy(remote_ip.data(), packet->data + remote_ip_offset, remote_ip.size());
+    broadcast = packet->data[broadcast_offset] != 0;
+    return true;
+}
+
 class Room::RoomImpl {
 public:
     std::mt19937 random_gen; ///< Random number generator. Used for GenerateFakeIPAddress
@@ -40,26 +79,140 @@ public:
         VerifyUser::UserData user_data;
         ENetPeer* peer; ///< The remote peer.
     };
-    using MemberList = std::vector<Member>;
-    MemberList members;                     ///< Information about the members of this room
-    mutable std::shared_mutex member_mutex; ///< Mutex for locking the members list
 
-    UsernameBanList username_ban_list; ///< List of banned usernames
-    IPBanList ip_ban_list;             ///< List of banned IP addresses
-    mutable std::mutex ban_list_mutex; ///< Mutex for the ban lists
+    /**
+     * Members of the room in join order, indexed by peer, fake IP and nickname. The indexes refer
+     * to the members stored in the list, so a list is never copied, moved or modified once built.
+     */
+    class MemberList {
+    public:
+        MemberList() = default;
+        explicit MemberList(std::vector<Member> members_);
+
+        MemberList(const MemberList&) = delete;
+        MemberList& operator=(const MemberList&) = delete;
+        MemberList(MemberList&&) = delete;
+        MemberList& operator=(MemberList&&) = delete;
+
+        /// Builds a new list from a copy of the members changed by the given function.
+        template <typename Func>
+        std::shared_ptr<const MemberList> WithChanges(Func&& modify) const {
+            std::vector<Member> new_members = members;
+            modify(new_members);
+            return std::make_shared<const MemberList>(std::move(new_members));
+        }
+
+        const Member* FindByPeer(const ENetPeer* peer) const;
+        const Member* FindByFakeIP(const IPv4Address& fake_ip) const;
+        const Member* FindByNickname(std::string_view nickname) const;
+
+        std::vector<Member>::const_iterator begin() const {
+            return members.begin();
+        }
+        std::vector<Member>::const_iterator end() const {
+            return members.end();
+        }
+        std::size_t size() const {
+            return members.size();
+        }
+        bool empty() const {
+            return members.empty();
+        }
+
+    private:
+        std::vector<Member> members;
+        std::unordered_map<const ENetPeer*, std::size_t> peer_index;
+        std::unordered_map<u32, std::size_t> fake_ip_index;
+        std::unordered_map<std::string_view, std::size_t> nickname_index;
+    };
+
+    /// Information about the members of this room. A published list is never modified, so readers
+    /// such as the broadcast fan-out iterate it without holding any lock.
+    std::shared_ptr<const MemberList> members = std::make_shared<const MemberList>();
+    mutable std::mutex member_mutex; ///< Mutex for swapping the members list, not for reading it
+
+    /// Gets the current members list.
+    std::shared_ptr<const MemberList> GetMembers() const {
+        std::lock_guard lock(member_mutex);
+        return members;
+    }
+
+    /**
+     * Publishes a modified copy of the members list. Only the thread servicing the room modifies
+     * the members, so modifications never race with each other.
+     */
+    template <typename Func>
+    void ModifyMembers(Func&& modify) {
+        auto new_list = GetMembers()->WithChanges(std::forward<Func>(modify));
+        std::lock_guard lock(member_mutex);
+        members = std::move(new_list);
+    }
+
+    /// Removes the member with the given peer, if any.
+    void RemoveMember(const ENetPeer* peer);
+
+    /// Banned usernames and IP addresses, possibly shared with other rooms
+    std::shared_ptr<RoomBanList> ban_list = std::make_shared<RoomBanList>();
+
+    /// Counters of the room, only written by the thread servicing it.
+    struct Statistics {
+        std::atomic<u64> packets_received{};
+        std::atomic<u64> packets_sent{};
+        std::atomic<u64> bytes_received{};
+        std::atomic<u64> bytes_sent{};
+        std::atomic<u64> events_handled{};
+        std::atomic<u64> handling_time_us{};
+        std::atomic<u64> max_handling_time_us{};
+        std::atomic<u32> member_count{};
+        std::atomic<u32> average_round_trip_ms{};
+        std::atomic<u32> max_round_trip_ms{};
+
+        void Reset() {
+            for (auto* counter : {&packets_received, &packets_sent, &bytes_received, &bytes_sent,
+                                  &events_handled, &handling_time_us, &max_handling_time_us}) {
+                counter->store(0, std::memory_order_relaxed);
+            }
+            member_count.store(0, std::memory_order_relaxed);
+            average_round_trip_ms.store(0, std::memory_order_relaxed);
+            max_round_trip_ms.store(0, std::memory_order_relaxed);
+        }
+    };
+    Statistics statistics;
+    std::chrono::steady_clock::time_point next_latency_sample{};
 
     RoomImpl() : random_gen(std::random_device()()) {}
 
     /// Thread that receives and dispatches network packets
     std::unique_ptr<std::thread> room_thread;
 
-    /// Verification backend of the room
-    std::unique_ptr<VerifyUser::Backend> verify_backend;
+    /// Whether the room is serviced by the threads of a RoomPool instead of room_thread
+    bool attached_to_pool = false;
+
+    /// Verification backend of the room, possibly shared with other rooms
+    std::shared_ptr<VerifyUser::Backend> verify_backend;
 
     /// Thread function that will receive and dispatch messages until the room is destroyed.
     void ServerLoop();
     void StartLoop();
 
+    /// Dispatches a received network event to its handler.
+    void HandleEvent(const ENetEvent& event);
+
+    /**
+     * Handles the pending network events without blocking.
+     * @return Whether events were left pending after handling MaxEventsPerService of them.
+     */
+    bool ServiceEvents();
+
+    /// Collects the traffic counters of the ENet host and samples the member round trip times.
+    void UpdateStatistics();
+
+    /// Whether forwarded packets are waiting for the flush at the end of the service iteration
+    bool flush_pending = false;
+
+    /// Sends the forwarded packets queued during this service iteration at once.
+    void FlushForwardedPackets();
+
     /**
      * Parses and answers a room join request from a client.
      * Validates the uniqueness of the username and assigns the MAC address
@@ -205,6 +358,14 @@ public:
      */
     IPv4Address GenerateFakeIPAddress();
 
+    /**
+     * Forwards the received packet itself to the member with the given fake IP, or to all members
+     * except the sender. The packet is sent when the service iteration ends.
+     * @param event The ENet event containing the data
+     */
+    void ForwardPacket(const ENetEvent* event, const IPv4Address& destination_address,
+                       bool broadcast);
+
     /**
      * Broadcasts this packet to all members except the sender.
      * @param event The ENet event containing the data
@@ -241,64 +402,172 @@ void Room::RoomImpl::ServerLoop() {
     while (state != State::Closed) {
         ENetEvent event;
         if (enet_host_service(server, &event, 5) > 0) {
-            switch (event.type) {
-            case ENET_EVENT_TYPE_RECEIVE:
-                switch (event.packet->data[0]) {
-                case IdJoinRequest:
-                    HandleJoinRequest(&event);
-                    break;
-                case IdSetGameInfo:
-                    HandleGameInfoPacket(&event);
-                    break;
-                case IdProxyPacket:
-                    HandleProxyPacket(&event);
-                    break;
-                case IdLdnPacket:
-                    HandleLdnPacket(&event);
-                    break;
-                case IdChatMessage:
-                    HandleChatPacket(&event);
-                    break;
-                // Moderation
-                case IdModKick:
-                    HandleModKickPacket(&event);
-                    break;
-                case IdModBan:
-                    HandleModBanPacket(&event);
-                    break;
-                case IdModUnban:
-                    HandleModUnbanPacket(&event);
-                    break;
-                case IdModGetBanList:
-                    HandleModGetBanListPacket(&event);
-                    break;
-                }
-                enet_packet_destroy(event.packet);
-                break;
-            case ENET_EVENT_TYPE_DISCONNECT:
-                HandleClientDisconnection(event.peer);
-                break;
-            case ENET_EVENT_TYPE_NONE:
-            case ENET_EVENT_TYPE_CONNECT:
-                break;
-            }
+            HandleEvent(event);
         }
+        // Handle the rest of the burst, then send everything it forwarded at once.
+        ServiceEvents();
     }
     // Close the connection to all members:
     SendCloseMessage();
 }
 
+void Room::RoomImpl::HandleEvent(const ENetEvent& event) {
+    const auto start_time = std::chrono::steady_clock::now();
+    switch (event.type) {
+    case ENET_EVENT_TYPE_RECEIVE:
+        switch (event.packet->data[0]) {
+        case IdJoinRequest:
+            HandleJoinRequest(&event);
+            break;
+        case IdSetGameInfo:
+            HandleGameInfoPacket(&event);
+            break;
+        case IdProxyPacket:
+            HandleProxyPacket(&event);
+            break;
+        case IdLdnPacket:
+            HandleLdnPacket(&event);
+            break;
+        case IdChatMessage:
+            HandleChatPacket(&event);
+            break;
+        // Moderation
+        case IdModKick:
+            HandleModKickPacket(&event);
+            break;
+        case IdModBan:
+            HandleModBanPacket(&event);
+            break;
+        case IdModUnban:
+            HandleModUnbanPacket(&event);
+            break;
+        case IdModGetBanList:
+            HandleModGetBanListPacket(&event);
+            break;
+        }
+        // Forwarded packets are referenced by their destinations, ENet destroys them once sent.
+        if (event.packet->referenceCount == 0) {
+            enet_packet_destroy(event.packet);
+        }
+        break;
+    case ENET_EVENT_TYPE_DISCONNECT:
+        HandleClientDisconnection(event.peer);
+        break;
+    case ENET_EVENT_TYPE_NONE:
+    case ENET_EVENT_TYPE_CONNECT:
+        break;
+    }
+
+    const u64 elapsed_us = static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                std::chrono::steady_clock::now() - start_time)
+                                                .count());
+    statistics.events_handled.fetch_add(1, std::memory_order_relaxed);
+    statistics.handling_time_us.fetch_add(elapsed_us, std::memory_order_relaxed);
+    if (elapsed_us > statistics.max_handling_time_us.load(std::memory_order_relaxed)) {
+        statistics.max_handling_time_us.store(elapsed_us, std::memory_order_relaxed);
+    }
+}
+
+bool Room::RoomImpl::ServiceEvents() {
+    bool events_pending = true;
+    for (u32 i = 0; i < MaxEventsPerService; ++i) {
+        ENetEvent event;
+        if (enet_host_service(server, &event, 0) <= 0) {
+            events_pending = false;
+            break;
+        }
+        HandleEvent(event);
+    }
+    FlushForwardedPackets();
+    UpdateStatistics();
+    return events_pending;
+}
+
+void Room::RoomImpl::FlushForwardedPackets() {
+    if (flush_pending) {
+        enet_host_flush(server);
+        flush_pending = false;
+    }
+}
+
+void Room::RoomImpl::UpdateStatistics() {
+    // ENet leaves resetting its 32-bit counters before they overflow to the user.
+    statistics.packets_received.fetch_add(server->totalReceivedPackets, std::memory_order_relaxed);
+    statistics.packets_sent.fetch_add(server->totalSentPackets, std::memory_order_relaxed);
+    statistics.bytes_received.fetch_add(server->totalReceivedData, std::memory_order_relaxed);
+    statistics.bytes_sent.fetch_add(server->totalSentData, std::memory_order_relaxed);
+    server->totalReceivedPackets = 0;
+    server->totalSentPackets = 0;
+    server->totalReceivedData = 0;
+    server->totalSentData = 0;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now < next_latency_sample) {
+        return;
+    }
+    next_latency_sample = now + LatencySampleInterval;
+
+    u64 total_round_trip_ms = 0;
+    u32 max_round_trip_ms = 0;
+    u32 member_count = 0;
+    {
+        const auto member_list = GetMembers();
+        for (const auto& member : *member_list) {
+            total_round_trip_ms += member.peer->roundTripTime;
+            max_round_trip_ms = std::max<u32>(max_round_trip_ms, member.peer->roundTripTime);
+        }
+        member_count = static_cast<u32>(member_list->size());
+    }
+    statistics.member_count.store(member_count, std::memory_order_relaxed);
+    statistics.average_round_trip_ms.store(
+        member_count == 0 ? 0 : static_cast<u32>(total_round_trip_ms / member_count),
+        std::memory_order_relaxed);
+    statistics.max_round_trip_ms.store(max_round_trip_ms, std::memory_order_relaxed);
+}
+
 void Room::RoomImpl::StartLoop() {
     room_thread = std::make_unique<std::thread>(&Room::RoomImpl::ServerLoop, this);
 }
 
+Room::RoomImpl::MemberList::MemberList(std::vector<Member> members_)
+    : members{std::move(members_)} {
+    peer_index.reserve(members.size());
+    fake_ip_index.reserve(members.size());
+    nickname_index.reserve(members.size());
+    for (std::size_t i = 0; i < members.size(); ++i) {
+        peer_index.emplace(members[i].peer, i);
+        fake_ip_index.emplace(std::bit_cast<u32>(members[i].fake_ip), i);
+        nickname_index.emplace(members[i].nickname, i);
+    }
+}
+
+auto Room::RoomImpl::MemberList::FindByPeer(const ENetPeer* peer) const -> const Member* {
+    const auto it = peer_index.find(peer);
+    return it != peer_index.end() ? &members[it->second] : nullptr;
+}
+
+auto Room::RoomImpl::MemberList::FindByFakeIP(const IPv4Address& fake_ip) const
+    -> const Member* {
+    const auto it = fake_ip_index.find(std::bit_cast<u32>(fake_ip));
+    return it != fake_ip_index.end() ? &members[it->second] : nullptr;
+}
+
+auto Room::RoomImpl::MemberList::FindByNickname(std::string_view nickname) const
+    -> const Member* {
+    const auto it = nickname_index.find(nickname);
+    return it != nickname_index.end() ? &members[it->second] : nullptr;
+}
+
+void Room::RoomImpl::RemoveMember(const ENetPeer* peer) {
+    ModifyMembers([peer](std::vector<Member>& member_list) {
+        std::erase_if(member_list, [peer](const Member& member) { return member.peer == peer; });
+    });
+}
+
 void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
-    {
-        std::lock_guard lock(member_mutex);
-        if (members.size() >= room_information.member_slots) {
-            SendRoomIsFull(event->peer);
-            return;
-        }
+    if (GetMembers()->size() >= room_information.member_slots) {
+        SendRoomIsFull(event->peer);
+        return;
     }
     Packet packet;
     packet.Append(event->packet->data, event->packet->dataLength);
@@ -357,37 +626,28 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
     }
     member.user_data = verify_backend->LoadUserData(uid, token);
 
-    std::string ip;
-    {
-        std::lock_guard lock(ban_list_mutex);
-
-        // Check username ban
-        if (!member.user_data.username.empty() &&
-            std::find(username_ban_list.begin(), username_ban_list.end(),
-                      member.user_data.username) != username_ban_list.end()) {
-
-            SendUserBanned(event->peer);
-            return;
-        }
+    // Check username ban
+    if (!member.user_data.username.empty() &&
+        ban_list->IsUsernameBanned(member.user_data.username)) {
+        SendUserBanned(event->peer);
+        return;
+    }
 
-        // Check IP ban
-        std::array<char, 256> ip_raw{};
-        enet_address_get_host_ip(&event->peer->address, ip_raw.data(), sizeof(ip_raw) - 1);
-        ip = ip_raw.data();
+    // Check IP ban
+    std::array<char, 256> ip_raw{};
+    enet_address_get_host_ip(&event->peer->address, ip_raw.data(), sizeof(ip_raw) - 1);
+    const std::string ip = ip_raw.data();
 
-        if (std::find(ip_ban_list.begin(), ip_ban_list.end(), ip) != ip_ban_list.end()) {
-            SendUserBanned(event->peer);
-            return;
-        }
+    if (ban_list->IsIPBanned(ip)) {
+        SendUserBanned(event->peer);
+        return;
     }
 
     // Notify everyone that the user has joined.
     SendStatusMessage(IdMemberJoin, member.nickname, member.user_data.username, ip);
 
-    {
-        std::lock_guard lock(member_mutex);
-        members.push_back(std::move(member));
-    }
+    ModifyMembers(
+        [&member](std::vector<Member>& member_list) { member_list.push_back(std::move(member)); });
 
     // Notify everyone that the room information has changed.
     BroadcastRoomInformation();
@@ -413,11 +673,9 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
 
     std::string username, ip;
     {
-        std::lock_guard lock(member_mutex);
-        const auto target_member =
-            std::find_if(members.begin(), members.end(),
-                         [&nickname](const auto& member) { return member.nickname == nickname; });
-        if (target_member == members.end()) {
+        const auto member_list = GetMembers();
+        const Member* const target_member = member_list->FindByNickname(nickname);
+        if (!target_member) {
             SendModNoSuchUser(event->peer);
             return;
         }
@@ -432,7 +690,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
         ip = ip_raw.data();
 
         enet_peer_disconnect(target_member->peer, 0);
-        members.erase(target_member);
+        RemoveMember(target_member->peer);
     }
 
     // Announce the change to all clients.
@@ -455,11 +713,9 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
 
     std::string username, ip;
     {
-        std::lock_guard lock(member_mutex);
-        const auto target_member =
-            std::find_if(members.begin(), members.end(),
-                         [&nickname](const auto& member) { return member.nickname == nickname; });
-        if (target_member == members.end()) {
+        const auto member_list = GetMembers();
+        const Member* const target_member = member_list->FindByNickname(nickname);
+        if (!target_member) {
             SendModNoSuchUser(event->peer);
             return;
         }
@@ -475,26 +731,11 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
         ip = ip_raw.data();
 
         enet_peer_disconnect(target_member->peer, 0);
-        members.erase(target_member);
+        RemoveMember(target_member->peer);
     }
 
-    {
-        std::lock_guard lock(ban_list_mutex);
-
-        if (!username.empty()) {
-            // Ban the forum username
-            if (std::find(username_ban_list.begin(), username_ban_list.end(), username) ==
-                username_ban_list.end()) {
-
-                username_ban_list.emplace_back(username);
-            }
-        }
-
-        // Ban the member's IP as well
-        if (std::find(ip_ban_list.begin(), ip_ban_list.end(), ip) == ip_ban_list.end()) {
-            ip_ban_list.emplace_back(ip);
-        }
-    }
+    // Ban the forum username and the member's IP
+    ban_list->Ban(username, ip);
 
     // Announce the change to all clients.
     SendStatusMessage(IdMemberBanned, nickname, username, ip);
@@ -514,24 +755,7 @@ void Room::RoomImpl::HandleModUnbanPacket(const ENetEvent* event) {
     std::string address;
     packet.Read(address);
 
-    bool unbanned = false;
-    {
-        std::lock_guard lock(ban_list_mutex);
-
-        auto it = std::find(username_ban_list.begin(), username_ban_list.end(), address);
-        if (it != username_ban_list.end()) {
-            unbanned = true;
-            username_ban_list.erase(it);
-        }
-
-        it = std::find(ip_ban_list.begin(), ip_ban_list.end(), address);
-        if (it != ip_ban_list.end()) {
-            unbanned = true;
-            ip_ban_list.erase(it);
-        }
-    }
-
-    if (unbanned) {
+    if (ban_list->Unban(address)) {
         SendStatusMessage(IdAddressUnbanned, address, "", "");
     } else {
         SendModNoSuchUser(event->peer);
@@ -550,28 +774,22 @@ void Room::RoomImpl::HandleModGetBanListPacket(const ENetEvent* event) {
 bool Room::RoomImpl::IsValidNickname(const std::string& nickname) const {
     // A nickname is valid if it matches the regex and is not already taken by anybody else in the
     // room.
-    const std::regex nickname_regex("^[ a-zA-Z0-9._-]{4,20}$");
+    static const std::regex nickname_regex("^[ a-zA-Z0-9._-]{4,20}$");
     if (!std::regex_match(nickname, nickname_regex))
         return false;
 
-    std::lock_guard lock(member_mutex);
-    return std::all_of(members.begin(), members.end(),
-                       [&nickname](const auto& member) { return member.nickname != nickname; });
+    return GetMembers()->FindByNickname(nickname) == nullptr;
 }
 
 bool Room::RoomImpl::IsValidFakeIPAddress(const IPv4Address& address) const {
     // An IP address is valid if it is not already taken by anybody else in the room.
-    std::lock_guard lock(member_mutex);
-    return std::all_of(members.begin(), members.end(),
-                       [&address](const auto& member) { return member.fake_ip != address; });
+    return GetMembers()->FindByFakeIP(address) == nullptr;
 }
 
 bool Room::RoomImpl::HasModPermission(const ENetPeer* client) const {
-    std::lock_guard lock(member_mutex);
-    const auto sending_member =
-        std::find_if(members.begin(), members.end(),
-                     [client](const auto& member) { return member.peer == client; });
-    if (sending_member == members.end()) {
+    const auto member_list = GetMembers();
+    const Member* const sending_member = member_list->FindByPeer(client);
+    if (!sending_member) {
         return false;
     }
     if (room_information.enable_yuzu_mods &&
@@ -701,11 +919,9 @@ void Room::RoomImpl::SendModNoSuchUser(ENetPeer* client) {
 void Room::RoomImpl::SendModBanListResponse(ENetPeer* client) {
     Packet packet;
     packet.Write(static_cast<u8>(IdModBanListResponse));
-    {
-        std::lock_guard lock(ban_list_mutex);
-        packet.Write(username_ban_list);
-        packet.Write(ip_ban_list);
-    }
+    const BanList bans = ban_list->Get();
+    packet.Write(bans.first);
+    packet.Write(bans.second);
 
     ENetPacket* enet_packet =
         enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
@@ -716,16 +932,16 @@ void Room::RoomImpl::SendModBanListResponse(ENetPeer* client) {
 void Room::RoomImpl::SendCloseMessage() {
     Packet packet;
     packet.Write(static_cast<u8>(IdCloseRoom));
-    std::lock_guard lock(member_mutex);
-    if (!members.empty()) {
+    const auto member_list = GetMembers();
+    if (!member_list->empty()) {
         ENetPacket* enet_packet =
             enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-        for (auto& member : members) {
+        for (const auto& member : *member_list) {
             enet_peer_send(member.peer, 0, enet_packet);
         }
     }
     enet_host_flush(server);
-    for (auto& member : members) {
+    for (const auto& member : *member_list) {
         enet_peer_disconnect(member.peer, 0);
     }
 }
@@ -737,11 +953,11 @@ void Room::RoomImpl::SendStatusMessage(StatusMessageTypes type, const std::strin
     packet.Write(static_cast<u8>(type));
     packet.Write(nickname);
     packet.Write(username);
-    std::lock_guard lock(member_mutex);
-    if (!members.empty()) {
+    const auto member_list = GetMembers();
+    if (!member_list->empty()) {
         ENetPacket* enet_packet =
             enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
-        for (auto& member : members) {
+        for (const auto& member : *member_list) {
             enet_peer_send(member.peer, 0, enet_packet);
         }
     }
@@ -779,19 +995,17 @@ void Room::RoomImpl::BroadcastRoomInformation() {
     packet.Write(room_information.preferred_game.name);
     packet.Write(room_information.host_username);
 
-    packet.Write(static_cast<u32>(members.size()));
-    {
-        std::lock_guard lock(member_mutex);
-        for (const auto& member : members) {
-            packet.Write(member.nickname);
-            packet.Write(member.fake_ip);
-            packet.Write(member.game_info.name);
-            packet.Write(member.game_info.id);
-            packet.Write(member.game_info.version);
-            packet.Write(member.user_data.username);
-            packet.Write(member.user_data.display_name);
-            packet.Write(member.user_data.avatar_url);
-        }
+    const auto member_list = GetMembers();
+    packet.Write(static_cast<u32>(member_list->size()));
+    for (const auto& member : *member_list) {
+        packet.Write(member.nickname);
+        packet.Write(member.fake_ip);
+        packet.Write(member.game_info.name);
+        packet.Write(member.game_info.id);
+        packet.Write(member.game_info.version);
+        packet.Write(member.user_data.username);
+        packet.Write(member.user_data.display_name);
+        packet.Write(member.user_data.avatar_url);
     }
 
     ENetPacket* enet_packet =
@@ -812,51 +1026,22 @@ IPv4Address Room::RoomImpl::GenerateFakeIPAddress() {
     return result_ip;
 }
 
-void Room::RoomImpl::HandleProxyPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-    in_packet.IgnoreBytes(sizeof(u8)); // Message type
-
-    in_packet.IgnoreBytes(sizeof(u8));          // Domain
-    in_packet.IgnoreBytes(sizeof(IPv4Address)); // IP
-    in_packet.IgnoreBytes(sizeof(u16));         // Port
-
-    in_packet.IgnoreBytes(sizeof(u8)); // Domain
-    IPv4Address remote_ip;
-    in_packet.Read(remote_ip);          // IP
-    in_packet.IgnoreBytes(sizeof(u16)); // Port
-
-    in_packet.IgnoreBytes(sizeof(u8)); // Protocol
-
-    bool broadcast;
-    in_packet.Read(broadcast); // Broadcast
-
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+void Room::RoomImpl::ForwardPacket(const ENetEvent* event,
+                                   const IPv4Address& destination_address, bool broadcast) {
+    // Send the received packet itself, ENet counts the references of its destinations. Forwarded
+    // packets have always been reliable, regardless of how they were received.
+    ENetPacket* enet_packet = event->packet;
+    enet_packet->flags = ENET_PACKET_FLAG_RELIABLE;
 
-    const auto& destination_address = remote_ip;
+    const auto member_list = GetMembers();
     if (broadcast) { // Send the data to everyone except the sender
-        std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
-        for (const auto& member : members) {
+        for (const auto& member : *member_list) {
             if (member.peer != event->peer) {
-                sent_packet = true;
                 enet_peer_send(member.peer, 0, enet_packet);
             }
         }
-
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
     } else { // Send the data only to the destination client
-        std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member_entry) -> bool {
-                                       return member_entry.fake_ip == destination_address;
-                                   });
-        if (member != members.end()) {
+        if (const Member* member = member_list->FindByFakeIP(destination_address)) {
             enet_peer_send(member->peer, 0, enet_packet);
         } else {
             LOG_ERROR(Network,
@@ -864,64 +1049,29 @@ void Room::RoomImpl::HandleProxyPacket(const ENetEvent* event) {
                       "{}.{}.{}.{}",
                       destination_address[0], destination_address[1], destination_address[2],
                       destination_address[3]);
-            enet_packet_destroy(enet_packet);
         }
     }
-    enet_host_flush(server);
+    flush_pending = true;
 }
 
-void Room::RoomImpl::HandleLdnPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-
-    in_packet.IgnoreBytes(sizeof(u8)); // Message type
-
-    in_packet.IgnoreBytes(sizeof(u8));          // LAN packet type
-    in_packet.IgnoreBytes(sizeof(IPv4Address)); // Local IP
-
+void Room::RoomImpl::HandleProxyPacket(const ENetEvent* event) {
     IPv4Address remote_ip;
-    in_packet.Read(remote_ip); // Remote IP
-
     bool broadcast;
-    in_packet.Read(broadcast); // Broadcast
-
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
-
-    const auto& destination_address = remote_ip;
-    if (broadcast) { // Send the data to everyone except the sender
-        std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
-        for (const auto& member : members) {
-            if (member.peer != event->peer) {
-                sent_packet = true;
-                enet_peer_send(member.peer, 0, enet_packet);
-            }
-        }
+    if (!ReadForwardDestination(event->packet, ProxyPacketRemoteIPOffset,
+                                ProxyPacketBroadcastOffset, remote_ip, broadcast)) {
+        return;
+    }
+    ForwardPacket(event, remote_ip, broadcast);
+}
 
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
-    } else {
-        std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member_entry) -> bool {
-                                       return member_entry.fake_ip == destination_address;
-                                   });
-        if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
-        } else {
-            LOG_ERROR(Network,
-                      "Attempting to send to unknown IP address: "
-                      "{}.{}.{}.{}",
-                      destination_address[0], destination_address[1], destination_address[2],
-                      destination_address[3]);
-            enet_packet_destroy(enet_packet);
-        }
+void Room::RoomImpl::HandleLdnPacket(const ENetEvent* event) {
+    IPv4Address remote_ip;
+    bool broadcast;
+    if (!ReadForwardDestination(event->packet, LdnPacketRemoteIPOffset, LdnPacketBroadcastOffset,
+                                remote_ip, broadcast)) {
+        return;
     }
-    enet_host_flush(server);
+    ForwardPacket(event, remote_ip, broadcast);
 }
 
 void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
@@ -931,13 +1081,10 @@ void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
     in_packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     std::string message;
     in_packet.Read(message);
-    auto CompareNetworkAddress = [event](const Member member) -> bool {
-        return member.peer == event->peer;
-    };
 
-    std::lock_guard lock(member_mutex);
-    const auto sending_member = std::find_if(members.begin(), members.end(), CompareNetworkAddress);
-    if (sending_member == members.end()) {
+    const auto member_list = GetMembers();
+    const Member* const sending_member = member_list->FindByPeer(event->peer);
+    if (!sending_member) {
         return; // Received a chat message from a unknown sender
     }
 
@@ -953,7 +1100,7 @@ void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
     ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
                                                  ENET_PACKET_FLAG_RELIABLE);
     bool sent_packet = false;
-    for (const auto& member : members) {
+    for (const auto& member : *member_list) {
         if (member.peer != event->peer) {
             sent_packet = true;
             enet_peer_send(member.peer, 0, enet_packet);
@@ -985,13 +1132,16 @@ void Room::RoomImpl::HandleGameInfoPacket(const ENetEvent* event) {
     in_packet.Read(game_info.version);
 
     {
-        std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [event](const Member& member_entry) -> bool {
-                                       return member_entry.peer == event->peer;
-                                   });
-        if (member != members.end()) {
-            member->game_info = game_info;
+        const auto member_list = GetMembers();
+        const Member* const member = member_list->FindByPeer(event->peer);
+        if (member) {
+            ModifyMembers([event, &game_info](std::vector<Member>& new_member_list) {
+                for (auto& member_entry : new_member_list) {
+                    if (member_entry.peer == event->peer) {
+                        member_entry.game_info = game_info;
+                    }
+                }
+            });
 
             const std::string display_name =
                 member->user_data.username.empty()
@@ -1013,12 +1163,8 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
     // Remove the client from the members list.
     std::string nickname, username, ip;
     {
-        std::lock_guard lock(member_mutex);
-        auto member =
-            std::find_if(members.begin(), members.end(), [client](const Member& member_entry) {
-                return member_entry.peer == client;
-            });
-        if (member != members.end()) {
+        const auto member_list = GetMembers();
+        if (const Member* member = member_list->FindByPeer(client)) {
             nickname = member->nickname;
             username = member->user_data.username;
 
@@ -1026,7 +1172,7 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
             enet_address_get_host_ip(&member->peer->address, ip_raw.data(), sizeof(ip_raw) - 1);
             ip = ip_raw.data();
 
-            members.erase(member);
+            RemoveMember(client);
         }
     }
 
@@ -1037,6 +1183,53 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
     BroadcastRoomInformation();
 }
 
+// RoomBanList
+RoomBanList::RoomBanList(Room::BanList ban_list)
+    : username_ban_list{std::move(ban_list.first)}, ip_ban_list{std::move(ban_list.second)},
+      banned_usernames(username_ban_list.begin(), username_ban_list.end()),
+      banned_ips(ip_ban_list.begin(), ip_ban_list.end()) {}
+
+bool RoomBanList::IsUsernameBanned(const std::string& username) const {
+    std::shared_lock lock(mutex);
+    return banned_usernames.contains(username);
+}
+
+bool RoomBanList::IsIPBanned(const std::string& ip) const {
+    std::shared_lock lock(mutex);
+    return banned_ips.contains(ip);
+}
+
+void RoomBanList::Ban(const std::string& username, const std::string& ip) {
+    std::lock_guard lock(mutex);
+    if (!username.empty() && banned_usernames.insert(username).second) {
+        username_ban_list.emplace_back(username);
+    }
+    if (banned_ips.insert(ip).second) {
+        ip_ban_list.emplace_back(ip);
+    }
+}
+
+bool RoomBanList::Unban(const std::string& address) {
+    std::lock_guard lock(mutex);
+    bool unbanned = false;
+
+    if (banned_usernames.erase(address) != 0) {
+        unbanned = true;
+        std::erase(username_ban_list, address);
+    }
+
+    if (banned_ips.erase(address) != 0) {
+        unbanned = true;
+        std::erase(ip_ban_list, address);
+    }
+    return unbanned;
+}
+
+Room::BanList RoomBanList::Get() const {
+    std::shared_lock lock(mutex);
+    return {username_ban_list, ip_ban_list};
+}
+
 // Room
 Room::Room() : room_impl{std::make_unique<RoomImpl>()} {}
 
@@ -1046,7 +1239,7 @@ bool Room::Create(const std::string& name, const std::string& description,
                   const std::string& server_address, u16 server_port, const std::string& password,
                   const u32 max_connections, const std::string& host_username,
                   const GameInfo preferred_game,
-                  std::unique_ptr<VerifyUser::Backend> verify_backend,
+                  std::shared_ptr<VerifyUser::Backend> verify_backend,
                   const Room::BanList& ban_list, bool enable_yuzu_mods) {
     ENetAddress address;
     address.host = ENET_HOST_ANY;
@@ -1066,19 +1259,59 @@ bool Room::Create(const std::string& name, const std::string& description,
     room_impl->room_information.name = name;
     room_impl->room_information.description = description;
     room_impl->room_information.member_slots = max_connections;
-    room_impl->room_information.port = server_port;
+    // The host reads back its address, which holds the port picked when server_port is 0
+    room_impl->room_information.port = room_impl->server->address.port;
     room_impl->room_information.preferred_game = preferred_game;
     room_impl->room_information.host_username = host_username;
     room_impl->room_information.enable_yuzu_mods = enable_yuzu_mods;
     room_impl->password = password;
     room_impl->verify_backend = std::move(verify_backend);
-    room_impl->username_ban_list = ban_list.first;
-    room_impl->ip_ban_list = ban_list.second;
+    room_impl->statistics.Reset();
+    if (room_impl->attached_to_pool) {
+        // The RoomPool services the room with its own threads and ban list.
+        return true;
+    }
+    room_impl->ban_list = std::make_shared<RoomBanList>(ban_list);
 
     room_impl->StartLoop();
     return true;
 }
 
+void Room::AttachToPool(std::shared_ptr<RoomBanList> shared_ban_list) {
+    room_impl->attached_to_pool = true;
+    room_impl->ban_list = std::move(shared_ban_list);
+}
+
+bool Room::ServiceRooms(std::span<Room* const> rooms, u32 timeout_ms) {
+    ENetSocketSet socket_set;
+    ENET_SOCKETSET_EMPTY(socket_set);
+    ENetSocket max_socket{};
+    bool has_open_room = false;
+    for (const Room* room : rooms) {
+        if (room->room_impl->state == State::Closed) {
+            continue;
+        }
+        const ENetSocket socket = room->room_impl->server->socket;
+        ENET_SOCKETSET_ADD(socket_set, socket);
+        max_socket = std::max(max_socket, socket);
+        has_open_room = true;
+    }
+    if (!has_open_room) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+        return false;
+    }
+    // Service every room even if the wait timed out, ENet sends its pings and resends from there.
+    enet_socketset_select(max_socket, &socket_set, nullptr, timeout_ms);
+
+    bool events_pending = false;
+    for (Room* room : rooms) {
+        if (room->room_impl->state != State::Closed) {
+            events_pending |= room->room_impl->ServiceEvents();
+        }
+    }
+    return events_pending;
+}
+
 Room::State Room::GetState() const {
     return room_impl->state;
 }
@@ -1093,14 +1326,29 @@ std::string Room::GetVerifyUID() const {
 }
 
 Room::BanList Room::GetBanList() const {
-    std::lock_guard lock(room_impl->ban_list_mutex);
-    return {room_impl->username_ban_list, room_impl->ip_ban_list};
+    return room_impl->ban_list->Get();
+}
+
+RoomStatistics Room::GetStatistics() const {
+    const auto& statistics = room_impl->statistics;
+    return {
+        .packets_received = statistics.packets_received.load(std::memory_order_relaxed),
+        .packets_sent = statistics.packets_sent.load(std::memory_order_relaxed),
+        .bytes_received = statistics.bytes_received.load(std::memory_order_relaxed),
+        .bytes_sent = statistics.bytes_sent.load(std::memory_order_relaxed),
+        .events_handled = statistics.events_handled.load(std::memory_order_relaxed),
+        .handling_time_us = statistics.handling_time_us.load(std::memory_order_relaxed),
+        .max_handling_time_us = statistics.max_handling_time_us.load(std::memory_order_relaxed),
+        .member_count = statistics.member_count.load(std::memory_order_relaxed),
+        .average_round_trip_ms = statistics.average_round_trip_ms.load(std::memory_order_relaxed),
+        .max_round_trip_ms = statistics.max_round_trip_ms.load(std::memory_order_relaxed),
+    };
 }
 
 std::vector<Member> Room::GetRoomMemberList() const {
     std::vector<Member> member_list;
-    std::lock_guard lock(room_impl->member_mutex);
-    for (const auto& member_impl : room_impl->members) {
+    const auto room_members = room_impl->GetMembers();
+    for (const auto& member_impl : *room_members) {
         Member member;
         member.nickname = member_impl.nickname;
         member.username = member_impl.user_data.username;
@@ -1123,9 +1371,19 @@ void Room::SetVerifyUID(const std::string& uid) {
 }
 
 void Room::Destroy() {
+    ASSERT_MSG(!room_impl->attached_to_pool, "Rooms of a RoomPool are destroyed by the pool");
+    Close();
+}
+
+void Room::Close() {
     room_impl->state = State::Closed;
-    room_impl->room_thread->join();
-    room_impl->room_thread.reset();
+    if (room_impl->room_thread) {
+        room_impl->room_thread->join();
+        room_impl->room_thread.reset();
+    } else if (room_impl->server) {
+        // The RoomPool has stopped servicing the room, close the connections from here.
+        room_impl->SendCloseMessage();
+    }
 
     if (room_impl->server) {
         enet_host_destroy(room_impl->server);
@@ -1134,7 +1392,7 @@ void Room::Destroy() {
     room_impl->server = nullptr;
     {
         std::lock_guard lock(room_impl->member_mutex);
-        room_impl->members.clear();
+        room_impl->members = std::make_shared<const RoomImpl::MemberList>();
     }
     room_impl->room_information.member_slots = 0;
     room_impl->room_information.name.clear();
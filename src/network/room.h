@@ -5,7 +5,10 @@
 
 #include <array>
 #include <memory>
+#include <shared_mutex>
+#include <span>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include "common/announce_multiplayer_room.h"
 #include "common/common_types.h"
@@ -72,6 +75,23 @@ enum StatusMessageTypes : u8 {
     IdAddressUnbanned, ///< A username / ip address is unbanned from the room
 };
 
+/// Traffic and latency counters of a room, accumulated since the room was last created.
+struct RoomStatistics {
+    u64 packets_received{};
+    u64 packets_sent{};
+    u64 bytes_received{};
+    u64 bytes_sent{};
+    u64 events_handled{};
+    u64 handling_time_us{};      ///< Total time spent handling events, in microseconds
+    u64 max_handling_time_us{};  ///< Longest time spent handling a single event, in microseconds
+    u32 member_count{};          ///< Number of members at the last latency sample
+    u32 average_round_trip_ms{}; ///< Average round trip time to the members, in milliseconds
+    u32 max_round_trip_ms{};     ///< Highest round trip time to a member, in milliseconds
+};
+
+class RoomBanList;
+class RoomPool;
+
 /// This is what a server [person creating a server] would use.
 class Room final {
 public:
@@ -115,14 +135,14 @@ public:
 
     /**
      * Creates the socket for this room. Will bind to default address if
-     * server is empty string.
+     * server is empty string, and to a port picked by the system if server_port is 0.
      */
     bool Create(const std::string& name, const std::string& description = "",
                 const std::string& server = "", u16 server_port = DefaultRoomPort,
                 const std::string& password = "",
                 const u32 max_connections = MaxConcurrentConnections,
                 const std::string& host_username = "", const GameInfo = {},
-                std::unique_ptr<VerifyUser::Backend> verify_backend = nullptr,
+                std::shared_ptr<VerifyUser::Backend> verify_backend = nullptr,
                 const BanList& ban_list = {}, bool enable_yuzu_mods = false);
 
     /**
@@ -136,13 +156,69 @@ public:
     BanList GetBanList() const;
 
     /**
-     * Destroys the socket
+     * Gets the packet and latency counters of the room.
+     */
+    RoomStatistics GetStatistics() const;
+
+    /**
+     * Destroys the socket. Rooms of a RoomPool are destroyed by RoomPool::DestroyRoom instead, as
+     * its event loop threads may be servicing them.
      */
     void Destroy();
 
 private:
+    friend class RoomPool;
+
+    /// Closes the connections and destroys the socket, once no thread is servicing the room.
+    void Close();
+
+    /**
+     * Leaves servicing the room to the event loop threads of a RoomPool instead of a thread of its
+     * own, and makes it use the ban list shared by the pool. Must be called before Create.
+     */
+    void AttachToPool(std::shared_ptr<RoomBanList> shared_ban_list);
+
+    /**
+     * Waits up to timeout_ms for network events on any of the given rooms, then handles the
+     * pending events of every open room.
+     * @return Whether a room was left with pending events, in which case it should not wait.
+     */
+    static bool ServiceRooms(std::span<Room* const> rooms, u32 timeout_ms);
+
     class RoomImpl;
     std::unique_ptr<RoomImpl> room_impl;
 };
 
+/**
+ * Thread-safe list of banned forum usernames and IP addresses, which may be shared by rooms.
+ * Lookups are hashed and only take a shared lock, as they happen on every join.
+ */
+class RoomBanList {
+public:
+    RoomBanList() = default;
+    explicit RoomBanList(Room::BanList ban_list);
+
+    /// Returns whether the given forum username is banned.
+    bool IsUsernameBanned(const std::string& username) const;
+
+    /// Returns whether the given IP address is banned.
+    bool IsIPBanned(const std::string& ip) const;
+
+    /// Bans the IP address, and the forum username if it is not empty.
+    void Ban(const std::string& username, const std::string& ip);
+
+    /// Removes a forum username or IP address from the list, returns false if it was not banned.
+    bool Unban(const std::string& address);
+
+    /// Gets a copy of the ban list.
+    Room::BanList Get() const;
+
+private:
+    mutable std::shared_mutex mutex;
+    Room::UsernameBanList username_ban_list; ///< Banned usernames, in the order they were banned
+    Room::IPBanList ip_ban_list;             ///< Banned IP addresses, in the order they were banned
+    std::unordered_set<std::string> banned_usernames; ///< Index of username_ban_list
+    std::unordered_set<std::string> banned_ips;       ///< Index of ip_ban_list
+};
+
 } // namespace Network
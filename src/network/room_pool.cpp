@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include "common/thread.h"
+#include "network/room_pool.h"
+
+namespace Network {
+
+/// Time an event loop waits for network events, the same as a room servicing itself.
+constexpr u32 EventLoopTimeoutMs = 5;
+
+RoomPool::RoomPool(size_t num_threads, std::shared_ptr<VerifyUser::Backend> verify_backend_,
+                   Room::BanList ban_list_)
+    : verify_backend{std::move(verify_backend_)},
+      ban_list{std::make_shared<RoomBanList>(std::move(ban_list_))} {
+    num_threads = std::max<size_t>(num_threads, 1);
+    event_loops.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        auto& event_loop = event_loops.emplace_back(std::make_unique<EventLoop>());
+        event_loop->thread = std::jthread(
+            [&event_loop = *event_loop](std::stop_token stop_token) {
+                RunEventLoop(stop_token, event_loop);
+            });
+    }
+}
+
+RoomPool::~RoomPool() {
+    Destroy();
+}
+
+std::shared_ptr<Room> RoomPool::CreateRoom(const RoomSettings& settings) {
+    auto room = std::make_shared<Room>();
+    room->AttachToPool(ban_list);
+    if (!room->Create(settings.name, settings.description, settings.bind_address, settings.port,
+                      settings.password, settings.max_connections, settings.host_username,
+                      settings.preferred_game, verify_backend, {}, settings.enable_yuzu_mods)) {
+        return nullptr;
+    }
+
+    std::scoped_lock lock{rooms_mutex};
+    if (event_loops.empty()) {
+        // The pool has been destroyed
+        room->Close();
+        return nullptr;
+    }
+    rooms.push_back(room);
+
+    const auto event_loop = std::ranges::min_element(
+        event_loops, {}, [](const auto& loop) { return loop->rooms.size(); });
+    {
+        std::scoped_lock loop_lock{(*event_loop)->mutex};
+        (*event_loop)->rooms.push_back(room);
+    }
+    (*event_loop)->rooms_changed = true;
+    return room;
+}
+
+std::vector<std::shared_ptr<Room>> RoomPool::GetRooms() const {
+    std::scoped_lock lock{rooms_mutex};
+    return rooms;
+}
+
+Room::BanList RoomPool::GetBanList() const {
+    return ban_list->Get();
+}
+
+void RoomPool::DestroyRoom(const std::shared_ptr<Room>& room) {
+    std::scoped_lock lock{rooms_mutex};
+    const auto it = std::ranges::find(rooms, room);
+    if (it == rooms.end()) {
+        return;
+    }
+    rooms.erase(it);
+
+    for (auto& event_loop : event_loops) {
+        std::unique_lock loop_lock{event_loop->mutex};
+        if (std::erase(event_loop->rooms, room) == 0) {
+            continue;
+        }
+        // The thread may still be servicing the room, wait until it picks up the new rooms.
+        const u64 generation = event_loop->rooms_generation;
+        event_loop->rooms_changed = true;
+        event_loop->rooms_picked_up.wait(
+            loop_lock, [&] { return event_loop->rooms_generation != generation; });
+        break;
+    }
+    if (room->GetState() == Room::State::Open) {
+        room->Close();
+    }
+}
+
+void RoomPool::Destroy() {
+    std::scoped_lock lock{rooms_mutex};
+    // Stop every event loop first, so no thread is servicing a room while it is destroyed.
+    for (auto& event_loop : event_loops) {
+        event_loop->thread.request_stop();
+    }
+    event_loops.clear();
+
+    for (auto& room : rooms) {
+        if (room->GetState() == Room::State::Open) {
+            room->Close();
+        }
+    }
+    rooms.clear();
+}
+
+void RoomPool::RunEventLoop(std::stop_token stop_token, EventLoop& event_loop) {
+    Common::SetCurrentThreadName("RoomEventLoop");
+
+    std::vector<Room*> loop_rooms;
+    bool events_pending = false;
+    while (!stop_token.stop_requested()) {
+        if (event_loop.rooms_changed.exchange(false)) {
+            {
+                std::scoped_lock lock{event_loop.mutex};
+                loop_rooms.clear();
+                for (const auto& room : event_loop.rooms) {
+                    loop_rooms.push_back(room.get());
+                }
+                ++event_loop.rooms_generation;
+            }
+            event_loop.rooms_picked_up.notify_all();
+        }
+        events_pending = Room::ServiceRooms(loop_rooms, events_pending ? 0 : EventLoopTimeoutMs);
+    }
+}
+
+} // namespace Network
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+#include "common/polyfill_thread.h"
+#include "network/room.h"
+#include "network/verify_user.h"
+
+namespace Network {
+
+/**
+ * Hosts several rooms in one process. Every room has its own ENet host, and the rooms are
+ * serviced by a fixed number of event loop threads. The rooms share one ban list and one
+ * verification backend.
+ */
+class RoomPool final {
+public:
+    struct RoomSettings {
+        std::string name;
+        std::string description;
+        std::string bind_address; ///< Binds to the default address if empty
+        u16 port = DefaultRoomPort;
+        std::string password;
+        u32 max_connections = MaxConcurrentConnections;
+        std::string host_username;
+        GameInfo preferred_game;
+        bool enable_yuzu_mods = false;
+    };
+
+    /**
+     * Starts the event loop threads of the pool.
+     * @param num_threads Number of event loop threads, at least one is started.
+     * @param verify_backend Verification backend shared by the rooms, must be thread-safe.
+     * @param ban_list Initial ban list shared by the rooms.
+     */
+    RoomPool(size_t num_threads, std::shared_ptr<VerifyUser::Backend> verify_backend,
+             Room::BanList ban_list = {});
+    ~RoomPool();
+
+    RoomPool(const RoomPool&) = delete;
+    RoomPool& operator=(const RoomPool&) = delete;
+
+    /**
+     * Creates a room and hands it to the event loop thread with the fewest rooms.
+     * @return The room, or nullptr if its socket could not be created.
+     */
+    std::shared_ptr<Room> CreateRoom(const RoomSettings& settings);
+
+    /// Gets the rooms of the pool, in the order they were created.
+    std::vector<std::shared_ptr<Room>> GetRooms() const;
+
+    /// Gets the ban list shared by the rooms.
+    Room::BanList GetBanList() const;
+
+    /**
+     * Closes a room of the pool. Waits until its event loop thread has stopped servicing it, which
+     * takes up to one event loop iteration.
+     */
+    void DestroyRoom(const std::shared_ptr<Room>& room);
+
+    /// Stops the event loop threads and closes every room.
+    void Destroy();
+
+private:
+    struct EventLoop {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<Room>> rooms;
+        std::atomic_bool rooms_changed{};
+        u64 rooms_generation{}; ///< Counts the times the thread picked up the rooms, under mutex
+        std::condition_variable rooms_picked_up;
+        std::jthread thread;
+    };
+
+    /// Thread function that services the rooms of an event loop until the pool is destroyed.
+    static void RunEventLoop(std::stop_token stop_token, EventLoop& event_loop);
+
+    std::shared_ptr<VerifyUser::Backend> verify_backend;
+    std::shared_ptr<RoomBanList> ban_list;
+
+    mutable std::mutex rooms_mutex;
+    std::vector<std::shared_ptr<Room>> rooms;
+    std::vector<std::unique_ptr<EventLoop>> event_loops;
+};
+
+} // namespace Network
@@ -0,0 +1,360 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+#include "common/common_types.h"
+#include "common/fs/path_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "common/thread_worker.h"
+#include "shader_recompiler/exception.h"
+#include "shader_recompiler/host_translate_info.h"
+#include "shader_recompiler/profile.h"
+#include "video_core/renderer_vulkan/vk_pipeline_cache.h"
+#include "video_core/shader_environment.h"
+#include "video_core/shader_translation_cache.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using VideoCommon::FileEnvironment;
+using VideoCommon::TranslatedShader;
+
+struct CompilerOptions {
+    std::filesystem::path pipeline_cache;
+    std::filesystem::path profile;
+    std::filesystem::path output;
+    u32 threads = 0;
+    u32 top = 10;
+    bool populate_cache = true;
+    bool verbose = false;
+};
+
+/// Outcome of translating the shaders of one pipeline
+struct PipelineResult {
+    u64 hash{};
+    bool is_compute{};
+    bool failed{};
+    u32 num_stages{};
+    u64 code_bytes{};
+    u64 info_descriptors{};
+    std::chrono::nanoseconds time{};
+    std::string error;
+};
+
+/// Baseline used when the cache directory has no profile, close to a desktop driver
+void MakeBaselineProfile(Shader::Profile& profile, Shader::HostTranslateInfo& host_info) {
+    profile = Shader::Profile{
+        .supported_spirv = 0x00010400,
+        .unified_descriptor_binding = true,
+        .support_descriptor_aliasing = true,
+        .support_int8 = true,
+        .support_int16 = true,
+        .support_int64 = true,
+        .support_vertex_instance_id = false,
+        .support_float_controls = true,
+        .support_vote = true,
+        .support_typeless_image_loads = true,
+        .support_demote_to_helper_invocation = true,
+        .support_int64_atomics = true,
+        .support_derivative_control = true,
+        .support_scaled_attributes = true,
+        .support_multi_viewport = true,
+        .min_ssbo_alignment = 16,
+        .max_user_clip_distances = 8,
+    };
+    host_info = Shader::HostTranslateInfo{
+        .support_float64 = true,
+        .support_float16 = true,
+        .support_int64 = true,
+        .support_snorm_render_buffer = true,
+        .min_ssbo_alignment = 16,
+    };
+}
+
+u64 CountDescriptors(const Shader::Info& info) {
+    return info.constant_buffer_descriptors.size() + info.storage_buffers_descriptors.size() +
+           info.texture_buffer_descriptors.size() + info.image_buffer_descriptors.size() +
+           info.texture_descriptors.size() + info.image_descriptors.size();
+}
+
+void Summarize(PipelineResult& result, std::span<const TranslatedShader> shaders) {
+    result.num_stages = static_cast<u32>(shaders.size());
+    for (const TranslatedShader& shader : shaders) {
+        result.code_bytes += shader.code.size() * sizeof(u32);
+        result.info_descriptors += CountDescriptors(shader.info);
+    }
+}
+
+double ToMilliseconds(std::chrono::nanoseconds time) {
+    return std::chrono::duration<double, std::milli>(time).count();
+}
+
+void PrintResult(const PipelineResult& result) {
+    if (result.failed) {
+        fmt::print("{:016x} {:<8} failed: {}\n", result.hash,
+                   result.is_compute ? "compute" : "graphics", result.error);
+        return;
+    }
+    fmt::print("{:016x} {:<8} {} stages {:>10.3f} ms {:>10} bytes {:>4} descriptors\n",
+               result.hash, result.is_compute ? "compute" : "graphics", result.num_stages,
+               ToMilliseconds(result.time), result.code_bytes, result.info_descriptors);
+}
+
+void PrintReport(std::vector<PipelineResult>& results, std::chrono::nanoseconds wall_time,
+                 const CompilerOptions& options) {
+    std::ranges::sort(results, std::ranges::greater{}, &PipelineResult::time);
+    if (options.verbose) {
+        for (const PipelineResult& result : results) {
+            PrintResult(result);
+        }
+    } else if (options.top > 0) {
+        fmt::print("Slowest pipelines:\n");
+        for (size_t i = 0; i < std::min<size_t>(options.top, results.size()); ++i) {
+            PrintResult(results[i]);
+        }
+    }
+
+    size_t num_failed = 0;
+    size_t num_compute = 0;
+    size_t num_stages = 0;
+    u64 code_bytes = 0;
+    std::chrono::nanoseconds cpu_time{};
+    for (const PipelineResult& result : results) {
+        num_failed += result.failed ? 1 : 0;
+        num_compute += result.is_compute ? 1 : 0;
+        num_stages += result.num_stages;
+        code_bytes += result.code_bytes;
+        cpu_time += result.time;
+    }
+    const size_t num_translated = results.size() - num_failed;
+    const double wall_seconds = std::chrono::duration<double>(wall_time).count();
+    fmt::print("\n{} pipelines ({} graphics, {} compute), {} failed\n", results.size(),
+               results.size() - num_compute, num_compute, num_failed);
+    fmt::print("{} shader stages, {:.1f} KiB of SPIR-V ({:.1f} KiB per stage)\n", num_stages,
+               code_bytes / 1024.0, num_stages == 0 ? 0.0 : code_bytes / 1024.0 / num_stages);
+    fmt::print("Translation time: {:.3f} s wall, {:.3f} s across threads, {:.3f} ms per pipeline\n",
+               wall_seconds, ToMilliseconds(cpu_time) / 1000.0,
+               num_translated == 0 ? 0.0 : ToMilliseconds(cpu_time) / num_translated);
+    if (wall_seconds > 0.0) {
+        fmt::print("Throughput: {:.1f} pipelines per second\n", results.size() / wall_seconds);
+    }
+}
+
+void PrintHelp(const char* argv0) {
+    fmt::print("Usage: {} [options] <vulkan.bin>\n"
+               "Translates the pipelines of a Vulkan pipeline cache without a GPU.\n\n"
+               "-p, --profile     Translation profile written by the emulator\n"
+               "                  (default: vulkan_translation_profile.bin next to the cache)\n"
+               "-o, --output      Translation cache to populate\n"
+               "                  (default: vulkan_translated.bin next to the cache)\n"
+               "-n, --no-output   Only measure, do not populate a translation cache\n"
+               "-j, --threads     Number of translation threads (default: all cores)\n"
+               "-t, --top         Number of slowest pipelines to list (default 10)\n"
+               "-V, --verbose     List every pipeline and show the recompiler log\n"
+               "-h, --help        Display this help and exit\n"
+               "-v, --version     Output version information and exit\n",
+               argv0);
+}
+
+} // Anonymous namespace
+
+/// Offline shader cache compiler, replays a pipeline cache through the shader recompiler.
+int main(int argc, char** argv) {
+    CompilerOptions options;
+    int option_index = 0;
+    char* endarg;
+
+    static struct option long_options[] = {
+        {"profile", required_argument, 0, 'p'},
+        {"output", required_argument, 0, 'o'},
+        {"no-output", no_argument, 0, 'n'},
+        {"threads", required_argument, 0, 'j'},
+        {"top", required_argument, 0, 't'},
+        {"verbose", no_argument, 0, 'V'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "p:o:nj:t:Vhv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'p':
+                options.profile = Common::FS::ToU8String(optarg);
+                break;
+            case 'o':
+                options.output = Common::FS::ToU8String(optarg);
+                break;
+            case 'n':
+                options.populate_cache = false;
+                break;
+            case 'j':
+                options.threads = strtoul(optarg, &endarg, 0);
+                break;
+            case 't':
+                options.top = strtoul(optarg, &endarg, 0);
+                break;
+            case 'V':
+                options.verbose = true;
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                fmt::print("yuzu shader cache compiler {} {}\n", Common::g_scm_branch,
+                           Common::g_scm_desc);
+                return 0;
+            }
+        } else {
+            options.pipeline_cache = Common::FS::ToU8String(argv[optind]);
+            ++optind;
+        }
+    }
+
+    if (options.pipeline_cache.empty()) {
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    const std::filesystem::path cache_dir = options.pipeline_cache.parent_path();
+    if (options.profile.empty()) {
+        options.profile = cache_dir / "vulkan_translation_profile.bin";
+    }
+    if (options.output.empty()) {
+        options.output = cache_dir / "vulkan_translated.bin";
+    }
+    if (options.threads == 0) {
+        options.threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    // LoadPipelines deletes incompatible caches, the input of the tool has to be left alone.
+    if (!VideoCommon::IsPipelineCacheCompatible(options.pipeline_cache,
+                                                Vulkan::PIPELINE_CACHE_VERSION)) {
+        fmt::print("{} is not a Vulkan pipeline cache of version {}\n",
+                   Common::FS::PathToUTF8String(options.pipeline_cache),
+                   Vulkan::PIPELINE_CACHE_VERSION);
+        return -1;
+    }
+
+    Common::Log::Initialize();
+    Common::Log::Filter filter;
+    filter.ParseFilterString(options.verbose ? "*:Info" : "*:Error");
+    Common::Log::SetGlobalFilter(filter);
+    Common::Log::SetColorConsoleBackendEnabled(true);
+    Common::Log::Start();
+
+    Shader::Profile profile;
+    Shader::HostTranslateInfo host_info;
+    if (!VideoCommon::LoadTranslationProfile(options.profile, profile, host_info)) {
+        // Entries translated with a made up profile would never be looked up by the emulator.
+        fmt::print("No usable profile at {}, translating with a baseline profile only to measure\n",
+                   Common::FS::PathToUTF8String(options.profile));
+        MakeBaselineProfile(profile, host_info);
+        options.populate_cache = false;
+    }
+
+    std::unique_ptr<VideoCommon::ShaderTranslationCache> translation_cache;
+    if (options.populate_cache) {
+        translation_cache = std::make_unique<VideoCommon::ShaderTranslationCache>(
+            options.output, Vulkan::PIPELINE_CACHE_VERSION,
+            VideoCommon::HashTranslationProfile(profile, host_info));
+    }
+
+    std::mutex results_mutex;
+    std::vector<PipelineResult> results;
+    const auto translate{[&](PipelineResult result, auto&& func) {
+        const auto start{Clock::now()};
+        try {
+            Summarize(result, func());
+        } catch (const Shader::Exception& exception) {
+            result.failed = true;
+            result.error = exception.what();
+        }
+        result.time = Clock::now() - start;
+        std::scoped_lock lock{results_mutex};
+        results.push_back(std::move(result));
+    }};
+
+    Common::StatefulThreadWorker<Vulkan::ShaderPools> workers(
+        options.threads, "ShaderCompiler", [] { return Vulkan::ShaderPools{}; });
+    const auto load_compute{[&](std::ifstream& file, FileEnvironment env) {
+        Vulkan::ComputePipelineCacheKey key;
+        file.read(reinterpret_cast<char*>(&key), sizeof(key));
+
+        workers.QueueWork([&, key, env_ = std::move(env)](Vulkan::ShaderPools* pools) mutable {
+            const u64 hash = key.Hash();
+            translate(PipelineResult{.hash = hash, .is_compute = true}, [&] {
+                pools->ReleaseContents();
+                const std::array<TranslatedShader, 1> shaders{
+                    Vulkan::TranslateComputePipeline(*pools, key, env_, profile, host_info)};
+                if (translation_cache) {
+                    const std::array<Shader::Environment* const, 1> envs{&env_};
+                    translation_cache->Store(hash, VideoCommon::HashEnvironments(envs), shaders);
+                }
+                return std::vector<TranslatedShader>(shaders.begin(), shaders.end());
+            });
+        });
+    }};
+    const auto load_graphics{[&](std::ifstream& file, std::vector<FileEnvironment> envs) {
+        Vulkan::GraphicsPipelineCacheKey key;
+        file.read(reinterpret_cast<char*>(&key), sizeof(key));
+
+        workers.QueueWork([&, key, envs_ = std::move(envs)](Vulkan::ShaderPools* pools) mutable {
+            const u64 hash = key.Hash();
+            translate(PipelineResult{.hash = hash}, [&] {
+                std::vector<Shader::Environment*> env_ptrs;
+                for (auto& env : envs_) {
+                    env_ptrs.push_back(&env);
+                }
+                pools->ReleaseContents();
+                std::vector<TranslatedShader> shaders{
+                    Vulkan::TranslateGraphicsPipeline(*pools, key, env_ptrs, profile, host_info)};
+                if (translation_cache) {
+                    translation_cache->Store(hash, VideoCommon::HashEnvironments(env_ptrs),
+                                             shaders);
+                }
+                return shaders;
+            });
+        });
+    }};
+
+    fmt::print("Translating {} on {} threads\n",
+               Common::FS::PathToUTF8String(options.pipeline_cache), options.threads);
+    const auto start{Clock::now()};
+    VideoCommon::LoadPipelines({}, options.pipeline_cache, Vulkan::PIPELINE_CACHE_VERSION,
+                               load_compute, load_graphics);
+    workers.WaitForRequests();
+    const auto wall_time{Clock::now() - start};
+
+    if (results.empty()) {
+        fmt::print("The pipeline cache is empty\n");
+        return -1;
+    }
+    PrintReport(results, wall_time, options);
+    if (translation_cache) {
+        translation_cache->ReportStatistics();
+        translation_cache.reset();
+        fmt::print("Translation cache written to {}\n",
+                   Common::FS::PathToUTF8String(options.output));
+    }
+    return 0;
+}
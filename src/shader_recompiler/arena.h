@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace Shader {
+
+/**
+ * Monotonic memory resource backing the IR of the shader being translated.
+ * Memory is only reclaimed by Reset, which keeps the blocks around so the next shader translated
+ * by the same worker does not go through the general purpose heap.
+ */
+class Arena final : public std::pmr::memory_resource {
+public:
+    Arena() = default;
+    explicit Arena(size_t block_size_) : block_size{block_size_} {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /// Releases every allocation, squashing the blocks into one large enough for all of them
+    void Reset() noexcept {
+        if (blocks.size() > 1) {
+            size_t total_size{};
+            for (const Block& block : blocks) {
+                total_size += block.size;
+            }
+            blocks.clear();
+            blocks.push_back(NewBlock(total_size));
+        }
+        current_block = 0;
+        offset = 0;
+        bytes_allocated = 0;
+    }
+
+    /// Bytes handed out since the last reset
+    [[nodiscard]] size_t BytesAllocated() const noexcept {
+        return bytes_allocated;
+    }
+
+    /// Memory resource for the IR built on this thread, the heap when no arena is active
+    [[nodiscard]] static std::pmr::memory_resource* Current() noexcept {
+        return current ? current : std::pmr::new_delete_resource();
+    }
+
+private:
+    friend class ArenaScope;
+
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        size_t size;
+    };
+
+    /// Blocks are left uninitialized, the IR constructs its objects in place
+    static Block NewBlock(size_t size) {
+        return Block{std::make_unique_for_overwrite<std::byte[]>(size), size};
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        bytes_allocated += bytes;
+        while (current_block < blocks.size()) {
+            Block& block{blocks[current_block]};
+            void* pointer{block.memory.get() + offset};
+            size_t space{block.size - offset};
+            if (std::align(alignment, bytes, pointer, space)) {
+                offset = block.size - space + bytes;
+                return pointer;
+            }
+            ++current_block;
+            offset = 0;
+        }
+        const size_t size{std::max(block_size, bytes + alignment)};
+        Block& block{blocks.emplace_back(NewBlock(size))};
+        current_block = blocks.size() - 1;
+        void* pointer{block.memory.get()};
+        size_t space{size};
+        std::align(alignment, bytes, pointer, space);
+        offset = size - space + bytes;
+        return pointer;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    static inline thread_local Arena* current{};
+
+    std::vector<Block> blocks;
+    size_t current_block{};
+    size_t offset{};
+    size_t bytes_allocated{};
+    size_t block_size{256 * 1024};
+};
+
+/// Makes an arena the memory resource of the IR built on the calling thread while in scope
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena) noexcept : previous{std::exchange(Arena::current, &arena)} {}
+
+    ~ArenaScope() {
+        Arena::current = previous;
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    Arena* previous;
+};
+
+} // namespace Shader
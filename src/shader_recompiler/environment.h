@@ -41,6 +41,9 @@ public:
     [[nodiscard]] virtual std::optional<ReplaceConstant> GetReplaceConstBuffer(u32 bank,
                                                                                u32 offset) = 0;
 
+    /// Hash of the state queried from the environment so far, besides the program code
+    [[nodiscard]] virtual u64 CalculateStateHash() const = 0;
+
     virtual void Dump(u64 pipeline_hash, u64 shader_hash) = 0;
 
     [[nodiscard]] const ProgramHeader& SPH() const noexcept {
@@ -3,7 +3,9 @@
 
 #include <algorithm>
 #include <memory>
+#include <memory_resource>
 
+#include "shader_recompiler/arena.h"
 #include "shader_recompiler/exception.h"
 #include "shader_recompiler/frontend/ir/basic_block.h"
 #include "shader_recompiler/frontend/ir/type.h"
@@ -31,16 +33,17 @@ void RemovePseudoInstruction(IR::Inst*& inst, IR::Opcode expected_opcode) {
     inst = nullptr;
 }
 
-void AllocAssociatedInsts(std::unique_ptr<AssociatedInsts>& associated_insts) {
+void AllocAssociatedInsts(AssociatedInsts*& associated_insts) {
     if (!associated_insts) {
-        associated_insts = std::make_unique<AssociatedInsts>();
+        std::pmr::polymorphic_allocator<AssociatedInsts> allocator{Arena::Current()};
+        associated_insts = allocator.new_object<AssociatedInsts>();
     }
 }
 } // Anonymous namespace
 
 Inst::Inst(IR::Opcode op_, u32 flags_) noexcept : op{op_}, flags{flags_} {
     if (op == Opcode::Phi) {
-        std::construct_at(&phi_args);
+        std::construct_at(&phi_args, Arena::Current());
     } else {
         std::construct_at(&args);
     }
@@ -386,7 +389,7 @@ void Inst::Use(const Value& value) {
     Inst* const inst{value.Inst()};
     ++inst->use_count;
 
-    std::unique_ptr<AssociatedInsts>& assoc_inst{inst->associated_insts};
+    AssociatedInsts*& assoc_inst{inst->associated_insts};
     switch (op) {
     case Opcode::GetZeroFromOp:
         AllocAssociatedInsts(assoc_inst);
@@ -421,7 +424,7 @@ void Inst::UndoUse(const Value& value) {
     Inst* const inst{value.Inst()};
     --inst->use_count;
 
-    std::unique_ptr<AssociatedInsts>& assoc_inst{inst->associated_insts};
+    AssociatedInsts*& assoc_inst{inst->associated_insts};
     switch (op) {
     case Opcode::GetZeroFromOp:
         AllocAssociatedInsts(assoc_inst);
@@ -6,6 +6,7 @@
 #include <array>
 #include <cstring>
 #include <memory>
+#include <memory_resource>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -241,10 +242,10 @@ private:
     u32 definition{};
     union {
         NonTriviallyDummy dummy{};
-        boost::container::small_vector<std::pair<Block*, Value>, 2> phi_args;
+        std::pmr::vector<std::pair<Block*, Value>> phi_args;
         std::array<Value, 5> args;
     };
-    std::unique_ptr<AssociatedInsts> associated_insts;
+    AssociatedInsts* associated_insts{}; ///< Allocated from the arena of the instruction
 };
 static_assert(sizeof(Inst) <= 128, "Inst size unintentionally increased");
 
@@ -15,11 +15,14 @@
 
 #include <deque>
 #include <map>
+#include <memory_resource>
 #include <span>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#include "shader_recompiler/arena.h"
 #include "shader_recompiler/frontend/ir/basic_block.h"
 #include "shader_recompiler/frontend/ir/opcodes.h"
 #include "shader_recompiler/frontend/ir/pred.h"
@@ -52,9 +55,20 @@ struct IndirectBranchVariable {
 
 using Variant = std::variant<IR::Reg, IR::Pred, ZeroFlagTag, SignFlagTag, CarryFlagTag,
                              OverflowFlagTag, GotoVariable, IndirectBranchVariable>;
-using ValueMap = std::unordered_map<IR::Block*, IR::Value>;
+using ValueMap = std::pmr::unordered_map<IR::Block*, IR::Value>;
+
+template <size_t... indices>
+std::array<ValueMap, sizeof...(indices)> MakeValueMaps(std::pmr::memory_resource* resource,
+                                                       std::index_sequence<indices...>) {
+    return {((void)indices, ValueMap{resource})...};
+}
 
 struct DefTable {
+    explicit DefTable(std::pmr::memory_resource* resource)
+        : preds{MakeValueMaps(resource, std::make_index_sequence<IR::NUM_USER_PREDS>{})},
+          goto_vars{resource}, indirect_branch_var{resource}, zero_flag{resource},
+          sign_flag{resource}, carry_flag{resource}, overflow_flag{resource} {}
+
     const IR::Value& Def(IR::Block* block, IR::Reg variable) {
         return block->SsaRegValue(variable);
     }
@@ -112,7 +126,7 @@ struct DefTable {
     }
 
     std::array<ValueMap, IR::NUM_USER_PREDS> preds;
-    std::unordered_map<u32, ValueMap> goto_vars;
+    std::pmr::unordered_map<u32, ValueMap> goto_vars;
     ValueMap indirect_branch_var;
     ValueMap zero_flag;
     ValueMap sign_flag;
@@ -295,8 +309,9 @@ private:
         return same;
     }
 
-    std::unordered_map<IR::Block*, std::map<Variant, IR::Inst*>> incomplete_phis;
-    DefTable current_def;
+    std::pmr::unordered_map<IR::Block*, std::pmr::map<Variant, IR::Inst*>> incomplete_phis{
+        Arena::Current()};
+    DefTable current_def{Arena::Current()};
 };
 
 void VisitInst(Pass& pass, IR::Block* block, IR::Inst& inst) {
@@ -370,7 +385,7 @@ void VisitBlock(Pass& pass, IR::Block* block) {
 }
 
 IR::Type GetConcreteType(IR::Inst* inst) {
-    std::deque<IR::Inst*> queue;
+    std::pmr::deque<IR::Inst*> queue{Arena::Current()};
     queue.push_back(inst);
     while (!queue.empty()) {
         IR::Inst* current = queue.front();
@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+
+namespace {
+using Common::FS::FileAccessMode;
+using Common::FS::FileType;
+using Common::FS::IOFile;
+
+constexpr size_t FileSize = 0x1000;
+
+/// File filled with a known pattern, removed when done
+class TemporaryFile {
+public:
+    TemporaryFile() : path{std::filesystem::temp_directory_path() / "io_file_test.bin"} {
+        data.resize(FileSize);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<u8>(i * 7 + i / 256);
+        }
+        IOFile file{path, FileAccessMode::Write, FileType::BinaryFile};
+        REQUIRE(file.WriteSpan(std::span<const u8>(data)) == data.size());
+    }
+    ~TemporaryFile() {
+        Common::FS::RemoveFile(path);
+    }
+
+    std::filesystem::path path;
+    std::vector<u8> data;
+};
+} // Anonymous namespace
+
+TEST_CASE("IOFile: Reads at an offset leave the stream position alone", "[common]") {
+    const TemporaryFile temp;
+    IOFile file{temp.path, FileAccessMode::Read, FileType::BinaryFile};
+    REQUIRE(file.IsOpen());
+    REQUIRE(file.Seek(100));
+
+    std::array<u8, 200> buffer{};
+    REQUIRE(file.ReadSpanAt(std::span<u8>(buffer), 1000) == buffer.size());
+    REQUIRE(std::equal(buffer.begin(), buffer.end(), temp.data.begin() + 1000));
+    REQUIRE(file.ReadSpanAt(std::span<u8>(buffer).first(16), 0) == 16);
+    REQUIRE(std::equal(buffer.begin(), buffer.begin() + 16, temp.data.begin()));
+    REQUIRE(file.Tell() == 100);
+
+    // The stream reads from where it was left
+    REQUIRE(file.ReadSpan(std::span<u8>(buffer)) == buffer.size());
+    REQUIRE(std::equal(buffer.begin(), buffer.end(), temp.data.begin() + 100));
+}
+
+TEST_CASE("IOFile: Reads at an offset stop at the end of the file", "[common]") {
+    const TemporaryFile temp;
+    IOFile file{temp.path, FileAccessMode::Read, FileType::BinaryFile};
+    constexpr s64 end = static_cast<s64>(FileSize);
+    std::array<u8, 100> buffer{};
+    REQUIRE(file.ReadSpanAt(std::span<u8>(buffer), end - 10) == 10);
+    REQUIRE(std::equal(buffer.begin(), buffer.begin() + 10, temp.data.end() - 10));
+    REQUIRE(file.ReadSpanAt(std::span<u8>(buffer), end) == 0);
+    REQUIRE(file.ReadSpanAt(std::span<u8>(buffer), end + 100) == 0);
+
+    // Only whole elements are counted
+    std::array<u32, 4> words{};
+    REQUIRE(file.ReadSpanAt(std::span<u32>(words), end - 6) == 1);
+}
+
+TEST_CASE("IOFile: Reads at an offset from several threads", "[common]") {
+    const TemporaryFile temp;
+    const IOFile file{temp.path, FileAccessMode::Read, FileType::BinaryFile};
+    constexpr size_t num_threads = 4;
+    constexpr size_t chunk_size = 61;
+    std::array<bool, num_threads> matches{};
+    {
+        std::vector<std::jthread> threads;
+        for (size_t thread = 0; thread < num_threads; ++thread) {
+            threads.emplace_back([&, thread] {
+                bool thread_matches = true;
+                std::array<u8, chunk_size> buffer;
+                for (size_t round = 0; round < 1000; ++round) {
+                    const size_t offset = (round * num_threads + thread) * chunk_size % FileSize;
+                    const size_t expected = std::min(chunk_size, FileSize - offset);
+                    const size_t read =
+                        file.ReadSpanAt(std::span<u8>(buffer), static_cast<s64>(offset));
+                    thread_matches &= read == expected &&
+                                      std::equal(buffer.begin(), buffer.begin() + expected,
+                                                 temp.data.begin() + offset);
+                }
+                matches[thread] = thread_matches;
+            });
+        }
+    }
+    REQUIRE(std::ranges::all_of(matches, [](bool value) { return value; }));
+}
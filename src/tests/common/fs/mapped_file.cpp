@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/mapped_file.h"
+
+namespace {
+using Common::FS::FileAccessMode;
+using Common::FS::FileType;
+using Common::FS::IOFile;
+using Common::FS::MappedFile;
+
+class TemporaryFile {
+public:
+    explicit TemporaryFile(size_t size)
+        : path{std::filesystem::temp_directory_path() / "mapped_file_test.bin"} {
+        data.resize(size);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<u8>(i * 13 + i / 256);
+        }
+        IOFile file{path, FileAccessMode::Write, FileType::BinaryFile};
+        REQUIRE(file.WriteSpan(std::span<const u8>(data)) == data.size());
+    }
+    ~TemporaryFile() {
+        Common::FS::RemoveFile(path);
+    }
+
+    std::filesystem::path path;
+    std::vector<u8> data;
+};
+} // Anonymous namespace
+
+TEST_CASE("MappedFile: Maps the whole file", "[common]") {
+    const TemporaryFile temp{0x3000};
+    const MappedFile file{temp.path};
+    REQUIRE(file.IsOpen());
+    REQUIRE(file.GetSize() == temp.data.size());
+    REQUIRE(std::ranges::equal(file.GetData(), temp.data));
+}
+
+TEST_CASE("MappedFile: Reads at an offset stop at the end of the file", "[common]") {
+    const TemporaryFile temp{0x3000};
+    const MappedFile file{temp.path};
+    std::array<u8, 100> buffer{};
+    REQUIRE(file.ReadAt(buffer, 0x1234) == buffer.size());
+    REQUIRE(std::equal(buffer.begin(), buffer.end(), temp.data.begin() + 0x1234));
+    REQUIRE(file.ReadAt(buffer, 0x3000 - 10) == 10);
+    REQUIRE(std::equal(buffer.begin(), buffer.begin() + 10, temp.data.end() - 10));
+    REQUIRE(file.ReadAt(buffer, 0x3000) == 0);
+    REQUIRE(file.ReadAt(buffer, 0x4000) == 0);
+}
+
+TEST_CASE("MappedFile: Empty files are not mapped", "[common]") {
+    const TemporaryFile temp{0};
+    MappedFile file;
+    REQUIRE(!file.Open(temp.path));
+    REQUIRE(!file.IsOpen());
+    REQUIRE(file.GetSize() == 0);
+    REQUIRE(file.GetData().empty());
+    std::array<u8, 16> buffer{};
+    REQUIRE(file.ReadAt(buffer, 0) == 0);
+}
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/logging/deferred_message_ring.h"
+
+namespace {
+using Common::Log::DeferredMessageRing;
+using Record = DeferredMessageRing::Record;
+
+constexpr std::size_t Capacity = DeferredMessageRing::Capacity;
+
+/// Records are told apart by their line number, and by their function for each producer
+Record MakeRecord(unsigned int line_num, const char* function = nullptr) {
+    return Record{
+        .line_num = line_num,
+        .function = function,
+        .packed_args{},
+    };
+}
+} // Anonymous namespace
+
+TEST_CASE("DeferredMessageRing: Pops records in the order they were pushed", "[common]") {
+    const auto ring = std::make_unique<DeferredMessageRing>();
+    Record record;
+    REQUIRE(!ring->TryPop(record));
+    for (unsigned int i = 0; i < 100; ++i) {
+        ring->Push(MakeRecord(i));
+    }
+    for (unsigned int i = 0; i < 100; ++i) {
+        REQUIRE(ring->TryPop(record));
+        REQUIRE(record.line_num == i);
+    }
+    REQUIRE(!ring->TryPop(record));
+    REQUIRE(ring->GetDroppedCount() == 0);
+}
+
+TEST_CASE("DeferredMessageRing: Keeps the order when wrapping around", "[common]") {
+    const auto ring = std::make_unique<DeferredMessageRing>();
+    // Batches that do not divide the capacity, so they straddle the end of the slots
+    constexpr unsigned int batch_size = 1000;
+    unsigned int pushed = 0;
+    unsigned int popped = 0;
+    while (popped < Capacity * 3) {
+        for (unsigned int i = 0; i < batch_size; ++i) {
+            ring->Push(MakeRecord(pushed++));
+        }
+        Record record;
+        while (ring->TryPop(record)) {
+            REQUIRE(record.line_num == popped++);
+        }
+        REQUIRE(popped == pushed);
+    }
+    REQUIRE(ring->GetDroppedCount() == 0);
+}
+
+TEST_CASE("DeferredMessageRing: Drops the oldest records when full", "[common]") {
+    const auto ring = std::make_unique<DeferredMessageRing>();
+    constexpr unsigned int overflow = 10;
+    for (unsigned int i = 0; i < Capacity + overflow; ++i) {
+        ring->Push(MakeRecord(i));
+    }
+    REQUIRE(ring->GetDroppedCount() == overflow);
+
+    Record record;
+    for (unsigned int i = overflow; i < Capacity + overflow; ++i) {
+        REQUIRE(ring->TryPop(record));
+        REQUIRE(record.line_num == i);
+    }
+    REQUIRE(!ring->TryPop(record));
+}
+
+TEST_CASE("DeferredMessageRing: Packed arguments survive the ring", "[common]") {
+    const auto ring = std::make_unique<DeferredMessageRing>();
+    const int integer = -42;
+    const double real = 1.5;
+    Record pushed = MakeRecord(0);
+    pushed.format = "{} and {}";
+    pushed.format_function = &Common::Log::FormatDeferredMessage<int, double>;
+    std::memcpy(pushed.packed_args.data(), &integer, sizeof(integer));
+    std::memcpy(pushed.packed_args.data() + sizeof(integer), &real, sizeof(real));
+    ring->Push(pushed);
+
+    Record record;
+    REQUIRE(ring->TryPop(record));
+    REQUIRE(record.format_function(record.format, record.packed_args.data()) == "-42 and 1.5");
+}
+
+TEST_CASE("DeferredMessageRing: Keeps the order of each producer", "[common]") {
+    const auto ring = std::make_unique<DeferredMessageRing>();
+    constexpr std::size_t num_producers = 4;
+    constexpr unsigned int records_per_producer = 50000;
+    static constexpr std::array<const char*, num_producers> names{"0", "1", "2", "3"};
+
+    std::vector<std::jthread> producers;
+    for (std::size_t producer = 0; producer < num_producers; ++producer) {
+        producers.emplace_back([&ring, producer] {
+            for (unsigned int i = 0; i < records_per_producer; ++i) {
+                ring->Push(MakeRecord(i, names[producer]));
+            }
+        });
+    }
+
+    // Records may be dropped while the consumer lags, but never reordered or duplicated
+    std::array<s64, num_producers> last_line;
+    last_line.fill(-1);
+    std::size_t num_popped = 0;
+    bool in_order = true;
+    const auto pop_all = [&] {
+        Record record;
+        while (ring->TryPop(record)) {
+            const std::size_t producer = static_cast<std::size_t>(record.function[0] - '0');
+            in_order &= static_cast<s64>(record.line_num) > last_line[producer];
+            last_line[producer] = record.line_num;
+            ++num_popped;
+        }
+    };
+    while (num_popped + ring->GetDroppedCount() < num_producers * records_per_producer) {
+        pop_all();
+    }
+    producers.clear();
+    pop_all();
+    REQUIRE(in_order);
+    REQUIRE(num_popped + ring->GetDroppedCount() == num_producers * records_per_producer);
+}
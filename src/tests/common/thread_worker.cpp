@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/thread_worker.h"
+#include "common/unique_function.h"
+
+namespace {
+
+/// The previous design of ThreadWorker, a single queue behind a single mutex, for comparison.
+class SingleQueueWorker {
+public:
+    explicit SingleQueueWorker(size_t num_workers) {
+        for (size_t i = 0; i < num_workers; ++i) {
+            threads.emplace_back([this](std::stop_token stop_token) {
+                while (true) {
+                    Common::UniqueFunction<void> task;
+                    {
+                        std::unique_lock lock{queue_mutex};
+                        if (requests.empty()) {
+                            wait_condition.notify_all();
+                        }
+                        Common::CondvarWait(condition, lock, stop_token,
+                                            [this] { return !requests.empty(); });
+                        if (stop_token.stop_requested()) {
+                            return;
+                        }
+                        task = std::move(requests.front());
+                        requests.pop();
+                    }
+                    task();
+                    ++work_done;
+                }
+            });
+        }
+    }
+
+    void QueueWork(Common::UniqueFunction<void> work) {
+        {
+            std::unique_lock lock{queue_mutex};
+            requests.emplace(std::move(work));
+            ++work_scheduled;
+        }
+        condition.notify_one();
+    }
+
+    void WaitForRequests() {
+        std::unique_lock lock{queue_mutex};
+        wait_condition.wait(lock, [this] { return work_done >= work_scheduled; });
+    }
+
+private:
+    std::queue<Common::UniqueFunction<void>> requests;
+    std::mutex queue_mutex;
+    std::condition_variable_any condition;
+    std::condition_variable wait_condition;
+    std::atomic<size_t> work_scheduled{};
+    std::atomic<size_t> work_done{};
+    std::vector<std::jthread> threads;
+};
+
+/// Queues many small tasks from several producer threads at once.
+template <typename Worker>
+size_t RunContention(Worker& worker, size_t num_producers, size_t tasks_per_producer) {
+    std::atomic<size_t> counter{};
+    {
+        std::vector<std::jthread> producers;
+        for (size_t i = 0; i < num_producers; ++i) {
+            producers.emplace_back([&] {
+                for (size_t task = 0; task < tasks_per_producer; ++task) {
+                    worker.QueueWork(
+                        [&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+    }
+    worker.WaitForRequests();
+    return counter.load();
+}
+
+} // Anonymous namespace
+
+TEST_CASE("ThreadWorker: Runs every task", "[common]") {
+    Common::ThreadWorker worker{4, "TestWorker"};
+    REQUIRE(RunContention(worker, 4, 10000) == 40000);
+    REQUIRE(RunContention(worker, 1, 1) == 1);
+}
+
+TEST_CASE("ThreadWorker: Single worker preserves order", "[common]") {
+    Common::ThreadWorker worker{1, "TestWorker"};
+    std::vector<int> order;
+    for (int i = 0; i < 1000; ++i) {
+        worker.QueueWork([&order, i] { order.push_back(i); });
+    }
+    worker.WaitForRequests();
+
+    REQUIRE(order.size() == 1000);
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(order[i] == i);
+    }
+}
+
+TEST_CASE("ThreadWorker: Batches and nested work", "[common]") {
+    Common::ThreadWorker worker{3, "TestWorker"};
+    std::atomic<int> counter{};
+
+    std::vector<Common::UniqueFunction<void>> batch;
+    for (int i = 0; i < 100; ++i) {
+        batch.emplace_back([&] {
+            // Work queued from a worker goes to its own queue.
+            worker.QueueWork([&counter] { ++counter; });
+            ++counter;
+        });
+    }
+    worker.QueueWork(std::move(batch));
+    worker.WaitForRequests();
+
+    REQUIRE(counter == 200);
+}
+
+TEST_CASE("ThreadWorker: Stateful workers", "[common]") {
+    Common::StatefulThreadWorker<int> worker{2, "TestWorker", [] { return 7; }};
+    std::atomic<int> sum{};
+    for (int i = 0; i < 10; ++i) {
+        worker.QueueWork([&sum](int* state) { sum += *state; });
+    }
+    worker.WaitForRequests();
+
+    REQUIRE(sum == 70);
+}
+
+TEST_CASE("ThreadWorker: Contention benchmark", "[common][.benchmark]") {
+    const size_t num_workers = std::max(std::thread::hardware_concurrency(), 2U) / 2;
+    const size_t num_producers = 4;
+    const size_t tasks_per_producer = 20000;
+    const std::string suffix = " (" + std::to_string(num_workers) + " workers, " +
+                               std::to_string(num_producers) + " producers)";
+
+    SingleQueueWorker single_queue_worker{num_workers};
+    BENCHMARK("Single queue" + suffix) {
+        return RunContention(single_queue_worker, num_producers, tasks_per_producer);
+    };
+
+    Common::ThreadWorker worker{num_workers, "TestWorker"};
+    BENCHMARK("Work stealing" + suffix) {
+        return RunContention(worker, num_producers, tasks_per_producer);
+    };
+}
@@ -0,0 +1,213 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <mbedtls/cipher.h>
+
+#include "common/common_types.h"
+#include "core/crypto/aes_util.h"
+#include "core/crypto/key_manager.h"
+
+namespace {
+using Core::Crypto::AESCipher;
+using Core::Crypto::Key128;
+using Core::Crypto::Key256;
+using Core::Crypto::Mode;
+using Core::Crypto::Op;
+
+template <size_t N>
+std::array<u8, N> MakeBytes(std::mt19937& rng) {
+    std::array<u8, N> bytes;
+    for (u8& byte : bytes) {
+        byte = static_cast<u8>(rng());
+    }
+    return bytes;
+}
+
+std::vector<u8> MakeData(std::mt19937& rng, size_t size) {
+    std::vector<u8> data(size);
+    for (u8& byte : data) {
+        byte = static_cast<u8>(rng());
+    }
+    return data;
+}
+
+std::array<u8, 16> NintendoTweak(size_t sector_id) {
+    std::array<u8, 16> tweak{};
+    for (size_t i = 16; i-- > 0; sector_id >>= 8) {
+        tweak[i] = static_cast<u8>(sector_id);
+    }
+    return tweak;
+}
+
+/// Transcodes the data with mbedtls alone, like AESCipher does on hosts without AES-NI
+std::vector<u8> Reference(mbedtls_cipher_type_t type, std::span<const u8> key,
+                          std::span<const u8> iv, std::span<const u8> data, Op op) {
+    mbedtls_cipher_context_t context;
+    mbedtls_cipher_init(&context);
+    REQUIRE(mbedtls_cipher_setup(&context, mbedtls_cipher_info_from_type(type)) == 0);
+    const mbedtls_operation_t operation = op == Op::Encrypt ? MBEDTLS_ENCRYPT : MBEDTLS_DECRYPT;
+    REQUIRE(mbedtls_cipher_setkey(&context, key.data(), static_cast<int>(key.size() * 8),
+                                  operation) == 0);
+    REQUIRE(mbedtls_cipher_set_iv(&context, iv.data(), iv.size()) == 0);
+    REQUIRE(mbedtls_cipher_reset(&context) == 0);
+    std::vector<u8> output(data.size());
+    size_t written = 0;
+    REQUIRE(mbedtls_cipher_update(&context, data.data(), data.size(), output.data(), &written) ==
+            0);
+    REQUIRE(written == data.size());
+    mbedtls_cipher_free(&context);
+    return output;
+}
+} // Anonymous namespace
+
+TEST_CASE("AESCipher: CTR matches the NIST test vectors", "[core]") {
+    // NIST SP 800-38A, F.5.1 CTR-AES128.Encrypt
+    const Key128 key{0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                     0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    const std::array<u8, 16> counter{0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+                                     0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff};
+    const std::array<u8, 64> plaintext{
+        0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73,
+        0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7,
+        0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4,
+        0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef, 0xf6, 0x9f, 0x24, 0x45,
+        0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10,
+    };
+    const std::array<u8, 64> ciphertext{
+        0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64, 0x99,
+        0x0d, 0xb6, 0xce, 0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff, 0x86, 0x17,
+        0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff, 0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3,
+        0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab, 0x1e, 0x03, 0x1d, 0xda,
+        0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee,
+    };
+    AESCipher<Key128> cipher(key, Mode::CTR);
+    std::array<u8, 64> output{};
+
+    cipher.SetIV(counter);
+    cipher.Transcode(plaintext.data(), plaintext.size(), output.data(), Op::Encrypt);
+    REQUIRE(output == ciphertext);
+
+    cipher.SetIV(counter);
+    cipher.Transcode(ciphertext.data(), ciphertext.size(), output.data(), Op::Decrypt);
+    REQUIRE(output == plaintext);
+}
+
+TEST_CASE("AESCipher: XTS matches the IEEE 1619 test vectors", "[core]") {
+    // IEEE P1619 XTS-AES-128, vectors 1 and 2, with the tweak given as the IV
+    const Key256 zero_key{};
+    const std::array<u8, 32> zero_data{};
+    const std::array<u8, 32> vector1{
+        0x91, 0x7c, 0xf6, 0x9e, 0xbd, 0x68, 0xb2, 0xec, 0x9b, 0x9f, 0xe9,
+        0xa3, 0xea, 0xdd, 0xa6, 0x92, 0xcd, 0x43, 0xd2, 0xf5, 0x95, 0x98,
+        0xed, 0x85, 0x8c, 0x02, 0xc2, 0x65, 0x2f, 0xbf, 0x92, 0x2e,
+    };
+    Key256 key;
+    std::fill(key.begin(), key.begin() + 16, u8{0x11});
+    std::fill(key.begin() + 16, key.end(), u8{0x22});
+    const std::array<u8, 16> tweak{0x33, 0x33, 0x33, 0x33, 0x33};
+    std::array<u8, 32> plaintext;
+    plaintext.fill(0x44);
+    const std::array<u8, 32> vector2{
+        0xc4, 0x54, 0x18, 0x5e, 0x6a, 0x16, 0x93, 0x6e, 0x39, 0x33, 0x40,
+        0x38, 0xac, 0xef, 0x83, 0x8b, 0xfb, 0x18, 0x6f, 0xff, 0x74, 0x80,
+        0xad, 0xc4, 0x28, 0x93, 0x82, 0xec, 0xd6, 0xd3, 0x94, 0xf0,
+    };
+    std::array<u8, 32> output{};
+
+    AESCipher<Key256> zero_cipher(zero_key, Mode::XTS);
+    zero_cipher.SetIV(std::array<u8, 16>{});
+    zero_cipher.Transcode(zero_data.data(), zero_data.size(), output.data(), Op::Encrypt);
+    REQUIRE(output == vector1);
+
+    AESCipher<Key256> cipher(key, Mode::XTS);
+    cipher.SetIV(tweak);
+    cipher.Transcode(plaintext.data(), plaintext.size(), output.data(), Op::Encrypt);
+    REQUIRE(output == vector2);
+    cipher.Transcode(vector2.data(), vector2.size(), output.data(), Op::Decrypt);
+    REQUIRE(output == plaintext);
+}
+
+TEST_CASE("AESCipher: CTR matches mbedtls", "[core]") {
+    std::mt19937 rng{1234};
+    for (const size_t size : {1, 15, 16, 17, 127, 128, 129, 1000, 0x4000}) {
+        const Key128 key = MakeBytes<16>(rng);
+        std::array<u8, 16> counter = MakeBytes<16>(rng);
+        // Carry across the low half of the counter
+        std::fill(counter.begin() + 8, counter.end(), u8{0xff});
+        const std::vector<u8> data = MakeData(rng, size);
+
+        AESCipher<Key128> cipher(key, Mode::CTR);
+        std::vector<u8> output(size);
+        cipher.SetIV(counter);
+        cipher.Transcode(data.data(), size, output.data(), Op::Decrypt);
+        REQUIRE(output == Reference(MBEDTLS_CIPHER_AES_128_CTR, key, counter, data, Op::Decrypt));
+    }
+}
+
+TEST_CASE("AESCipher: XTS sectors match mbedtls", "[core]") {
+    std::mt19937 rng{5678};
+    for (const size_t sector_size : {0x10, 0x200, 0x4000}) {
+        const Key256 key = MakeBytes<32>(rng);
+        const size_t first_sector = rng() % 1000;
+        const std::vector<u8> data = MakeData(rng, sector_size * 4);
+        AESCipher<Key256> cipher(key, Mode::XTS);
+
+        for (const Op op : {Op::Encrypt, Op::Decrypt}) {
+            std::vector<u8> output(data.size());
+            cipher.XTSTranscode(data.data(), data.size(), output.data(), first_sector,
+                                sector_size, op);
+            for (size_t sector = 0; sector < 4; ++sector) {
+                const std::span<const u8> input =
+                    std::span(data).subspan(sector * sector_size, sector_size);
+                const std::vector<u8> expected =
+                    Reference(MBEDTLS_CIPHER_AES_128_XTS, key,
+                              NintendoTweak(first_sector + sector), input, op);
+                REQUIRE(std::equal(expected.begin(), expected.end(),
+                                   output.begin() + sector * sector_size));
+            }
+        }
+    }
+}
+
+TEST_CASE("AESCipher: Benchmark", "[core][.benchmark]") {
+    std::mt19937 rng{1234};
+    const Key128 ctr_key = MakeBytes<16>(rng);
+    const Key256 xts_key = MakeBytes<32>(rng);
+    const std::array<u8, 16> counter = MakeBytes<16>(rng);
+    // Size of the blocks read from NCAs
+    const std::vector<u8> data = MakeData(rng, 0x100000);
+    std::vector<u8> output(data.size());
+
+    AESCipher<Key128> ctr_cipher(ctr_key, Mode::CTR);
+    AESCipher<Key256> xts_cipher(xts_key, Mode::XTS);
+    BENCHMARK("CTR 1 MiB") {
+        ctr_cipher.SetIV(counter);
+        ctr_cipher.Transcode(data.data(), data.size(), output.data(), Op::Decrypt);
+        return output[0];
+    };
+    BENCHMARK("CTR 1 MiB, mbedtls") {
+        return Reference(MBEDTLS_CIPHER_AES_128_CTR, ctr_key, counter, data, Op::Decrypt)[0];
+    };
+    BENCHMARK("XTS 1 MiB, 0x4000 byte sectors") {
+        xts_cipher.XTSTranscode(data.data(), data.size(), output.data(), 0, 0x4000, Op::Decrypt);
+        return output[0];
+    };
+    BENCHMARK("XTS 1 MiB, 0x4000 byte sectors, mbedtls") {
+        for (size_t offset = 0; offset < data.size(); offset += 0x4000) {
+            const std::span<const u8> sector = std::span(data).subspan(offset, 0x4000);
+            const std::vector<u8> result = Reference(MBEDTLS_CIPHER_AES_128_XTS, xts_key,
+                                                     NintendoTweak(offset / 0x4000), sector,
+                                                     Op::Decrypt);
+            std::copy(result.begin(), result.end(), output.begin() + offset);
+        }
+        return output[0];
+    };
+}
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <mbedtls/sha256.h>
+
+#include "common/common_types.h"
+#include "common/hex_util.h"
+#include "core/crypto/sha_util.h"
+
+namespace {
+using Core::Crypto::CalculateSHA256;
+using Core::Crypto::CalculateSHA256Blocks;
+using Core::Crypto::SHA256Hash;
+
+std::span<const u8> AsBytes(std::string_view string) {
+    return {reinterpret_cast<const u8*>(string.data()), string.size()};
+}
+
+std::vector<u8> MakeData(std::mt19937& rng, size_t size) {
+    std::vector<u8> data(size);
+    for (u8& byte : data) {
+        byte = static_cast<u8>(rng());
+    }
+    return data;
+}
+
+/// Hashes the data with mbedtls alone, like hosts without the SHA extensions do
+SHA256Hash Reference(std::span<const u8> data) {
+    SHA256Hash hash;
+    REQUIRE(mbedtls_sha256_ret(data.data(), data.size(), hash.data(), 0) == 0);
+    return hash;
+}
+} // Anonymous namespace
+
+TEST_CASE("SHA256: Hashes match the FIPS 180-2 test vectors", "[core]") {
+    REQUIRE(CalculateSHA256({}) ==
+            Common::AsArray("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+    REQUIRE(CalculateSHA256(AsBytes("abc")) ==
+            Common::AsArray("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+    REQUIRE(CalculateSHA256(AsBytes("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")) ==
+            Common::AsArray("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+    const std::vector<u8> million_a(1000000, 'a');
+    REQUIRE(CalculateSHA256(million_a) ==
+            Common::AsArray("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+}
+
+TEST_CASE("SHA256: Block hashes match mbedtls", "[core]") {
+    std::mt19937 rng{1234};
+    // Sizes around the padding boundaries, and the block sizes of the integrity storages
+    for (const size_t block_size : {1, 55, 56, 63, 64, 65, 119, 120, 0x200, 0x4000}) {
+        // Odd counts leave a block that is not hashed along another one
+        for (const size_t num_blocks : {1, 2, 3, 4, 5}) {
+            const std::vector<u8> data = MakeData(rng, block_size * num_blocks);
+            std::vector<SHA256Hash> hashes(num_blocks);
+            CalculateSHA256Blocks(hashes, data.data(), block_size);
+            for (size_t i = 0; i < num_blocks; ++i) {
+                const std::span<const u8> block =
+                    std::span(data).subspan(i * block_size, block_size);
+                REQUIRE(hashes[i] == Reference(block));
+                REQUIRE(CalculateSHA256(block) == hashes[i]);
+            }
+        }
+    }
+}
+
+TEST_CASE("SHA256: Benchmark", "[core][.benchmark]") {
+    // Hash block size of the NCA integrity storages
+    constexpr size_t block_size = 0x4000;
+    constexpr size_t num_blocks = 64;
+    std::mt19937 rng{1234};
+    const std::vector<u8> data = MakeData(rng, block_size * num_blocks);
+    std::vector<SHA256Hash> hashes(num_blocks);
+
+    BENCHMARK("1 MiB in 0x4000 byte blocks") {
+        CalculateSHA256Blocks(hashes, data.data(), block_size);
+        return hashes[0][0];
+    };
+    BENCHMARK("1 MiB in 0x4000 byte blocks, one at a time") {
+        for (size_t i = 0; i < num_blocks; ++i) {
+            hashes[i] = CalculateSHA256(std::span(data).subspan(i * block_size, block_size));
+        }
+        return hashes[0][0];
+    };
+    BENCHMARK("1 MiB in 0x4000 byte blocks, mbedtls") {
+        for (size_t i = 0; i < num_blocks; ++i) {
+            hashes[i] = Reference(std::span(data).subspan(i * block_size, block_size));
+        }
+        return hashes[0][0];
+    };
+}
@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/literals.h"
+#include "core/file_sys/fssystem/fssystem_buddy_heap.h"
+
+namespace {
+using namespace Common::Literals;
+using FileSys::FileSystemBuddyHeap;
+
+constexpr size_t BlockSize = 4_KiB;
+constexpr s32 OrderMax = 4;
+constexpr size_t MaxOrderSize = BlockSize << OrderMax;
+
+/// Buddy heap over two blocks of the largest order
+class TestHeap {
+public:
+    TestHeap() : memory(HeapSize) {
+        heap.Initialize(memory.data(), HeapSize, BlockSize, OrderMax);
+    }
+
+    ~TestHeap() {
+        heap.Finalize();
+    }
+
+    size_t Offset(const void* ptr) const {
+        return static_cast<size_t>(static_cast<const u8*>(ptr) - memory.data());
+    }
+
+    static constexpr size_t HeapSize = MaxOrderSize * 2;
+
+    std::vector<u8> memory;
+    FileSystemBuddyHeap heap;
+};
+} // Anonymous namespace
+
+TEST_CASE("FileSystemBuddyHeap: Converts between sizes and orders", "[core]") {
+    TestHeap test_heap;
+    const FileSystemBuddyHeap& heap = test_heap.heap;
+    REQUIRE(heap.GetOrderFromBytes(0) == 0);
+    REQUIRE(heap.GetOrderFromBytes(1) == 0);
+    REQUIRE(heap.GetOrderFromBytes(BlockSize) == 0);
+    REQUIRE(heap.GetOrderFromBytes(BlockSize + 1) == 1);
+    REQUIRE(heap.GetOrderFromBytes(3 * BlockSize) == 2);
+    REQUIRE(heap.GetOrderFromBytes(MaxOrderSize) == OrderMax);
+    REQUIRE(heap.GetOrderFromBytes(MaxOrderSize + 1) == -1);
+    REQUIRE(heap.GetBytesFromOrder(3) == 8 * BlockSize);
+    REQUIRE(heap.GetTotalFreeSize() == TestHeap::HeapSize);
+    REQUIRE(heap.GetAllocatableSizeMax() == MaxOrderSize);
+}
+
+TEST_CASE("FileSystemBuddyHeap: Allocations are aligned to their size", "[core]") {
+    TestHeap test_heap;
+    FileSystemBuddyHeap& heap = test_heap.heap;
+    std::vector<std::pair<void*, s32>> allocations;
+    size_t allocated_size = 0;
+    for (const s32 order : {0, 2, 1, 0, 3, 2}) {
+        void* const block = heap.AllocateByOrder(order);
+        REQUIRE(block != nullptr);
+        REQUIRE(test_heap.Offset(block) % heap.GetBytesFromOrder(order) == 0);
+        for (const auto& [other, other_order] : allocations) {
+            const size_t begin = test_heap.Offset(block);
+            const size_t other_begin = test_heap.Offset(other);
+            REQUIRE((begin + heap.GetBytesFromOrder(order) <= other_begin ||
+                     other_begin + heap.GetBytesFromOrder(other_order) <= begin));
+        }
+        allocations.emplace_back(block, order);
+        allocated_size += heap.GetBytesFromOrder(order);
+        REQUIRE(heap.GetTotalFreeSize() == TestHeap::HeapSize - allocated_size);
+    }
+}
+
+TEST_CASE("FileSystemBuddyHeap: Fails when no block is large enough", "[core]") {
+    TestHeap test_heap;
+    FileSystemBuddyHeap& heap = test_heap.heap;
+    REQUIRE(heap.AllocateByOrder(OrderMax) != nullptr);
+    void* const block = heap.AllocateByOrder(0);
+    REQUIRE(block != nullptr);
+
+    // Half of the heap is free, but not as one block of the largest order
+    REQUIRE(heap.AllocateByOrder(OrderMax) == nullptr);
+    REQUIRE(heap.GetAllocatableSizeMax() == heap.GetBytesFromOrder(OrderMax - 1));
+
+    heap.Free(block, 0);
+    REQUIRE(heap.AllocateByOrder(OrderMax) != nullptr);
+    REQUIRE(heap.AllocateByOrder(0) == nullptr);
+    REQUIRE(heap.GetTotalFreeSize() == 0);
+}
+
+TEST_CASE("FileSystemBuddyHeap: Freed buddies are coalesced", "[core]") {
+    TestHeap test_heap;
+    FileSystemBuddyHeap& heap = test_heap.heap;
+    std::mt19937 rng{1234};
+    for (size_t round = 0; round < 8; ++round) {
+        // Split the whole heap into blocks of random orders
+        std::vector<std::pair<void*, s32>> allocations;
+        while (heap.GetTotalFreeSize() != 0) {
+            const s32 order = static_cast<s32>(rng() % (OrderMax + 1));
+            if (void* const block = heap.AllocateByOrder(order)) {
+                allocations.emplace_back(block, order);
+            }
+        }
+
+        // Free them in any order, the heap must end up as blocks of the largest order again
+        std::ranges::shuffle(allocations, rng);
+        for (const auto& [block, order] : allocations) {
+            heap.Free(block, order);
+        }
+        REQUIRE(heap.GetTotalFreeSize() == TestHeap::HeapSize);
+        REQUIRE(heap.GetAllocatableSizeMax() == MaxOrderSize);
+        void* const first = heap.AllocateByOrder(OrderMax);
+        void* const second = heap.AllocateByOrder(OrderMax);
+        REQUIRE(first != nullptr);
+        REQUIRE(second != nullptr);
+        heap.Free(first, OrderMax);
+        heap.Free(second, OrderMax);
+    }
+}
@@ -0,0 +1,288 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include "common/literals.h"
+#include "core/file_sys/fssystem/fssystem_compressed_storage.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+
+namespace {
+using namespace Common::Literals;
+using FileSys::BucketTree;
+using FileSys::CompressedStorage;
+using FileSys::CompressionType;
+
+constexpr size_t BlockSizeMax = 64_KiB;
+constexpr size_t ContinuousReadingSizeMax = 640_KiB;
+
+std::atomic<u64> g_decompress_count;
+
+/// Stands in for LZ4, every physical block expands to its virtual size
+Result Decompress(void* dst, size_t dst_size, const void* src, size_t src_size) {
+    auto* const out = static_cast<u8*>(dst);
+    const auto* const in = static_cast<const u8*>(src);
+    for (size_t offset = 0, round = 0; offset < dst_size; offset += src_size, ++round) {
+        const size_t size = std::min(src_size, dst_size - offset);
+        for (size_t i = 0; i < size; ++i) {
+            out[offset + i] = static_cast<u8>(in[i] ^ round);
+        }
+    }
+    g_decompress_count.fetch_add(1, std::memory_order_relaxed);
+    R_SUCCEED();
+}
+
+FileSys::DecompressorFunction GetDecompressor(CompressionType type) {
+    return type == CompressionType::Lz4 ? Decompress : nullptr;
+}
+
+struct CacheParameters {
+    size_t cache_size_0;
+    size_t cache_size_1;
+    s32 max_cache_entries;
+};
+
+constexpr CacheParameters NcaCache{CompressedStorage::CacheBlockSizeMax,
+                                   CompressedStorage::CacheSizeMax,
+                                   CompressedStorage::CacheEntriesMax};
+
+/// Compressed storage made of LZ4 blocks of the same size
+class TestStorage {
+public:
+    explicit TestStorage(size_t num_blocks_, size_t virtual_block_size_,
+                         size_t physical_block_size, CacheParameters cache)
+        : num_blocks{num_blocks_}, virtual_block_size{virtual_block_size_} {
+        std::vector<u8> data(num_blocks * physical_block_size);
+        std::mt19937 rng{1234};
+        for (u8& byte : data) {
+            byte = static_cast<u8>(rng());
+        }
+
+        // A single entry set, indexed by a single node
+        const s64 end_offset = static_cast<s64>(num_blocks * virtual_block_size);
+        std::vector<u8> node(CompressedStorage::NodeSize);
+        const BucketTree::NodeHeader node_header{0, 1, end_offset};
+        std::memcpy(node.data(), &node_header, sizeof(node_header));
+
+        std::vector<u8> entries(CompressedStorage::NodeSize);
+        const BucketTree::NodeHeader entry_header{0, static_cast<s32>(num_blocks), end_offset};
+        std::memcpy(entries.data(), &entry_header, sizeof(entry_header));
+        for (size_t i = 0; i < num_blocks; ++i) {
+            const CompressedStorage::Entry entry{
+                .virt_offset = static_cast<s64>(i * virtual_block_size),
+                .phys_offset = static_cast<s64>(i * physical_block_size),
+                .compression_type = CompressionType::Lz4,
+                .phys_size = static_cast<s32>(physical_block_size),
+            };
+            std::memcpy(entries.data() + sizeof(entry_header) + i * sizeof(entry), &entry,
+                        sizeof(entry));
+        }
+
+        expected.resize(num_blocks * virtual_block_size);
+        for (size_t i = 0; i < num_blocks; ++i) {
+            (void)Decompress(expected.data() + i * virtual_block_size, virtual_block_size,
+                             data.data() + i * physical_block_size, physical_block_size);
+        }
+
+        storage = std::make_unique<CompressedStorage>();
+        const Result result = storage->Initialize(
+            std::make_shared<FileSys::VectorVfsFile>(std::move(data)),
+            std::make_shared<FileSys::VectorVfsFile>(std::move(node)),
+            std::make_shared<FileSys::VectorVfsFile>(std::move(entries)),
+            static_cast<s32>(num_blocks), BlockSizeMax, ContinuousReadingSizeMax, GetDecompressor,
+            cache.cache_size_0, cache.cache_size_1, cache.max_cache_entries);
+        REQUIRE(R_SUCCEEDED(result));
+    }
+
+    /// Reads a range and checks it against the decompressed data
+    void Read(size_t offset, size_t size) {
+        buffer.resize(size);
+        REQUIRE(storage->Read(buffer.data(), size, offset) == size);
+        REQUIRE(std::memcmp(buffer.data(), expected.data() + offset, size) == 0);
+    }
+
+    /// Reads a range without checking it, for benchmarks
+    void ReadUnchecked(size_t offset, size_t size) {
+        buffer.resize(size);
+        storage->Read(buffer.data(), size, offset);
+    }
+
+    /// Reads a range of a block, away from the previous read so nothing is read ahead
+    void ReadInBlock(size_t block, size_t offset, size_t size) {
+        Read(block * virtual_block_size + offset, size);
+    }
+
+    CompressedStorage::CacheStatistics GetStatistics() const {
+        return storage->GetCacheStatistics();
+    }
+
+    size_t num_blocks;
+    size_t virtual_block_size;
+
+private:
+    std::vector<u8> expected;
+    std::vector<u8> buffer;
+    std::unique_ptr<CompressedStorage> storage;
+};
+
+/// Accesses of a game streaming assets: four files read in interleaved 16 KiB chunks, and
+/// small lookups in a table that stays hot
+std::vector<std::pair<size_t, size_t>> MakeTrace(size_t storage_size) {
+    constexpr size_t num_streams = 4;
+    constexpr size_t chunk_size = 16_KiB;
+    constexpr size_t table_size = 1_MiB;
+    std::mt19937 rng{5678};
+    std::vector<std::pair<size_t, size_t>> trace;
+    std::vector<size_t> stream_offsets(num_streams);
+    for (size_t& offset : stream_offsets) {
+        offset = table_size + (rng() % ((storage_size - table_size) / chunk_size)) * chunk_size;
+    }
+    for (size_t i = 0; i < 1024; ++i) {
+        if (i % 4 == 3) {
+            trace.emplace_back(rng() % (table_size - 1_KiB), 1_KiB);
+            continue;
+        }
+        size_t& offset = stream_offsets[i % num_streams];
+        if (offset + chunk_size > storage_size) {
+            offset = table_size;
+        }
+        trace.emplace_back(offset, chunk_size);
+        offset += chunk_size;
+    }
+    return trace;
+}
+} // Anonymous namespace
+
+TEST_CASE("CompressedStorage: Partial reads of a block are served from the cache", "[core]") {
+    TestStorage storage{16, 128_KiB, 64_KiB, {256_KiB, 1_MiB, 16}};
+    const u64 decompress_count = g_decompress_count;
+
+    storage.ReadInBlock(2, 100, 4_KiB);
+    storage.ReadInBlock(2, 8000, 4_KiB);
+    storage.ReadInBlock(2, 120_KiB, 8_KiB);
+    REQUIRE(g_decompress_count - decompress_count == 1);
+
+    const CompressedStorage::CacheStatistics statistics = storage.GetStatistics();
+    REQUIRE(statistics.hit_count == 2);
+    REQUIRE(statistics.miss_count == 1);
+    REQUIRE(statistics.eviction_count == 0);
+}
+
+TEST_CASE("CompressedStorage: Least recently used blocks are evicted", "[core]") {
+    SECTION("By entry count") {
+        TestStorage storage{16, 128_KiB, 64_KiB, {256_KiB, 1_MiB, 2}};
+        storage.ReadInBlock(1, 100, 4_KiB);
+        storage.ReadInBlock(3, 100, 4_KiB);
+        storage.ReadInBlock(1, 200, 4_KiB);
+        storage.ReadInBlock(5, 100, 4_KiB);
+        REQUIRE(storage.GetStatistics().eviction_count == 1);
+
+        // Block 3 was the least recently used one
+        storage.ReadInBlock(1, 300, 4_KiB);
+        storage.ReadInBlock(5, 200, 4_KiB);
+        storage.ReadInBlock(3, 200, 4_KiB);
+        const CompressedStorage::CacheStatistics statistics = storage.GetStatistics();
+        REQUIRE(statistics.hit_count == 3);
+        REQUIRE(statistics.miss_count == 4);
+        REQUIRE(statistics.eviction_count == 2);
+    }
+    SECTION("By total size") {
+        TestStorage storage{16, 128_KiB, 64_KiB, {256_KiB, 256_KiB, 16}};
+        storage.ReadInBlock(1, 100, 4_KiB);
+        storage.ReadInBlock(3, 100, 4_KiB);
+        storage.ReadInBlock(5, 100, 4_KiB);
+        storage.ReadInBlock(3, 200, 4_KiB);
+        storage.ReadInBlock(1, 200, 4_KiB);
+        const CompressedStorage::CacheStatistics statistics = storage.GetStatistics();
+        REQUIRE(statistics.hit_count == 1);
+        REQUIRE(statistics.miss_count == 4);
+        REQUIRE(statistics.eviction_count == 2);
+    }
+}
+
+TEST_CASE("CompressedStorage: Blocks over the size limit are not cached", "[core]") {
+    TestStorage storage{16, 128_KiB, 64_KiB, {64_KiB, 1_MiB, 16}};
+    const u64 decompress_count = g_decompress_count;
+    storage.ReadInBlock(2, 100, 4_KiB);
+    storage.ReadInBlock(2, 8000, 4_KiB);
+    REQUIRE(g_decompress_count - decompress_count == 2);
+    REQUIRE(storage.GetStatistics().hit_count == 0);
+}
+
+TEST_CASE("CompressedStorage: Reads return the decompressed data", "[core]") {
+    for (const CacheParameters cache : {CacheParameters{0, 0, 0},
+                                        NcaCache}) {
+        TestStorage storage{64, 96_KiB, 48_KiB, cache};
+        const size_t storage_size = storage.num_blocks * storage.virtual_block_size;
+        std::mt19937 rng{1234};
+        for (size_t i = 0; i < 200; ++i) {
+            const size_t size = 1 + rng() % 300_KiB;
+            storage.Read(rng() % (storage_size - size), size);
+        }
+        // Sequential reads, which are read ahead
+        for (size_t offset = 0; offset + 20_KiB <= storage_size; offset += 20_KiB) {
+            storage.Read(offset, 20_KiB);
+        }
+    }
+}
+
+TEST_CASE("CompressedStorage: Parallel decompression matches serial decompression", "[core]") {
+    // The expected data is decompressed one block at a time. Reads of several whole blocks are
+    // decompressed in parallel straight into the destination, other reads of several blocks are
+    // decompressed in parallel into a staging buffer.
+    TestStorage storage{64, 64_KiB, 32_KiB, {0, 0, 0}};
+    for (const size_t block_count : {2, 3, 8, 19}) {
+        for (const size_t first_block : {0, 5, 40}) {
+            const size_t offset = first_block * storage.virtual_block_size;
+            const size_t size = block_count * storage.virtual_block_size;
+            storage.Read(offset, size);
+            storage.Read(offset + 100, size - 200);
+            storage.Read(offset, size - 100);
+        }
+    }
+}
+
+TEST_CASE("CompressedStorage: Benchmark", "[core][.benchmark]") {
+    struct Configuration {
+        const char* name;
+        CacheParameters cache;
+    };
+    const Configuration configurations[]{
+        {"No cache", {0, 0, 0}},
+        {"16 KiB cache", {16_KiB, 16_KiB, 32}},
+        {"NCA cache", NcaCache},
+        {"2 MiB cache", {256_KiB, 2_MiB, 32}},
+        {"4 MiB cache", {256_KiB, 4_MiB, 64}},
+    };
+    const std::vector<std::pair<size_t, size_t>> trace = MakeTrace(32_MiB);
+    for (const Configuration& configuration : configurations) {
+        // Blocks compressed to half of their size
+        TestStorage storage{256, 128_KiB, 64_KiB, configuration.cache};
+        const u64 decompress_count = g_decompress_count;
+        for (const auto& [offset, size] : trace) {
+            storage.Read(offset, size);
+        }
+        const u64 decompressions = g_decompress_count - decompress_count;
+        const CompressedStorage::CacheStatistics statistics = storage.GetStatistics();
+        const u64 lookups = statistics.hit_count + statistics.miss_count;
+        BENCHMARK(fmt::format("Trace replay, {}: {} hits / {} lookups, {} decompressions",
+                              configuration.name, statistics.hit_count, lookups,
+                              decompressions)) {
+            for (const auto& [offset, size] : trace) {
+                storage.ReadUnchecked(offset, size);
+            }
+            return trace.size();
+        };
+    }
+}
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "core/hle/service/dispatch_queue.h"
+
+namespace {
+using Service::DispatchQueue;
+using Clock = DispatchQueue<int>::Clock;
+
+/// Serves the queue like ServerManager::WorkerLoop
+void Serve(DispatchQueue<int>& queue, std::stop_token stop_token, std::atomic<int>& served) {
+    while (const auto entry = queue.Pop(stop_token)) {
+        const auto start_time = Clock::now();
+        queue.Account(entry->queue_time, start_time, Clock::now());
+        served.fetch_add(1, std::memory_order_release);
+        served.notify_all();
+    }
+}
+
+/// Pushes the items like ServerManager::QueueSession and waits for the workers to serve them
+void Dispatch(DispatchQueue<int>& queue, std::atomic<int>& served, int num_items) {
+    const int target = served.load(std::memory_order_acquire) + num_items;
+    for (int i = 0; i < num_items; ++i) {
+        queue.Push(i);
+    }
+    for (int value = served.load(std::memory_order_acquire); value < target;
+         value = served.load(std::memory_order_acquire)) {
+        served.wait(value, std::memory_order_acquire);
+    }
+}
+} // Anonymous namespace
+
+TEST_CASE("DispatchQueue: Items are taken in order", "[core]") {
+    DispatchQueue<int> queue;
+    std::stop_source stop_source;
+    for (int i = 0; i < 5; ++i) {
+        queue.Push(i);
+    }
+    REQUIRE(queue.GetStatistics().queue_depth == 5);
+    REQUIRE(queue.GetStatistics().max_queue_depth == 5);
+    for (int i = 0; i < 5; ++i) {
+        const auto entry = queue.Pop(stop_source.get_token());
+        REQUIRE(entry.has_value());
+        REQUIRE(entry->item == i);
+    }
+    REQUIRE(queue.GetStatistics().queue_depth == 0);
+    REQUIRE(queue.GetStatistics().max_queue_depth == 5);
+}
+
+TEST_CASE("DispatchQueue: Stopping wakes up the waiting workers", "[core]") {
+    DispatchQueue<int> queue;
+    std::stop_source stop_source;
+    std::atomic<int> served{};
+    std::vector<std::jthread> workers;
+    for (int i = 0; i < 4; ++i) {
+        workers.emplace_back([&] { Serve(queue, stop_source.get_token(), served); });
+    }
+    Dispatch(queue, served, 100);
+    stop_source.request_stop();
+    workers.clear();
+
+    // Every item was served and accounted exactly once
+    REQUIRE(served.load() == 100);
+    const auto stats = queue.GetStatistics();
+    REQUIRE(stats.requests == 100);
+    REQUIRE(stats.queue_depth == 0);
+    REQUIRE(stats.max_queue_time <= stats.total_queue_time);
+    REQUIRE(stats.max_service_time <= stats.total_service_time);
+
+    // Items queued after the stop are not taken anymore
+    queue.Push(0);
+    REQUIRE(!queue.Pop(stop_source.get_token()).has_value());
+}
@@ -0,0 +1,315 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "enet/enet.h"
+#include "network/packet.h"
+#include "network/room.h"
+#include "network/room_pool.h"
+#include "network/verify_user.h"
+
+namespace {
+using namespace Network;
+
+/// Raw ENet client speaking the room protocol, without the thread of a RoomMember.
+class SyntheticClient {
+public:
+    explicit SyntheticClient(const std::string& nickname, u16 port) {
+        host = enet_host_create(nullptr, 1, NumChannels, 0, 0);
+        REQUIRE(host != nullptr);
+
+        ENetAddress address{};
+        enet_address_set_host(&address, "127.0.0.1");
+        address.port = port;
+        peer = enet_host_connect(host, &address, NumChannels, 0);
+        REQUIRE(peer != nullptr);
+
+        ENetEvent event;
+        REQUIRE(enet_host_service(host, &event, 1000) > 0);
+        REQUIRE(event.type == ENET_EVENT_TYPE_CONNECT);
+
+        Packet packet;
+        packet.Write(static_cast<u8>(IdJoinRequest));
+        packet.Write(nickname);
+        packet.Write(NoPreferredIP);
+        packet.Write(network_version);
+        packet.Write(std::string{}); // Password
+        packet.Write(std::string{}); // Token
+        Send(packet);
+
+        const auto join_success = ReceiveType(IdJoinSuccess);
+        REQUIRE(join_success.has_value());
+        Packet response;
+        response.Append(join_success->data(), join_success->size());
+        response.IgnoreBytes(sizeof(u8)); // Message type
+        response.Read(fake_ip);
+    }
+
+    ~SyntheticClient() {
+        enet_peer_disconnect(peer, 0);
+        enet_host_flush(host);
+        enet_host_destroy(host);
+    }
+
+    void Send(const Packet& packet) {
+        ENetPacket* enet_packet =
+            enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+        enet_peer_send(peer, 0, enet_packet);
+        enet_host_flush(host);
+    }
+
+    void SendLdnPacket(const IPv4Address& remote_ip, bool broadcast, const std::vector<u8>& data) {
+        Packet packet;
+        packet.Write(static_cast<u8>(IdLdnPacket));
+        packet.Write(static_cast<u8>(0)); // LAN packet type
+        packet.Write(fake_ip);
+        packet.Write(remote_ip);
+        packet.Write(broadcast);
+        packet.Write(data);
+        Send(packet);
+    }
+
+    /// Waits for a packet of the given type, skipping room information and status messages.
+    std::optional<std::vector<u8>> ReceiveType(u8 type) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (std::chrono::steady_clock::now() < deadline) {
+            ENetEvent event;
+            if (enet_host_service(host, &event, 10) <= 0 ||
+                event.type != ENET_EVENT_TYPE_RECEIVE) {
+                continue;
+            }
+            std::vector<u8> data(event.packet->data,
+                                 event.packet->data + event.packet->dataLength);
+            enet_packet_destroy(event.packet);
+            if (data[0] == type) {
+                return data;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// Handles the incoming packets without blocking, returns how many were LDN packets.
+    size_t DrainLdnPackets() {
+        size_t count = 0;
+        ENetEvent event;
+        while (enet_host_service(host, &event, 0) > 0) {
+            if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+                count += event.packet->data[0] == IdLdnPacket ? 1 : 0;
+                enet_packet_destroy(event.packet);
+            }
+        }
+        return count;
+    }
+
+    IPv4Address fake_ip{};
+
+private:
+    ENetHost* host{};
+    ENetPeer* peer{};
+};
+
+/// Opens a room on the loopback interface for the duration of a test.
+class TestRoom {
+public:
+    TestRoom() {
+        REQUIRE(enet_initialize() == 0);
+        // Bind to any free port, so tests never collide with a running room
+        REQUIRE(room.Create("Test Room", "", "127.0.0.1", 0, "", 16, "", {},
+                            std::make_shared<VerifyUser::NullBackend>()));
+        port = room.GetRoomInformation().port;
+        REQUIRE(port != 0);
+    }
+
+    ~TestRoom() {
+        room.Destroy();
+        enet_deinitialize();
+    }
+
+    Room room;
+    u16 port{};
+};
+
+/// Starts a pool of rooms on the loopback interface for the duration of a test.
+class TestPool {
+public:
+    explicit TestPool(Room::BanList ban_list = {}) {
+        REQUIRE(enet_initialize() == 0);
+        pool.emplace(2, std::make_shared<VerifyUser::NullBackend>(), std::move(ban_list));
+    }
+
+    ~TestPool() {
+        pool.reset();
+        enet_deinitialize();
+    }
+
+    std::shared_ptr<Room> CreateRoom() {
+        auto room = pool->CreateRoom({
+            .name = "Test Room",
+            .bind_address = "127.0.0.1",
+            .port = 0,
+            .max_connections = 16,
+        });
+        REQUIRE(room != nullptr);
+        REQUIRE(room->GetRoomInformation().port != 0);
+        return room;
+    }
+
+    std::optional<RoomPool> pool;
+};
+
+std::vector<u8> LdnPayload(size_t size) {
+    std::vector<u8> payload(size);
+    for (size_t i = 0; i < size; ++i) {
+        payload[i] = static_cast<u8>(i * 7);
+    }
+    return payload;
+}
+
+/// Checks that the room forwards a packet between two new clients.
+void RequireForwarding(const Room& room) {
+    const u16 port = room.GetRoomInformation().port;
+    SyntheticClient sender{"Sender", port};
+    SyntheticClient receiver{"Receiver", port};
+    sender.SendLdnPacket(receiver.fake_ip, false, LdnPayload(100));
+    REQUIRE(receiver.ReceiveType(IdLdnPacket).has_value());
+}
+} // Anonymous namespace
+
+TEST_CASE("RoomBanList: Bans and unbans addresses", "[network]") {
+    RoomBanList ban_list{{{"banned_user"}, {"10.0.0.1"}}};
+    REQUIRE(ban_list.IsUsernameBanned("banned_user"));
+    REQUIRE(ban_list.IsIPBanned("10.0.0.1"));
+    REQUIRE(!ban_list.IsUsernameBanned("10.0.0.1"));
+
+    ban_list.Ban("other_user", "10.0.0.2");
+    ban_list.Ban("", "10.0.0.2");
+    REQUIRE(ban_list.IsUsernameBanned("other_user"));
+    REQUIRE(!ban_list.IsUsernameBanned(""));
+    REQUIRE(ban_list.Get() ==
+            Room::BanList{{"banned_user", "other_user"}, {"10.0.0.1", "10.0.0.2"}});
+
+    REQUIRE(ban_list.Unban("banned_user"));
+    REQUIRE(ban_list.Unban("10.0.0.2"));
+    REQUIRE(!ban_list.Unban("unknown"));
+    REQUIRE(!ban_list.IsUsernameBanned("banned_user"));
+    REQUIRE(!ban_list.IsIPBanned("10.0.0.2"));
+    REQUIRE(ban_list.Get() == Room::BanList{{"other_user"}, {"10.0.0.1"}});
+}
+
+TEST_CASE("Room: Forwards LDN packets unchanged", "[network]") {
+    TestRoom test_room;
+    SyntheticClient sender{"Sender", test_room.port};
+    SyntheticClient receiver{"Receiver", test_room.port};
+    SyntheticClient bystander{"Bystander", test_room.port};
+
+    const auto payload = LdnPayload(1000);
+    Packet expected;
+    expected.Write(static_cast<u8>(IdLdnPacket));
+    expected.Write(static_cast<u8>(0));
+    expected.Write(sender.fake_ip);
+    expected.Write(receiver.fake_ip);
+    expected.Write(false);
+    expected.Write(payload);
+
+    // Unicast reaches only the destination, byte for byte.
+    sender.SendLdnPacket(receiver.fake_ip, false, payload);
+    const auto received = receiver.ReceiveType(IdLdnPacket);
+    REQUIRE(received.has_value());
+    REQUIRE(received->size() == expected.GetDataSize());
+    REQUIRE(std::equal(received->begin(), received->end(),
+                       static_cast<const u8*>(expected.GetData())));
+
+    // Broadcast reaches everyone except the sender.
+    constexpr size_t broadcast_offset = 10;
+    sender.SendLdnPacket(NoPreferredIP, true, payload);
+    const auto receiver_broadcast = receiver.ReceiveType(IdLdnPacket);
+    REQUIRE(receiver_broadcast.has_value());
+    REQUIRE((*receiver_broadcast)[broadcast_offset] == 1);
+    const auto bystander_broadcast = bystander.ReceiveType(IdLdnPacket);
+    REQUIRE(bystander_broadcast.has_value());
+    REQUIRE((*bystander_broadcast)[broadcast_offset] == 1);
+    REQUIRE(sender.DrainLdnPackets() == 0);
+}
+
+TEST_CASE("Room: Forwarding throughput", "[network][.benchmark]") {
+    constexpr size_t num_clients = 8;
+    constexpr size_t packets_per_client = 64;
+
+    TestRoom test_room;
+    std::vector<std::unique_ptr<SyntheticClient>> clients;
+    for (size_t i = 0; i < num_clients; ++i) {
+        clients.push_back(std::make_unique<SyntheticClient>("Client " + std::to_string(i),
+                                                          test_room.port));
+    }
+    const auto payload = LdnPayload(512);
+
+    // Every client broadcasts to all the others, like LDN traffic at game frame rate.
+    BENCHMARK("8 clients broadcasting 64 LDN packets each") {
+        for (size_t packet = 0; packet < packets_per_client; ++packet) {
+            for (auto& client : clients) {
+                client->SendLdnPacket(NoPreferredIP, true, payload);
+            }
+        }
+        const size_t expected = num_clients * (num_clients - 1) * packets_per_client;
+        size_t received = 0;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (received < expected && std::chrono::steady_clock::now() < deadline) {
+            for (auto& client : clients) {
+                received += client->DrainLdnPackets();
+            }
+        }
+        return received;
+    };
+}
+
+TEST_CASE("RoomPool: Services every room until it is destroyed", "[network]") {
+    TestPool test_pool;
+    RoomPool& pool = *test_pool.pool;
+    std::vector<std::shared_ptr<Room>> rooms;
+    for (size_t i = 0; i < 3; ++i) {
+        rooms.push_back(test_pool.CreateRoom());
+    }
+    REQUIRE(pool.GetRooms() == rooms);
+    for (const auto& room : rooms) {
+        RequireForwarding(*room);
+    }
+
+    // The other rooms are still serviced while one is destroyed
+    {
+        SyntheticClient client{"Client", rooms[0]->GetRoomInformation().port};
+        pool.DestroyRoom(rooms[1]);
+        REQUIRE(rooms[1]->GetState() == Room::State::Closed);
+        REQUIRE(rooms[0]->GetRoomMemberList().size() == 1);
+    }
+    REQUIRE(pool.GetRooms() == std::vector{rooms[0], rooms[2]});
+    RequireForwarding(*rooms[0]);
+    RequireForwarding(*rooms[2]);
+
+    pool.Destroy();
+    for (const auto& room : rooms) {
+        REQUIRE(room->GetState() == Room::State::Closed);
+    }
+    REQUIRE(pool.GetRooms().empty());
+    REQUIRE(pool.CreateRoom({.port = 0}) == nullptr);
+}
+
+TEST_CASE("RoomPool: Rooms share the ban list", "[network]") {
+    const Room::BanList ban_list{{"banned_user"}, {"10.0.0.1"}};
+    TestPool test_pool{ban_list};
+    const auto first = test_pool.CreateRoom();
+    const auto second = test_pool.CreateRoom();
+    REQUIRE(first->GetBanList() == ban_list);
+    REQUIRE(second->GetBanList() == ban_list);
+    REQUIRE(test_pool.pool->GetBanList() == ban_list);
+}
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstdint>
+#include <memory_resource>
+#include <regex>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "shader_recompiler/arena.h"
+#include "shader_recompiler/frontend/ir/basic_block.h"
+#include "shader_recompiler/frontend/ir/ir_emitter.h"
+#include "shader_recompiler/frontend/ir/program.h"
+#include "shader_recompiler/ir_opt/passes.h"
+#include "shader_recompiler/object_pool.h"
+
+namespace {
+using Shader::Arena;
+using Shader::ArenaScope;
+
+bool IsAligned(const void* pointer, size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+/// Register accesses over a chain of branches, the SSA rewrite turns them into phis
+class TestProgram {
+public:
+    explicit TestProgram(size_t num_diamonds) {
+        Shader::IR::Block* head = NewBlock();
+        Emit(*head, 0);
+        for (size_t i = 0; i < num_diamonds; ++i) {
+            Shader::IR::Block* const left = NewBlock();
+            Shader::IR::Block* const right = NewBlock();
+            Shader::IR::Block* const join = NewBlock();
+            head->AddBranch(left);
+            head->AddBranch(right);
+            left->AddBranch(join);
+            right->AddBranch(join);
+            Emit(*left, static_cast<u32>(i * 2 + 1));
+            Emit(*right, static_cast<u32>(i * 2 + 2));
+            Emit(*join, 0);
+            head = join;
+        }
+        // Successors are visited before their predecessors in post order
+        for (auto it = program.blocks.rbegin(); it != program.blocks.rend(); ++it) {
+            program.post_order_blocks.push_back(*it);
+        }
+    }
+
+    void RewriteSsa() {
+        Shader::Optimization::SsaRewritePass(program);
+    }
+
+    /// Dumps the program without the addresses of the instructions
+    std::string Dump() const {
+        const std::regex address{R"(\[[0-9a-f]+\] )"};
+        return std::regex_replace(Shader::IR::DumpProgram(program), address, "");
+    }
+
+private:
+    static constexpr size_t NumRegisters = 16;
+
+    Shader::IR::Block* NewBlock() {
+        return program.blocks.emplace_back(block_pool.Create(inst_pool));
+    }
+
+    static void Emit(Shader::IR::Block& block, u32 seed) {
+        Shader::IR::IREmitter ir{block};
+        for (size_t i = 0; i < NumRegisters; ++i) {
+            const Shader::IR::Reg reg = Shader::IR::Reg::R0 + static_cast<int>(i);
+            if (seed == 0) {
+                ir.SetReg(reg, ir.IAdd(ir.GetReg(reg), ir.Imm32(1)));
+            } else if (i % 2 == seed % 2) {
+                ir.SetReg(reg, ir.Imm32(static_cast<u32>(seed * NumRegisters + i)));
+            }
+        }
+    }
+
+    Shader::ObjectPool<Shader::IR::Inst> inst_pool;
+    Shader::ObjectPool<Shader::IR::Block> block_pool;
+    Shader::IR::Program program;
+};
+} // Anonymous namespace
+
+TEST_CASE("Arena: Allocations are aligned and reused after a reset", "[shader_recompiler]") {
+    Arena arena{4096};
+    for (const size_t alignment : {1, 4, 8, 16, 64, 256}) {
+        REQUIRE(IsAligned(arena.allocate(100, alignment), alignment));
+    }
+    // Larger than a block
+    REQUIRE(IsAligned(arena.allocate(10000, 16), 16));
+    REQUIRE(arena.BytesAllocated() == 6 * 100 + 10000);
+
+    // The blocks are squashed into one, which the next allocations share
+    arena.Reset();
+    REQUIRE(arena.BytesAllocated() == 0);
+    void* const first = arena.allocate(100, 16);
+    void* const second = arena.allocate(10000, 16);
+    REQUIRE(static_cast<char*>(second) == static_cast<char*>(first) + 112);
+    arena.Reset();
+    REQUIRE(arena.allocate(100, 16) == first);
+}
+
+TEST_CASE("ArenaScope: Sets the memory resource of the thread", "[shader_recompiler]") {
+    REQUIRE(Arena::Current() == std::pmr::new_delete_resource());
+    Arena outer;
+    Arena inner;
+    {
+        const ArenaScope outer_scope{outer};
+        REQUIRE(Arena::Current() == &outer);
+        {
+            const ArenaScope inner_scope{inner};
+            REQUIRE(Arena::Current() == &inner);
+        }
+        REQUIRE(Arena::Current() == &outer);
+    }
+    REQUIRE(Arena::Current() == std::pmr::new_delete_resource());
+}
+
+TEST_CASE("Arena: SSA rewrite output matches the heap", "[shader_recompiler]") {
+    TestProgram heap_program{8};
+    heap_program.RewriteSsa();
+
+    Arena arena;
+    const ArenaScope arena_scope{arena};
+    TestProgram arena_program{8};
+    arena_program.RewriteSsa();
+    REQUIRE(arena.BytesAllocated() > 0);
+    REQUIRE(arena_program.Dump() == heap_program.Dump());
+}
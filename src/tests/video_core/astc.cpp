@@ -0,0 +1,250 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <bit>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "video_core/textures/astc.h"
+#include "video_core/textures/astc_bit_stream.h"
+
+namespace {
+using namespace Tegra::Texture;
+
+constexpr std::array<std::array<u32, 2>, 14> BLOCK_SIZES{{
+    {4, 4},
+    {5, 4},
+    {5, 5},
+    {6, 5},
+    {6, 6},
+    {8, 5},
+    {8, 6},
+    {8, 8},
+    {10, 5},
+    {10, 6},
+    {10, 8},
+    {10, 10},
+    {12, 10},
+    {12, 12},
+}};
+
+/// Bit length of num_values integers of the given range (ASTC spec, section C.2.12)
+u32 SequenceBitLength(u32 max_value, u32 num_values) {
+    switch (max_value) {
+    case 2:
+    case 5:
+    case 11:
+    case 23: {
+        const u32 bits = max_value == 2 ? 0 : max_value == 5 ? 1 : max_value == 11 ? 2 : 3;
+        return num_values * bits + (num_values * 8 + 4) / 5;
+    }
+    case 4:
+    case 9:
+    case 19: {
+        const u32 bits = max_value == 4 ? 0 : max_value == 9 ? 1 : 2;
+        return num_values * bits + (num_values * 7 + 2) / 3;
+    }
+    default:
+        return num_values * std::bit_width(max_value);
+    }
+}
+
+class BlockWriter {
+public:
+    void Write(u32 offset, u32 num_bits, u32 value) {
+        for (u32 bit = 0; bit < num_bits; ++bit) {
+            const u32 index = offset + bit;
+            data[index / 8] = static_cast<u8>((data[index / 8] & ~(1U << (index % 8))) |
+                                              (((value >> bit) & 1) << (index % 8)));
+        }
+    }
+
+    std::array<u8, 16> data;
+};
+
+/**
+ * Generates a random valid LDR block for the given footprint. Most are single partition and single
+ * plane, the rest covers the block modes left to the generic decoder.
+ */
+std::array<u8, 16> RandomBlock(std::mt19937& rng, u32 block_width, u32 block_height) {
+    static constexpr std::array<u32, 10> LDR_ENDPOINT_MODES{0, 1, 4, 5, 6, 8, 9, 10, 12, 13};
+    BlockWriter block;
+    while (true) {
+        for (u8& value : block.data) {
+            value = static_cast<u8>(rng());
+        }
+        if (rng() % 16 == 0) {
+            // Void extent block with random extents and color.
+            block.Write(0, 12, 0xDFC);
+            return block.data;
+        }
+
+        // Block mode, layouts of table C.2.8 besides the fixed 6x10 and 10x6 grids
+        const u32 r = 2 + rng() % 6;
+        const u32 a = rng() % 4;
+        const u32 b = rng() % 4;
+        const bool high_precision = rng() % 2 != 0;
+        bool dual_plane = rng() % 8 == 0;
+        u32 mode = (r & 1) << 4 | a << 5;
+        u32 grid_width = 0;
+        u32 grid_height = 0;
+        switch (const u32 layout = rng() % 8) {
+        case 0:
+        case 1:
+        case 2:
+        case 3:
+        case 4: {
+            static constexpr std::array<u32, 5> LAYOUT_BITS{0x0, 0x4, 0x8, 0xC, 0x10C};
+            mode |= (r >> 1) | LAYOUT_BITS[layout];
+            const u32 b1 = b & 1;
+            grid_width = std::array<u32, 5>{b + 4, b + 8, a + 2, a + 2, b1 + 2}[layout];
+            grid_height = std::array<u32, 5>{a + 2, a + 2, b + 8, b1 + 6, a + 2}[layout];
+            mode |= (layout < 3 ? b : b1) << 7;
+            break;
+        }
+        case 5:
+        case 6:
+            mode |= (r >> 1) << 2 | (layout == 6 ? 0x80 : 0);
+            grid_width = layout == 5 ? 12 : a + 2;
+            grid_height = layout == 5 ? a + 2 : 12;
+            break;
+        default:
+            mode |= (r >> 1) << 2 | 0x100 | b << 9;
+            grid_width = a + 6;
+            grid_height = b + 6;
+            dual_plane = false;
+            break;
+        }
+        const bool extended_layout = (mode & 0x100) != 0 && (mode & 3) == 0;
+        if (!extended_layout) {
+            mode |= (high_precision ? 0x200 : 0) | (dual_plane ? 0x400 : 0);
+        }
+        const u32 max_weight =
+            (high_precision && !extended_layout ? std::array<u32, 6>{9, 11, 15, 19, 23, 31}
+                                                : std::array<u32, 6>{1, 2, 3, 4, 5, 7})[r - 2];
+        const u32 num_weights = grid_width * grid_height * (dual_plane ? 2 : 1);
+        const u32 weight_bits = SequenceBitLength(max_weight, num_weights);
+        if (grid_width > block_width || grid_height > block_height || weight_bits < 24 ||
+            weight_bits > 96) {
+            continue;
+        }
+
+        const u32 num_partitions = rng() % 4 == 0 ? 2 + rng() % 2 : 1;
+        const u32 endpoint_mode = LDR_ENDPOINT_MODES[rng() % LDR_ENDPOINT_MODES.size()];
+        const u32 num_values = num_partitions * ((endpoint_mode >> 2) + 1) * 2;
+        const u32 header_bits = num_partitions == 1 ? 17 : 29;
+        const s32 color_bits = 128 - static_cast<s32>(header_bits + weight_bits) -
+                               (dual_plane ? 2 : 0);
+        // Endpoints need at least six quantization levels.
+        if (color_bits < static_cast<s32>(SequenceBitLength(5, num_values))) {
+            continue;
+        }
+        block.Write(0, 11, mode);
+        block.Write(11, 2, num_partitions - 1);
+        if (num_partitions == 1) {
+            block.Write(13, 4, endpoint_mode);
+        } else {
+            // Keep the random partition index, all partitions share the endpoint mode.
+            block.Write(23, 6, endpoint_mode << 2);
+        }
+        return block.data;
+    }
+}
+
+std::vector<u8> MakeCorpus(size_t num_blocks, u32 block_width, u32 block_height) {
+    std::mt19937 rng{block_width * 16 + block_height};
+    std::vector<u8> corpus;
+    corpus.reserve(num_blocks * 16);
+    for (size_t block = 0; block < num_blocks; ++block) {
+        const auto data = RandomBlock(rng, block_width, block_height);
+        corpus.insert(corpus.end(), data.begin(), data.end());
+    }
+    return corpus;
+}
+
+std::vector<u8> Decode(bool use_fast_paths, std::span<const u8> corpus, u32 width, u32 height,
+                       u32 block_width, u32 block_height) {
+    std::vector<u8> output(width * height * 4);
+    if (use_fast_paths) {
+        ASTC::Decompress(corpus, width, height, 1, block_width, block_height, output);
+    } else {
+        ASTC::DecompressGeneric(corpus, width, height, 1, block_width, block_height, output);
+    }
+    return output;
+}
+
+/// Reads bits one at a time, like InputBitStream::ReadBits used to
+u32 ReadBitsOneByOne(ASTC::InputBitStream& stream, size_t num_bits) {
+    u32 value = 0;
+    for (size_t i = 0; i < num_bits; ++i) {
+        value |= (stream.ReadBit() ? 1U : 0U) << i;
+    }
+    return value;
+}
+} // Anonymous namespace
+
+TEST_CASE("ASTC: Reading several bits matches reading them one by one", "[video_core]") {
+    std::mt19937 rng{1234};
+    std::array<u8, 16> data;
+    for (size_t round = 0; round < 1000; ++round) {
+        for (u8& byte : data) {
+            byte = static_cast<u8>(rng());
+        }
+        // Start at a random offset, then read random widths until past the end of the block
+        ASTC::InputBitStream stream{data};
+        ASTC::InputBitStream reference{data};
+        const size_t offset = rng() % (data.size() * 8);
+        for (size_t skipped = 0; skipped < offset; ++skipped) {
+            stream.ReadBit();
+        }
+        (void)ReadBitsOneByOne(reference, offset);
+        for (size_t bits_requested = offset; bits_requested < data.size() * 8 + 40;) {
+            const size_t num_bits = rng() % 33;
+            REQUIRE(stream.ReadBits(num_bits) == ReadBitsOneByOne(reference, num_bits));
+            REQUIRE(stream.GetBitsRead() == reference.GetBitsRead());
+            bits_requested += num_bits;
+        }
+        REQUIRE(stream.ReadBits<7>() == ReadBitsOneByOne(reference, 7));
+    }
+}
+
+TEST_CASE("ASTC: Fast paths match the generic decoder", "[video_core]") {
+    constexpr u32 blocks_per_row = 64;
+    constexpr u32 rows = 64;
+    for (const auto [block_width, block_height] : BLOCK_SIZES) {
+        const auto corpus = MakeCorpus(blocks_per_row * rows, block_width, block_height);
+        const u32 width = blocks_per_row * block_width;
+        const u32 height = rows * block_height;
+        const auto generic = Decode(false, corpus, width, height, block_width, block_height);
+        const auto fast = Decode(true, corpus, width, height, block_width, block_height);
+        INFO("Block size " << block_width << "x" << block_height);
+        REQUIRE(fast == generic);
+    }
+}
+
+TEST_CASE("ASTC: Benchmark", "[video_core][.benchmark]") {
+    constexpr u32 size = 1024;
+    for (const auto [block_width, block_height] :
+         {std::array<u32, 2>{4, 4}, {8, 8}, {12, 12}}) {
+        const u32 cols = (size + block_width - 1) / block_width;
+        const u32 rows = (size + block_height - 1) / block_height;
+        const auto corpus = MakeCorpus(cols * rows, block_width, block_height);
+        std::vector<u8> output(size * size * 4);
+
+        const std::string name = std::to_string(block_width) + "x" + std::to_string(block_height);
+        BENCHMARK("Generic " + name) {
+            ASTC::DecompressGeneric(corpus, size, size, 1, block_width, block_height, output);
+            return output[0];
+        };
+        BENCHMARK("Fast paths " + name) {
+            ASTC::Decompress(corpus, size, size, 1, block_width, block_height, output);
+            return output[0];
+        };
+    }
+}
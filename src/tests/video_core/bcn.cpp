@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <bc_decoder.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "video_core/textures/bcn.h"
+
+namespace {
+using namespace Tegra::Texture;
+
+constexpr u32 SIZE = 256;
+
+/// RGBA8 image with smooth gradients, noisy gradients, hard edges and flat areas, one per quadrant
+std::vector<u8> MakeImage(u32 width, u32 height) {
+    std::mt19937 rng{1234};
+    std::uniform_int_distribution<int> noise{-24, 24};
+    const auto clamp = [](int value) { return static_cast<u8>(std::clamp(value, 0, 255)); };
+    std::vector<u8> image(width * height * 4);
+    for (u32 y = 0; y < height; ++y) {
+        for (u32 x = 0; x < width; ++x) {
+            const int u = static_cast<int>(x * 255 / width);
+            const int v = static_cast<int>(y * 255 / height);
+            const bool right = x >= width / 2;
+            const bool bottom = y >= height / 2;
+            std::array<int, 3> color;
+            if (!right && !bottom) {
+                color = {u, v, 255 - (u + v) / 2};
+            } else if (right && !bottom) {
+                color = {v + noise(rng), u + noise(rng), 128 + noise(rng)};
+            } else if (!right) {
+                const bool stripe = ((x / 3) + (y / 5)) % 2 == 0;
+                color = stripe ? std::array{230, 40, 30} : std::array{20, 60, 200};
+            } else {
+                color = {90, 160, 70};
+            }
+            u8* const texel = &image[(y * width + x) * 4];
+            for (size_t channel = 0; channel < 3; ++channel) {
+                texel[channel] = clamp(color[channel]);
+            }
+            texel[3] = static_cast<u8>((x + y) * 255 / (width + height));
+        }
+    }
+    return image;
+}
+
+std::vector<u8> WithOpaqueAlpha(std::vector<u8> image) {
+    for (size_t i = 3; i < image.size(); i += 4) {
+        image[i] = 255;
+    }
+    return image;
+}
+
+std::vector<u8> Decode(bool bc3, const std::vector<u8>& blocks, u32 width, u32 height) {
+    const size_t block_size = bc3 ? 16 : 8;
+    std::vector<u8> image(width * height * 4);
+    size_t offset = 0;
+    for (u32 y = 0; y < height; y += 4) {
+        for (u32 x = 0; x < width; x += 4) {
+            u8* const dst = &image[(y * width + x) * 4];
+            if (bc3) {
+                bcn::DecodeBc3(&blocks[offset], dst, x, y, width, height);
+            } else {
+                bcn::DecodeBc1(&blocks[offset], dst, x, y, width, height);
+            }
+            offset += block_size;
+        }
+    }
+    return image;
+}
+
+double PSNR(const std::vector<u8>& a, const std::vector<u8>& b) {
+    double squared_error = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        const double difference = static_cast<double>(a[i]) - static_cast<double>(b[i]);
+        squared_error += difference * difference;
+    }
+    const double mse = squared_error / static_cast<double>(a.size());
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+size_t CompressedSize(bool bc3, u32 width, u32 height) {
+    return ((width + 3) / 4) * ((height + 3) / 4) * (bc3 ? 16 : 8);
+}
+
+std::vector<u8> Compress(bool bc3, const std::vector<u8>& image, u32 width, u32 height,
+                         BCN::Quality quality) {
+    std::vector<u8> blocks(CompressedSize(bc3, width, height));
+    if (bc3) {
+        BCN::CompressBC3(image, width, height, 1, blocks, quality);
+    } else {
+        BCN::CompressBC1(image, width, height, 1, blocks, quality);
+    }
+    return blocks;
+}
+
+std::vector<u8> CompressReference(bool bc3, const std::vector<u8>& image, u32 width, u32 height) {
+    std::vector<u8> blocks(CompressedSize(bc3, width, height));
+    if (bc3) {
+        BCN::CompressBC3Reference(image, width, height, 1, blocks);
+    } else {
+        BCN::CompressBC1Reference(image, width, height, 1, blocks);
+    }
+    return blocks;
+}
+} // Anonymous namespace
+
+TEST_CASE("BCN: Quality is close to stb_dxt", "[video_core]") {
+    for (const bool bc3 : {false, true}) {
+        const std::vector<u8> image =
+            bc3 ? MakeImage(SIZE, SIZE) : WithOpaqueAlpha(MakeImage(SIZE, SIZE));
+        const auto psnr = [&](const std::vector<u8>& blocks) {
+            return PSNR(image, Decode(bc3, blocks, SIZE, SIZE));
+        };
+        const double reference = psnr(CompressReference(bc3, image, SIZE, SIZE));
+        const double high = psnr(Compress(bc3, image, SIZE, SIZE, BCN::Quality::High));
+        const double fast = psnr(Compress(bc3, image, SIZE, SIZE, BCN::Quality::Fast));
+        INFO((bc3 ? "BC3" : "BC1") << ": stb_dxt " << reference << " dB, high " << high
+                                   << " dB, fast " << fast << " dB");
+        REQUIRE(high >= reference - 0.1);
+        REQUIRE(fast >= reference - 0.5);
+    }
+}
+
+TEST_CASE("BCN: Flat images keep their color", "[video_core]") {
+    // Odd sizes cover the blocks crossing the edges of the image
+    constexpr u32 width = 13;
+    constexpr u32 height = 7;
+    for (const BCN::Quality quality : {BCN::Quality::Fast, BCN::Quality::High}) {
+        for (const bool bc3 : {false, true}) {
+            std::vector<u8> image(width * height * 4);
+            for (size_t i = 0; i < image.size(); i += 4) {
+                image[i + 0] = 200;
+                image[i + 1] = 100;
+                image[i + 2] = 50;
+                image[i + 3] = bc3 ? 77 : 255;
+            }
+            const auto decoded = Decode(bc3, Compress(bc3, image, width, height, quality), width,
+                                        height);
+            // Not every 8-bit value is the interpolant of two endpoints
+            for (size_t i = 0; i < image.size(); ++i) {
+                REQUIRE(std::abs(decoded[i] - image[i]) <= 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("BCN: BC1 keeps transparent texels", "[video_core]") {
+    std::vector<u8> image = WithOpaqueAlpha(MakeImage(SIZE, SIZE));
+    for (u32 y = 0; y < SIZE; y += 3) {
+        image[(y * SIZE + y) * 4 + 3] = 0;
+    }
+    const auto decoded =
+        Decode(false, Compress(false, image, SIZE, SIZE, BCN::Quality::High), SIZE, SIZE);
+    for (size_t i = 3; i < image.size(); i += 4) {
+        REQUIRE((decoded[i] == 0) == (image[i] == 0));
+    }
+}
+
+TEST_CASE("BCN: Benchmark", "[video_core][.benchmark]") {
+    constexpr u32 size = 1024;
+    for (const bool bc3 : {false, true}) {
+        const std::vector<u8> image =
+            bc3 ? MakeImage(size, size) : WithOpaqueAlpha(MakeImage(size, size));
+        std::vector<u8> blocks(CompressedSize(bc3, size, size));
+        const std::string name = bc3 ? "BC3" : "BC1";
+        BENCHMARK("stb_dxt " + name) {
+            if (bc3) {
+                BCN::CompressBC3Reference(image, size, size, 1, blocks);
+            } else {
+                BCN::CompressBC1Reference(image, size, size, 1, blocks);
+            }
+            return blocks[0];
+        };
+        for (const auto& [quality, quality_name] :
+             {std::pair{BCN::Quality::Fast, "fast"}, std::pair{BCN::Quality::High, "high"}}) {
+            BENCHMARK(name + " " + quality_name) {
+                if (bc3) {
+                    BCN::CompressBC3(image, size, size, 1, blocks, quality);
+                } else {
+                    BCN::CompressBC1(image, size, size, 1, blocks, quality);
+                }
+                return blocks[0];
+            };
+        }
+    }
+}
@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "video_core/dma_pusher.h"
+
+namespace {
+using Tegra::CommandHeader;
+using Tegra::DmaPusher;
+using Tegra::SubmissionMode;
+
+struct Call {
+    u32 method;
+    u32 subchannel;
+    u32 argument;
+
+    bool operator==(const Call&) const = default;
+};
+
+CommandHeader MakeHeader(SubmissionMode mode, u32 method, u32 subchannel, u32 count) {
+    CommandHeader header{};
+    header.method.Assign(method);
+    header.subchannel.Assign(subchannel);
+    header.method_count.Assign(count);
+    header.mode.Assign(mode);
+    return header;
+}
+
+/// Pushbuffer with every submission mode, with methods split across segment boundaries
+std::vector<CommandHeader> MakeCommands(size_t num_words) {
+    std::mt19937 rng{1234};
+    std::uniform_int_distribution<u32> mode_distribution{0, 3};
+    std::uniform_int_distribution<u32> method_distribution{0x40, 0x1000};
+    std::uniform_int_distribution<u32> subchannel_distribution{0, 7};
+    std::uniform_int_distribution<u32> count_distribution{1, 40};
+    std::vector<CommandHeader> commands;
+    while (commands.size() < num_words) {
+        const u32 method = method_distribution(rng);
+        const u32 subchannel = subchannel_distribution(rng);
+        const u32 count = count_distribution(rng);
+        constexpr std::array modes{SubmissionMode::Increasing, SubmissionMode::NonIncreasing,
+                                   SubmissionMode::Inline, SubmissionMode::IncreaseOnce};
+        const SubmissionMode mode = modes[mode_distribution(rng)];
+        commands.push_back(MakeHeader(mode, method, subchannel, count));
+        if (mode == SubmissionMode::Inline) {
+            continue;
+        }
+        for (u32 i = 0; i < count; ++i) {
+            commands.push_back(CommandHeader{.argument = static_cast<u32>(rng())});
+        }
+    }
+    commands.resize(num_words);
+    return commands;
+}
+
+/// Method calls of the commands, as they were made before decoding and execution were split
+std::vector<Call> Interpret(std::span<const CommandHeader> commands) {
+    std::vector<Call> calls;
+    u32 method = 0;
+    u32 subchannel = 0;
+    u32 method_count = 0;
+    bool non_incrementing = false;
+    bool increment_once = false;
+    for (const CommandHeader& command : commands) {
+        if (method_count) {
+            calls.push_back({method, subchannel, command.argument});
+            if (!non_incrementing) {
+                method++;
+            }
+            if (increment_once) {
+                non_incrementing = true;
+            }
+            method_count--;
+            continue;
+        }
+        switch (command.mode) {
+        case SubmissionMode::Increasing:
+        case SubmissionMode::NonIncreasing:
+        case SubmissionMode::IncreaseOnce:
+            method = command.method;
+            subchannel = command.subchannel;
+            method_count = command.method_count;
+            non_incrementing = command.mode == SubmissionMode::NonIncreasing;
+            increment_once = command.mode == SubmissionMode::IncreaseOnce;
+            break;
+        case SubmissionMode::Inline:
+            calls.push_back({command.method, command.subchannel, command.arg_count});
+            method = command.method;
+            subchannel = command.subchannel;
+            non_incrementing = true;
+            increment_once = false;
+            break;
+        default:
+            break;
+        }
+    }
+    return calls;
+}
+
+/// Method calls of decoded batches, as they are executed by the pusher
+void Expand(std::span<const CommandHeader> commands,
+            std::span<const DmaPusher::MethodBatch> batches, std::vector<Call>& calls) {
+    for (const DmaPusher::MethodBatch& batch : batches) {
+        for (u32 i = 0; i < batch.num_arguments; ++i) {
+            const CommandHeader& command = commands[batch.first_argument + i];
+            switch (batch.mode) {
+            case DmaPusher::BatchMode::Increasing:
+                calls.push_back({batch.method + i, batch.subchannel, command.argument});
+                break;
+            case DmaPusher::BatchMode::NonIncreasing:
+                calls.push_back({batch.method, batch.subchannel, command.argument});
+                break;
+            case DmaPusher::BatchMode::Inline:
+                calls.push_back({batch.method, batch.subchannel, command.arg_count});
+                break;
+            }
+        }
+    }
+}
+} // Anonymous namespace
+
+TEST_CASE("DmaPusher: Decoded segments make the same calls as the whole pushbuffer",
+          "[video_core]") {
+    const std::vector<CommandHeader> commands = MakeCommands(2000);
+    const std::vector<Call> expected = Interpret(commands);
+
+    // Split the pushbuffer in segments of every size, the decoder state carries the methods
+    // that continue in the next segment
+    for (size_t segment_size = 1; segment_size <= commands.size(); segment_size += 37) {
+        DmaPusher::DecodeState state{};
+        std::vector<DmaPusher::MethodBatch> batches;
+        std::vector<Call> calls;
+        for (size_t offset = 0; offset < commands.size(); offset += segment_size) {
+            const size_t size = std::min(segment_size, commands.size() - offset);
+            const std::span<const CommandHeader> segment =
+                std::span(commands).subspan(offset, size);
+            batches.clear();
+            DmaPusher::DecodeCommands(segment, state, batches);
+            Expand(segment, batches, calls);
+        }
+        REQUIRE(calls == expected);
+    }
+}
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <memory>
+#include <thread>
+#include <variant>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "video_core/dma_pusher.h"
+#include "video_core/gpu_thread.h"
+
+namespace {
+using namespace VideoCommon::GPUThread;
+
+Tegra::CommandList MakeCommandList(size_t num_entries, u64 seed) {
+    Tegra::CommandList list(num_entries);
+    for (size_t i = 0; i < num_entries; ++i) {
+        list.command_lists[i].raw = seed * 0x10000 + i;
+    }
+    return list;
+}
+
+bool HasEntries(const Tegra::CommandList& list, size_t num_entries, u64 seed) {
+    if (list.command_lists.size() != num_entries || !list.prefetch_command_list.empty()) {
+        return false;
+    }
+    for (size_t i = 0; i < num_entries; ++i) {
+        if (list.command_lists[i].raw != seed * 0x10000 + i) {
+            return false;
+        }
+    }
+    return true;
+}
+} // Anonymous namespace
+
+TEST_CASE("GPUThread::CommandQueue: Round trips commands and lists", "[video_core]") {
+    auto queue = std::make_unique<CommandQueue>();
+    queue->PushList(3, MakeCommandList(5, 1), 1, false);
+    queue->Push(GPUTickCommand{}, 2, true);
+
+    Tegra::CommandList prefetch{boost::container::small_vector<Tegra::CommandHeader, 512>(3)};
+    prefetch.prefetch_command_list[0].argument = 0x11;
+    prefetch.prefetch_command_list[1].argument = 0x22;
+    prefetch.prefetch_command_list[2].argument = 0x33;
+    queue->PushList(4, std::move(prefetch), 3, false);
+
+    std::stop_source stop_source;
+    CommandDataContainer* command = queue->Front(stop_source.get_token());
+    REQUIRE(command->fence == 1);
+    auto* submit_list = std::get_if<SubmitListCommand>(&command->data);
+    REQUIRE(submit_list != nullptr);
+    REQUIRE(submit_list->channel == 3);
+    REQUIRE(HasEntries(queue->TakeCommandList(*submit_list), 5, 1));
+    queue->Pop();
+
+    command = queue->Front(stop_source.get_token());
+    REQUIRE(command->fence == 2);
+    REQUIRE(command->block);
+    REQUIRE(std::holds_alternative<GPUTickCommand>(command->data));
+    queue->Pop();
+
+    command = queue->Front(stop_source.get_token());
+    submit_list = std::get_if<SubmitListCommand>(&command->data);
+    REQUIRE(submit_list != nullptr);
+    const Tegra::CommandList list = queue->TakeCommandList(*submit_list);
+    REQUIRE(list.command_lists.empty());
+    REQUIRE(list.prefetch_command_list.size() == 3);
+    REQUIRE(list.prefetch_command_list[2].argument == 0x33);
+    queue->Pop();
+
+    const CommandQueueStatistics statistics = queue->GetStatistics();
+    REQUIRE(statistics.pushed_commands == 3);
+    REQUIRE(statistics.max_queued_commands == 3);
+    REQUIRE(statistics.producer_stalls == 0);
+
+    // An empty queue returns nothing once stopped.
+    stop_source.request_stop();
+    REQUIRE(queue->Front(stop_source.get_token()) == nullptr);
+}
+
+TEST_CASE("GPUThread::CommandQueue: Heap allocates lists larger than the ring", "[video_core]") {
+    auto queue = std::make_unique<CommandQueue>();
+    const size_t num_entries = CommandQueue::EntryCapacity + 1;
+    queue->PushList(0, MakeCommandList(num_entries, 2), 1, false);
+    queue->PushList(0, MakeCommandList(7, 3), 2, false);
+    REQUIRE(queue->GetStatistics().oversized_lists == 1);
+
+    std::stop_source stop_source;
+    for (const auto& [size, seed] : {std::pair{num_entries, 2}, std::pair{size_t{7}, 3}}) {
+        CommandDataContainer* const command = queue->Front(stop_source.get_token());
+        auto* const submit_list = std::get_if<SubmitListCommand>(&command->data);
+        REQUIRE(submit_list != nullptr);
+        REQUIRE(HasEntries(queue->TakeCommandList(*submit_list), size, seed));
+        queue->Pop();
+    }
+}
+
+TEST_CASE("GPUThread::CommandQueue: Producer waits for the consumer", "[video_core]") {
+    // Enough lists to wrap the entry ring several times and fill the command ring.
+    constexpr size_t num_lists = CommandQueue::CommandCapacity * 4;
+    constexpr size_t entries_per_list = 100;
+
+    auto queue = std::make_unique<CommandQueue>();
+    std::jthread producer([&queue] {
+        for (size_t i = 0; i < num_lists; ++i) {
+            queue->PushList(0, MakeCommandList(entries_per_list, i), i + 1, false);
+        }
+    });
+
+    std::stop_source stop_source;
+    for (size_t i = 0; i < num_lists; ++i) {
+        CommandDataContainer* const command = queue->Front(stop_source.get_token());
+        REQUIRE(command->fence == i + 1);
+        auto* const submit_list = std::get_if<SubmitListCommand>(&command->data);
+        REQUIRE(submit_list != nullptr);
+        REQUIRE(HasEntries(queue->TakeCommandList(*submit_list), entries_per_list, i));
+        queue->Pop();
+    }
+    producer.join();
+
+    const CommandQueueStatistics statistics = queue->GetStatistics();
+    REQUIRE(statistics.pushed_commands == num_lists);
+    REQUIRE(statistics.max_queued_commands <= CommandQueue::CommandCapacity);
+}
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <filesystem>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "video_core/shader_translation_cache.h"
+
+namespace {
+using VideoCommon::ShaderTranslationCache;
+using VideoCommon::TranslatedShader;
+
+constexpr u32 CACHE_VERSION = 1;
+constexpr u64 PROFILE_HASH = 0x1234;
+
+class TemporaryFile {
+public:
+    TemporaryFile() : path{std::filesystem::temp_directory_path() / "translation_cache_test.bin"} {
+        Common::FS::RemoveFile(path);
+    }
+    ~TemporaryFile() {
+        Common::FS::RemoveFile(path);
+    }
+
+    std::filesystem::path path;
+};
+
+std::vector<TranslatedShader> MakeShaders(u32 seed) {
+    std::vector<TranslatedShader> shaders(2);
+    for (u32 i = 0; i < 2; ++i) {
+        TranslatedShader& shader = shaders[i];
+        shader.stage_index = i;
+        shader.code = {seed, seed + i, 0x07230203};
+        shader.info.uses_fp16 = true;
+        shader.info.constant_buffer_mask = seed;
+        shader.info.nvn_buffer_used.set(3);
+        shader.info.loads.mask.set(500);
+        shader.info.legacy_stores_mapping.emplace(Shader::IR::Attribute::ColorFrontDiffuseR,
+                                                  Shader::IR::Attribute::Generic0X);
+        shader.info.constant_buffer_descriptors.push_back({.index = seed, .count = 1});
+        shader.info.texture_descriptors.push_back({.cbuf_index = 1, .cbuf_offset = seed * 4});
+    }
+    return shaders;
+}
+
+bool Matches(const std::vector<TranslatedShader>& shaders, u32 seed) {
+    const std::vector<TranslatedShader> expected = MakeShaders(seed);
+    if (shaders.size() != expected.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < shaders.size(); ++i) {
+        const Shader::Info& info = shaders[i].info;
+        const Shader::Info& expected_info = expected[i].info;
+        if (shaders[i].stage_index != expected[i].stage_index ||
+            shaders[i].code != expected[i].code || info.uses_fp16 != expected_info.uses_fp16 ||
+            info.constant_buffer_mask != expected_info.constant_buffer_mask ||
+            info.nvn_buffer_used != expected_info.nvn_buffer_used ||
+            info.loads.mask != expected_info.loads.mask ||
+            info.legacy_stores_mapping != expected_info.legacy_stores_mapping ||
+            info.constant_buffer_descriptors != expected_info.constant_buffer_descriptors ||
+            info.texture_descriptors != expected_info.texture_descriptors) {
+            return false;
+        }
+    }
+    return true;
+}
+} // Anonymous namespace
+
+TEST_CASE("ShaderTranslationCache: Round trips stored shaders", "[video_core]") {
+    const TemporaryFile file;
+    {
+        ShaderTranslationCache cache{file.path, CACHE_VERSION, PROFILE_HASH};
+        REQUIRE(!cache.Find(1, 2));
+        cache.Store(1, 2, MakeShaders(10));
+        cache.Store(3, 4, MakeShaders(20));
+    }
+    ShaderTranslationCache cache{file.path, CACHE_VERSION, PROFILE_HASH};
+    const auto first = cache.Find(1, 2);
+    REQUIRE(first);
+    REQUIRE(Matches(*first, 10));
+    const auto second = cache.Find(3, 4);
+    REQUIRE(second);
+    REQUIRE(Matches(*second, 20));
+    REQUIRE(!cache.Find(1, 4));
+
+    const ShaderTranslationCache::Statistics statistics = cache.GetStatistics();
+    REQUIRE(statistics.lookups == 3);
+    REQUIRE(statistics.hits == 2);
+    REQUIRE(statistics.loaded_entries == 2);
+}
+
+TEST_CASE("ShaderTranslationCache: Discards files of other profiles", "[video_core]") {
+    const TemporaryFile file;
+    {
+        ShaderTranslationCache cache{file.path, CACHE_VERSION, PROFILE_HASH};
+        cache.Store(1, 2, MakeShaders(10));
+    }
+    {
+        ShaderTranslationCache cache{file.path, CACHE_VERSION, PROFILE_HASH + 1};
+        REQUIRE(!cache.Find(1, 2));
+    }
+    ShaderTranslationCache cache{file.path, CACHE_VERSION + 1, PROFILE_HASH + 1};
+    REQUIRE(!cache.Find(1, 2));
+}
+
+TEST_CASE("ShaderTranslationCache: Keeps the records before a corrupted tail", "[video_core]") {
+    const TemporaryFile file;
+    {
+        ShaderTranslationCache cache{file.path, CACHE_VERSION, PROFILE_HASH};
+        cache.Store(1, 2, MakeShaders(10));
+        cache.Store(3, 4, MakeShaders(20));
+    }
+    {
+        // Simulate a write interrupted in the middle of the last record.
+        const u64 size = Common::FS::GetSize(file.path);
+        Common::FS::IOFile io{file.path, Common::FS::FileAccessMode::ReadWrite,
+                              Common::FS::FileType::BinaryFile};
+        REQUIRE(io.SetSize(size - 8));
+    }
+    {
+        ShaderTranslationCache cache{file.path, CACHE_VERSION, PROFILE_HASH};
+        REQUIRE(cache.Find(1, 2));
+        REQUIRE(!cache.Find(3, 4));
+        cache.Store(3, 4, MakeShaders(30));
+    }
+    // The tail was compacted away, the record stored after it has to be readable.
+    ShaderTranslationCache cache{file.path, CACHE_VERSION, PROFILE_HASH};
+    const auto first = cache.Find(1, 2);
+    REQUIRE(first);
+    REQUIRE(Matches(*first, 10));
+    const auto second = cache.Find(3, 4);
+    REQUIRE(second);
+    REQUIRE(Matches(*second, 30));
+}
@@ -0,0 +1,185 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "video_core/engines/sw_blitter/converter.h"
+#include "video_core/engines/sw_blitter/scaler.h"
+
+namespace {
+using namespace Tegra::Engines::Blitter;
+using Tegra::RenderTargetFormat;
+
+std::vector<u8> MakeImage(u32 width, u32 height, size_t bytes_per_pixel) {
+    std::mt19937 rng{4321};
+    std::uniform_int_distribution<int> distribution{0, 255};
+    std::vector<u8> image(width * height * bytes_per_pixel);
+    for (u8& value : image) {
+        value = static_cast<u8>(distribution(rng));
+    }
+    return image;
+}
+
+std::vector<f32> ToFloat(const std::vector<u8>& image) {
+    std::vector<f32> result(image.size());
+    for (size_t i = 0; i < image.size(); ++i) {
+        result[i] = static_cast<f32>(image[i]) / 255.0f;
+    }
+    return result;
+}
+} // Anonymous namespace
+
+TEST_CASE("SwBlitter: Nearest neighbor picks the pixel under each output pixel", "[video_core]") {
+    constexpr u32 src_width = 4;
+    constexpr u32 src_height = 3;
+    std::vector<u32> src(src_width * src_height);
+    for (u32 i = 0; i < src.size(); ++i) {
+        src[i] = i;
+    }
+    std::vector<u32> dst(2 * 2);
+    NearestNeighbor({reinterpret_cast<const u8*>(src.data()), src.size() * sizeof(u32)},
+                    {reinterpret_cast<u8*>(dst.data()), dst.size() * sizeof(u32)}, src_width,
+                    src_height, 2, 2, sizeof(u32));
+    // Rows advance by 1.5 source rows, columns by 2 source columns
+    REQUIRE(dst == std::vector<u32>{0, 2, 4, 6});
+
+    std::vector<u32> upscaled(8 * 6);
+    NearestNeighbor({reinterpret_cast<const u8*>(src.data()), src.size() * sizeof(u32)},
+                    {reinterpret_cast<u8*>(upscaled.data()), upscaled.size() * sizeof(u32)},
+                    src_width, src_height, 8, 6, sizeof(u32));
+    for (u32 y = 0; y < 6; ++y) {
+        for (u32 x = 0; x < 8; ++x) {
+            REQUIRE(upscaled[y * 8 + x] == src[(y / 2) * src_width + x / 2]);
+        }
+    }
+}
+
+TEST_CASE("SwBlitter: Bilinear interpolates between the source pixels", "[video_core]") {
+    // 2x2 to 3x3 keeps the corners and places the other pixels halfway between them
+    const std::vector<f32> src{
+        0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.5f, 0.0f, 1.0f,
+        0.0f, 1.0f, 0.0f, 0.5f, 1.0f, 1.0f, 1.0f, 1.0f,
+    };
+    std::vector<f32> dst(3 * 3 * IR_COMPONENTS);
+    Bilinear(src, dst, 2, 2, 3, 3);
+    const auto pixel = [&](u32 x, u32 y) {
+        const f32* const value = &dst[(y * 3 + x) * IR_COMPONENTS];
+        return std::array{value[0], value[1], value[2], value[3]};
+    };
+    REQUIRE(pixel(0, 0) == std::array{0.0f, 0.0f, 0.0f, 0.0f});
+    REQUIRE(pixel(2, 0) == std::array{1.0f, 0.5f, 0.0f, 1.0f});
+    REQUIRE(pixel(2, 2) == std::array{1.0f, 1.0f, 1.0f, 1.0f});
+    REQUIRE(pixel(1, 0) == std::array{0.5f, 0.25f, 0.0f, 0.5f});
+    REQUIRE(pixel(1, 1) == std::array{0.5f, 0.625f, 0.25f, 0.625f});
+}
+
+TEST_CASE("SwBlitter: 8-bit bilinear matches the floating point filter", "[video_core]") {
+    constexpr u32 src_width = 37;
+    constexpr u32 src_height = 23;
+    constexpr u32 dst_width = 61;
+    constexpr u32 dst_height = 17;
+    for (const size_t bytes_per_pixel : {size_t{1}, size_t{2}, size_t{4}}) {
+        const std::vector<u8> src = MakeImage(src_width, src_height, bytes_per_pixel);
+        std::vector<u8> dst(dst_width * dst_height * bytes_per_pixel);
+        BilinearUnorm8(src, dst, src_width, src_height, dst_width, dst_height, bytes_per_pixel);
+
+        // Filter each component on its own in the intermediate representation
+        for (size_t component = 0; component < bytes_per_pixel; ++component) {
+            std::vector<f32> src_ir(src_width * src_height * IR_COMPONENTS);
+            for (size_t i = 0; i < src_width * src_height; ++i) {
+                src_ir[i * IR_COMPONENTS] = src[i * bytes_per_pixel + component];
+            }
+            std::vector<f32> dst_ir(dst_width * dst_height * IR_COMPONENTS);
+            Bilinear(src_ir, dst_ir, src_width, src_height, dst_width, dst_height);
+            for (size_t i = 0; i < dst_width * dst_height; ++i) {
+                const f32 expected = dst_ir[i * IR_COMPONENTS];
+                const f32 value = dst[i * bytes_per_pixel + component];
+                // Weights have 7 fractional bits
+                REQUIRE(std::abs(value - expected) <= 2.0f);
+            }
+        }
+    }
+}
+
+TEST_CASE("SwBlitter: 8-bit converters keep the generic conversion", "[video_core]") {
+    ConverterFactory factory;
+    std::vector<u8> pixels(19 * 4);
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        pixels[i] = static_cast<u8>(i * 13 + 7);
+    }
+    std::vector<f32> ir(19 * IR_COMPONENTS);
+
+    SECTION("A8B8G8R8_UNORM") {
+        Converter* const converter = factory.GetFormatConverter(RenderTargetFormat::A8B8G8R8_UNORM);
+        converter->ConvertTo(pixels, ir);
+        // The first byte is alpha, the last one is red
+        for (size_t i = 0; i < 19; ++i) {
+            REQUIRE(ir[i * 4 + 0] == static_cast<f32>(pixels[i * 4 + 3]) / 255.0f);
+            REQUIRE(ir[i * 4 + 1] == static_cast<f32>(pixels[i * 4 + 2]) / 255.0f);
+            REQUIRE(ir[i * 4 + 2] == static_cast<f32>(pixels[i * 4 + 1]) / 255.0f);
+            REQUIRE(ir[i * 4 + 3] == static_cast<f32>(pixels[i * 4 + 0]) / 255.0f);
+        }
+        const std::vector<f32> input = ToFloat(MakeImage(19, 1, IR_COMPONENTS));
+        std::vector<u8> result(pixels.size());
+        converter->ConvertFrom(input, result);
+        for (size_t i = 0; i < 19; ++i) {
+            for (size_t byte = 0; byte < 4; ++byte) {
+                const f32 value = input[i * 4 + 3 - byte];
+                REQUIRE(result[i * 4 + byte] == static_cast<u8>(static_cast<u32>(value * 255.0f)));
+            }
+        }
+    }
+    SECTION("A8R8G8B8_SRGB") {
+        Converter* const converter = factory.GetFormatConverter(RenderTargetFormat::A8R8G8B8_SRGB);
+        converter->ConvertTo(pixels, ir);
+        std::vector<u8> result(pixels.size());
+        converter->ConvertFrom(ir, result);
+        // Alpha stays linear, colors are decoded to linear values darker than their encoding
+        for (size_t i = 0; i < 19; ++i) {
+            REQUIRE(ir[i * 4 + 3] == static_cast<f32>(pixels[i * 4]) / 255.0f);
+            REQUIRE(result[i * 4] == pixels[i * 4]);
+            for (size_t byte = 1; byte < 4; ++byte) {
+                const f32 value = ir[i * 4 + byte - 1];
+                REQUIRE(value >= 0.0f);
+                REQUIRE(value <= static_cast<f32>(pixels[i * 4 + byte]) / 255.0f);
+            }
+        }
+    }
+}
+
+TEST_CASE("SwBlitter: Benchmark", "[video_core][.benchmark]") {
+    constexpr u32 src_width = 1920;
+    constexpr u32 src_height = 1080;
+    constexpr u32 dst_width = 1280;
+    constexpr u32 dst_height = 720;
+    const std::vector<u8> src = MakeImage(src_width, src_height, 4);
+    std::vector<u8> dst(dst_width * dst_height * 4);
+    std::vector<f32> src_ir(src_width * src_height * IR_COMPONENTS);
+    std::vector<f32> dst_ir(dst_width * dst_height * IR_COMPONENTS);
+    ConverterFactory factory;
+    Converter* const converter = factory.GetFormatConverter(RenderTargetFormat::A8B8G8R8_UNORM);
+
+    BENCHMARK("Nearest A8B8G8R8") {
+        NearestNeighbor(src, dst, src_width, src_height, dst_width, dst_height, 4);
+        return dst[0];
+    };
+    BENCHMARK("Bilinear A8B8G8R8") {
+        BilinearUnorm8(src, dst, src_width, src_height, dst_width, dst_height, 4);
+        return dst[0];
+    };
+    BENCHMARK("Bilinear A8B8G8R8 through floats") {
+        converter->ConvertTo(src, src_ir);
+        Bilinear(src_ir, dst_ir, src_width, src_height, dst_width, dst_height);
+        converter->ConvertFrom(dst_ir, dst);
+        return dst[0];
+    };
+}
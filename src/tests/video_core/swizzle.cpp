@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "video_core/textures/decoders.h"
+#include "video_core/textures/workers.h"
+
+namespace {
+using namespace Tegra::Texture;
+
+constexpr SwizzleTable SWIZZLE_TABLE = MakeSwizzleTable();
+
+/// Byte by byte reference of the block linear layout of a 2D texture.
+u32 ReferenceOffset(u32 x, u32 y, u32 width_bytes, u32 block_height) {
+    const u32 gobs_in_x = (width_bytes + GOB_SIZE_X - 1) / GOB_SIZE_X;
+    const u32 block_size = GOB_SIZE << block_height;
+    const u32 block_y = y / (GOB_SIZE_Y << block_height);
+    const u32 gob_y = (y / GOB_SIZE_Y) % (1U << block_height);
+    return block_y * gobs_in_x * block_size + (x / GOB_SIZE_X) * block_size + gob_y * GOB_SIZE +
+           SWIZZLE_TABLE[y % GOB_SIZE_Y][x % GOB_SIZE_X];
+}
+
+std::vector<u8> RandomBytes(size_t size) {
+    std::mt19937 rng{size};
+    std::vector<u8> result(size);
+    for (u8& value : result) {
+        value = static_cast<u8>(rng());
+    }
+    return result;
+}
+} // Anonymous namespace
+
+TEST_CASE("Swizzle: Unswizzle matches the GOB layout", "[video_core]") {
+    for (const u32 bytes_per_pixel : {1U, 2U, 4U, 8U, 16U}) {
+        for (const u32 block_height : {0U, 1U, 4U}) {
+            for (const auto [width, height] : {std::array<u32, 2>{1, 1}, {17, 9}, {128, 64}}) {
+                const u32 width_bytes = width * bytes_per_pixel;
+                const auto swizzled = RandomBytes(
+                    CalculateSize(true, bytes_per_pixel, width, height, 1, block_height, 0));
+                std::vector<u8> linear(width_bytes * height);
+                UnswizzleTexture(linear, swizzled, bytes_per_pixel, width, height, 1, block_height,
+                                 0);
+
+                bool matches = true;
+                for (u32 y = 0; y < height; ++y) {
+                    for (u32 x = 0; x < width_bytes; ++x) {
+                        const u32 offset = ReferenceOffset(x, y, width_bytes, block_height);
+                        matches &= linear[y * width_bytes + x] == swizzled[offset];
+                    }
+                }
+                REQUIRE(matches);
+
+                std::vector<u8> reswizzled(swizzled.size());
+                SwizzleTexture(reswizzled, linear, bytes_per_pixel, width, height, 1, block_height,
+                               0);
+                std::vector<u8> round_trip(linear.size());
+                UnswizzleTexture(round_trip, reswizzled, bytes_per_pixel, width, height, 1,
+                                 block_height, 0);
+                REQUIRE(round_trip == linear);
+            }
+        }
+    }
+}
+
+TEST_CASE("Swizzle: Subrect round trip", "[video_core]") {
+    constexpr u32 width = 200;
+    constexpr u32 height = 40;
+    for (const u32 bytes_per_pixel : {1U, 2U, 4U, 8U, 16U}) {
+        const u32 pitch = width * bytes_per_pixel;
+        const auto linear = RandomBytes(pitch * height);
+        std::vector<u8> swizzled(CalculateSize(true, bytes_per_pixel, width, height, 1, 2, 0));
+        SwizzleSubrect(swizzled, linear, bytes_per_pixel, width, height, 1, 0, 0, width, height,
+                       2, 0, pitch);
+
+        // Read back an unaligned window of the surface.
+        constexpr u32 origin_x = 37;
+        constexpr u32 origin_y = 5;
+        constexpr u32 extent_x = 101;
+        constexpr u32 extent_y = 30;
+        const u32 window_pitch = extent_x * bytes_per_pixel;
+        std::vector<u8> window(window_pitch * extent_y);
+        UnswizzleSubrect(window, swizzled, bytes_per_pixel, width, height, 1, origin_x, origin_y,
+                         extent_x, extent_y, 2, 0, window_pitch);
+
+        bool matches = true;
+        for (u32 y = 0; y < extent_y; ++y) {
+            for (u32 x = 0; x < window_pitch; ++x) {
+                const u32 linear_offset =
+                    (origin_y + y) * pitch + origin_x * bytes_per_pixel + x;
+                matches &= window[y * window_pitch + x] == linear[linear_offset];
+            }
+        }
+        REQUIRE(matches);
+    }
+}
+
+TEST_CASE("Swizzle: Large textures are split across the workers", "[video_core]") {
+    // 2 MiB, split in bands of block rows
+    constexpr u32 width = 1024;
+    constexpr u32 height = 512;
+    constexpr u32 bytes_per_pixel = 4;
+    constexpr u32 block_height = 4;
+    constexpr u32 width_bytes = width * bytes_per_pixel;
+    const auto swizzled =
+        RandomBytes(CalculateSize(true, bytes_per_pixel, width, height, 1, block_height, 0));
+    std::vector<u8> linear(width_bytes * height);
+    UnswizzleTexture(linear, swizzled, bytes_per_pixel, width, height, 1, block_height, 0);
+    bool matches = true;
+    for (u32 y = 0; y < height; ++y) {
+        for (u32 x = 0; x < width_bytes; ++x) {
+            const u32 offset = ReferenceOffset(x, y, width_bytes, block_height);
+            matches &= linear[y * width_bytes + x] == swizzled[offset];
+        }
+    }
+    REQUIRE(matches);
+
+    // Called from one of the workers, the calling thread converts the bands itself
+    std::vector<u8> from_worker(linear.size());
+    GetThreadWorkers().QueueWork([&] {
+        UnswizzleTexture(from_worker, swizzled, bytes_per_pixel, width, height, 1, block_height,
+                         0);
+    });
+    GetThreadWorkers().WaitForRequests();
+    REQUIRE(from_worker == linear);
+
+    // 2 MiB of small slices, split in groups of whole slices
+    constexpr u32 depth = 128;
+    constexpr u32 slice_width = 64;
+    const auto volume = RandomBytes(slice_width * bytes_per_pixel * slice_width * depth);
+    std::vector<u8> swizzled_volume(
+        CalculateSize(true, bytes_per_pixel, slice_width, slice_width, depth, 1, 1));
+    SwizzleTexture(swizzled_volume, volume, bytes_per_pixel, slice_width, slice_width, depth, 1,
+                   1);
+    std::vector<u8> round_trip(volume.size());
+    UnswizzleTexture(round_trip, swizzled_volume, bytes_per_pixel, slice_width, slice_width,
+                     depth, 1, 1);
+    REQUIRE(round_trip == volume);
+}
+
+TEST_CASE("Swizzle: Benchmark", "[video_core][.benchmark]") {
+    for (const u32 bytes_per_pixel : {1U, 4U, 16U}) {
+        for (const u32 block_height : {0U, 4U}) {
+            for (const u32 size : {256U, 1024U, 4096U}) {
+                const u32 width = size / bytes_per_pixel;
+                const auto linear = RandomBytes(size * size);
+                std::vector<u8> swizzled(
+                    CalculateSize(true, bytes_per_pixel, width, size, 1, block_height, 0));
+                std::vector<u8> output(linear.size());
+
+                const std::string name = std::to_string(bytes_per_pixel) + "bpp/bh" +
+                                         std::to_string(block_height) + "/" +
+                                         std::to_string(width) + "x" + std::to_string(size);
+                BENCHMARK("Swizzle " + name) {
+                    SwizzleTexture(swizzled, linear, bytes_per_pixel, width, size, 1, block_height,
+                                   0);
+                    return swizzled[0];
+                };
+                BENCHMARK("Unswizzle " + name) {
+                    UnswizzleTexture(output, swizzled, bytes_per_pixel, width, size, 1,
+                                     block_height, 0);
+                    return output[0];
+                };
+            }
+        }
+    }
+}
@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <filesystem>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "video_core/texture_cache/transcode_cache.h"
+
+namespace {
+using VideoCommon::TranscodeCache;
+
+constexpr u64 ENTRY_SIZE = 1000;
+constexpr u64 HEADER_SIZE = 56;
+
+class TemporaryDirectory {
+public:
+    TemporaryDirectory()
+        : path{std::filesystem::temp_directory_path() / "transcode_cache_test"} {
+        Common::FS::RemoveDirRecursively(path);
+    }
+    ~TemporaryDirectory() {
+        Common::FS::RemoveDirRecursively(path);
+    }
+
+    std::filesystem::path path;
+};
+
+std::vector<u8> MakeData(u8 seed) {
+    std::vector<u8> data(ENTRY_SIZE);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<u8>(seed + i * 7);
+    }
+    return data;
+}
+
+TranscodeCache::Key MakeKey(u64 hash) {
+    return {.hash = hash, .check_hash = ~hash, .input_size = 16};
+}
+
+bool Contains(TranscodeCache& cache, u64 hash, u8 seed) {
+    std::vector<u8> output(ENTRY_SIZE);
+    return cache.Find(MakeKey(hash), output) && output == MakeData(seed);
+}
+} // Anonymous namespace
+
+TEST_CASE("TranscodeCache: Stored entries are found", "[video_core]") {
+    const TemporaryDirectory directory;
+    TranscodeCache cache{directory.path, 1ULL << 20};
+    cache.Store(MakeKey(1), MakeData(1));
+    cache.Store(MakeKey(2), MakeData(2));
+    cache.Flush();
+
+    REQUIRE(Contains(cache, 1, 1));
+    REQUIRE(Contains(cache, 2, 2));
+    REQUIRE(!Contains(cache, 3, 3));
+
+    // Entries of another size are not returned
+    std::vector<u8> output(ENTRY_SIZE / 2);
+    REQUIRE(!cache.Find(MakeKey(1), output));
+
+    const TranscodeCache::Statistics statistics = cache.GetStatistics();
+    REQUIRE(statistics.lookups == 4);
+    REQUIRE(statistics.hits == 2);
+    REQUIRE(statistics.stores == 2);
+}
+
+TEST_CASE("TranscodeCache: Entries persist across instances", "[video_core]") {
+    const TemporaryDirectory directory;
+    {
+        TranscodeCache cache{directory.path, 1ULL << 20};
+        cache.Store(MakeKey(1), MakeData(1));
+    }
+    TranscodeCache cache{directory.path, 1ULL << 20};
+    // Entries left by previous runs are indexed once the directory has been scanned
+    cache.Flush();
+    REQUIRE(Contains(cache, 1, 1));
+}
+
+TEST_CASE("TranscodeCache: Least recently used entries are evicted", "[video_core]") {
+    const TemporaryDirectory directory;
+    TranscodeCache cache{directory.path, 2 * (ENTRY_SIZE + HEADER_SIZE)};
+    cache.Store(MakeKey(1), MakeData(1));
+    cache.Store(MakeKey(2), MakeData(2));
+    cache.Flush();
+    REQUIRE(Contains(cache, 1, 1));
+    cache.Store(MakeKey(3), MakeData(3));
+    cache.Flush();
+
+    REQUIRE(Contains(cache, 1, 1));
+    REQUIRE(!Contains(cache, 2, 2));
+    REQUIRE(Contains(cache, 3, 3));
+    REQUIRE(cache.GetStatistics().evictions == 1);
+}
+
+TEST_CASE("TranscodeCache: Damaged entries are removed", "[video_core]") {
+    const TemporaryDirectory directory;
+    TranscodeCache cache{directory.path, 1ULL << 20};
+    cache.Store(MakeKey(1), MakeData(1));
+    cache.Flush();
+
+    const std::filesystem::path path = directory.path / "0000000000000001.bin";
+    {
+        Common::FS::IOFile file{path, Common::FS::FileAccessMode::ReadWrite,
+                                Common::FS::FileType::BinaryFile};
+        REQUIRE(file.Seek(HEADER_SIZE + 10));
+        REQUIRE(file.WriteObject(u8{0xFF}));
+    }
+    REQUIRE(!Contains(cache, 1, 1));
+    cache.Flush();
+    REQUIRE(!Common::FS::Exists(path));
+}
+
+TEST_CASE("TranscodeCache: Colliding keys are not returned", "[video_core]") {
+    const TemporaryDirectory directory;
+    TranscodeCache cache{directory.path, 1ULL << 20};
+    cache.Store(MakeKey(1), MakeData(1));
+    cache.Flush();
+
+    // Same name, another input
+    std::vector<u8> output(ENTRY_SIZE);
+    TranscodeCache::Key key = MakeKey(1);
+    key.check_hash = 0;
+    REQUIRE(!cache.Find(key, output));
+    key = MakeKey(1);
+    key.input_size = 32;
+    REQUIRE(!cache.Find(key, output));
+
+    // The entry is kept for its own input
+    cache.Flush();
+    REQUIRE(Contains(cache, 1, 1));
+}
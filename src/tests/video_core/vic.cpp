@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <memory>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+extern "C" {
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif
+#include <libswscale/swscale.h>
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+}
+
+#include "common/common_types.h"
+#include "video_core/host1x/ffmpeg/ffmpeg.h"
+#include "video_core/host1x/vic_frame.h"
+
+namespace {
+using namespace Tegra::Host1x;
+
+/// YUV420P frame like the ones decoded in software, with gradients and noise in every plane
+std::unique_ptr<FFmpeg::Frame> MakeFrame(int width, int height) {
+    auto frame = std::make_unique<FFmpeg::Frame>();
+    AVFrame* const av_frame = frame->GetFrame();
+    av_frame->width = width;
+    av_frame->height = height;
+    frame->SetFormat(AV_PIX_FMT_YUV420P);
+    REQUIRE(av_frame_get_buffer(av_frame, 0) == 0);
+
+    std::mt19937 rng{5678};
+    std::uniform_int_distribution<int> noise{-8, 8};
+    for (int plane = 0; plane < 3; ++plane) {
+        const int plane_width = plane == 0 ? width : (width + 1) / 2;
+        const int plane_height = plane == 0 ? height : (height + 1) / 2;
+        for (int y = 0; y < plane_height; ++y) {
+            u8* const line = frame->GetData(plane) + y * frame->GetStride(plane);
+            for (int x = 0; x < plane_width; ++x) {
+                const int value = (x * 3 + y * 2 + plane * 64 + noise(rng)) & 0xff;
+                line[x] = static_cast<u8>(value);
+            }
+        }
+    }
+    return frame;
+}
+
+/// Converts the whole frame with a single scaler, as frames were converted before
+void ConvertWhole(SwsContext* context, const FFmpeg::Frame& frame, std::vector<u8>& result) {
+    result.resize(static_cast<size_t>(frame.GetWidth() * frame.GetHeight() * 4));
+    u8* const output = result.data();
+    const std::array<int, 4> output_stride{frame.GetWidth() * 4, 0, 0, 0};
+    sws_scale(context, frame.GetPlanes(), frame.GetStrides(), 0, frame.GetHeight(), &output,
+              output_stride.data());
+}
+
+SwsContext* MakeWholeContext(const FFmpeg::Frame& frame, AVPixelFormat format) {
+    return sws_getContext(frame.GetWidth(), frame.GetHeight(), AV_PIX_FMT_YUV420P,
+                          frame.GetWidth(), frame.GetHeight(), format, 0, nullptr, nullptr,
+                          nullptr);
+}
+} // Anonymous namespace
+
+TEST_CASE("VIC: Chroma planes are interleaved", "[video_core]") {
+    // Odd widths cover the samples after the last whole vector
+    constexpr size_t width = 45;
+    constexpr size_t height = 5;
+    constexpr size_t input_pitch = 64;
+    constexpr size_t output_pitch = 128;
+    std::vector<u8> chroma_u(input_pitch * height);
+    std::vector<u8> chroma_v(input_pitch * height);
+    for (size_t i = 0; i < chroma_u.size(); ++i) {
+        chroma_u[i] = static_cast<u8>(i);
+        chroma_v[i] = static_cast<u8>(255 - i);
+    }
+    std::vector<u8> output(output_pitch * height, 0xcd);
+    InterleaveChroma(output.data(), output_pitch, chroma_u.data(), chroma_v.data(), input_pitch,
+                     width, height);
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            REQUIRE(output[y * output_pitch + x * 2] == chroma_u[y * input_pitch + x]);
+            REQUIRE(output[y * output_pitch + x * 2 + 1] == chroma_v[y * input_pitch + x]);
+        }
+        // Padding at the end of the lines is left untouched
+        REQUIRE(output[y * output_pitch + width * 2] == 0xcd);
+    }
+}
+
+TEST_CASE("VIC: RGB conversion in bands matches a single conversion", "[video_core]") {
+    // A last band shorter than the others, and an odd height converted whole
+    for (const auto& [width, height] : {std::pair{1280, 720}, {1920, 1080}, {1280, 721}}) {
+        const auto frame = MakeFrame(width, height);
+        // The formats used for the RGBA8, BGRA8 and RGBX8 outputs of the VIC
+        for (const AVPixelFormat format : {AV_PIX_FMT_RGBA, AV_PIX_FMT_BGRA, AV_PIX_FMT_RGB0}) {
+            SwsContext* const context = MakeWholeContext(*frame, format);
+            std::vector<u8> expected;
+            ConvertWhole(context, *frame, expected);
+            sws_freeContext(context);
+
+            RGBFrameConverter converter;
+            const std::span<const u8> converted = converter.Convert(*frame, format);
+            REQUIRE(std::vector<u8>(converted.begin(), converted.end()) == expected);
+        }
+    }
+}
+
+TEST_CASE("VIC: RGB conversion without a scaler returns no pixels", "[video_core]") {
+    const auto frame = MakeFrame(1280, 720);
+    RGBFrameConverter converter;
+    // Hardware surfaces are not scaler outputs
+    REQUIRE(converter.Convert(*frame, AV_PIX_FMT_VAAPI).empty());
+    REQUIRE(!converter.Convert(*frame, AV_PIX_FMT_RGBA).empty());
+}
+
+TEST_CASE("VIC: Benchmark", "[video_core][.benchmark]") {
+    const auto frame = MakeFrame(1920, 1080);
+    SwsContext* const context = MakeWholeContext(*frame, AV_PIX_FMT_RGBA);
+    RGBFrameConverter converter;
+    std::vector<u8> converted;
+    BENCHMARK("RGB conversion, one scaler") {
+        ConvertWhole(context, *frame, converted);
+        return converted[0];
+    };
+    BENCHMARK("RGB conversion in bands") {
+        return converter.Convert(*frame, AV_PIX_FMT_RGBA)[0];
+    };
+    sws_freeContext(context);
+
+    const size_t width = 1920 / 2;
+    const size_t height = 1080 / 2;
+    const size_t input_pitch = static_cast<size_t>(frame->GetStride(1));
+    const size_t output_pitch = 2048;
+    std::vector<u8> output(output_pitch * height);
+    BENCHMARK("Chroma interleave, bytewise") {
+        for (size_t y = 0; y < height; ++y) {
+            const u8* const chroma_u = frame->GetData(1) + y * input_pitch;
+            const u8* const chroma_v = frame->GetData(2) + y * input_pitch;
+            u8* const line = output.data() + y * output_pitch;
+            for (size_t x = 0; x < width; ++x) {
+                line[x * 2] = chroma_u[x];
+                line[x * 2 + 1] = chroma_v[x];
+            }
+        }
+        return output[0];
+    };
+    BENCHMARK("Chroma interleave") {
+        InterleaveChroma(output.data(), output_pitch, frame->GetData(1), frame->GetData(2),
+                         input_pitch, width, height);
+        return output[0];
+    };
+}
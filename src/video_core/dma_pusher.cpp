@@ -1,9 +1,14 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
 #include "common/cityhash.h"
 #include "common/microprofile.h"
 #include "common/settings.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
 #include "video_core/dma_pusher.h"
 #include "video_core/engines/maxwell_3d.h"
@@ -16,12 +21,22 @@ namespace Tegra {
 constexpr u32 MacroRegistersStart = 0xE00;
 constexpr u32 ComputeInline = 0x6D;
 
+namespace {
+/// Every channel is executed by the GPU thread, so one thread prefetches for all of them
+Common::ThreadWorker& GetPrefetchWorker() {
+    static Common::ThreadWorker worker{1, "GPU:Prefetch"};
+    return worker;
+}
+} // Anonymous namespace
+
 DmaPusher::DmaPusher(Core::System& system_, GPU& gpu_, MemoryManager& memory_manager_,
                      Control::ChannelState& channel_state_)
     : gpu{gpu_}, system{system_}, memory_manager{memory_manager_}, puller{gpu_, memory_manager_,
                                                                           *this, channel_state_} {}
 
-DmaPusher::~DmaPusher() = default;
+DmaPusher::~DmaPusher() {
+    WaitForPrefetch();
+}
 
 MICROPROFILE_DEFINE(DispatchCalls, "GPU", "Execute command buffer", MP_RGB(128, 128, 192));
 
@@ -67,10 +82,13 @@ bool DmaPusher::Step() {
             command_list.command_lists[dma_pushbuffer_subindex++]};
         dma_state.dma_get = command_list_header.addr;
 
+        std::optional<CommandListHeader> next_header;
         if (dma_pushbuffer_subindex >= command_list.command_lists.size()) {
             // We've gone through the current list, remove it from the queue
             dma_pushbuffer.pop();
             dma_pushbuffer_subindex = 0;
+        } else {
+            next_header = command_list.command_lists[dma_pushbuffer_subindex];
         }
 
         if (command_list_header.size == 0) {
@@ -78,9 +96,9 @@ bool DmaPusher::Step() {
         }
 
         // Push buffer non-empty, read a word
-        if (dma_state.method >= MacroRegistersStart) {
-            if (subchannels[dma_state.subchannel]) {
-                subchannels[dma_state.subchannel]->current_dirty = memory_manager.IsMemoryDirty(
+        if (decode_state.method >= MacroRegistersStart) {
+            if (subchannels[decode_state.subchannel]) {
+                subchannels[decode_state.subchannel]->current_dirty = memory_manager.IsMemoryDirty(
                     dma_state.dma_get, command_list_header.size * sizeof(u32));
             }
         }
@@ -99,91 +117,204 @@ bool DmaPusher::Step() {
             ProcessCommands(headers);
         };
         if (Settings::IsGPULevelHigh()) {
-            if (dma_state.method >= MacroRegistersStart) {
+            if (decode_state.method >= MacroRegistersStart) {
                 unsafe_process();
                 return true;
             }
-            if (subchannel_type[dma_state.subchannel] == Engines::EngineTypes::KeplerCompute &&
-                dma_state.method == ComputeInline) {
+            if (subchannel_type[decode_state.subchannel] == Engines::EngineTypes::KeplerCompute &&
+                decode_state.method == ComputeInline) {
                 unsafe_process();
                 return true;
             }
             safe_process();
             return true;
         }
-        unsafe_process();
+
+        // Like the PBDMA of the hardware, the next segment of the list is read and decoded while
+        // the engines execute this one. Executing may write to the next segment (inline to memory,
+        // DMA copies, semaphore releases...), so its decoding is only used after checking that
+        // its commands are still the ones in memory.
+        Tegra::Memory::GpuGuestMemory<Tegra::CommandHeader,
+                                      Tegra::Memory::GuestMemoryFlags::UnsafeRead>
+            headers(memory_manager, dma_state.dma_get, command_list_header.size,
+                    &command_headers);
+        std::span<const MethodBatch> batches;
+        if (const DecodedSegment* segment = TakePrefetchedSegment(command_list_header, headers)) {
+            decode_state = segment->end_state;
+            batches = segment->batches;
+        } else {
+            method_batches.clear();
+            DecodeCommands(headers, decode_state, method_batches);
+            batches = method_batches;
+        }
+        if (next_header && next_header->size != 0) {
+            PrefetchSegment(*next_header);
+        }
+        ExecuteBatches(headers, batches);
     }
     return true;
 }
 
 void DmaPusher::ProcessCommands(std::span<const CommandHeader> commands) {
+    method_batches.clear();
+    DecodeCommands(commands, decode_state, method_batches);
+    ExecuteBatches(commands, method_batches);
+}
+
+void DmaPusher::DecodeCommands(std::span<const CommandHeader> commands, DecodeState& state,
+                               std::vector<MethodBatch>& batches) {
+    const auto set_state = [&state](const CommandHeader& command_header) {
+        state.method = command_header.method;
+        state.subchannel = command_header.subchannel;
+        state.method_count = command_header.method_count;
+    };
     for (std::size_t index = 0; index < commands.size();) {
         const CommandHeader& command_header = commands[index];
 
-        if (dma_state.method_count) {
-            // Data word of methods command
-            dma_state.dma_word_offset = static_cast<u32>(index * sizeof(u32));
-            if (dma_state.non_incrementing) {
-                const u32 max_write = static_cast<u32>(
-                    std::min<std::size_t>(index + dma_state.method_count, commands.size()) - index);
-                CallMultiMethod(&command_header.argument, max_write);
-                dma_state.method_count -= max_write;
-                dma_state.is_last_call = true;
+        if (state.method_count) {
+            // Data words of methods command
+            const u32 max_write = static_cast<u32>(
+                std::min<std::size_t>(index + state.method_count, commands.size()) - index);
+            if (state.non_incrementing) {
+                batches.push_back({state.method, state.subchannel, state.method_count,
+                                   static_cast<u32>(index), max_write, BatchMode::NonIncreasing});
+                state.method_count -= max_write;
                 index += max_write;
                 continue;
-            } else {
-                dma_state.is_last_call = dma_state.method_count <= 1;
-                CallMethod(command_header.argument);
             }
-
-            if (!dma_state.non_incrementing) {
-                dma_state.method++;
+            // Only the first argument of an increase once command increments the method
+            const u32 num_arguments = state.increment_once ? 1 : max_write;
+            batches.push_back({state.method, state.subchannel, state.method_count,
+                               static_cast<u32>(index), num_arguments, BatchMode::Increasing});
+            state.method += num_arguments;
+            state.method_count -= num_arguments;
+            if (state.increment_once) {
+                state.non_incrementing = true;
             }
+            index += num_arguments;
+            continue;
+        }
 
-            if (dma_increment_once) {
-                dma_state.non_incrementing = true;
-            }
+        // No command active - this is the first word of a new one
+        switch (command_header.mode) {
+        case SubmissionMode::Increasing:
+            set_state(command_header);
+            state.non_incrementing = false;
+            state.increment_once = false;
+            break;
+        case SubmissionMode::NonIncreasing:
+            set_state(command_header);
+            state.non_incrementing = true;
+            state.increment_once = false;
+            break;
+        case SubmissionMode::Inline:
+            state.method = command_header.method;
+            state.subchannel = command_header.subchannel;
+            batches.push_back({state.method, state.subchannel, state.method_count,
+                               static_cast<u32>(index), 1, BatchMode::Inline});
+            state.non_incrementing = true;
+            state.increment_once = false;
+            break;
+        case SubmissionMode::IncreaseOnce:
+            set_state(command_header);
+            state.non_incrementing = false;
+            state.increment_once = true;
+            break;
+        default:
+            break;
+        }
+        index++;
+    }
+}
 
-            dma_state.method_count--;
-        } else {
-            // No command active - this is the first word of a new one
-            switch (command_header.mode) {
-            case SubmissionMode::Increasing:
-                SetState(command_header);
-                dma_state.non_incrementing = false;
-                dma_increment_once = false;
-                break;
-            case SubmissionMode::NonIncreasing:
-                SetState(command_header);
-                dma_state.non_incrementing = true;
-                dma_increment_once = false;
-                break;
-            case SubmissionMode::Inline:
-                dma_state.method = command_header.method;
-                dma_state.subchannel = command_header.subchannel;
-                dma_state.dma_word_offset = static_cast<u64>(
-                    -static_cast<s64>(dma_state.dma_get)); // negate to set address as 0
-                CallMethod(command_header.arg_count);
-                dma_state.non_incrementing = true;
-                dma_increment_once = false;
-                break;
-            case SubmissionMode::IncreaseOnce:
-                SetState(command_header);
-                dma_state.non_incrementing = false;
-                dma_increment_once = true;
-                break;
-            default:
-                break;
+void DmaPusher::ExecuteBatches(std::span<const CommandHeader> commands,
+                               std::span<const MethodBatch> batches) {
+    for (const MethodBatch& batch : batches) {
+        dma_state.method = batch.method;
+        dma_state.subchannel = batch.subchannel;
+        dma_state.method_count = batch.method_count;
+        switch (batch.mode) {
+        case BatchMode::Increasing:
+            for (u32 index = batch.first_argument;
+                 index < batch.first_argument + batch.num_arguments; ++index) {
+                dma_state.dma_word_offset = static_cast<u32>(index * sizeof(u32));
+                dma_state.is_last_call = dma_state.method_count <= 1;
+                CallMethod(commands[index].argument);
+                dma_state.method++;
+                dma_state.method_count--;
             }
+            break;
+        case BatchMode::NonIncreasing:
+            dma_state.dma_word_offset = static_cast<u32>(batch.first_argument * sizeof(u32));
+            CallMultiMethod(&commands[batch.first_argument].argument, batch.num_arguments);
+            dma_state.method_count -= batch.num_arguments;
+            dma_state.is_last_call = true;
+            break;
+        case BatchMode::Inline:
+            dma_state.dma_word_offset = static_cast<u64>(
+                -static_cast<s64>(dma_state.dma_get)); // negate to set address as 0
+            CallMethod(commands[batch.first_argument].arg_count);
+            break;
         }
-        index++;
     }
 }
 
-void DmaPusher::SetState(const CommandHeader& command_header) {
-    dma_state.method = command_header.method;
-    dma_state.subchannel = command_header.subchannel;
-    dma_state.method_count = command_header.method_count;
+void DmaPusher::FetchSegment(DecodedSegment& segment, CommandListHeader header,
+                             const DecodeState& state) const {
+    segment.address = header.addr;
+    segment.size = header.size;
+    segment.start_state = state;
+    segment.end_state = state;
+    segment.commands.resize_destructive(header.size);
+    memory_manager.ReadBlockUnsafe(header.addr, segment.commands.data(),
+                                   header.size * sizeof(u32));
+    segment.batches.clear();
+    DecodeCommands(segment.commands, segment.end_state, segment.batches);
+}
+
+void DmaPusher::PrefetchSegment(CommandListHeader header) {
+    WaitForPrefetch();
+    {
+        std::scoped_lock lock{prefetch_mutex};
+        prefetch_done = false;
+    }
+    prefetch_pending = true;
+    DecodedSegment& segment = segments[current_segment ^ 1];
+    GetPrefetchWorker().QueueWork([this, &segment, header, state = decode_state] {
+        FetchSegment(segment, header, state);
+        // Notify while holding the lock, the pusher may be destroyed as soon as it is released
+        std::scoped_lock lock{prefetch_mutex};
+        prefetch_done = true;
+        prefetch_cv.notify_one();
+    });
+}
+
+DmaPusher::DecodedSegment* DmaPusher::TakePrefetchedSegment(
+    CommandListHeader header, std::span<const CommandHeader> commands) {
+    if (!prefetch_pending) {
+        return nullptr;
+    }
+    WaitForPrefetch();
+
+    DecodedSegment& segment = segments[current_segment ^ 1];
+    if (segment.address != header.addr || segment.size != header.size ||
+        segment.start_state != decode_state) {
+        return nullptr;
+    }
+    if (std::memcmp(segment.commands.data(), commands.data(), commands.size_bytes()) != 0) {
+        return nullptr;
+    }
+    current_segment ^= 1;
+    return &segment;
+}
+
+void DmaPusher::WaitForPrefetch() {
+    if (!prefetch_pending) {
+        return;
+    }
+    std::unique_lock lock{prefetch_mutex};
+    prefetch_cv.wait(lock, [this] { return prefetch_done; });
+    prefetch_pending = false;
 }
 
 void DmaPusher::CallMethod(u32 argument) const {
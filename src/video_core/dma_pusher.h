@@ -4,6 +4,8 @@
 #pragma once
 
 #include <array>
+#include <condition_variable>
+#include <mutex>
 #include <span>
 #include <vector>
 #include <boost/container/small_vector.hpp>
@@ -138,19 +140,78 @@ public:
 
     void BindRasterizer(VideoCore::RasterizerInterface* rasterizer);
 
+    /// State of the command stream decoder, carried from one pushbuffer segment to the next
+    struct DecodeState {
+        u32 method;            ///< Current method
+        u32 subchannel;        ///< Current subchannel
+        u32 method_count;      ///< Current method count
+        bool non_incrementing; ///< Current command's NI flag
+        bool increment_once;   ///< Current command increments the method only once
+
+        bool operator==(const DecodeState&) const = default;
+    };
+
+    enum class BatchMode : u32 {
+        Increasing,    ///< One method call per argument, incrementing the method
+        NonIncreasing, ///< All the arguments go to the same method in a single call
+        Inline,        ///< A single argument encoded in the command header
+    };
+
+    /// A run of arguments for the same subchannel, decoded from a pushbuffer segment
+    struct MethodBatch {
+        u32 method;
+        u32 subchannel;
+        u32 method_count;   ///< Arguments the method still expects before this run
+        u32 first_argument; ///< Index of the first argument within the segment
+        u32 num_arguments;
+        BatchMode mode;
+    };
+
+    /// Splits the command words into method batches, without calling into the engines.
+    static void DecodeCommands(std::span<const CommandHeader> commands, DecodeState& state,
+                               std::vector<MethodBatch>& batches);
+
 private:
     static constexpr u32 non_puller_methods = 0x40;
     static constexpr u32 max_subchannels = 8;
+
+    /// A pushbuffer segment read from GPU memory and split into method batches
+    struct DecodedSegment {
+        GPUVAddr address{};
+        u64 size{};
+        DecodeState start_state{};
+        DecodeState end_state{};
+        Common::ScratchBuffer<CommandHeader> commands;
+        std::vector<MethodBatch> batches;
+    };
+
     bool Step();
     void ProcessCommands(std::span<const CommandHeader> commands);
 
-    void SetState(const CommandHeader& command_header);
+    /// Dispatches decoded method batches to the engines.
+    void ExecuteBatches(std::span<const CommandHeader> commands,
+                        std::span<const MethodBatch> batches);
+
+    /// Reads a segment from GPU memory and decodes it, starting from the given state.
+    void FetchSegment(DecodedSegment& segment, CommandListHeader header,
+                      const DecodeState& state) const;
+
+    /// Reads and decodes the given segment on the prefetch thread, starting from decode_state.
+    void PrefetchSegment(CommandListHeader header);
+
+    /// Waits for the segment being prefetched, returns it when it still matches the commands.
+    DecodedSegment* TakePrefetchedSegment(CommandListHeader header,
+                                          std::span<const CommandHeader> commands);
+
+    /// Blocks until the prefetch thread is done with this pusher.
+    void WaitForPrefetch();
 
     void CallMethod(u32 argument) const;
     void CallMultiMethod(const u32* base_start, u32 num_methods) const;
 
     Common::ScratchBuffer<CommandHeader>
         command_headers; ///< Buffer for list of commands fetched at once
+    std::vector<MethodBatch> method_batches; ///< Batches of the commands processed in place
 
     std::queue<CommandList> dma_pushbuffer; ///< Queue of command lists to be processed
     std::size_t dma_pushbuffer_subindex{};  ///< Index within a command list within the pushbuffer
@@ -162,12 +223,20 @@ private:
         u32 length_pending;    ///< Large NI command length pending
         GPUVAddr dma_get;      ///< Currently read segment
         u64 dma_word_offset;   ///< Current word offset from address
-        bool non_incrementing; ///< Current command's NI flag
         bool is_last_call;
     };
 
     DmaState dma_state{};
-    bool dma_increment_once{};
+    DecodeState decode_state{};
+
+    /// Segment being executed and segment being prefetched, swapped when a prefetch is used
+    std::array<DecodedSegment, 2> segments;
+    std::size_t current_segment{};
+    bool prefetch_pending{};
+
+    std::mutex prefetch_mutex;
+    std::condition_variable prefetch_cv;
+    bool prefetch_done{}; ///< Set by the prefetch thread, guarded by prefetch_mutex
 
     const bool ib_enable{true}; ///< IB mode enabled
 
@@ -1,13 +1,13 @@
 // SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-3.0-or-later
 
-#include <algorithm>
-#include <cmath>
-#include <vector>
+#include <cstring>
+#include <span>
 
 #include "common/scratch_buffer.h"
 #include "video_core/engines/sw_blitter/blitter.h"
 #include "video_core/engines/sw_blitter/converter.h"
+#include "video_core/engines/sw_blitter/scaler.h"
 #include "video_core/guest_memory.h"
 #include "video_core/memory_manager.h"
 #include "video_core/surface.h"
@@ -26,91 +26,6 @@ using namespace Texture;
 
 namespace {
 
-constexpr size_t ir_components = 4;
-
-void NearestNeighbor(std::span<const u8> input, std::span<u8> output, u32 src_width, u32 src_height,
-                     u32 dst_width, u32 dst_height, size_t bpp) {
-    const size_t dx_du = std::llround((static_cast<f64>(src_width) / dst_width) * (1ULL << 32));
-    const size_t dy_dv = std::llround((static_cast<f64>(src_height) / dst_height) * (1ULL << 32));
-    size_t src_y = 0;
-    for (u32 y = 0; y < dst_height; y++) {
-        size_t src_x = 0;
-        for (u32 x = 0; x < dst_width; x++) {
-            const size_t read_from = ((src_y * src_width + src_x) >> 32) * bpp;
-            const size_t write_to = (y * dst_width + x) * bpp;
-
-            std::memcpy(&output[write_to], &input[read_from], bpp);
-            src_x += dx_du;
-        }
-        src_y += dy_dv;
-    }
-}
-
-void NearestNeighborFast(std::span<const f32> input, std::span<f32> output, u32 src_width,
-                         u32 src_height, u32 dst_width, u32 dst_height) {
-    const size_t dx_du = std::llround((static_cast<f64>(src_width) / dst_width) * (1ULL << 32));
-    const size_t dy_dv = std::llround((static_cast<f64>(src_height) / dst_height) * (1ULL << 32));
-    size_t src_y = 0;
-    for (u32 y = 0; y < dst_height; y++) {
-        size_t src_x = 0;
-        for (u32 x = 0; x < dst_width; x++) {
-            const size_t read_from = ((src_y * src_width + src_x) >> 32) * ir_components;
-            const size_t write_to = (y * dst_width + x) * ir_components;
-
-            std::memcpy(&output[write_to], &input[read_from], sizeof(f32) * ir_components);
-            src_x += dx_du;
-        }
-        src_y += dy_dv;
-    }
-}
-
-void Bilinear(std::span<const f32> input, std::span<f32> output, size_t src_width,
-              size_t src_height, size_t dst_width, size_t dst_height) {
-    const auto bilinear_sample = [](std::span<const f32> x0_y0, std::span<const f32> x1_y0,
-                                    std::span<const f32> x0_y1, std::span<const f32> x1_y1,
-                                    f32 weight_x, f32 weight_y) {
-        std::array<f32, ir_components> result{};
-        for (size_t i = 0; i < ir_components; i++) {
-            const f32 a = std::lerp(x0_y0[i], x1_y0[i], weight_x);
-            const f32 b = std::lerp(x0_y1[i], x1_y1[i], weight_x);
-            result[i] = std::lerp(a, b, weight_y);
-        }
-        return result;
-    };
-    const f32 dx_du =
-        dst_width > 1 ? static_cast<f32>(src_width - 1) / static_cast<f32>(dst_width - 1) : 0.f;
-    const f32 dy_dv =
-        dst_height > 1 ? static_cast<f32>(src_height - 1) / static_cast<f32>(dst_height - 1) : 0.f;
-    for (u32 y = 0; y < dst_height; y++) {
-        for (u32 x = 0; x < dst_width; x++) {
-            const f32 x_low = std::floor(static_cast<f32>(x) * dx_du);
-            const f32 y_low = std::floor(static_cast<f32>(y) * dy_dv);
-            const f32 x_high = std::ceil(static_cast<f32>(x) * dx_du);
-            const f32 y_high = std::ceil(static_cast<f32>(y) * dy_dv);
-            const f32 weight_x = (static_cast<f32>(x) * dx_du) - x_low;
-            const f32 weight_y = (static_cast<f32>(y) * dy_dv) - y_low;
-
-            const auto read_src = [&](f32 in_x, f32 in_y) {
-                const size_t read_from =
-                    ((static_cast<size_t>(in_x) * src_width + static_cast<size_t>(in_y)) >> 32) *
-                    ir_components;
-                return std::span<const f32>(&input[read_from], ir_components);
-            };
-
-            auto x0_y0 = read_src(x_low, y_low);
-            auto x1_y0 = read_src(x_high, y_low);
-            auto x0_y1 = read_src(x_low, y_high);
-            auto x1_y1 = read_src(x_high, y_high);
-
-            const auto result = bilinear_sample(x0_y0, x1_y0, x0_y1, x1_y1, weight_x, weight_y);
-
-            const size_t write_to = (y * dst_width + x) * ir_components;
-
-            std::memcpy(&output[write_to], &result, sizeof(f32) * ir_components);
-        }
-    }
-}
-
 template <bool unpack>
 void ProcessPitchLinear(std::span<const u8> input, std::span<u8> output, size_t extent_x,
                         size_t extent_y, u32 pitch, u32 x0, u32 y0, size_t bpp) {
@@ -174,28 +89,56 @@ bool SoftwareBlitEngine::Blit(Fermi2D::Surface& src, Fermi2D::Surface& dst,
         src.format != dst.format || src_extent_x != dst_extent_x || src_extent_y != dst_extent_y;
 
     const auto conversion_phase_same_format = [&]() {
-        NearestNeighbor(impl->src_buffer, impl->dst_buffer, src_extent_x, src_extent_y,
-                        dst_extent_x, dst_extent_y, dst_bytes_per_pixel);
+        if (config.filter == Fermi2D::Filter::Bilinear) {
+            BilinearUnorm8(impl->src_buffer, impl->dst_buffer, src_extent_x, src_extent_y,
+                           dst_extent_x, dst_extent_y, dst_bytes_per_pixel);
+        } else {
+            NearestNeighbor(impl->src_buffer, impl->dst_buffer, src_extent_x, src_extent_y,
+                            dst_extent_x, dst_extent_y, dst_bytes_per_pixel);
+        }
     };
 
     const auto conversion_phase_ir = [&]() {
-        auto* input_converter = impl->converter_factory.GetFormatConverter(src.format);
+        // Converters hold no state, bands of rows are converted concurrently
+        Converter* const input_converter = impl->converter_factory.GetFormatConverter(src.format);
+        Converter* const output_converter = impl->converter_factory.GetFormatConverter(dst.format);
         impl->intermediate_src.resize_destructive((src_copy_size / src_bytes_per_pixel) *
-                                                  ir_components);
+                                                  IR_COMPONENTS);
         impl->intermediate_dst.resize_destructive((dst_copy_size / dst_bytes_per_pixel) *
-                                                  ir_components);
-        input_converter->ConvertTo(impl->src_buffer, impl->intermediate_src);
+                                                  IR_COMPONENTS);
+        const std::span<const u8> src_pixels{impl->src_buffer};
+        const std::span<u8> dst_pixels{impl->dst_buffer};
+        const std::span<f32> src_ir{impl->intermediate_src};
+        const std::span<f32> dst_ir{impl->intermediate_dst};
+
+        const size_t src_ir_pitch = src_extent_x * IR_COMPONENTS;
+        const size_t src_pitch = size_t{src_extent_x} * src_bytes_per_pixel;
+        ForEachRowBand(src_extent_y, src_ir_pitch * sizeof(f32), [&](u32 begin, u32 end) {
+            const size_t num_rows = end - begin;
+            input_converter->ConvertTo(
+                src_pixels.subspan(begin * src_pitch, num_rows * src_pitch),
+                src_ir.subspan(begin * src_ir_pitch, num_rows * src_ir_pitch));
+        });
 
         if (config.filter != Fermi2D::Filter::Bilinear) {
-            NearestNeighborFast(impl->intermediate_src, impl->intermediate_dst, src_extent_x,
-                                src_extent_y, dst_extent_x, dst_extent_y);
+            const std::span<const u8> src_ir_bytes{reinterpret_cast<const u8*>(src_ir.data()),
+                                                   src_ir.size_bytes()};
+            const std::span<u8> dst_ir_bytes{reinterpret_cast<u8*>(dst_ir.data()),
+                                             dst_ir.size_bytes()};
+            NearestNeighbor(src_ir_bytes, dst_ir_bytes, src_extent_x, src_extent_y, dst_extent_x,
+                            dst_extent_y, IR_COMPONENTS * sizeof(f32));
         } else {
-            Bilinear(impl->intermediate_src, impl->intermediate_dst, src_extent_x, src_extent_y,
-                     dst_extent_x, dst_extent_y);
+            Bilinear(src_ir, dst_ir, src_extent_x, src_extent_y, dst_extent_x, dst_extent_y);
         }
 
-        auto* output_converter = impl->converter_factory.GetFormatConverter(dst.format);
-        output_converter->ConvertFrom(impl->intermediate_dst, impl->dst_buffer);
+        const size_t dst_ir_pitch = dst_extent_x * IR_COMPONENTS;
+        const size_t dst_pitch = size_t{dst_extent_x} * dst_bytes_per_pixel;
+        ForEachRowBand(dst_extent_y, dst_ir_pitch * sizeof(f32), [&](u32 begin, u32 end) {
+            const size_t num_rows = end - begin;
+            output_converter->ConvertFrom(
+                dst_ir.subspan(begin * dst_ir_pitch, num_rows * dst_ir_pitch),
+                dst_pixels.subspan(begin * dst_pitch, num_rows * dst_pitch));
+        });
     };
 
     // Do actual Blit
@@ -212,10 +155,13 @@ bool SoftwareBlitEngine::Blit(Fermi2D::Surface& src, Fermi2D::Surface& dst,
 
     // Conversion Phase
     if (no_passthrough) {
-        if (src.format != dst.format || config.filter == Fermi2D::Filter::Bilinear) {
-            conversion_phase_ir();
-        } else {
+        // Formats of 8-bit UNORM components are filtered without converting them to floats
+        const bool same_format_filter =
+            config.filter != Fermi2D::Filter::Bilinear || IsUnorm8Format(src.format);
+        if (src.format == dst.format && same_format_filter) {
             conversion_phase_same_format();
+        } else {
+            conversion_phase_ir();
         }
     } else {
         impl->dst_buffer.swap(impl->src_buffer);
@@ -1,8 +1,10 @@
 // SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstring>
 #include <span>
 #include <unordered_map>
 
@@ -12,6 +14,10 @@
 #include "video_core/surface.h"
 #include "video_core/textures/decoders.h"
 
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
+
 #ifdef _MSC_VER
 #define FORCE_INLINE __forceinline
 #else
@@ -951,11 +957,109 @@ public:
     ~NullConverter() = default;
 };
 
+/// Converter of the formats laid out like the intermediate representation, copying the pixels
+class R32G32B32A32_FLOATConverter final : public Converter {
+public:
+    void ConvertTo(std::span<const u8> input, std::span<f32> output) override {
+        std::memcpy(output.data(), input.data(), output.size_bytes());
+    }
+    void ConvertFrom(std::span<const f32> input, std::span<u8> output) override {
+        std::memcpy(output.data(), input.data(), output.size_bytes());
+    }
+};
+
+/**
+ * Converter of the 8-bit RGBA UNORM and SRGB formats, the most common render targets.
+ * Produces the same values as ConverterImpl, without unpacking each component from a word.
+ */
+template <class ConverterTraits>
+class Unorm8Converter final : public Converter {
+private:
+    static constexpr std::array<Swizzle, 4> component_swizzle = ConverterTraits::component_swizzle;
+    static constexpr bool is_srgb = ConverterTraits::component_types[0] == ComponentType::SRGB;
+    static constexpr size_t components_per_ir_rep = 4;
+
+    static_assert(ConverterTraits::num_components == 4);
+    static_assert(std::ranges::all_of(ConverterTraits::component_sizes,
+                                      [](size_t size) { return size == 8; }));
+
+    static constexpr std::array<f32, 256> UNORM_TO_FLOAT_LUT = [] {
+        std::array<f32, 256> lut{};
+        for (size_t value = 0; value < lut.size(); ++value) {
+            lut[value] = static_cast<f32>(value) / 255.0f;
+        }
+        return lut;
+    }();
+
+    static constexpr bool IsLinear(size_t which_component) {
+        return !is_srgb || component_swizzle[which_component] == Swizzle::A;
+    }
+
+    static u8 ConvertFromComponent(f32 in_component, bool linear) {
+        if (!linear) {
+            const u32 index = static_cast<u32>(in_component * 255.0f);
+            in_component = RGB_TO_SRGB_LUT[std::min<u32>(index, 255)];
+        }
+        return static_cast<u8>(static_cast<u32>(in_component * 255.0f));
+    }
+
+public:
+    void ConvertTo(std::span<const u8> input, std::span<f32> output) override {
+        const size_t num_pixels = output.size() / components_per_ir_rep;
+        for (size_t pixel = 0; pixel < num_pixels; pixel++) {
+            const u8* const components = &input[pixel * 4];
+            f32* const new_components = &output[pixel * components_per_ir_rep];
+            for (size_t i = 0; i < 4; i++) {
+                const auto& lut = IsLinear(i) ? UNORM_TO_FLOAT_LUT : SRGB_TO_RGB_LUT;
+                new_components[static_cast<size_t>(component_swizzle[i])] = lut[components[i]];
+            }
+        }
+    }
+
+    void ConvertFrom(std::span<const f32> input, std::span<u8> output) override {
+        const size_t num_pixels = output.size() / 4;
+        size_t pixel = 0;
+#ifdef ARCHITECTURE_x86_64
+        if constexpr (!is_srgb) {
+            // Four pixels at a time, the shuffle moves the components to their byte in the pixel
+            constexpr int shuffle =
+                _MM_SHUFFLE(static_cast<int>(component_swizzle[3]),
+                            static_cast<int>(component_swizzle[2]),
+                            static_cast<int>(component_swizzle[1]),
+                            static_cast<int>(component_swizzle[0]));
+            const __m128 scale = _mm_set1_ps(255.0f);
+            const __m128i byte_mask = _mm_set1_epi32(0xFF);
+            const auto convert = [&](const f32* components) {
+                const __m128 value = _mm_loadu_ps(components);
+                const __m128 ordered = _mm_shuffle_ps(value, value, shuffle);
+                return _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(ordered, scale)), byte_mask);
+            };
+            for (; pixel + 4 <= num_pixels; pixel += 4) {
+                const f32* const components = &input[pixel * components_per_ir_rep];
+                const __m128i low = _mm_packs_epi32(convert(components), convert(components + 4));
+                const __m128i high =
+                    _mm_packs_epi32(convert(components + 8), convert(components + 12));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(&output[pixel * 4]),
+                                 _mm_packus_epi16(low, high));
+            }
+        }
+#endif
+        for (; pixel < num_pixels; pixel++) {
+            const f32* const old_components = &input[pixel * components_per_ir_rep];
+            u8* const components = &output[pixel * 4];
+            for (size_t i = 0; i < 4; i++) {
+                components[i] = ConvertFromComponent(
+                    old_components[static_cast<size_t>(component_swizzle[i])], IsLinear(i));
+            }
+        }
+    }
+};
+
 Converter* ConverterFactory::BuildConverter(RenderTargetFormat format) {
     switch (format) {
     case RenderTargetFormat::R32G32B32A32_FLOAT:
         return impl->converters_cache
-            .emplace(format, std::make_unique<ConverterImpl<R32G32B32A32_FLOATTraits>>())
+            .emplace(format, std::make_unique<R32G32B32A32_FLOATConverter>())
             .first->second.get();
         break;
     case RenderTargetFormat::R32G32B32A32_SINT:
@@ -1030,12 +1134,12 @@ Converter* ConverterFactory::BuildConverter(RenderTargetFormat format) {
         break;
     case RenderTargetFormat::A8R8G8B8_UNORM:
         return impl->converters_cache
-            .emplace(format, std::make_unique<ConverterImpl<A8R8G8B8_UNORMTraits>>())
+            .emplace(format, std::make_unique<Unorm8Converter<A8R8G8B8_UNORMTraits>>())
             .first->second.get();
         break;
     case RenderTargetFormat::A8R8G8B8_SRGB:
         return impl->converters_cache
-            .emplace(format, std::make_unique<ConverterImpl<A8R8G8B8_SRGBTraits>>())
+            .emplace(format, std::make_unique<Unorm8Converter<A8R8G8B8_SRGBTraits>>())
             .first->second.get();
         break;
     case RenderTargetFormat::A2B10G10R10_UNORM:
@@ -1055,12 +1159,12 @@ Converter* ConverterFactory::BuildConverter(RenderTargetFormat format) {
         break;
     case RenderTargetFormat::A8B8G8R8_UNORM:
         return impl->converters_cache
-            .emplace(format, std::make_unique<ConverterImpl<A8B8G8R8_UNORMTraits>>())
+            .emplace(format, std::make_unique<Unorm8Converter<A8B8G8R8_UNORMTraits>>())
             .first->second.get();
         break;
     case RenderTargetFormat::A8B8G8R8_SRGB:
         return impl->converters_cache
-            .emplace(format, std::make_unique<ConverterImpl<A8B8G8R8_SRGBTraits>>())
+            .emplace(format, std::make_unique<Unorm8Converter<A8B8G8R8_SRGBTraits>>())
             .first->second.get();
         break;
     case RenderTargetFormat::A8B8G8R8_SNORM:
@@ -1231,4 +1335,18 @@ Converter* ConverterFactory::BuildConverter(RenderTargetFormat format) {
     }
 }
 
+bool IsUnorm8Format(RenderTargetFormat format) {
+    switch (format) {
+    case RenderTargetFormat::A8R8G8B8_UNORM:
+    case RenderTargetFormat::A8B8G8R8_UNORM:
+    case RenderTargetFormat::X8R8G8B8_UNORM:
+    case RenderTargetFormat::X8B8G8R8_UNORM:
+    case RenderTargetFormat::R8G8_UNORM:
+    case RenderTargetFormat::R8_UNORM:
+        return true;
+    default:
+        return false;
+    }
+}
+
 } // namespace Tegra::Engines::Blitter
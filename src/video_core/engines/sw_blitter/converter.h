@@ -33,4 +33,7 @@ private:
     std::unique_ptr<ConverterFactoryImpl> impl;
 };
 
+/// Returns true when every component of the format is 8-bit UNORM, so it can be filtered bytewise
+[[nodiscard]] bool IsUnorm8Format(RenderTargetFormat format);
+
 } // namespace Tegra::Engines::Blitter
@@ -0,0 +1,239 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "common/alignment.h"
+#include "common/literals.h"
+#include "video_core/engines/sw_blitter/scaler.h"
+#include "video_core/textures/workers.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#elif defined(ARCHITECTURE_arm64)
+#include <arm_neon.h>
+#endif
+
+namespace Tegra::Engines::Blitter {
+namespace {
+using namespace Common::Literals;
+
+/// Images smaller than this are scaled on the calling thread.
+constexpr size_t PARALLEL_SCALE_THRESHOLD = 1_MiB;
+
+/// Approximate amount of output written by each worker task.
+constexpr size_t PARALLEL_SCALE_TASK_SIZE = 256_KiB;
+
+/// Fractional bits of the weights of 8-bit bilinear filtering, weighted pixels fit in 16 bits
+constexpr s32 WEIGHT_BITS = 7;
+constexpr s32 WEIGHT_ONE = 1 << WEIGHT_BITS;
+
+struct BilinearTap {
+    u32 low;
+    u32 high;
+    f32 weight; ///< Weight of the high pixel
+};
+
+/// Calls func with the pixel size as a compile time constant when it is a common one, else zero
+template <typename Func>
+void DispatchPixelSize(size_t bytes_per_pixel, Func&& func) {
+    switch (bytes_per_pixel) {
+    case 1:
+        return func(std::integral_constant<size_t, 1>{});
+    case 2:
+        return func(std::integral_constant<size_t, 2>{});
+    case 4:
+        return func(std::integral_constant<size_t, 4>{});
+    case 8:
+        return func(std::integral_constant<size_t, 8>{});
+    case 16:
+        return func(std::integral_constant<size_t, 16>{});
+    default:
+        return func(std::integral_constant<size_t, 0>{});
+    }
+}
+
+/// Source pixels of each output pixel along an axis, the first and last pixels are kept aligned
+std::vector<BilinearTap> BilinearTaps(u32 src_size, u32 dst_size) {
+    const f32 step =
+        dst_size > 1 ? static_cast<f32>(src_size - 1) / static_cast<f32>(dst_size - 1) : 0.f;
+    std::vector<BilinearTap> taps(dst_size);
+    for (u32 i = 0; i < dst_size; ++i) {
+        const f32 position = static_cast<f32>(i) * step;
+        const f32 low = std::floor(position);
+        taps[i] = {
+            .low = std::min(static_cast<u32>(low), src_size - 1),
+            .high = std::min(static_cast<u32>(std::ceil(position)), src_size - 1),
+            .weight = position - low,
+        };
+    }
+    return taps;
+}
+
+void BilinearPixel(const f32* p00, const f32* p10, const f32* p01, const f32* p11, f32 weight_x,
+                   f32 weight_y, f32* output) {
+#ifdef ARCHITECTURE_x86_64
+    const __m128 x = _mm_set1_ps(weight_x);
+    const __m128 a = _mm_loadu_ps(p00);
+    const __m128 c = _mm_loadu_ps(p01);
+    const __m128 top = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p10), a), x));
+    const __m128 bottom = _mm_add_ps(c, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(p11), c), x));
+    const __m128 y = _mm_set1_ps(weight_y);
+    _mm_storeu_ps(output, _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), y)));
+#elif defined(ARCHITECTURE_arm64)
+    const float32x4_t a = vld1q_f32(p00);
+    const float32x4_t c = vld1q_f32(p01);
+    const float32x4_t top = vaddq_f32(a, vmulq_n_f32(vsubq_f32(vld1q_f32(p10), a), weight_x));
+    const float32x4_t bottom = vaddq_f32(c, vmulq_n_f32(vsubq_f32(vld1q_f32(p11), c), weight_x));
+    vst1q_f32(output, vaddq_f32(top, vmulq_n_f32(vsubq_f32(bottom, top), weight_y)));
+#else
+    for (size_t i = 0; i < IR_COMPONENTS; ++i) {
+        const f32 top = p00[i] + (p10[i] - p00[i]) * weight_x;
+        const f32 bottom = p01[i] + (p11[i] - p01[i]) * weight_x;
+        output[i] = top + (bottom - top) * weight_y;
+    }
+#endif
+}
+
+template <size_t BYTES_PER_PIXEL>
+void BilinearUnorm8Pixel(const u8* p00, const u8* p10, const u8* p01, const u8* p11, s32 weight_x,
+                         s32 weight_y, u8* output, size_t bytes_per_pixel) {
+    constexpr s32 rounding = 1 << (2 * WEIGHT_BITS - 1);
+#ifdef ARCHITECTURE_x86_64
+    if constexpr (BYTES_PER_PIXEL == 4) {
+        const auto load = [](const u8* pixel) {
+            s32 value;
+            std::memcpy(&value, pixel, sizeof(value));
+            return _mm_cvtsi32_si128(value);
+        };
+        // Interleave the pixels to filter, so a multiply-add weighs and sums each pair
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i top_pixels = _mm_unpacklo_epi8(_mm_unpacklo_epi8(load(p00), load(p10)), zero);
+        const __m128i bottom_pixels =
+            _mm_unpacklo_epi8(_mm_unpacklo_epi8(load(p01), load(p11)), zero);
+        const __m128i x = _mm_set1_epi32(weight_x << 16 | (WEIGHT_ONE - weight_x));
+        const __m128i top = _mm_madd_epi16(top_pixels, x);
+        const __m128i bottom = _mm_madd_epi16(bottom_pixels, x);
+        const __m128i rows =
+            _mm_unpacklo_epi16(_mm_packs_epi32(top, top), _mm_packs_epi32(bottom, bottom));
+        const __m128i y = _mm_set1_epi32(weight_y << 16 | (WEIGHT_ONE - weight_y));
+        const __m128i sum = _mm_add_epi32(_mm_madd_epi16(rows, y), _mm_set1_epi32(rounding));
+        const __m128i result = _mm_srli_epi32(sum, 2 * WEIGHT_BITS);
+        const s32 value = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(result, zero), zero));
+        std::memcpy(output, &value, sizeof(value));
+        return;
+    }
+#endif
+    const size_t num_bytes = BYTES_PER_PIXEL != 0 ? BYTES_PER_PIXEL : bytes_per_pixel;
+    for (size_t i = 0; i < num_bytes; ++i) {
+        const s32 top = p00[i] * (WEIGHT_ONE - weight_x) + p10[i] * weight_x;
+        const s32 bottom = p01[i] * (WEIGHT_ONE - weight_x) + p11[i] * weight_x;
+        output[i] = static_cast<u8>(
+            (top * (WEIGHT_ONE - weight_y) + bottom * weight_y + rounding) >> (2 * WEIGHT_BITS));
+    }
+}
+
+} // Anonymous namespace
+
+void NearestNeighbor(std::span<const u8> input, std::span<u8> output, u32 src_width,
+                     u32 src_height, u32 dst_width, u32 dst_height, size_t bytes_per_pixel) {
+    // 32.32 fixed point steps between the source pixels of consecutive output pixels
+    const u64 dx_du = std::llround((static_cast<f64>(src_width) / dst_width) * (1ULL << 32));
+    const u64 dy_dv = std::llround((static_cast<f64>(src_height) / dst_height) * (1ULL << 32));
+
+    // Every row reads the same source columns
+    std::vector<size_t> columns(dst_width);
+    u64 src_x = 0;
+    for (u32 x = 0; x < dst_width; ++x) {
+        columns[x] = std::min<u64>(src_x >> 32, src_width - 1) * bytes_per_pixel;
+        src_x += dx_du;
+    }
+    DispatchPixelSize(bytes_per_pixel, [&](auto pixel_size) {
+        constexpr size_t BYTES_PER_PIXEL = decltype(pixel_size)::value;
+        const size_t size = BYTES_PER_PIXEL != 0 ? BYTES_PER_PIXEL : bytes_per_pixel;
+        ForEachRowBand(dst_height, dst_width * size, [&](u32 begin, u32 end) {
+            for (u32 y = begin; y < end; ++y) {
+                const u64 src_y = std::min<u64>((y * dy_dv) >> 32, src_height - 1);
+                const u8* const src_row = &input[src_y * src_width * size];
+                u8* dst = &output[static_cast<size_t>(y) * dst_width * size];
+                for (u32 x = 0; x < dst_width; ++x, dst += size) {
+                    std::memcpy(dst, src_row + columns[x], size);
+                }
+            }
+        });
+    });
+}
+
+void Bilinear(std::span<const f32> input, std::span<f32> output, u32 src_width, u32 src_height,
+              u32 dst_width, u32 dst_height) {
+    const std::vector<BilinearTap> columns = BilinearTaps(src_width, dst_width);
+    const std::vector<BilinearTap> rows = BilinearTaps(src_height, dst_height);
+    const size_t src_pitch = size_t{src_width} * IR_COMPONENTS;
+    const size_t dst_pitch = size_t{dst_width} * IR_COMPONENTS;
+    ForEachRowBand(dst_height, dst_pitch * sizeof(f32), [&](u32 begin, u32 end) {
+        for (u32 y = begin; y < end; ++y) {
+            const BilinearTap& row = rows[y];
+            const f32* const row_low = &input[row.low * src_pitch];
+            const f32* const row_high = &input[row.high * src_pitch];
+            f32* const dst = &output[y * dst_pitch];
+            for (u32 x = 0; x < dst_width; ++x) {
+                const size_t low = columns[x].low * IR_COMPONENTS;
+                const size_t high = columns[x].high * IR_COMPONENTS;
+                BilinearPixel(row_low + low, row_low + high, row_high + low, row_high + high,
+                              columns[x].weight, row.weight, dst + x * IR_COMPONENTS);
+            }
+        }
+    });
+}
+
+void BilinearUnorm8(std::span<const u8> input, std::span<u8> output, u32 src_width,
+                    u32 src_height, u32 dst_width, u32 dst_height, size_t bytes_per_pixel) {
+    const std::vector<BilinearTap> columns = BilinearTaps(src_width, dst_width);
+    const std::vector<BilinearTap> rows = BilinearTaps(src_height, dst_height);
+    const auto to_fixed = [](f32 weight) {
+        return static_cast<s32>(std::lround(weight * static_cast<f32>(WEIGHT_ONE)));
+    };
+    const size_t src_pitch = size_t{src_width} * bytes_per_pixel;
+    const size_t dst_pitch = size_t{dst_width} * bytes_per_pixel;
+    DispatchPixelSize(bytes_per_pixel, [&](auto pixel_size) {
+        constexpr size_t BYTES_PER_PIXEL = decltype(pixel_size)::value;
+        ForEachRowBand(dst_height, dst_pitch, [&](u32 begin, u32 end) {
+            for (u32 y = begin; y < end; ++y) {
+                const BilinearTap& row = rows[y];
+                const u8* const row_low = &input[row.low * src_pitch];
+                const u8* const row_high = &input[row.high * src_pitch];
+                const s32 weight_y = to_fixed(row.weight);
+                u8* const dst = &output[y * dst_pitch];
+                for (u32 x = 0; x < dst_width; ++x) {
+                    const size_t low = columns[x].low * bytes_per_pixel;
+                    const size_t high = columns[x].high * bytes_per_pixel;
+                    BilinearUnorm8Pixel<BYTES_PER_PIXEL>(
+                        row_low + low, row_low + high, row_high + low, row_high + high,
+                        to_fixed(columns[x].weight), weight_y, dst + x * bytes_per_pixel,
+                        bytes_per_pixel);
+                }
+            }
+        });
+    });
+}
+
+void ForEachRowBand(u32 num_rows, size_t row_size, const std::function<void(u32, u32)>& func) {
+    if (num_rows * row_size < PARALLEL_SCALE_THRESHOLD) {
+        func(0, num_rows);
+        return;
+    }
+    // Bands never share output rows, the workers can write them concurrently
+    const u32 rows_per_task = static_cast<u32>(
+        std::max<size_t>(PARALLEL_SCALE_TASK_SIZE / std::max<size_t>(row_size, 1), 1));
+    const u32 num_bands = Common::DivideUp(num_rows, rows_per_task);
+    Texture::RunTasks(num_bands, [&func, num_rows, rows_per_task](size_t band) {
+        const u32 begin = static_cast<u32>(band) * rows_per_task;
+        func(begin, std::min(begin + rows_per_task, num_rows));
+    });
+}
+
+} // namespace Tegra::Engines::Blitter
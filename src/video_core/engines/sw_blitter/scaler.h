@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <functional>
+#include <span>
+
+#include "common/common_types.h"
+
+namespace Tegra::Engines::Blitter {
+
+/// Components of each pixel in the f32 intermediate representation of the converters
+constexpr size_t IR_COMPONENTS = 4;
+
+/// Scales an image of pixels of any format, taking the source pixel under each output pixel
+void NearestNeighbor(std::span<const u8> input, std::span<u8> output, u32 src_width,
+                     u32 src_height, u32 dst_width, u32 dst_height, size_t bytes_per_pixel);
+
+/// Scales an image in the intermediate representation with bilinear filtering
+void Bilinear(std::span<const f32> input, std::span<f32> output, u32 src_width, u32 src_height,
+              u32 dst_width, u32 dst_height);
+
+/// Scales an image made only of 8-bit UNORM components with bilinear filtering, in fixed point
+void BilinearUnorm8(std::span<const u8> input, std::span<u8> output, u32 src_width,
+                    u32 src_height, u32 dst_width, u32 dst_height, size_t bytes_per_pixel);
+
+/**
+ * Calls func(begin, end) for bands of rows covering [0, num_rows).
+ * Large images are split across the texture workers, small ones run on the calling thread.
+ *
+ * @param num_rows Number of rows of the image
+ * @param row_size Bytes written for each row, used to size the bands
+ * @param func     Function processing the rows in [begin, end)
+ */
+void ForEachRowBand(u32 num_rows, size_t row_size, const std::function<void(u32, u32)>& func);
+
+} // namespace Tegra::Engines::Blitter
@@ -1,6 +1,9 @@
 // SPDX-FileCopyrightText: Copyright 2019 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <chrono>
+#include <cstring>
+
 #include "common/assert.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
@@ -16,6 +19,167 @@
 
 namespace VideoCommon::GPUThread {
 
+CommandQueue::CommandQueue() : entries(EntryCapacity) {}
+
+CommandQueue::~CommandQueue() = default;
+
+void CommandQueue::Push(CommandData&& data, u64 fence, bool block) {
+    const u64 write_index = command_write.load(std::memory_order_relaxed);
+    WaitForSpace(write_index + 1, entry_write);
+
+    CommandDataContainer& slot = commands[write_index % CommandCapacity];
+    slot.data = std::move(data);
+    slot.fence = fence;
+    slot.block = block;
+    Publish(write_index);
+}
+
+void CommandQueue::PushList(s32 channel, Tegra::CommandList&& list, u64 fence, bool block) {
+    const size_t num_command_lists = list.command_lists.size();
+    const size_t num_prefetch_commands = list.prefetch_command_list.size();
+    const size_t command_lists_bytes = num_command_lists * sizeof(Tegra::CommandListHeader);
+    const size_t prefetch_bytes = num_prefetch_commands * sizeof(Tegra::CommandHeader);
+    const size_t num_words = (command_lists_bytes + prefetch_bytes + sizeof(u64) - 1) / sizeof(u64);
+    if (num_words > EntryCapacity) {
+        ++oversized_lists;
+        Push(SubmitListCommand{
+                 .channel = channel,
+                 .num_command_lists = static_cast<u32>(num_command_lists),
+                 .num_prefetch_commands = static_cast<u32>(num_prefetch_commands),
+                 .entries_begin = entry_write,
+                 .entries_end = entry_write,
+                 .oversized_list = std::make_unique<Tegra::CommandList>(std::move(list)),
+             },
+             fence, block);
+        return;
+    }
+
+    // Keep the entries contiguous, skipping the tail of the ring when they don't fit in it.
+    u64 entries_begin = entry_write;
+    const size_t offset = entries_begin % EntryCapacity;
+    if (offset + num_words > EntryCapacity) {
+        entries_begin += EntryCapacity - offset;
+    }
+    const u64 entries_end = entries_begin + num_words;
+
+    const u64 write_index = command_write.load(std::memory_order_relaxed);
+    WaitForSpace(write_index + 1, entries_end);
+
+    u8* const dest = reinterpret_cast<u8*>(entries.data() + entries_begin % EntryCapacity);
+    std::memcpy(dest, list.command_lists.data(), command_lists_bytes);
+    std::memcpy(dest + command_lists_bytes, list.prefetch_command_list.data(), prefetch_bytes);
+    entry_write = entries_end;
+    pushed_entry_words.fetch_add(num_words, std::memory_order_relaxed);
+
+    CommandDataContainer& slot = commands[write_index % CommandCapacity];
+    slot.data = SubmitListCommand{
+        .channel = channel,
+        .num_command_lists = static_cast<u32>(num_command_lists),
+        .num_prefetch_commands = static_cast<u32>(num_prefetch_commands),
+        .entries_begin = entries_begin,
+        .entries_end = entries_end,
+        .oversized_list = nullptr,
+    };
+    slot.fence = fence;
+    slot.block = block;
+    Publish(write_index);
+}
+
+CommandDataContainer* CommandQueue::Front(std::stop_token stop_token) {
+    const u64 read_index = command_read.load(std::memory_order_relaxed);
+    if (read_index == command_write.load(std::memory_order_acquire)) {
+        std::unique_lock lock{consumer_mutex};
+        // Pairs with the producer reading the flag after publishing, one of both sees the other.
+        consumer_waiting.store(true);
+        Common::CondvarWait(consumer_cv, lock, stop_token,
+                            [this, read_index] { return read_index != command_write.load(); });
+        consumer_waiting.store(false, std::memory_order_relaxed);
+        if (stop_token.stop_requested()) {
+            return nullptr;
+        }
+    }
+    return &commands[read_index % CommandCapacity];
+}
+
+Tegra::CommandList CommandQueue::TakeCommandList(SubmitListCommand& command) const {
+    if (command.oversized_list) {
+        Tegra::CommandList list = std::move(*command.oversized_list);
+        command.oversized_list.reset();
+        return list;
+    }
+    // Lists of up to 512 entries fit in the inline storage of the command list.
+    Tegra::CommandList list;
+    list.command_lists.resize(command.num_command_lists);
+    list.prefetch_command_list.resize(command.num_prefetch_commands);
+    const size_t command_lists_bytes =
+        command.num_command_lists * sizeof(Tegra::CommandListHeader);
+    const u8* const src =
+        reinterpret_cast<const u8*>(entries.data() + command.entries_begin % EntryCapacity);
+    std::memcpy(list.command_lists.data(), src, command_lists_bytes);
+    std::memcpy(list.prefetch_command_list.data(), src + command_lists_bytes,
+                command.num_prefetch_commands * sizeof(Tegra::CommandHeader));
+    return list;
+}
+
+void CommandQueue::Pop() {
+    const u64 read_index = command_read.load(std::memory_order_relaxed);
+    CommandDataContainer& slot = commands[read_index % CommandCapacity];
+    if (const auto* submit_list = std::get_if<SubmitListCommand>(&slot.data)) {
+        entry_read.store(submit_list->entries_end, std::memory_order_release);
+    }
+    command_read.store(read_index + 1);
+    if (producer_waiting.load()) {
+        std::scoped_lock lock{producer_mutex};
+        producer_cv.notify_one();
+    }
+}
+
+CommandQueueStatistics CommandQueue::GetStatistics() const {
+    return {
+        .pushed_commands = pushed_commands.load(std::memory_order_relaxed),
+        .pushed_entry_words = pushed_entry_words.load(std::memory_order_relaxed),
+        .oversized_lists = oversized_lists.load(std::memory_order_relaxed),
+        .producer_stalls = producer_stalls.load(std::memory_order_relaxed),
+        .producer_stall_time_us = producer_stall_time_us.load(std::memory_order_relaxed),
+        .max_queued_commands = max_queued_commands.load(std::memory_order_relaxed),
+    };
+}
+
+void CommandQueue::WaitForSpace(u64 command_end, u64 entry_end) {
+    const auto has_space = [this, command_end, entry_end] {
+        return command_end - command_read.load() <= CommandCapacity &&
+               entry_end - entry_read.load() <= EntryCapacity;
+    };
+    if (has_space()) {
+        return;
+    }
+    const auto stall_begin = std::chrono::steady_clock::now();
+    {
+        std::unique_lock lock{producer_mutex};
+        producer_waiting.store(true);
+        producer_cv.wait(lock, has_space);
+        producer_waiting.store(false, std::memory_order_relaxed);
+    }
+    const auto stall_time = std::chrono::steady_clock::now() - stall_begin;
+    producer_stalls.fetch_add(1, std::memory_order_relaxed);
+    producer_stall_time_us.fetch_add(
+        std::chrono::duration_cast<std::chrono::microseconds>(stall_time).count(),
+        std::memory_order_relaxed);
+}
+
+void CommandQueue::Publish(u64 write_index) {
+    command_write.store(write_index + 1);
+    pushed_commands.fetch_add(1, std::memory_order_relaxed);
+    const u64 queued = write_index + 1 - command_read.load(std::memory_order_relaxed);
+    if (queued > max_queued_commands.load(std::memory_order_relaxed)) {
+        max_queued_commands.store(queued, std::memory_order_relaxed);
+    }
+    if (consumer_waiting.load()) {
+        std::scoped_lock lock{consumer_mutex};
+        consumer_cv.notify_one();
+    }
+}
+
 /// Runs the GPU thread
 static void RunThread(std::stop_token stop_token, Core::System& system,
                       VideoCore::RendererBase& renderer, Core::Frontend::GraphicsContext& context,
@@ -33,26 +197,27 @@ static void RunThread(std::stop_token stop_token, Core::System& system,
     auto current_context = context.Acquire();
     VideoCore::RasterizerInterface* const rasterizer = renderer.ReadRasterizer();
 
-    CommandDataContainer next;
-
     while (!stop_token.stop_requested()) {
-        state.queue.PopWait(next, stop_token);
-        if (stop_token.stop_requested()) {
+        CommandDataContainer* const next = state.queue.Front(stop_token);
+        if (next == nullptr) {
             break;
         }
-        if (auto* submit_list = std::get_if<SubmitListCommand>(&next.data)) {
-            scheduler.Push(submit_list->channel, std::move(submit_list->entries));
-        } else if (std::holds_alternative<GPUTickCommand>(next.data)) {
+        if (auto* submit_list = std::get_if<SubmitListCommand>(&next->data)) {
+            scheduler.Push(submit_list->channel, state.queue.TakeCommandList(*submit_list));
+        } else if (std::holds_alternative<GPUTickCommand>(next->data)) {
             system.GPU().TickWork();
-        } else if (const auto* flush = std::get_if<FlushRegionCommand>(&next.data)) {
+        } else if (const auto* flush = std::get_if<FlushRegionCommand>(&next->data)) {
             rasterizer->FlushRegion(flush->addr, flush->size);
-        } else if (const auto* invalidate = std::get_if<InvalidateRegionCommand>(&next.data)) {
+        } else if (const auto* invalidate = std::get_if<InvalidateRegionCommand>(&next->data)) {
             rasterizer->OnCacheInvalidation(invalidate->addr, invalidate->size);
         } else {
             ASSERT(false);
         }
-        state.signaled_fence.store(next.fence);
-        if (next.block) {
+        const u64 fence = next->fence;
+        const bool block = next->block;
+        state.queue.Pop();
+        state.signaled_fence.store(fence);
+        if (block) {
             // We have to lock the write_lock to ensure that the condition_variable wait not get a
             // race between the check and the lock itself.
             std::scoped_lock lk{state.write_lock};
@@ -64,7 +229,15 @@ static void RunThread(std::stop_token stop_token, Core::System& system,
 ThreadManager::ThreadManager(Core::System& system_, bool is_async_)
     : system{system_}, is_async{is_async_} {}
 
-ThreadManager::~ThreadManager() = default;
+ThreadManager::~ThreadManager() {
+    const CommandQueueStatistics statistics = state.queue.GetStatistics();
+    LOG_DEBUG(HW_GPU,
+              "GPU thread queue: {} commands, {} entry words, {} oversized lists, "
+              "{} stalls for {} us, at most {} queued",
+              statistics.pushed_commands, statistics.pushed_entry_words,
+              statistics.oversized_lists, statistics.producer_stalls,
+              statistics.producer_stall_time_us, statistics.max_queued_commands);
+}
 
 void ThreadManager::StartThread(VideoCore::RendererBase& renderer,
                                 Core::Frontend::GraphicsContext& context,
@@ -75,7 +248,7 @@ void ThreadManager::StartThread(VideoCore::RendererBase& renderer,
 }
 
 void ThreadManager::SubmitList(s32 channel, Tegra::CommandList&& entries) {
-    PushCommand(SubmitListCommand(channel, std::move(entries)));
+    PushCommandList(channel, std::move(entries));
 }
 
 void ThreadManager::FlushRegion(DAddr addr, u64 size) {
@@ -114,15 +287,34 @@ u64 ThreadManager::PushCommand(CommandData&& command_data, bool block) {
 
     std::unique_lock lk(state.write_lock);
     const u64 fence{++state.last_fence};
-    state.queue.EmplaceWait(std::move(command_data), fence, block);
+    state.queue.Push(std::move(command_data), fence, block);
+
+    if (block) {
+        WaitForFence(lk, fence);
+    }
+
+    return fence;
+}
+
+u64 ThreadManager::PushCommandList(s32 channel, Tegra::CommandList&& entries) {
+    // In synchronous GPU mode, block the caller until the command has executed
+    const bool block = !is_async;
+
+    std::unique_lock lk(state.write_lock);
+    const u64 fence{++state.last_fence};
+    state.queue.PushList(channel, std::move(entries), fence, block);
 
     if (block) {
-        Common::CondvarWait(state.cv, lk, thread.get_stop_token(), [this, fence] {
-            return fence <= state.signaled_fence.load(std::memory_order_relaxed);
-        });
+        WaitForFence(lk, fence);
     }
 
     return fence;
 }
 
+void ThreadManager::WaitForFence(std::unique_lock<std::mutex>& lock, u64 fence) {
+    Common::CondvarWait(state.cv, lock, thread.get_stop_token(), [this, fence] {
+        return fence <= state.signaled_fence.load(std::memory_order_relaxed);
+    });
+}
+
 } // namespace VideoCommon::GPUThread
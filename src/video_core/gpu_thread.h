@@ -3,18 +3,21 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <thread>
 #include <variant>
+#include <vector>
 
-#include "common/bounded_threadsafe_queue.h"
 #include "common/polyfill_thread.h"
 #include "video_core/framebuffer_config.h"
 
 namespace Tegra {
+struct CommandList;
 struct FramebufferConfig;
 namespace Control {
 class Scheduler;
@@ -37,11 +40,12 @@ namespace VideoCommon::GPUThread {
 
 /// Command to signal to the GPU thread that a command list is ready for processing
 struct SubmitListCommand final {
-    explicit SubmitListCommand(s32 channel_, Tegra::CommandList&& entries_)
-        : channel{channel_}, entries{std::move(entries_)} {}
-
     s32 channel;
-    Tegra::CommandList entries;
+    u32 num_command_lists;
+    u32 num_prefetch_commands;
+    u64 entries_begin; ///< Position of the entries in the entry ring of the command queue
+    u64 entries_end;
+    std::unique_ptr<Tegra::CommandList> oversized_list; ///< Set when the ring can't hold it
 };
 
 /// Command to signal to the GPU thread to flush a region
@@ -87,9 +91,78 @@ struct CommandDataContainer {
     bool block{};
 };
 
+/// Backpressure counters of the command queue, collected since it was created
+struct CommandQueueStatistics {
+    u64 pushed_commands{};
+    u64 pushed_entry_words{};
+    u64 oversized_lists{};     ///< Command lists larger than the entry ring, heap allocated
+    u64 producer_stalls{};     ///< Pushes that had to wait for the GPU thread to make room
+    u64 producer_stall_time_us{};
+    u64 max_queued_commands{}; ///< Highest number of commands waiting for the GPU thread
+};
+
+/**
+ * Fixed capacity ring of commands for the GPU thread. Command list entries are copied into a
+ * preallocated ring of words next to it, so submitting a list neither allocates nor locks unless
+ * the GPU thread fell behind and the producer has to wait for room.
+ * Only one thread may push at a time, and only the GPU thread may pop.
+ */
+class CommandQueue final {
+public:
+    static constexpr size_t CommandCapacity = 0x1000;
+    static constexpr size_t EntryCapacity = 0x10000;
+
+    CommandQueue();
+    ~CommandQueue();
+
+    /// Pushes a command, waiting for a free slot when the ring is full.
+    void Push(CommandData&& data, u64 fence, bool block);
+
+    /// Copies the entries of a command list into the ring and pushes a command referencing them.
+    void PushList(s32 channel, Tegra::CommandList&& entries, u64 fence, bool block);
+
+    /// Waits for the oldest command, returns nullptr when the stop token is triggered.
+    [[nodiscard]] CommandDataContainer* Front(std::stop_token stop_token);
+
+    /// Builds the command list referenced by a command returned by Front.
+    [[nodiscard]] Tegra::CommandList TakeCommandList(SubmitListCommand& command) const;
+
+    /// Releases the oldest command and its entries.
+    void Pop();
+
+    [[nodiscard]] CommandQueueStatistics GetStatistics() const;
+
+private:
+    /// Waits until the consumer released everything before the given positions.
+    void WaitForSpace(u64 command_end, u64 entry_end);
+
+    void Publish(u64 write_index);
+
+    alignas(128) std::atomic<u64> command_read{};
+    std::atomic<u64> entry_read{};
+    alignas(128) std::atomic<u64> command_write{};
+    u64 entry_write{};
+
+    std::atomic_bool consumer_waiting{};
+    std::atomic_bool producer_waiting{};
+    std::mutex consumer_mutex;
+    std::condition_variable_any consumer_cv;
+    std::mutex producer_mutex;
+    std::condition_variable_any producer_cv;
+
+    std::array<CommandDataContainer, CommandCapacity> commands;
+    std::vector<u64> entries;
+
+    std::atomic<u64> pushed_commands{};
+    std::atomic<u64> pushed_entry_words{};
+    std::atomic<u64> oversized_lists{};
+    std::atomic<u64> producer_stalls{};
+    std::atomic<u64> producer_stall_time_us{};
+    std::atomic<u64> max_queued_commands{};
+};
+
 /// Struct used to synchronize the GPU thread
 struct SynchState final {
-    using CommandQueue = Common::MPSCQueue<CommandDataContainer>;
     std::mutex write_lock;
     CommandQueue queue;
     u64 last_fence{};
@@ -121,10 +194,20 @@ public:
 
     void TickGPU();
 
+    [[nodiscard]] CommandQueueStatistics GetQueueStatistics() const {
+        return state.queue.GetStatistics();
+    }
+
 private:
     /// Pushes a command to be executed by the GPU thread
     u64 PushCommand(CommandData&& command_data, bool block = false);
 
+    /// Pushes a command list to be executed by the GPU thread
+    u64 PushCommandList(s32 channel, Tegra::CommandList&& entries);
+
+    /// Waits for the GPU thread to signal the given fence, called with the write lock held
+    void WaitForFence(std::unique_lock<std::mutex>& lock, u64 fence);
+
     Core::System& system;
     const bool is_async;
     VideoCore::RasterizerInterface* rasterizer = nullptr;
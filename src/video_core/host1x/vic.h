@@ -7,8 +7,7 @@
 
 #include "common/common_types.h"
 #include "common/scratch_buffer.h"
-
-struct SwsContext;
+#include "video_core/host1x/vic_frame.h"
 
 namespace Tegra {
 
@@ -48,18 +47,13 @@ private:
 
     /// Avoid reallocation of the following buffers every frame, as their
     /// size does not change during a stream
-    using AVMallocPtr = std::unique_ptr<u8, decltype(&av_free)>;
-    AVMallocPtr converted_frame_buffer;
+    RGBFrameConverter rgb_converter;
     Common::ScratchBuffer<u8> luma_buffer;
     Common::ScratchBuffer<u8> chroma_buffer;
 
     GPUVAddr config_struct_address{};
     GPUVAddr output_surface_luma_address{};
     GPUVAddr output_surface_chroma_address{};
-
-    SwsContext* scaler_ctx{};
-    s32 scaler_width{};
-    s32 scaler_height{};
 };
 
 } // namespace Host1x
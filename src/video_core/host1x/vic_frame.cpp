@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+
+extern "C" {
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+}
+
+#include "common/alignment.h"
+#include "common/literals.h"
+#include "common/logging/log.h"
+#include "video_core/host1x/vic_frame.h"
+#include "video_core/textures/workers.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#elif defined(ARCHITECTURE_arm64)
+#include <arm_neon.h>
+#endif
+
+namespace Tegra::Host1x {
+namespace {
+using namespace Common::Literals;
+
+/// Frames smaller than this are converted on the calling thread.
+constexpr size_t PARALLEL_CONVERSION_THRESHOLD = 1_MiB;
+
+/// Approximate amount of converted pixels written by each band.
+constexpr size_t PARALLEL_CONVERSION_TASK_SIZE = 1_MiB;
+
+/// Bands start on multiples of this many rows, keeping them aligned to the subsampled chroma.
+constexpr size_t BAND_ROW_ALIGNMENT = 16;
+} // Anonymous namespace
+
+struct RGBFrameConverter::Band {
+    std::unique_ptr<SwsContext, decltype(&sws_freeContext)> context;
+    int first_row;
+    int num_rows;
+};
+
+void InterleaveChroma(u8* output, size_t output_pitch, const u8* chroma_u, const u8* chroma_v,
+                      size_t input_pitch, size_t width, size_t height) {
+    for (size_t y = 0; y < height; ++y) {
+        const u8* const src_u = chroma_u + y * input_pitch;
+        const u8* const src_v = chroma_v + y * input_pitch;
+        u8* const dst = output + y * output_pitch;
+        size_t x = 0;
+#ifdef ARCHITECTURE_x86_64
+        for (; x + 16 <= width; x += 16) {
+            const __m128i u = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_u + x));
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_v + x));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 2), _mm_unpacklo_epi8(u, v));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 2 + 16),
+                             _mm_unpackhi_epi8(u, v));
+        }
+#elif defined(ARCHITECTURE_arm64)
+        for (; x + 16 <= width; x += 16) {
+            uint8x16x2_t samples;
+            samples.val[0] = vld1q_u8(src_u + x);
+            samples.val[1] = vld1q_u8(src_v + x);
+            vst2q_u8(dst + x * 2, samples);
+        }
+#endif
+        for (; x < width; ++x) {
+            dst[x * 2] = src_u[x];
+            dst[x * 2 + 1] = src_v[x];
+        }
+    }
+}
+
+RGBFrameConverter::RGBFrameConverter() = default;
+
+RGBFrameConverter::~RGBFrameConverter() = default;
+
+std::span<const u8> RGBFrameConverter::Convert(const FFmpeg::Frame& frame, AVPixelFormat format) {
+    const int width = frame.GetWidth();
+    const int height = frame.GetHeight();
+    if (!buffer || width != frame_width || height != frame_height ||
+        frame.GetPixelFormat() != frame_format || format != target_format) {
+        Configure(width, height, frame.GetPixelFormat(), format);
+    }
+    if (bands.empty()) {
+        // No scaler could be created for this conversion, there is nothing to write
+        return {};
+    }
+    const size_t pitch = static_cast<size_t>(width) * 4;
+    const AVPixFmtDescriptor* const descriptor = av_pix_fmt_desc_get(frame_format);
+    const auto convert_band = [&](const Band& band) {
+        // Each band sees its rows as a whole frame, move the planes to its first row
+        std::array<const u8*, 4> planes{};
+        for (int plane = 0; plane < static_cast<int>(planes.size()); ++plane) {
+            const u8* const data = frame.GetData(plane);
+            if (!data) {
+                continue;
+            }
+            const bool is_chroma = plane == 1 || plane == 2;
+            const int row = band.first_row >> (is_chroma ? descriptor->log2_chroma_h : 0);
+            planes[plane] = data + static_cast<ptrdiff_t>(row) * frame.GetStride(plane);
+        }
+        u8* const output = buffer.get() + static_cast<size_t>(band.first_row) * pitch;
+        const std::array<int, 4> output_stride{static_cast<int>(pitch), 0, 0, 0};
+        sws_scale(band.context.get(), planes.data(), frame.GetStrides(), 0, band.num_rows,
+                  &output, output_stride.data());
+    };
+    Texture::RunTasks(bands.size(), [&](size_t index) { convert_band(bands[index]); });
+    return {buffer.get(), pitch * static_cast<size_t>(height)};
+}
+
+void RGBFrameConverter::Configure(int width, int height, AVPixelFormat src_format,
+                                  AVPixelFormat dst_format) {
+    frame_width = width;
+    frame_height = height;
+    frame_format = src_format;
+    target_format = dst_format;
+
+    const size_t pitch = static_cast<size_t>(width) * 4;
+    const size_t frame_size = pitch * static_cast<size_t>(height);
+    buffer.reset(static_cast<u8*>(av_malloc(frame_size)));
+
+    // Unscaled YUV420P to RGBA and BGRA conversions of frames with an even height compute every
+    // pair of rows on its own. Other conversions, like the generic scaler used for RGB0 or odd
+    // heights, may filter chroma across rows and are converted whole to keep the bands seamless.
+    const bool is_band_safe = src_format == AV_PIX_FMT_YUV420P &&
+                              (dst_format == AV_PIX_FMT_RGBA || dst_format == AV_PIX_FMT_BGRA) &&
+                              height % 2 == 0;
+    int rows_per_band = height;
+    if (is_band_safe && frame_size >= PARALLEL_CONVERSION_THRESHOLD) {
+        const size_t rows = std::max<size_t>(PARALLEL_CONVERSION_TASK_SIZE / pitch, 1);
+        rows_per_band = static_cast<int>(Common::AlignUp(rows, BAND_ROW_ALIGNMENT));
+    }
+    bool is_created = CreateBands(rows_per_band);
+    if (!is_created && rows_per_band != height) {
+        // Fall back to converting the whole frame with a single scaler
+        is_created = CreateBands(height);
+    }
+    if (!is_created) {
+        LOG_ERROR(Service_NVDRV, "Failed to create a scaler from {} to {}",
+                  static_cast<int>(src_format), static_cast<int>(dst_format));
+    }
+}
+
+bool RGBFrameConverter::CreateBands(int rows_per_band) {
+    bands.clear();
+    for (int first_row = 0; first_row < frame_height; first_row += rows_per_band) {
+        const int num_rows = std::min(rows_per_band, frame_height - first_row);
+        SwsContext* const context =
+            sws_getContext(frame_width, num_rows, frame_format, frame_width, num_rows,
+                           target_format, 0, nullptr, nullptr, nullptr);
+        if (!context) {
+            bands.clear();
+            return false;
+        }
+        bands.push_back({
+            .context{context, sws_freeContext},
+            .first_row = first_row,
+            .num_rows = num_rows,
+        });
+    }
+    return true;
+}
+
+} // namespace Tegra::Host1x
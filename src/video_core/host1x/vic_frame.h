@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+#include "video_core/host1x/ffmpeg/ffmpeg.h"
+
+namespace Tegra::Host1x {
+
+/**
+ * Interleaves the chroma planes of a YUV420P frame into the chroma lines of an NV12 surface.
+ *
+ * @param output       First chroma line of the surface
+ * @param output_pitch Distance in bytes between two chroma lines of the surface
+ * @param chroma_u     First plane, stored in the even bytes of the surface
+ * @param chroma_v     Second plane, stored in the odd bytes of the surface
+ * @param input_pitch  Distance in bytes between two lines of the planes
+ * @param width        Number of samples in each line of the planes
+ * @param height       Number of lines of the planes
+ */
+void InterleaveChroma(u8* output, size_t output_pitch, const u8* chroma_u, const u8* chroma_v,
+                      size_t input_pitch, size_t width, size_t height);
+
+/**
+ * Converts decoded frames to packed 32-bit RGB pixels.
+ * Large YUV420P frames are split in bands of rows converted in parallel, each with its own
+ * scaler context. Contexts and the output buffer are reused while the frames keep their size.
+ */
+class RGBFrameConverter {
+public:
+    YUZU_NON_COPYABLE(RGBFrameConverter);
+    YUZU_NON_MOVEABLE(RGBFrameConverter);
+
+    RGBFrameConverter();
+    ~RGBFrameConverter();
+
+    /**
+     * Converts the frame to the given format, returns its rows of four bytes per pixel.
+     * The returned span is empty when no scaler supports the conversion.
+     */
+    [[nodiscard]] std::span<const u8> Convert(const FFmpeg::Frame& frame, AVPixelFormat format);
+
+private:
+    struct Band;
+
+    void Configure(int width, int height, AVPixelFormat src_format, AVPixelFormat dst_format);
+
+    /// Creates a scaler for each band of rows, returns false and leaves no bands on failure
+    bool CreateBands(int rows_per_band);
+
+    std::vector<Band> bands;
+    std::unique_ptr<u8, decltype(&av_free)> buffer{nullptr, av_free};
+    int frame_width{};
+    int frame_height{};
+    AVPixelFormat frame_format{AV_PIX_FMT_NONE};
+    AVPixelFormat target_format{AV_PIX_FMT_NONE};
+};
+
+} // namespace Tegra::Host1x
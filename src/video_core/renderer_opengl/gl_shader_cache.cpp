@@ -452,6 +452,7 @@ std::unique_ptr<GraphicsPipeline> ShaderCache::CreateGraphicsPipeline(
     bool force_context_flush) try {
     auto hash = key.Hash();
     LOG_INFO(Render_OpenGL, "0x{:016x}", hash);
+    const Shader::ArenaScope arena_scope{pools.arena};
     size_t env_index{};
     u32 total_storage_buffers{};
     std::array<Shader::IR::Program, Maxwell::MaxShaderProgram> programs;
@@ -575,6 +576,7 @@ std::unique_ptr<ComputePipeline> ShaderCache::CreateComputePipeline(
     auto hash = key.Hash();
     LOG_INFO(Render_OpenGL, "0x{:016x}", hash);
 
+    const Shader::ArenaScope arena_scope{pools.arena};
     Shader::Maxwell::Flow::CFG cfg{env, pools.flow_block, env.StartAddress()};
 
     if (Settings::values.dump_shaders) {
@@ -53,7 +53,7 @@ using VideoCommon::FileEnvironment;
 using VideoCommon::GenericEnvironment;
 using VideoCommon::GraphicsEnvironment;
 
-constexpr u32 CACHE_VERSION = 11;
+constexpr u32 CACHE_VERSION = PIPELINE_CACHE_VERSION;
 constexpr std::array<char, 8> VULKAN_CACHE_MAGIC_NUMBER{'y', 'u', 'z', 'u', 'v', 'k', 'c', 'h'};
 
 template <typename Container>
@@ -278,6 +278,13 @@ size_t GetTotalPipelineWorkers() {
 #endif
 }
 
+/// Shader pools of the calling pipeline worker, kept between the pipelines it loads
+ShaderPools& WorkerShaderPools() {
+    thread_local ShaderPools pools;
+    pools.ReleaseContents();
+    return pools;
+}
+
 } // Anonymous namespace
 
 size_t ComputePipelineCacheKey::Hash() const noexcept {
@@ -298,6 +305,101 @@ bool GraphicsPipelineCacheKey::operator==(const GraphicsPipelineCacheKey& rhs) c
     return std::memcmp(&rhs, this, Size()) == 0;
 }
 
+std::vector<VideoCommon::TranslatedShader> TranslateGraphicsPipeline(
+    ShaderPools& pools, const GraphicsPipelineCacheKey& key,
+    std::span<Shader::Environment* const> envs, const Shader::Profile& profile,
+    const Shader::HostTranslateInfo& host_info) {
+    const Shader::ArenaScope arena_scope{pools.arena};
+    const size_t hash{key.Hash()};
+    size_t env_index{0};
+    std::array<Shader::IR::Program, Maxwell::MaxShaderProgram> programs;
+    const bool uses_vertex_a{key.unique_hashes[0] != 0};
+    const bool uses_vertex_b{key.unique_hashes[1] != 0};
+
+    // Layer passthrough generation for devices without VK_EXT_shader_viewport_index_layer
+    Shader::IR::Program* layer_source_program{};
+
+    for (size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
+        const bool is_emulated_stage = layer_source_program != nullptr &&
+                                       index == static_cast<u32>(Maxwell::ShaderType::Geometry);
+        if (key.unique_hashes[index] == 0 && is_emulated_stage) {
+            auto topology = MaxwellToOutputTopology(key.state.topology);
+            programs[index] = GenerateGeometryPassthrough(pools.inst, pools.block, host_info,
+                                                          *layer_source_program, topology);
+            continue;
+        }
+        if (key.unique_hashes[index] == 0) {
+            continue;
+        }
+        Shader::Environment& env{*envs[env_index]};
+        ++env_index;
+
+        const u32 cfg_offset{static_cast<u32>(env.StartAddress() + sizeof(Shader::ProgramHeader))};
+        Shader::Maxwell::Flow::CFG cfg(env, pools.flow_block, cfg_offset, index == 0);
+        if (!uses_vertex_a || index != 1) {
+            // Normal path
+            programs[index] = TranslateProgram(pools.inst, pools.block, env, cfg, host_info);
+        } else {
+            // VertexB path when VertexA is present.
+            auto& program_va{programs[0]};
+            auto program_vb{TranslateProgram(pools.inst, pools.block, env, cfg, host_info)};
+            programs[index] = MergeDualVertexPrograms(program_va, program_vb, env);
+        }
+
+        if (Settings::values.dump_shaders) {
+            env.Dump(hash, key.unique_hashes[index]);
+        }
+
+        if (programs[index].info.requires_layer_emulation) {
+            layer_source_program = &programs[index];
+        }
+    }
+    std::vector<VideoCommon::TranslatedShader> translated_shaders;
+    const Shader::IR::Program* previous_stage{};
+    Shader::Backend::Bindings binding;
+    for (size_t index = uses_vertex_a && uses_vertex_b ? 1 : 0; index < Maxwell::MaxShaderProgram;
+         ++index) {
+        const bool is_emulated_stage = layer_source_program != nullptr &&
+                                       index == static_cast<u32>(Maxwell::ShaderType::Geometry);
+        if (key.unique_hashes[index] == 0 && !is_emulated_stage) {
+            continue;
+        }
+        UNIMPLEMENTED_IF(index == 0);
+
+        Shader::IR::Program& program{programs[index]};
+        const auto runtime_info{MakeRuntimeInfo(programs, key, program, previous_stage)};
+        ConvertLegacyToGeneric(program, runtime_info);
+        translated_shaders.push_back({
+            .stage_index = static_cast<u32>(index - 1),
+            .code = EmitSPIRV(profile, runtime_info, program, binding),
+            .info = program.info,
+        });
+        previous_stage = &program;
+    }
+    return translated_shaders;
+}
+
+VideoCommon::TranslatedShader TranslateComputePipeline(ShaderPools& pools,
+                                                       const ComputePipelineCacheKey& key,
+                                                       Shader::Environment& env,
+                                                       const Shader::Profile& profile,
+                                                       const Shader::HostTranslateInfo& host_info) {
+    const Shader::ArenaScope arena_scope{pools.arena};
+    Shader::Maxwell::Flow::CFG cfg{env, pools.flow_block, env.StartAddress()};
+
+    // Dump it before error.
+    if (Settings::values.dump_shaders) {
+        env.Dump(key.Hash(), key.unique_hash);
+    }
+
+    auto program{TranslateProgram(pools.inst, pools.block, env, cfg, host_info)};
+    return {
+        .stage_index = 0,
+        .code = EmitSPIRV(profile, program),
+        .info = program.info,
+    };
+}
+
 PipelineCache::PipelineCache(Tegra::MaxwellDeviceMemoryManager& device_memory_,
                              const Device& device_, Scheduler& scheduler_,
                              DescriptorPool& descriptor_pool_,
@@ -477,6 +579,11 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
         vulkan_pipeline_cache =
             LoadVulkanPipelineCache(vulkan_pipeline_cache_filename, CACHE_VERSION);
     }
+    VideoCommon::SaveTranslationProfile(base_dir / "vulkan_translation_profile.bin", profile,
+                                        host_info);
+    translation_cache = std::make_unique<VideoCommon::ShaderTranslationCache>(
+        base_dir / "vulkan_translated.bin", CACHE_VERSION,
+        VideoCommon::HashTranslationProfile(profile, host_info));
 
     struct {
         std::mutex mutex;
@@ -494,7 +601,7 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
         file.read(reinterpret_cast<char*>(&key), sizeof(key));
 
         workers.QueueWork([this, key, env_ = std::move(env), &state, &callback]() mutable {
-            ShaderPools pools;
+            ShaderPools& pools{WorkerShaderPools()};
             auto pipeline{CreateComputePipeline(pools, key, env_, state.statistics.get(), false)};
             std::scoped_lock lock{state.mutex};
             if (pipeline) {
@@ -525,7 +632,7 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
             return;
         }
         workers.QueueWork([this, key, envs_ = std::move(envs), &state, &callback]() mutable {
-            ShaderPools pools;
+            ShaderPools& pools{WorkerShaderPools()};
             boost::container::static_vector<Shader::Environment*, 5> env_ptrs;
             for (auto& env : envs_) {
                 env_ptrs.push_back(&env);
@@ -564,6 +671,7 @@ void PipelineCache::LoadDiskResources(u64 title_id, std::stop_token stop_loading
     if (state.statistics) {
         state.statistics->Report();
     }
+    translation_cache->ReportStatistics();
 }
 
 GraphicsPipeline* PipelineCache::CurrentGraphicsPipelineSlowPath() {
@@ -610,23 +718,24 @@ std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline(
     bool build_in_parallel) try {
     auto hash = key.Hash();
     LOG_INFO(Render_Vulkan, "0x{:016x}", hash);
-    size_t env_index{0};
-    std::array<Shader::IR::Program, Maxwell::MaxShaderProgram> programs;
-    const bool uses_vertex_a{key.unique_hashes[0] != 0};
-    const bool uses_vertex_b{key.unique_hashes[1] != 0};
-
-    // Layer passthrough generation for devices without VK_EXT_shader_viewport_index_layer
-    Shader::IR::Program* layer_source_program{};
+    // Only pipelines loaded from disk have environments with their full state before translation
+    if (translation_cache && !build_in_parallel) {
+        const auto translated{translation_cache->Find(hash, VideoCommon::HashEnvironments(envs))};
+        if (translated) {
+            return CreateGraphicsPipeline(key, *translated, statistics, build_in_parallel);
+        }
+    }
+    const std::vector<VideoCommon::TranslatedShader> translated{
+        TranslateGraphicsPipeline(pools, key, envs, profile, host_info)};
+    if (translation_cache) {
+        translation_cache->Store(hash, VideoCommon::HashEnvironments(envs), translated);
+    }
+    return CreateGraphicsPipeline(key, translated, statistics, build_in_parallel);
 
+} catch (const Shader::Exception& exception) {
+    auto hash = key.Hash();
+    size_t env_index{0};
     for (size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
-        const bool is_emulated_stage = layer_source_program != nullptr &&
-                                       index == static_cast<u32>(Maxwell::ShaderType::Geometry);
-        if (key.unique_hashes[index] == 0 && is_emulated_stage) {
-            auto topology = MaxwellToOutputTopology(key.state.topology);
-            programs[index] = GenerateGeometryPassthrough(pools.inst, pools.block, host_info,
-                                                          *layer_source_program, topology);
-            continue;
-        }
         if (key.unique_hashes[index] == 0) {
             continue;
         }
@@ -635,75 +744,38 @@ std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline(
 
         const u32 cfg_offset{static_cast<u32>(env.StartAddress() + sizeof(Shader::ProgramHeader))};
         Shader::Maxwell::Flow::CFG cfg(env, pools.flow_block, cfg_offset, index == 0);
-        if (!uses_vertex_a || index != 1) {
-            // Normal path
-            programs[index] = TranslateProgram(pools.inst, pools.block, env, cfg, host_info);
-        } else {
-            // VertexB path when VertexA is present.
-            auto& program_va{programs[0]};
-            auto program_vb{TranslateProgram(pools.inst, pools.block, env, cfg, host_info)};
-            programs[index] = MergeDualVertexPrograms(program_va, program_vb, env);
-        }
-
-        if (Settings::values.dump_shaders) {
-            env.Dump(hash, key.unique_hashes[index]);
-        }
-
-        if (programs[index].info.requires_layer_emulation) {
-            layer_source_program = &programs[index];
-        }
+        env.Dump(hash, key.unique_hashes[index]);
     }
+    LOG_ERROR(Render_Vulkan, "{}", exception.what());
+    return nullptr;
+}
+
+std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline(
+    const GraphicsPipelineCacheKey& key,
+    std::span<const VideoCommon::TranslatedShader> translated_shaders,
+    PipelineStatistics* statistics, bool build_in_parallel) {
     std::array<const Shader::Info*, Maxwell::MaxShaderStage> infos{};
     std::array<vk::ShaderModule, Maxwell::MaxShaderStage> modules;
-
-    const Shader::IR::Program* previous_stage{};
-    Shader::Backend::Bindings binding;
-    for (size_t index = uses_vertex_a && uses_vertex_b ? 1 : 0; index < Maxwell::MaxShaderProgram;
-         ++index) {
-        const bool is_emulated_stage = layer_source_program != nullptr &&
-                                       index == static_cast<u32>(Maxwell::ShaderType::Geometry);
-        if (key.unique_hashes[index] == 0 && !is_emulated_stage) {
-            continue;
+    for (const VideoCommon::TranslatedShader& shader : translated_shaders) {
+        const size_t stage_index{shader.stage_index};
+        if (stage_index >= Maxwell::MaxShaderStage) {
+            LOG_ERROR(Render_Vulkan, "Invalid cached shader stage {}", stage_index);
+            return nullptr;
         }
-        UNIMPLEMENTED_IF(index == 0);
-
-        Shader::IR::Program& program{programs[index]};
-        const size_t stage_index{index - 1};
-        infos[stage_index] = &program.info;
-
-        const auto runtime_info{MakeRuntimeInfo(programs, key, program, previous_stage)};
-        ConvertLegacyToGeneric(program, runtime_info);
-        const std::vector<u32> code{EmitSPIRV(profile, runtime_info, program, binding)};
-        device.SaveShader(code);
-        modules[stage_index] = BuildShader(device, code);
+        infos[stage_index] = &shader.info;
+        device.SaveShader(shader.code);
+        modules[stage_index] = BuildShader(device, shader.code);
         if (device.HasDebuggingToolAttached()) {
-            const std::string name{fmt::format("Shader {:016x}", key.unique_hashes[index])};
+            const std::string name{
+                fmt::format("Shader {:016x}", key.unique_hashes[stage_index + 1])};
             modules[stage_index].SetObjectNameEXT(name.c_str());
         }
-        previous_stage = &program;
     }
     Common::ThreadWorker* const thread_worker{build_in_parallel ? &workers : nullptr};
     return std::make_unique<GraphicsPipeline>(
         scheduler, buffer_cache, texture_cache, vulkan_pipeline_cache, &shader_notify, device,
         descriptor_pool, guest_descriptor_queue, thread_worker, statistics, render_pass_cache, key,
         std::move(modules), infos);
-
-} catch (const Shader::Exception& exception) {
-    auto hash = key.Hash();
-    size_t env_index{0};
-    for (size_t index = 0; index < Maxwell::MaxShaderProgram; ++index) {
-        if (key.unique_hashes[index] == 0) {
-            continue;
-        }
-        Shader::Environment& env{*envs[env_index]};
-        ++env_index;
-
-        const u32 cfg_offset{static_cast<u32>(env.StartAddress() + sizeof(Shader::ProgramHeader))};
-        Shader::Maxwell::Flow::CFG cfg(env, pools.flow_block, cfg_offset, index == 0);
-        env.Dump(hash, key.unique_hashes[index]);
-    }
-    LOG_ERROR(Render_Vulkan, "{}", exception.what());
-    return nullptr;
 }
 
 std::unique_ptr<GraphicsPipeline> PipelineCache::CreateGraphicsPipeline() {
@@ -759,17 +831,32 @@ std::unique_ptr<ComputePipeline> PipelineCache::CreateComputePipeline(
 
     LOG_INFO(Render_Vulkan, "0x{:016x}", hash);
 
-    Shader::Maxwell::Flow::CFG cfg{env, pools.flow_block, env.StartAddress()};
-
-    // Dump it before error.
-    if (Settings::values.dump_shaders) {
-        env.Dump(hash, key.unique_hash);
+    const std::array<Shader::Environment* const, 1> envs{&env};
+    // Only pipelines loaded from disk have environments with their full state before translation
+    if (translation_cache && !build_in_parallel) {
+        const auto translated{translation_cache->Find(hash, VideoCommon::HashEnvironments(envs))};
+        if (translated && translated->size() == 1) {
+            return CreateComputePipeline(key, translated->front(), statistics, build_in_parallel);
+        }
     }
+    const VideoCommon::TranslatedShader translated{
+        TranslateComputePipeline(pools, key, env, profile, host_info)};
+    if (translation_cache) {
+        translation_cache->Store(hash, VideoCommon::HashEnvironments(envs),
+                                 std::span(&translated, 1));
+    }
+    return CreateComputePipeline(key, translated, statistics, build_in_parallel);
 
-    auto program{TranslateProgram(pools.inst, pools.block, env, cfg, host_info)};
-    const std::vector<u32> code{EmitSPIRV(profile, program)};
-    device.SaveShader(code);
-    vk::ShaderModule spv_module{BuildShader(device, code)};
+} catch (const Shader::Exception& exception) {
+    LOG_ERROR(Render_Vulkan, "{}", exception.what());
+    return nullptr;
+}
+
+std::unique_ptr<ComputePipeline> PipelineCache::CreateComputePipeline(
+    const ComputePipelineCacheKey& key, const VideoCommon::TranslatedShader& translated,
+    PipelineStatistics* statistics, bool build_in_parallel) {
+    device.SaveShader(translated.code);
+    vk::ShaderModule spv_module{BuildShader(device, translated.code)};
     if (device.HasDebuggingToolAttached()) {
         const auto name{fmt::format("Shader {:016x}", key.unique_hash)};
         spv_module.SetObjectNameEXT(name.c_str());
@@ -777,11 +864,8 @@ std::unique_ptr<ComputePipeline> PipelineCache::CreateComputePipeline(
     Common::ThreadWorker* const thread_worker{build_in_parallel ? &workers : nullptr};
     return std::make_unique<ComputePipeline>(device, vulkan_pipeline_cache, descriptor_pool,
                                              guest_descriptor_queue, thread_worker, statistics,
-                                             &shader_notify, program.info, std::move(spv_module));
-
-} catch (const Shader::Exception& exception) {
-    LOG_ERROR(Render_Vulkan, "{}", exception.what());
-    return nullptr;
+                                             &shader_notify, translated.info,
+                                             std::move(spv_module));
 }
 
 void PipelineCache::SerializeVulkanPipelineCache(const std::filesystem::path& filename,
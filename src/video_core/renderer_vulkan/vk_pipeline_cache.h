@@ -7,12 +7,14 @@
 #include <cstddef>
 #include <filesystem>
 #include <memory>
+#include <span>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 
 #include "common/common_types.h"
 #include "common/thread_worker.h"
+#include "shader_recompiler/arena.h"
 #include "shader_recompiler/frontend/ir/basic_block.h"
 #include "shader_recompiler/frontend/ir/value.h"
 #include "shader_recompiler/frontend/maxwell/control_flow.h"
@@ -27,6 +29,7 @@
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
 #include "video_core/renderer_vulkan/vk_texture_cache.h"
 #include "video_core/shader_cache.h"
+#include "video_core/shader_translation_cache.h"
 
 namespace Core {
 class System;
@@ -90,13 +93,29 @@ struct ShaderPools {
         flow_block.ReleaseContents();
         block.ReleaseContents();
         inst.ReleaseContents();
+        arena.Reset();
     }
 
     Shader::ObjectPool<Shader::IR::Inst> inst{8192};
     Shader::ObjectPool<Shader::IR::Block> block{32};
     Shader::ObjectPool<Shader::Maxwell::Flow::Block> flow_block{32};
+    Shader::Arena arena;
 };
 
+/// Version of the pipeline cache files written by the Vulkan backend
+constexpr u32 PIPELINE_CACHE_VERSION = 11;
+
+/// Translates the shaders of a graphics pipeline to SPIR-V, throws Shader::Exception on failure
+[[nodiscard]] std::vector<VideoCommon::TranslatedShader> TranslateGraphicsPipeline(
+    ShaderPools& pools, const GraphicsPipelineCacheKey& key,
+    std::span<Shader::Environment* const> envs, const Shader::Profile& profile,
+    const Shader::HostTranslateInfo& host_info);
+
+/// Translates the shader of a compute pipeline to SPIR-V, throws Shader::Exception on failure
+[[nodiscard]] VideoCommon::TranslatedShader TranslateComputePipeline(
+    ShaderPools& pools, const ComputePipelineCacheKey& key, Shader::Environment& env,
+    const Shader::Profile& profile, const Shader::HostTranslateInfo& host_info);
+
 class PipelineCache : public VideoCommon::ShaderCache {
 public:
     explicit PipelineCache(Tegra::MaxwellDeviceMemoryManager& device_memory_, const Device& device,
@@ -125,6 +144,11 @@ private:
         std::span<Shader::Environment* const> envs, PipelineStatistics* statistics,
         bool build_in_parallel);
 
+    std::unique_ptr<GraphicsPipeline> CreateGraphicsPipeline(
+        const GraphicsPipelineCacheKey& key,
+        std::span<const VideoCommon::TranslatedShader> translated_shaders,
+        PipelineStatistics* statistics, bool build_in_parallel);
+
     std::unique_ptr<ComputePipeline> CreateComputePipeline(const ComputePipelineCacheKey& key,
                                                            const ShaderInfo* shader);
 
@@ -134,6 +158,10 @@ private:
                                                            PipelineStatistics* statistics,
                                                            bool build_in_parallel);
 
+    std::unique_ptr<ComputePipeline> CreateComputePipeline(
+        const ComputePipelineCacheKey& key, const VideoCommon::TranslatedShader& translated,
+        PipelineStatistics* statistics, bool build_in_parallel);
+
     void SerializeVulkanPipelineCache(const std::filesystem::path& filename,
                                       const vk::PipelineCache& pipeline_cache, u32 cache_version);
 
@@ -167,6 +195,8 @@ private:
     std::filesystem::path vulkan_pipeline_cache_filename;
     vk::PipelineCache vulkan_pipeline_cache;
 
+    std::unique_ptr<VideoCommon::ShaderTranslationCache> translation_cache;
+
     Common::ThreadWorker workers;
     Common::ThreadWorker serialization_thread;
     DynamicFeatures dynamic_features;
@@ -114,6 +114,49 @@ static void DumpImpl(u64 pipeline_hash, u64 shader_hash, std::span<const u64> co
     }
 }
 
+template <typename Map>
+static void HashSortedMap(std::vector<u64>& words, const Map& map) {
+    // Iteration order of unordered maps depends on how they were filled, sort the pairs.
+    std::vector<std::pair<u64, u64>> pairs;
+    pairs.reserve(map.size());
+    for (const auto& [key, value] : map) {
+        pairs.emplace_back(static_cast<u64>(key), static_cast<u64>(value));
+    }
+    std::ranges::sort(pairs);
+    for (const auto& [key, value] : pairs) {
+        words.push_back(key);
+        words.push_back(value);
+    }
+}
+
+static u64 CalculateStateHashImpl(
+    const std::unordered_map<u32, Shader::TextureType>& texture_types,
+    const std::unordered_map<u32, Shader::TexturePixelFormat>& texture_pixel_formats,
+    const std::unordered_map<u64, u32>& cbuf_values,
+    const std::unordered_map<u64, Shader::ReplaceConstant>& cbuf_replacements,
+    u32 local_memory_size, u32 texture_bound, u32 shared_memory_size,
+    const std::array<u32, 3>& workgroup_size, u32 viewport_transform_state, u32 start_address,
+    Shader::Stage stage, const std::array<u32, 8>& gp_passthrough_mask) {
+    std::vector<u64> words{local_memory_size, texture_bound, viewport_transform_state,
+                           start_address, static_cast<u64>(stage)};
+    if (stage == Shader::Stage::Compute) {
+        words.push_back(shared_memory_size);
+        words.insert(words.end(), workgroup_size.begin(), workgroup_size.end());
+    } else if (stage == Shader::Stage::Geometry) {
+        words.insert(words.end(), gp_passthrough_mask.begin(), gp_passthrough_mask.end());
+    }
+    for (const size_t size : {texture_types.size(), texture_pixel_formats.size(),
+                              cbuf_values.size(), cbuf_replacements.size()}) {
+        words.push_back(size);
+    }
+    HashSortedMap(words, texture_types);
+    HashSortedMap(words, texture_pixel_formats);
+    HashSortedMap(words, cbuf_values);
+    HashSortedMap(words, cbuf_replacements);
+    return Common::CityHash64(reinterpret_cast<const char*>(words.data()),
+                              words.size() * sizeof(u64));
+}
+
 GenericEnvironment::GenericEnvironment(Tegra::MemoryManager& gpu_memory_, GPUVAddr program_base_,
                                        u32 start_address_)
     : gpu_memory{&gpu_memory_}, program_base{program_base_} {
@@ -189,6 +232,13 @@ u64 GenericEnvironment::CalculateHash() const {
     return Common::CityHash64(data.get(), size);
 }
 
+u64 GenericEnvironment::CalculateStateHash() const {
+    return CalculateStateHashImpl(texture_types, texture_pixel_formats, cbuf_values,
+                                  cbuf_replacements, local_memory_size, texture_bound,
+                                  shared_memory_size, workgroup_size, viewport_transform_state,
+                                  start_address, stage, gp_passthrough_mask);
+}
+
 void GenericEnvironment::Dump(u64 pipeline_hash, u64 shader_hash) {
     DumpImpl(pipeline_hash, shader_hash, code, read_highest, read_lowest, initial_offset, stage);
 }
@@ -512,6 +562,13 @@ void FileEnvironment::Deserialize(std::ifstream& file) {
     is_proprietary_driver = texture_bound == 2;
 }
 
+u64 FileEnvironment::CalculateStateHash() const {
+    return CalculateStateHashImpl(texture_types, texture_pixel_formats, cbuf_values,
+                                  cbuf_replacements, local_memory_size, texture_bound,
+                                  shared_memory_size, workgroup_size, viewport_transform_state,
+                                  start_address, stage, gp_passthrough_mask);
+}
+
 void FileEnvironment::Dump(u64 pipeline_hash, u64 shader_hash) {
     DumpImpl(pipeline_hash, shader_hash, code, read_highest, read_lowest, initial_offset, stage);
 }
@@ -614,6 +671,16 @@ void SerializePipeline(std::span<const char> key, std::span<const GenericEnviron
     }
 }
 
+bool IsPipelineCacheCompatible(const std::filesystem::path& filename,
+                               u32 expected_cache_version) {
+    std::ifstream file(filename, std::ios::binary);
+    std::array<char, 8> magic_number{};
+    u32 cache_version{};
+    file.read(magic_number.data(), magic_number.size())
+        .read(reinterpret_cast<char*>(&cache_version), sizeof(cache_version));
+    return file.good() && magic_number == MAGIC_NUMBER && cache_version == expected_cache_version;
+}
+
 void LoadPipelines(
     std::stop_token stop_loading, const std::filesystem::path& filename, u32 expected_cache_version,
     Common::UniqueFunction<void, std::ifstream&, FileEnvironment> load_compute,
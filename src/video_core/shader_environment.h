@@ -58,6 +58,8 @@ public:
 
     [[nodiscard]] u64 CalculateHash() const;
 
+    [[nodiscard]] u64 CalculateStateHash() const override;
+
     void Dump(u64 pipeline_hash, u64 shader_hash) override;
 
     void Serialize(std::ofstream& file) const;
@@ -194,6 +196,8 @@ public:
         return cbuf_replacements.size() != 0;
     }
 
+    [[nodiscard]] u64 CalculateStateHash() const override;
+
     void Dump(u64 pipeline_hash, u64 shader_hash) override;
 
 private:
@@ -224,6 +228,10 @@ void SerializePipeline(const Key& key, const Envs& envs, const std::filesystem::
                       std::span(envs.data(), envs.size()), filename, cache_version);
 }
 
+/// Returns true when the file is a pipeline cache with the expected version.
+[[nodiscard]] bool IsPipelineCacheCompatible(const std::filesystem::path& filename,
+                                             u32 expected_cache_version);
+
 void LoadPipelines(
     std::stop_token stop_loading, const std::filesystem::path& filename, u32 expected_cache_version,
     Common::UniqueFunction<void, std::ifstream&, FileEnvironment> load_compute,
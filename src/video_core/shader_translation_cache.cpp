@@ -0,0 +1,668 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cstring>
+#include <map>
+#include <type_traits>
+#include <utility>
+
+#include "common/cityhash.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/settings.h"
+#include "shader_recompiler/environment.h"
+#include "shader_recompiler/host_translate_info.h"
+#include "shader_recompiler/profile.h"
+#include "video_core/shader_translation_cache.h"
+
+namespace VideoCommon {
+namespace {
+
+constexpr std::array<char, 8> MAGIC_NUMBER{'y', 'u', 'z', 'u', 't', 'r', 'n', 's'};
+
+/// Version of the record layout, bump it when the serialization of Shader::Info changes
+constexpr u32 FORMAT_VERSION = 1;
+
+constexpr std::array<char, 8> PROFILE_MAGIC_NUMBER{'y', 'u', 'z', 'u', 't', 'r', 'p', 'f'};
+
+/// Compact the file when at least this fraction of it is superseded records
+constexpr u64 COMPACTION_RATIO = 4;
+
+/// Flush appended records once this many bytes are buffered, a lost tail is only retranslated
+constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+struct FileHeader {
+    std::array<char, 8> magic;
+    u32 format_version;
+    u32 cache_version;
+    u64 profile_hash;
+};
+static_assert(std::has_unique_object_representations_v<FileHeader>);
+
+struct TranslationProfile {
+    std::array<char, 8> magic;
+    u32 format_version;
+    u32 reserved;
+    u64 profile_hash;
+    Shader::Profile profile;
+    Shader::HostTranslateInfo host_info;
+    Settings::ResolutionScalingInfo resolution_info;
+    bool renderer_debug;
+    bool disable_shader_loop_safety_checks;
+};
+
+struct RecordHeader {
+    u64 pipeline_hash;
+    u64 environment_hash;
+    u64 payload_hash;
+    u32 payload_size;
+    u32 reserved;
+};
+static_assert(std::has_unique_object_representations_v<RecordHeader>);
+
+template <typename T>
+concept IsPlainData = std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>;
+
+class Writer {
+public:
+    explicit Writer(std::vector<u8>& bytes_) : bytes{bytes_} {}
+
+    template <IsPlainData T>
+    void operator()(const T& value) {
+        const size_t offset = bytes.size();
+        bytes.resize(offset + sizeof(T));
+        std::memcpy(bytes.data() + offset, &value, sizeof(T));
+    }
+
+    template <size_t N>
+    void operator()(const std::bitset<N>& bits) {
+        for (size_t word = 0; word < (N + 63) / 64; ++word) {
+            u64 value = 0;
+            for (size_t bit = word * 64; bit < std::min<size_t>(N, (word + 1) * 64); ++bit) {
+                value |= static_cast<u64>(bits[bit]) << (bit % 64);
+            }
+            (*this)(value);
+        }
+    }
+
+    void operator()(const Shader::VaryingState& state) {
+        (*this)(state.mask);
+    }
+
+    template <typename K, typename V>
+    void operator()(const std::map<K, V>& map) {
+        (*this)(static_cast<u32>(map.size()));
+        for (const auto& [key, value] : map) {
+            (*this)(key);
+            (*this)(value);
+        }
+    }
+
+    template <typename Container>
+        requires IsPlainData<typename Container::value_type> && (!IsPlainData<Container>)
+    void operator()(const Container& container) {
+        (*this)(static_cast<u32>(container.size()));
+        const size_t offset = bytes.size();
+        const size_t size = container.size() * sizeof(typename Container::value_type);
+        bytes.resize(offset + size);
+        std::memcpy(bytes.data() + offset, container.data(), size);
+    }
+
+private:
+    std::vector<u8>& bytes;
+};
+
+class Reader {
+public:
+    explicit Reader(std::span<const u8> bytes_) : bytes{bytes_} {}
+
+    [[nodiscard]] bool Failed() const noexcept {
+        return failed;
+    }
+
+    template <IsPlainData T>
+    void operator()(T& value) {
+        Read(&value, sizeof(T));
+    }
+
+    template <size_t N>
+    void operator()(std::bitset<N>& bits) {
+        for (size_t word = 0; word < (N + 63) / 64; ++word) {
+            u64 value = 0;
+            (*this)(value);
+            for (size_t bit = word * 64; bit < std::min<size_t>(N, (word + 1) * 64); ++bit) {
+                bits[bit] = ((value >> (bit % 64)) & 1) != 0;
+            }
+        }
+    }
+
+    void operator()(Shader::VaryingState& state) {
+        (*this)(state.mask);
+    }
+
+    template <typename K, typename V>
+    void operator()(std::map<K, V>& map) {
+        u32 size = 0;
+        (*this)(size);
+        map.clear();
+        for (u32 i = 0; i < size && !failed; ++i) {
+            K key{};
+            V value{};
+            (*this)(key);
+            (*this)(value);
+            map.emplace(key, value);
+        }
+    }
+
+    template <typename Container>
+        requires IsPlainData<typename Container::value_type> && (!IsPlainData<Container>)
+    void operator()(Container& container) {
+        u32 size = 0;
+        (*this)(size);
+        const size_t size_bytes = size * sizeof(typename Container::value_type);
+        if (failed || size > container.max_size() || size_bytes > bytes.size() - offset) {
+            failed = true;
+            return;
+        }
+        container.resize(size);
+        Read(container.data(), size_bytes);
+    }
+
+    void Read(void* data, size_t size) {
+        if (failed || size > bytes.size() - offset) {
+            failed = true;
+            std::memset(data, 0, size);
+            return;
+        }
+        std::memcpy(data, bytes.data() + offset, size);
+        offset += size;
+    }
+
+private:
+    std::span<const u8> bytes;
+    size_t offset{};
+    bool failed{};
+};
+
+#if defined(__GLIBCXX__) && defined(ARCHITECTURE_x86_64)
+// The size of the standard containers differs between libraries, checking one is enough.
+static_assert(sizeof(Shader::Info) == 2216,
+              "Serialize the new members of Shader::Info and bump FORMAT_VERSION");
+#endif
+
+/// Visits every member of Shader::Info, the order is part of the file format
+template <typename Archive, typename InfoType>
+void VisitInfo(Archive& ar, InfoType& info) {
+    ar(info.uses_workgroup_id);
+    ar(info.uses_local_invocation_id);
+    ar(info.uses_invocation_id);
+    ar(info.uses_invocation_info);
+    ar(info.uses_sample_id);
+    ar(info.uses_is_helper_invocation);
+    ar(info.uses_subgroup_invocation_id);
+    ar(info.uses_subgroup_shuffles);
+    ar(info.uses_patches);
+    ar(info.interpolation);
+    ar(info.loads);
+    ar(info.stores);
+    ar(info.passthrough);
+    ar(info.legacy_stores_mapping);
+    ar(info.loads_indexed_attributes);
+    ar(info.stores_frag_color);
+    ar(info.stores_sample_mask);
+    ar(info.stores_frag_depth);
+    ar(info.stores_tess_level_outer);
+    ar(info.stores_tess_level_inner);
+    ar(info.stores_indexed_attributes);
+    ar(info.stores_global_memory);
+    ar(info.uses_local_memory);
+    ar(info.uses_fp16);
+    ar(info.uses_fp64);
+    ar(info.uses_fp16_denorms_flush);
+    ar(info.uses_fp16_denorms_preserve);
+    ar(info.uses_fp32_denorms_flush);
+    ar(info.uses_fp32_denorms_preserve);
+    ar(info.uses_int8);
+    ar(info.uses_int16);
+    ar(info.uses_int64);
+    ar(info.uses_image_1d);
+    ar(info.uses_sampled_1d);
+    ar(info.uses_sparse_residency);
+    ar(info.uses_demote_to_helper_invocation);
+    ar(info.uses_subgroup_vote);
+    ar(info.uses_subgroup_mask);
+    ar(info.uses_fswzadd);
+    ar(info.uses_derivatives);
+    ar(info.uses_typeless_image_reads);
+    ar(info.uses_typeless_image_writes);
+    ar(info.uses_image_buffers);
+    ar(info.uses_shared_increment);
+    ar(info.uses_shared_decrement);
+    ar(info.uses_global_increment);
+    ar(info.uses_global_decrement);
+    ar(info.uses_atomic_f32_add);
+    ar(info.uses_atomic_f16x2_add);
+    ar(info.uses_atomic_f16x2_min);
+    ar(info.uses_atomic_f16x2_max);
+    ar(info.uses_atomic_f32x2_add);
+    ar(info.uses_atomic_f32x2_min);
+    ar(info.uses_atomic_f32x2_max);
+    ar(info.uses_atomic_s32_min);
+    ar(info.uses_atomic_s32_max);
+    ar(info.uses_int64_bit_atomics);
+    ar(info.uses_global_memory);
+    ar(info.uses_atomic_image_u32);
+    ar(info.uses_shadow_lod);
+    ar(info.uses_rescaling_uniform);
+    ar(info.uses_cbuf_indirect);
+    ar(info.uses_render_area);
+    ar(info.used_constant_buffer_types);
+    ar(info.used_storage_buffer_types);
+    ar(info.used_indirect_cbuf_types);
+    ar(info.constant_buffer_mask);
+    ar(info.constant_buffer_used_sizes);
+    ar(info.nvn_buffer_base);
+    ar(info.nvn_buffer_used);
+    ar(info.requires_layer_emulation);
+    ar(info.emulated_layer);
+    ar(info.used_clip_distances);
+    ar(info.constant_buffer_descriptors);
+    ar(info.storage_buffers_descriptors);
+    ar(info.texture_buffer_descriptors);
+    ar(info.image_buffer_descriptors);
+    ar(info.texture_descriptors);
+    ar(info.image_descriptors);
+}
+
+std::vector<u8> SerializeShaders(std::span<const TranslatedShader> shaders) {
+    std::vector<u8> bytes;
+    Writer writer{bytes};
+    writer(static_cast<u32>(shaders.size()));
+    for (const TranslatedShader& shader : shaders) {
+        writer(shader.stage_index);
+        writer(shader.code);
+        VisitInfo(writer, shader.info);
+    }
+    return bytes;
+}
+
+std::optional<std::vector<TranslatedShader>> DeserializeShaders(std::span<const u8> bytes) {
+    Reader reader{bytes};
+    u32 num_shaders = 0;
+    reader(num_shaders);
+    std::vector<TranslatedShader> shaders;
+    for (u32 i = 0; i < num_shaders && !reader.Failed(); ++i) {
+        TranslatedShader& shader = shaders.emplace_back();
+        reader(shader.stage_index);
+        reader(shader.code);
+        VisitInfo(reader, shader.info);
+    }
+    if (reader.Failed()) {
+        return std::nullopt;
+    }
+    return shaders;
+}
+
+template <typename... Values>
+void AddWords(std::vector<u64>& words, Values... values) {
+    (words.push_back(static_cast<u64>(values)), ...);
+}
+
+} // Anonymous namespace
+
+u64 HashTranslationProfile(const Shader::Profile& profile,
+                           const Shader::HostTranslateInfo& host_info) {
+    // Hashed member by member, the padding of the structures is indeterminate.
+    static_assert(sizeof(Shader::Profile) == 80, "Hash the new members of Shader::Profile");
+    static_assert(sizeof(Shader::HostTranslateInfo) == 16,
+                  "Hash the new members of Shader::HostTranslateInfo");
+    std::vector<u64> words;
+    AddWords(words, profile.supported_spirv, profile.unified_descriptor_binding,
+             profile.support_descriptor_aliasing, profile.support_int8, profile.support_int16,
+             profile.support_int64, profile.support_vertex_instance_id,
+             profile.support_float_controls, profile.support_separate_denorm_behavior,
+             profile.support_separate_rounding_mode, profile.support_fp16_denorm_preserve,
+             profile.support_fp32_denorm_preserve, profile.support_fp16_denorm_flush,
+             profile.support_fp32_denorm_flush, profile.support_fp16_signed_zero_nan_preserve,
+             profile.support_fp32_signed_zero_nan_preserve,
+             profile.support_fp64_signed_zero_nan_preserve,
+             profile.support_explicit_workgroup_layout, profile.support_vote,
+             profile.support_viewport_index_layer_non_geometry, profile.support_viewport_mask,
+             profile.support_typeless_image_loads, profile.support_demote_to_helper_invocation,
+             profile.support_int64_atomics, profile.support_derivative_control,
+             profile.support_geometry_shader_passthrough, profile.support_native_ndc,
+             profile.support_gl_nv_gpu_shader_5, profile.support_gl_amd_gpu_shader_half_float,
+             profile.support_gl_texture_shadow_lod, profile.support_gl_warp_intrinsics,
+             profile.support_gl_variable_aoffi, profile.support_gl_sparse_textures,
+             profile.support_gl_derivative_control, profile.support_scaled_attributes,
+             profile.support_multi_viewport, profile.support_geometry_streams,
+             profile.warp_size_potentially_larger_than_guest, profile.lower_left_origin_mode,
+             profile.need_declared_frag_colors, profile.need_fastmath_off,
+             profile.need_gather_subpixel_offset, profile.has_broken_spirv_clamp,
+             profile.has_broken_spirv_position_input, profile.has_broken_unsigned_image_offsets,
+             profile.has_broken_signed_operations, profile.has_broken_fp16_float_controls,
+             profile.has_gl_component_indexing_bug, profile.has_gl_precise_bug,
+             profile.has_gl_cbuf_ftou_bug, profile.has_gl_bool_ref_bug,
+             profile.ignore_nan_fp_comparisons,
+             profile.has_broken_spirv_subgroup_mask_vector_extract_dynamic,
+             profile.gl_max_compute_smem_size, profile.has_broken_robust,
+             profile.min_ssbo_alignment, profile.max_user_clip_distances);
+    AddWords(words, host_info.support_float64, host_info.support_float16,
+             host_info.support_int64, host_info.needs_demote_reorder,
+             host_info.support_snorm_render_buffer, host_info.support_viewport_index_layer,
+             host_info.min_ssbo_alignment, host_info.support_geometry_shader_passthrough,
+             host_info.support_conditional_barrier);
+
+    // Settings read by the recompiler and the backends
+    const auto& resolution = Settings::values.resolution_info;
+    AddWords(words, resolution.active, resolution.downscale, resolution.up_scale,
+             resolution.down_shift, std::bit_cast<u32>(resolution.up_factor),
+             std::bit_cast<u32>(resolution.down_factor), Settings::values.renderer_debug.GetValue(),
+             Settings::values.disable_shader_loop_safety_checks.GetValue());
+    return Common::CityHash64(reinterpret_cast<const char*>(words.data()),
+                              words.size() * sizeof(u64));
+}
+
+u64 HashEnvironments(std::span<Shader::Environment* const> envs) {
+    std::vector<u64> hashes;
+    hashes.reserve(envs.size());
+    for (const Shader::Environment* const env : envs) {
+        hashes.push_back(env->CalculateStateHash());
+    }
+    return Common::CityHash64(reinterpret_cast<const char*>(hashes.data()),
+                              hashes.size() * sizeof(u64));
+}
+
+void SaveTranslationProfile(const std::filesystem::path& filename, const Shader::Profile& profile,
+                            const Shader::HostTranslateInfo& host_info) {
+    const TranslationProfile translation_profile{
+        .magic = PROFILE_MAGIC_NUMBER,
+        .format_version = FORMAT_VERSION,
+        .reserved = 0,
+        .profile_hash = HashTranslationProfile(profile, host_info),
+        .profile = profile,
+        .host_info = host_info,
+        .resolution_info = Settings::values.resolution_info,
+        .renderer_debug = Settings::values.renderer_debug.GetValue(),
+        .disable_shader_loop_safety_checks =
+            Settings::values.disable_shader_loop_safety_checks.GetValue(),
+    };
+    Common::FS::IOFile file{filename, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen() || !file.WriteObject(translation_profile)) {
+        LOG_ERROR(Common_Filesystem, "Failed to write translation profile {}",
+                  Common::FS::PathToUTF8String(filename));
+    }
+}
+
+bool LoadTranslationProfile(const std::filesystem::path& filename, Shader::Profile& profile,
+                            Shader::HostTranslateInfo& host_info) {
+    const Common::FS::IOFile file{filename, Common::FS::FileAccessMode::Read,
+                                  Common::FS::FileType::BinaryFile};
+    TranslationProfile translation_profile{};
+    if (!file.IsOpen() || file.GetSize() != sizeof(translation_profile) ||
+        !file.ReadObject(translation_profile)) {
+        LOG_ERROR(Common_Filesystem, "Failed to read translation profile {}",
+                  Common::FS::PathToUTF8String(filename));
+        return false;
+    }
+    if (translation_profile.magic != PROFILE_MAGIC_NUMBER ||
+        translation_profile.format_version != FORMAT_VERSION) {
+        LOG_ERROR(Common_Filesystem, "Translation profile {} has an unknown format",
+                  Common::FS::PathToUTF8String(filename));
+        return false;
+    }
+    profile = translation_profile.profile;
+    host_info = translation_profile.host_info;
+    Settings::values.resolution_info = translation_profile.resolution_info;
+    Settings::values.renderer_debug.SetValue(translation_profile.renderer_debug);
+    Settings::values.disable_shader_loop_safety_checks.SetValue(
+        translation_profile.disable_shader_loop_safety_checks);
+
+    // Different hashing rules would silently produce entries no emulator build looks up.
+    if (HashTranslationProfile(profile, host_info) != translation_profile.profile_hash) {
+        LOG_ERROR(Common_Filesystem, "Translation profile {} was written by another version",
+                  Common::FS::PathToUTF8String(filename));
+        return false;
+    }
+    return true;
+}
+
+ShaderTranslationCache::ShaderTranslationCache(std::filesystem::path filename_, u32 cache_version_,
+                                               u64 profile_hash_)
+    : filename{std::move(filename_)}, cache_version{cache_version_}, profile_hash{profile_hash_} {
+    const bool needs_compaction = Load();
+    if (!mapped_file.IsOpen()) {
+        return;
+    }
+    if (needs_compaction) {
+        compacting = true;
+        compaction_thread = std::jthread([this] { Compact(); });
+    } else {
+        file.Open(filename, Common::FS::FileAccessMode::Append, Common::FS::FileType::BinaryFile,
+                  Common::FS::FileShareFlag::ShareReadWrite);
+    }
+}
+
+ShaderTranslationCache::~ShaderTranslationCache() {
+    // Let a running compaction finish, records stored after a torn tail would be lost otherwise.
+    if (compaction_thread.joinable()) {
+        compaction_thread.join();
+    }
+}
+
+std::optional<std::vector<TranslatedShader>> ShaderTranslationCache::Find(u64 pipeline_hash,
+                                                                          u64 environment_hash) {
+    ++lookups;
+    std::shared_lock lock{index_mutex};
+    const auto it = index.find(Key{pipeline_hash, environment_hash});
+    if (it == index.end()) {
+        return std::nullopt;
+    }
+    const std::span<const u8> data = mapped_file.GetData();
+    auto shaders = DeserializeShaders(data.subspan(it->second.offset, it->second.size));
+    if (shaders) {
+        ++hits;
+    }
+    return shaders;
+}
+
+void ShaderTranslationCache::Store(u64 pipeline_hash, u64 environment_hash,
+                                   std::span<const TranslatedShader> shaders) {
+    const std::vector<u8> payload = SerializeShaders(shaders);
+    const RecordHeader header{
+        .pipeline_hash = pipeline_hash,
+        .environment_hash = environment_hash,
+        .payload_hash =
+            Common::CityHash64(reinterpret_cast<const char*>(payload.data()), payload.size()),
+        .payload_size = static_cast<u32>(payload.size()),
+        .reserved = 0,
+    };
+    std::vector<u8> record(sizeof(header) + payload.size());
+    std::memcpy(record.data(), &header, sizeof(header));
+    std::memcpy(record.data() + sizeof(header), payload.data(), payload.size());
+
+    ++stores;
+    WriteRecord(record);
+}
+
+ShaderTranslationCache::Statistics ShaderTranslationCache::GetStatistics() const {
+    std::shared_lock lock{index_mutex};
+    return {
+        .lookups = lookups.load(std::memory_order_relaxed),
+        .hits = hits.load(std::memory_order_relaxed),
+        .stores = stores.load(std::memory_order_relaxed),
+        .loaded_entries = index.size(),
+        .loaded_bytes = loaded_bytes,
+    };
+}
+
+void ShaderTranslationCache::ReportStatistics() const {
+    const Statistics statistics = GetStatistics();
+    if (statistics.lookups == 0 && statistics.stores == 0) {
+        return;
+    }
+    double hit_rate = 0.0;
+    if (statistics.lookups != 0) {
+        hit_rate =
+            static_cast<double>(statistics.hits) * 100.0 / static_cast<double>(statistics.lookups);
+    }
+    LOG_INFO(Render, "Shader translation cache: {} of {} lookups hit ({:.1f}%), {} stored",
+             statistics.hits, statistics.lookups, hit_rate, statistics.stores);
+}
+
+bool ShaderTranslationCache::Load() {
+    const auto invalidate = [this](const char* reason) {
+        LOG_INFO(Render, "Discarding shader translation cache {}: {}",
+                 Common::FS::PathToUTF8String(filename), reason);
+        mapped_file.Close();
+        if (CreateFile(filename)) {
+            mapped_file.Open(filename);
+        }
+        return false;
+    };
+    if (!Common::FS::Exists(filename)) {
+        if (CreateFile(filename)) {
+            mapped_file.Open(filename);
+        }
+        return false;
+    }
+    if (!mapped_file.Open(filename)) {
+        return false;
+    }
+    const std::span<const u8> data = mapped_file.GetData();
+    FileHeader file_header{};
+    if (data.size() < sizeof(file_header)) {
+        return invalidate("truncated header");
+    }
+    std::memcpy(&file_header, data.data(), sizeof(file_header));
+    if (file_header.magic != MAGIC_NUMBER || file_header.format_version != FORMAT_VERSION) {
+        return invalidate("unknown format");
+    }
+    if (file_header.cache_version != cache_version) {
+        return invalidate("old cache version");
+    }
+    if (file_header.profile_hash != profile_hash) {
+        return invalidate("different host profile");
+    }
+
+    u64 live_bytes = 0;
+    u64 offset = sizeof(file_header);
+    while (data.size() - offset >= sizeof(RecordHeader)) {
+        RecordHeader header;
+        std::memcpy(&header, data.data() + offset, sizeof(header));
+        const u64 payload_offset = offset + sizeof(header);
+        if (header.payload_size > data.size() - payload_offset) {
+            break;
+        }
+        const char* const payload = reinterpret_cast<const char*>(data.data() + payload_offset);
+        if (Common::CityHash64(payload, header.payload_size) != header.payload_hash) {
+            break;
+        }
+        const Key key{header.pipeline_hash, header.environment_hash};
+        const Entry entry{payload_offset, header.payload_size};
+        if (const auto [it, is_new] = index.try_emplace(key, entry); !is_new) {
+            live_bytes -= sizeof(header) + it->second.size;
+            it->second = entry;
+        }
+        live_bytes += sizeof(header) + header.payload_size;
+        offset = payload_offset + header.payload_size;
+    }
+    loaded_bytes = live_bytes;
+    LOG_INFO(Render, "Loaded {} translated pipelines from {}", index.size(),
+             Common::FS::PathToUTF8String(filename));
+
+    // Records appended after a torn write would be unreachable, drop the tail before appending.
+    const bool has_torn_tail = offset != data.size();
+    const u64 superseded_bytes = offset - sizeof(file_header) - live_bytes;
+    return has_torn_tail || superseded_bytes * COMPACTION_RATIO >= data.size();
+}
+
+bool ShaderTranslationCache::CreateFile(const std::filesystem::path& path) const {
+    const FileHeader header{
+        .magic = MAGIC_NUMBER,
+        .format_version = FORMAT_VERSION,
+        .cache_version = cache_version,
+        .profile_hash = profile_hash,
+    };
+    Common::FS::IOFile new_file{path, Common::FS::FileAccessMode::Write,
+                                Common::FS::FileType::BinaryFile};
+    if (!new_file.IsOpen() || !new_file.WriteObject(header)) {
+        LOG_ERROR(Common_Filesystem, "Failed to create shader translation cache {}",
+                  Common::FS::PathToUTF8String(path));
+        return false;
+    }
+    return true;
+}
+
+void ShaderTranslationCache::Compact() {
+    const std::filesystem::path temp_filename{filename.string() + ".tmp"};
+    bool success = CreateFile(temp_filename);
+    if (success) {
+        Common::FS::IOFile temp_file{temp_filename, Common::FS::FileAccessMode::Append,
+                                     Common::FS::FileType::BinaryFile};
+        const std::span<const u8> data = mapped_file.GetData();
+        for (const auto& [key, entry] : index) {
+            // Records are written contiguously, the header precedes the payload.
+            const auto record = data.subspan(entry.offset - sizeof(RecordHeader),
+                                             sizeof(RecordHeader) + entry.size);
+            if (temp_file.WriteSpan(record) != record.size()) {
+                success = false;
+                break;
+            }
+        }
+    }
+
+    std::scoped_lock lock{write_mutex};
+    if (success) {
+        std::unique_lock index_lock{index_mutex};
+        mapped_file.Close();
+        if (Common::FS::RemoveFile(filename) && Common::FS::RenameFile(temp_filename, filename)) {
+            LOG_INFO(Render, "Compacted shader translation cache {}",
+                     Common::FS::PathToUTF8String(filename));
+        }
+        // Reindex the compacted file, the records moved.
+        index.clear();
+        Load();
+    } else {
+        Common::FS::RemoveFile(temp_filename);
+    }
+    file.Open(filename, Common::FS::FileAccessMode::Append, Common::FS::FileType::BinaryFile,
+              Common::FS::FileShareFlag::ShareReadWrite);
+    compacting = false;
+    if (file.IsOpen() && !pending_records.empty()) {
+        static_cast<void>(file.WriteSpan(std::span<const u8>(pending_records)));
+        file.Flush();
+    }
+    unflushed_bytes = 0;
+    pending_records = {};
+}
+
+void ShaderTranslationCache::WriteRecord(std::span<const u8> record) {
+    std::scoped_lock lock{write_mutex};
+    if (compacting) {
+        pending_records.insert(pending_records.end(), record.begin(), record.end());
+        return;
+    }
+    if (!file.IsOpen()) {
+        return;
+    }
+    if (file.WriteSpan(record) != record.size()) {
+        LOG_ERROR(Common_Filesystem, "Failed to write to shader translation cache {}",
+                  Common::FS::PathToUTF8String(filename));
+    }
+    // Pipelines built at runtime store one record each, flushing them one by one stalls the
+    // pipeline workers. The file is flushed when closed.
+    unflushed_bytes += record.size();
+    if (unflushed_bytes >= FLUSH_THRESHOLD) {
+        file.Flush();
+        unflushed_bytes = 0;
+    }
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/mapped_file.h"
+#include "common/polyfill_thread.h"
+#include "shader_recompiler/shader_info.h"
+
+namespace Shader {
+class Environment;
+struct HostTranslateInfo;
+struct Profile;
+} // namespace Shader
+
+namespace VideoCommon {
+
+/// Backend output of the translation of one shader stage
+struct TranslatedShader {
+    u32 stage_index{};
+    std::vector<u32> code;
+    Shader::Info info;
+};
+
+/// Fingerprint of everything besides the guest shader that changes the backend output
+[[nodiscard]] u64 HashTranslationProfile(const Shader::Profile& profile,
+                                         const Shader::HostTranslateInfo& host_info);
+
+/// Writes the profile and the settings translation depends on, for offline shader compilers.
+void SaveTranslationProfile(const std::filesystem::path& filename, const Shader::Profile& profile,
+                            const Shader::HostTranslateInfo& host_info);
+
+/// Reads a profile written by SaveTranslationProfile and applies its settings to Settings::values.
+[[nodiscard]] bool LoadTranslationProfile(const std::filesystem::path& filename,
+                                          Shader::Profile& profile,
+                                          Shader::HostTranslateInfo& host_info);
+
+/// Combines the state hashes of the environments of a pipeline
+[[nodiscard]] u64 HashEnvironments(std::span<Shader::Environment* const> envs);
+
+/**
+ * On-disk cache of translated shaders, keyed by the pipeline hash (which covers the guest code),
+ * the state read from the shader environments and the translation profile. It lets a cache-warm
+ * boot build its pipelines without running the shader recompiler.
+ *
+ * The file is memory-mapped when opened and only ever appended to. Superseded or corrupted
+ * records are dropped by rewriting the file in the background.
+ */
+class ShaderTranslationCache {
+public:
+    struct Statistics {
+        u64 lookups{};
+        u64 hits{};
+        u64 stores{};
+        u64 loaded_entries{};
+        u64 loaded_bytes{};
+    };
+
+    explicit ShaderTranslationCache(std::filesystem::path filename, u32 cache_version,
+                                    u64 profile_hash);
+    ~ShaderTranslationCache();
+
+    /// Returns the translated shaders of a pipeline, if the cache has them.
+    [[nodiscard]] std::optional<std::vector<TranslatedShader>> Find(u64 pipeline_hash,
+                                                                    u64 environment_hash);
+
+    /// Appends the translated shaders of a pipeline to the cache.
+    void Store(u64 pipeline_hash, u64 environment_hash,
+               std::span<const TranslatedShader> shaders);
+
+    [[nodiscard]] Statistics GetStatistics() const;
+
+    /// Logs the hit rate of the cache.
+    void ReportStatistics() const;
+
+private:
+    struct Key {
+        u64 pipeline_hash;
+        u64 environment_hash;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const noexcept {
+            return static_cast<size_t>(key.pipeline_hash ^ (key.environment_hash * 31));
+        }
+    };
+
+    /// Location of a record payload in the mapped file
+    struct Entry {
+        u64 offset;
+        u32 size;
+    };
+
+    using Index = std::unordered_map<Key, Entry, KeyHash>;
+
+    /// Maps the file and indexes its records, returns true when the file has to be compacted.
+    bool Load();
+
+    /// Creates an empty cache file with a valid header.
+    bool CreateFile(const std::filesystem::path& path) const;
+
+    /// Rewrites the file with only the indexed records.
+    void Compact();
+
+    void WriteRecord(std::span<const u8> record);
+
+    std::filesystem::path filename;
+    u32 cache_version;
+    u64 profile_hash;
+
+    mutable std::shared_mutex index_mutex;
+    Common::FS::MappedFile mapped_file;
+    Index index;
+
+    std::mutex write_mutex;
+    Common::FS::IOFile file;
+    bool compacting{};
+    std::vector<u8> pending_records; ///< Records stored while the file is being compacted
+    size_t unflushed_bytes{};        ///< Bytes written since the file was last flushed
+
+    std::atomic<u64> lookups{};
+    std::atomic<u64> hits{};
+    std::atomic<u64> stores{};
+    u64 loaded_bytes{};
+
+    std::jthread compaction_thread;
+};
+
+} // namespace VideoCommon
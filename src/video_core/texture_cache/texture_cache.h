@@ -7,6 +7,7 @@
 #include <boost/container/small_vector.hpp>
 
 #include "common/alignment.h"
+#include "common/fs/path_util.h"
 #include "common/settings.h"
 #include "video_core/control/channel_state.h"
 #include "video_core/dirty_flags.h"
@@ -1090,7 +1091,8 @@ void TextureCache<P>::UploadImageContents(Image& image, StagingBuffer& staging)
         unswizzle_data_buffer.resize_destructive(image.unswizzled_size_bytes);
         auto copies =
             UnswizzleImage(*gpu_memory, gpu_addr, image.info, swizzle_data, unswizzle_data_buffer);
-        ConvertImage(unswizzle_data_buffer, image.info, mapped_span, copies);
+        ConvertImage(unswizzle_data_buffer, image.info, mapped_span, copies,
+                     GetTranscodeCache(image.info));
         image.UploadMemory(staging, copies);
     } else {
         const auto copies =
@@ -1296,12 +1298,13 @@ void TextureCache<P>::QueueAsyncDecode(Image& image, ImageId image_id) {
                                  local_unswizzle_data_buffer);
     const size_t out_size = MapSizeBytes(image);
 
-    auto func = [out_size, copies, info = image.info,
+    auto func = [this, out_size, copies, info = image.info,
                  input = std::move(local_unswizzle_data_buffer),
                  async_decode = decode_ptr]() mutable {
         async_decode->decoded_data.resize_destructive(out_size);
         std::span copies_span{copies.data(), copies.size()};
-        ConvertImage(input, info, async_decode->decoded_data, copies_span);
+        ConvertImage(input, info, async_decode->decoded_data, copies_span,
+                     GetTranscodeCache(info));
 
         // TODO: Do we need this lock?
         std::unique_lock lock{async_decode->mutex};
@@ -1336,6 +1339,21 @@ void TextureCache<P>::TickAsyncDecode() {
     }
 }
 
+template <class P>
+TranscodeCache* TextureCache<P>::GetTranscodeCache(const ImageInfo& info) {
+    if (!IsPixelFormatASTC(info.format) || !Settings::values.use_astc_disk_cache.GetValue()) {
+        return nullptr;
+    }
+    // Called from the decode worker too, and scanning the directory is only worth it once
+    // textures are actually transcoded
+    std::call_once(transcode_cache_flag, [this] {
+        const u64 size = u64{Settings::values.astc_disk_cache_size.GetValue()} * 1_MiB;
+        transcode_cache = std::make_unique<TranscodeCache>(
+            Common::FS::GetYuzuPath(Common::FS::YuzuPath::CacheDir) / "astc", size);
+    });
+    return transcode_cache.get();
+}
+
 template <class P>
 bool TextureCache<P>::ScaleUp(Image& image) {
     const bool has_copy = image.HasScaled();
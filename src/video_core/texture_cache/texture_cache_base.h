@@ -6,6 +6,7 @@
 #include <atomic>
 #include <deque>
 #include <limits>
+#include <memory>
 #include <mutex>
 #include <span>
 #include <type_traits>
@@ -33,6 +34,7 @@
 #include "video_core/texture_cache/image_info.h"
 #include "video_core/texture_cache/image_view_base.h"
 #include "video_core/texture_cache/render_targets.h"
+#include "video_core/texture_cache/transcode_cache.h"
 #include "video_core/texture_cache/types.h"
 #include "video_core/textures/texture.h"
 
@@ -422,6 +424,10 @@ private:
     void QueueAsyncDecode(Image& image, ImageId image_id);
     void TickAsyncDecode();
 
+    /// Returns the disk cache for the ASTC conversions of the image, opened on first use.
+    /// Returns null when the cache is disabled or the image is not ASTC.
+    TranscodeCache* GetTranscodeCache(const ImageInfo& info);
+
     Runtime& runtime;
 
     Tegra::MaxwellDeviceMemoryManager& device_memory;
@@ -489,6 +495,8 @@ private:
     u64 modification_tick = 0;
     u64 frame_tick = 0;
 
+    std::once_flag transcode_cache_flag;
+    std::unique_ptr<TranscodeCache> transcode_cache; ///< Outlives the decode worker using it
     Common::ThreadWorker texture_decode_worker{1, "TextureDecoder"};
     std::vector<std::unique_ptr<AsyncDecodeContext>> async_decodes;
 
@@ -0,0 +1,275 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "common/cityhash.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/mapped_file.h"
+#include "common/fs/path_util.h"
+#include "common/literals.h"
+#include "common/logging/log.h"
+#include "video_core/texture_cache/transcode_cache.h"
+
+namespace VideoCommon {
+namespace {
+
+using namespace Common::Literals;
+
+constexpr std::array<char, 8> MAGIC_NUMBER{'y', 'u', 'z', 'u', 't', 'x', 'c', 'c'};
+
+/// Version of the entry layout, bump it when the output of a texture conversion changes
+constexpr u32 FORMAT_VERSION = 2;
+
+/// Stores are dropped while this many bytes are waiting to be written
+constexpr u64 MAX_PENDING_BYTES = 256_MiB;
+
+constexpr std::string_view ENTRY_EXTENSION = ".bin";
+constexpr std::string_view TEMPORARY_EXTENSION = ".tmp";
+
+struct EntryHeader {
+    std::array<char, 8> magic;
+    u32 format_version;
+    u32 reserved;
+    u64 key;
+    u64 check_hash;
+    u64 input_size;
+    u64 payload_hash;
+    u64 payload_size;
+};
+static_assert(std::has_unique_object_representations_v<EntryHeader>);
+
+u64 HashPayload(std::span<const u8> payload) {
+    return Common::CityHash64(reinterpret_cast<const char*>(payload.data()), payload.size());
+}
+
+} // Anonymous namespace
+
+TranscodeCache::TranscodeCache(std::filesystem::path directory_, u64 max_size_bytes_)
+    : directory{std::move(directory_)}, max_size_bytes{max_size_bytes_} {
+    worker.QueueWork([this] { Scan(); });
+}
+
+TranscodeCache::~TranscodeCache() {
+    Flush();
+    const Statistics statistics = GetStatistics();
+    if (statistics.lookups == 0) {
+        return;
+    }
+    const double hit_rate =
+        static_cast<double>(statistics.hits) * 100.0 / static_cast<double>(statistics.lookups);
+    LOG_INFO(Render, "Transcode cache: {} of {} lookups hit ({:.1f}%), {} stored, {} evicted",
+             statistics.hits, statistics.lookups, hit_rate, statistics.stores,
+             statistics.evictions);
+}
+
+bool TranscodeCache::Find(const Key& key, std::span<u8> output) {
+    ++lookups;
+    // Misses are the common case on a cold cache, they are answered by the index. Entries are
+    // only indexed once the directory has been scanned.
+    {
+        std::scoped_lock lock{index_mutex};
+        if (!entries.contains(key.hash)) {
+            return false;
+        }
+    }
+    const Common::FS::MappedFile file{EntryPath(key.hash)};
+    if (!file.IsOpen()) {
+        return false;
+    }
+    const std::span<const u8> data = file.GetData();
+    EntryHeader header;
+    if (data.size() != sizeof(header) + output.size()) {
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    const std::span<const u8> payload = data.subspan(sizeof(header));
+    if (header.magic != MAGIC_NUMBER || header.format_version != FORMAT_VERSION ||
+        header.key != key.hash || header.payload_size != output.size()) {
+        LOG_WARNING(Render, "Removing damaged transcode cache entry {:016x}", key.hash);
+        worker.QueueWork([this, hash = key.hash] { Remove(hash); });
+        return false;
+    }
+    if (header.check_hash != key.check_hash || header.input_size != key.input_size) {
+        // Another input with the same key, keep the entry for it
+        return false;
+    }
+    if (header.payload_hash != HashPayload(payload)) {
+        LOG_WARNING(Render, "Removing damaged transcode cache entry {:016x}", key.hash);
+        worker.QueueWork([this, hash = key.hash] { Remove(hash); });
+        return false;
+    }
+    std::memcpy(output.data(), payload.data(), payload.size());
+    ++hits;
+    worker.QueueWork([this, hash = key.hash] { Touch(hash); });
+    return true;
+}
+
+void TranscodeCache::Store(const Key& key, std::span<const u8> data) {
+    if (data.size() > max_size_bytes) {
+        return;
+    }
+    if (pending_bytes.fetch_add(data.size()) + data.size() > MAX_PENDING_BYTES) {
+        pending_bytes -= data.size();
+        return;
+    }
+    ++stores;
+    worker.QueueWork([this, key, copy = std::vector<u8>(data.begin(), data.end())] {
+        Write(key, copy);
+        pending_bytes -= copy.size();
+    });
+}
+
+void TranscodeCache::Flush() {
+    worker.WaitForRequests();
+}
+
+TranscodeCache::Statistics TranscodeCache::GetStatistics() const {
+    return {
+        .lookups = lookups.load(std::memory_order_relaxed),
+        .hits = hits.load(std::memory_order_relaxed),
+        .stores = stores.load(std::memory_order_relaxed),
+        .evictions = evictions.load(std::memory_order_relaxed),
+    };
+}
+
+std::filesystem::path TranscodeCache::EntryPath(u64 key) const {
+    return directory / fmt::format("{:016x}{}", key, ENTRY_EXTENSION);
+}
+
+void TranscodeCache::Scan() {
+    if (!Common::FS::CreateDirs(directory)) {
+        LOG_ERROR(Render, "Failed to create transcode cache directory {}",
+                  Common::FS::PathToUTF8String(directory));
+        return;
+    }
+    std::vector<std::tuple<std::filesystem::file_time_type, u64, u64>> found;
+    const auto callback = [&found](const std::filesystem::directory_entry& entry) {
+        const std::filesystem::path& path = entry.path();
+        if (path.extension() == TEMPORARY_EXTENSION) {
+            // Left behind by a run that did not finish writing it
+            Common::FS::RemoveFile(path);
+            return true;
+        }
+        const std::string stem = Common::FS::PathToUTF8String(path.stem());
+        const char* const stem_end = stem.data() + stem.size();
+        u64 key{};
+        const auto [end, error] = std::from_chars(stem.data(), stem_end, key, 16);
+        if (path.extension() != ENTRY_EXTENSION || error != std::errc{} || end != stem_end) {
+            return true;
+        }
+        std::error_code ec;
+        const auto time = entry.last_write_time(ec);
+        const u64 size = entry.file_size(ec);
+        if (!ec) {
+            found.emplace_back(time, key, size);
+        }
+        return true;
+    };
+    Common::FS::IterateDirEntries(directory, callback, Common::FS::DirEntryFilter::File);
+
+    // Oldest first, so each insertion becomes the most recently used entry
+    std::ranges::sort(found);
+    for (const auto& [time, key, size] : found) {
+        // Entries may already be indexed when they were stored before the scan ran
+        if (!entries.contains(key)) {
+            Insert(key, size);
+        }
+    }
+    LOG_INFO(Render, "Transcode cache holds {} entries ({} MiB)", entries.size(),
+             total_size_bytes / 1_MiB);
+    Evict();
+}
+
+void TranscodeCache::Write(const Key& key, std::span<const u8> data) {
+    const std::filesystem::path path = EntryPath(key.hash);
+    if (entries.contains(key.hash) || Common::FS::Exists(path)) {
+        return;
+    }
+    const EntryHeader header{
+        .magic = MAGIC_NUMBER,
+        .format_version = FORMAT_VERSION,
+        .reserved = 0,
+        .key = key.hash,
+        .check_hash = key.check_hash,
+        .input_size = key.input_size,
+        .payload_hash = HashPayload(data),
+        .payload_size = data.size(),
+    };
+    // Write to a temporary file first, lookups must never map a partially written entry
+    std::filesystem::path temporary_path = path;
+    temporary_path.replace_extension(TEMPORARY_EXTENSION);
+    {
+        Common::FS::IOFile file{temporary_path, Common::FS::FileAccessMode::Write,
+                                Common::FS::FileType::BinaryFile};
+        if (!file.IsOpen() || !file.WriteObject(header) ||
+            file.WriteSpan(data) != data.size()) {
+            LOG_ERROR(Render, "Failed to write transcode cache entry {}",
+                      Common::FS::PathToUTF8String(temporary_path));
+            file.Close();
+            Common::FS::RemoveFile(temporary_path);
+            return;
+        }
+    }
+    if (!Common::FS::RenameFile(temporary_path, path)) {
+        Common::FS::RemoveFile(temporary_path);
+        return;
+    }
+    Insert(key.hash, sizeof(header) + data.size());
+    Evict();
+}
+
+void TranscodeCache::Touch(u64 key) {
+    {
+        std::scoped_lock lock{index_mutex};
+        const auto it = entries.find(key);
+        if (it == entries.end()) {
+            return;
+        }
+        lru.splice(lru.begin(), lru, it->second.lru_position);
+    }
+    std::error_code ec;
+    std::filesystem::last_write_time(EntryPath(key), std::filesystem::file_time_type::clock::now(),
+                                     ec);
+}
+
+void TranscodeCache::Insert(u64 key, u64 size) {
+    std::scoped_lock lock{index_mutex};
+    lru.push_front(key);
+    entries.emplace(key, Entry{size, lru.begin()});
+    total_size_bytes += size;
+}
+
+void TranscodeCache::Remove(u64 key) {
+    Common::FS::RemoveFile(EntryPath(key));
+    std::scoped_lock lock{index_mutex};
+    const auto it = entries.find(key);
+    if (it == entries.end()) {
+        return;
+    }
+    total_size_bytes -= it->second.size;
+    lru.erase(it->second.lru_position);
+    entries.erase(it);
+}
+
+void TranscodeCache::Evict() {
+    while (total_size_bytes > max_size_bytes && !lru.empty()) {
+        Remove(lru.back());
+        ++evictions;
+    }
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+
+#include "common/common_types.h"
+#include "common/thread_worker.h"
+
+namespace VideoCommon {
+
+/**
+ * Content-addressed on-disk cache of textures transcoded on the CPU (e.g. ASTC decoded to RGBA8 or
+ * re-encoded to BC1/BC3), keyed by a hash of the guest data and the conversion parameters.
+ *
+ * Every entry is a file of its own, mapped on lookup. The directory is indexed in memory, so
+ * misses never touch the disk. Scanning the directory, writes, access time updates and the least
+ * recently used eviction that keeps the directory under its size budget run on a worker thread.
+ */
+class TranscodeCache {
+public:
+    /// Identifies an entry, the check hash and the input size guard against key collisions
+    struct Key {
+        u64 hash;       ///< Names the entry
+        u64 check_hash; ///< Second hash of the input, independent from the first one
+        u64 input_size;
+    };
+
+    struct Statistics {
+        u64 lookups{};
+        u64 hits{};
+        u64 stores{};
+        u64 evictions{};
+    };
+
+    explicit TranscodeCache(std::filesystem::path directory, u64 max_size_bytes);
+    ~TranscodeCache();
+
+    /// Copies the entry of the given key to output, returns false when it is not cached.
+    [[nodiscard]] bool Find(const Key& key, std::span<u8> output);
+
+    /// Queues a copy of the data to be written as the entry of the given key.
+    void Store(const Key& key, std::span<const u8> data);
+
+    /// Waits until every queued write and eviction has reached the disk.
+    void Flush();
+
+    [[nodiscard]] Statistics GetStatistics() const;
+
+private:
+    struct Entry {
+        u64 size;
+        std::list<u64>::iterator lru_position;
+    };
+
+    [[nodiscard]] std::filesystem::path EntryPath(u64 key) const;
+
+    /// Indexes the entries left by previous runs, oldest first.
+    void Scan();
+
+    void Write(const Key& key, std::span<const u8> data);
+
+    /// Marks an entry as the most recently used one, also on disk for the next runs.
+    void Touch(u64 key);
+
+    void Insert(u64 key, u64 size);
+    void Remove(u64 key);
+
+    /// Removes least recently used entries until the cache fits its budget.
+    void Evict();
+
+    std::filesystem::path directory;
+    u64 max_size_bytes;
+
+    // Only modified from the worker thread, lookups read the index under index_mutex
+    std::mutex index_mutex;
+    std::unordered_map<u64, Entry> entries;
+    std::list<u64> lru; ///< Most recently used entry first
+    u64 total_size_bytes{};
+
+    std::atomic<u64> pending_bytes{}; ///< Bytes of the stores not written yet
+    std::atomic<u64> lookups{};
+    std::atomic<u64> hits{};
+    std::atomic<u64> stores{};
+    std::atomic<u64> evictions{};
+
+    Common::ThreadWorker worker{1, "TranscodeCache"};
+};
+
+} // namespace VideoCommon
@@ -16,6 +16,7 @@
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "common/bit_util.h"
+#include "common/cityhash.h"
 #include "common/common_types.h"
 #include "common/div_ceil.h"
 #include "common/scratch_buffer.h"
@@ -29,6 +30,7 @@
 #include "video_core/texture_cache/format_lookup_table.h"
 #include "video_core/texture_cache/formatter.h"
 #include "video_core/texture_cache/samples_helper.h"
+#include "video_core/texture_cache/transcode_cache.h"
 #include "video_core/texture_cache/util.h"
 #include "video_core/textures/astc.h"
 #include "video_core/textures/bcn.h"
@@ -566,6 +568,29 @@ void SwizzleBlockLinearImage(Tegra::MemoryManager& gpu_memory, GPUVAddr gpu_addr
     ASSERT(host_offset - copy.buffer_offset == copy.buffer_size);
 }
 
+/// Identifies a converted ASTC level by its guest data and everything its conversion depends on
+[[nodiscard]] TranscodeCache::Key TranscodeCacheKey(std::span<const u8> input, Extent3D extent,
+                                                   u32 num_slices, Extent2D tile_size,
+                                                   Settings::AstcRecompression recompression,
+                                                   Settings::AstcRecompressionQuality quality) {
+    const std::array<u32, 7> parameters{
+        extent.width,      extent.height,    num_slices,
+        tile_size.width,   tile_size.height, static_cast<u32>(recompression),
+        static_cast<u32>(quality),
+    };
+    const u64 parameters_hash = Common::CityHash64(
+        reinterpret_cast<const char*>(parameters.data()), sizeof(parameters));
+    const size_t input_size = static_cast<size_t>(Common::DivCeil(extent.width, tile_size.width)) *
+                              Common::DivCeil(extent.height, tile_size.height) * num_slices * 16;
+    const char* const data = reinterpret_cast<const char*>(input.data());
+    const size_t size = std::min(input_size, input.size());
+    return {
+        .hash = Common::CityHash64WithSeed(data, size, parameters_hash),
+        .check_hash = Common::CityHash64WithSeeds(data, size, ~parameters_hash, size),
+        .input_size = size,
+    };
+}
+
 } // Anonymous namespace
 
 u32 CalculateGuestSizeInBytes(const ImageInfo& info) noexcept {
@@ -911,7 +936,7 @@ boost::container::small_vector<BufferImageCopy, 16> UnswizzleImage(Tegra::Memory
 }
 
 void ConvertImage(std::span<const u8> input, const ImageInfo& info, std::span<u8> output,
-                  std::span<BufferImageCopy> copies) {
+                  std::span<BufferImageCopy> copies, TranscodeCache* transcode_cache) {
     u32 output_offset = 0;
     Common::ScratchBuffer<u8> decode_scratch;
 
@@ -929,13 +954,34 @@ void ConvertImage(std::span<const u8> input, const ImageInfo& info, std::span<u8
         copy.buffer_offset = output_offset;
 
         const auto recompression_setting = Settings::values.astc_recompression.GetValue();
+        const auto quality_setting = Settings::values.astc_recompression_quality.GetValue();
         const bool astc = IsPixelFormatASTC(info.format);
+        const u32 num_slices = copy.image_subresource.num_layers * copy.image_extent.depth;
+
+        // Skips the conversion when the transcode cache has its result
+        const auto transcode = [&](std::span<u8> level_output, auto&& convert) {
+            if (!transcode_cache) {
+                convert();
+                return;
+            }
+            const TranscodeCache::Key key =
+                TranscodeCacheKey(input_offset, copy.image_extent, num_slices, tile_size,
+                                  recompression_setting, quality_setting);
+            if (!transcode_cache->Find(key, level_output)) {
+                convert();
+                transcode_cache->Store(key, level_output);
+            }
+        };
 
         if (astc && recompression_setting == Settings::AstcRecompression::Uncompressed) {
-            Tegra::Texture::ASTC::Decompress(
-                input_offset, copy.image_extent.width, copy.image_extent.height,
-                copy.image_subresource.num_layers * copy.image_extent.depth, tile_size.width,
-                tile_size.height, output.subspan(output_offset));
+            const u32 level_size = copy.image_extent.width * copy.image_extent.height *
+                                   num_slices * BytesPerBlock(PixelFormat::A8B8G8R8_UNORM);
+            const std::span<u8> level_output = output.subspan(output_offset, level_size);
+            transcode(level_output, [&] {
+                Tegra::Texture::ASTC::Decompress(input_offset, copy.image_extent.width,
+                                                 copy.image_extent.height, num_slices,
+                                                 tile_size.width, tile_size.height, level_output);
+            });
 
             output_offset += copy.image_extent.width * copy.image_extent.height *
                              copy.image_subresource.num_layers *
@@ -948,27 +994,28 @@ void ConvertImage(std::span<const u8> input, const ImageInfo& info, std::span<u8
                                       : Tegra::Texture::BCN::CompressBC3;
             const auto bpp_div = recompression_setting == Settings::AstcRecompression::Bc1 ? 2 : 1;
 
-            const u32 plane_dim = copy.image_extent.width * copy.image_extent.height;
-            const u32 level_size = plane_dim * copy.image_extent.depth *
-                                   copy.image_subresource.num_layers *
-                                   BytesPerBlock(PixelFormat::A8B8G8R8_UNORM);
-            decode_scratch.resize_destructive(level_size);
-
-            Tegra::Texture::ASTC::Decompress(
-                input_offset, copy.image_extent.width, copy.image_extent.height,
-                copy.image_subresource.num_layers * copy.image_extent.depth, tile_size.width,
-                tile_size.height, decode_scratch);
-
-            compress(decode_scratch, copy.image_extent.width, copy.image_extent.height,
-                     copy.image_subresource.num_layers * copy.image_extent.depth,
-                     output.subspan(output_offset));
-
             const u32 aligned_plane_dim = Common::AlignUp(copy.image_extent.width, 4) *
                                           Common::AlignUp(copy.image_extent.height, 4);
 
-            copy.buffer_size =
-                (aligned_plane_dim * copy.image_extent.depth * copy.image_subresource.num_layers) /
-                bpp_div;
+            copy.buffer_size = (aligned_plane_dim * num_slices) / bpp_div;
+            const std::span<u8> level_output = output.subspan(output_offset, copy.buffer_size);
+            transcode(level_output, [&] {
+                const u32 plane_dim = copy.image_extent.width * copy.image_extent.height;
+                const u32 level_size =
+                    plane_dim * num_slices * BytesPerBlock(PixelFormat::A8B8G8R8_UNORM);
+                decode_scratch.resize_destructive(level_size);
+
+                Tegra::Texture::ASTC::Decompress(input_offset, copy.image_extent.width,
+                                                 copy.image_extent.height, num_slices,
+                                                 tile_size.width, tile_size.height,
+                                                 decode_scratch);
+
+                const auto quality = quality_setting == Settings::AstcRecompressionQuality::Fast
+                                         ? Tegra::Texture::BCN::Quality::Fast
+                                         : Tegra::Texture::BCN::Quality::High;
+                compress(decode_scratch, copy.image_extent.width, copy.image_extent.height,
+                         num_slices, level_output, quality);
+            });
             output_offset += static_cast<u32>(copy.buffer_size);
         } else {
             DecompressBCn(input_offset, output.subspan(output_offset), copy, info.format);
@@ -17,6 +17,8 @@
 
 namespace VideoCommon {
 
+class TranscodeCache;
+
 using Tegra::Texture::TICEntry;
 
 using LevelArray = std::array<u32, MAX_MIP_LEVELS>;
@@ -66,8 +68,10 @@ struct OverlapResult {
     Tegra::MemoryManager& gpu_memory, GPUVAddr gpu_addr, const ImageInfo& info,
     std::span<const u8> input, std::span<u8> output);
 
+/// Converts unswizzled images to a host format, looking up and storing ASTC conversions in the
+/// transcode cache when one is given.
 void ConvertImage(std::span<const u8> input, const ImageInfo& info, std::span<u8> output,
-                  std::span<BufferImageCopy> copies);
+                  std::span<BufferImageCopy> copies, TranscodeCache* transcode_cache);
 
 [[nodiscard]] boost::container::small_vector<BufferImageCopy, 16> FullDownloadCopies(
     const ImageInfo& info);
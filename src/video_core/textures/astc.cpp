@@ -5,6 +5,7 @@
 // <http://gamma.cs.unc.edu/FasTC/>
 
 #include <algorithm>
+#include <array>
 #include <bit>
 #include <cassert>
 #include <cstring>
@@ -17,54 +18,12 @@
 #include "common/common_types.h"
 #include "common/polyfill_ranges.h"
 #include "video_core/textures/astc.h"
+#include "video_core/textures/astc_bit_stream.h"
 #include "video_core/textures/workers.h"
 
-class InputBitStream {
-public:
-    constexpr explicit InputBitStream(std::span<const u8> data, size_t start_offset = 0)
-        : cur_byte{data.data()}, total_bits{data.size()}, next_bit{start_offset % 8} {}
-
-    constexpr size_t GetBitsRead() const {
-        return bits_read;
-    }
-
-    constexpr bool ReadBit() {
-        if (bits_read >= total_bits * 8) {
-            return 0;
-        }
-        const bool bit = ((*cur_byte >> next_bit) & 1) != 0;
-        ++next_bit;
-        while (next_bit >= 8) {
-            next_bit -= 8;
-            ++cur_byte;
-        }
-        ++bits_read;
-        return bit;
-    }
-
-    constexpr u32 ReadBits(std::size_t nBits) {
-        u32 ret = 0;
-        for (std::size_t i = 0; i < nBits; ++i) {
-            ret |= (ReadBit() & 1) << i;
-        }
-        return ret;
-    }
-
-    template <std::size_t nBits>
-    constexpr u32 ReadBits() {
-        u32 ret = 0;
-        for (std::size_t i = 0; i < nBits; ++i) {
-            ret |= (ReadBit() & 1) << i;
-        }
-        return ret;
-    }
-
-private:
-    const u8* cur_byte;
-    size_t total_bits = 0;
-    size_t next_bit = 0;
-    size_t bits_read = 0;
-};
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 
 class OutputBitStream {
 public:
@@ -1143,6 +1102,78 @@ static void UnquantizeTexelWeights(u32 out[2][144], const IntegerEncodedVector&
             }
 }
 
+/// Bilinear taps of the weight grid read by each texel of a block (Section C.2.18)
+struct WeightInfillTable {
+    u32 block_width = 0;
+    u32 block_height = 0;
+    u32 grid_width = 0;
+    u32 grid_height = 0;
+    std::array<std::array<u8, 4>, 144> index;
+    std::array<std::array<u8, 4>, 144> weight;
+};
+
+static void BuildWeightInfillTable(WeightInfillTable& table, u32 blockWidth, u32 blockHeight,
+                                   u32 gridWidth, u32 gridHeight) {
+    table.block_width = blockWidth;
+    table.block_height = blockHeight;
+    table.grid_width = gridWidth;
+    table.grid_height = gridHeight;
+
+    // Same arithmetic as UnquantizeTexelWeights, taps outside of the grid contribute nothing
+    const u32 Ds = (1024 + (blockWidth / 2)) / (blockWidth - 1);
+    const u32 Dt = (1024 + (blockHeight / 2)) / (blockHeight - 1);
+    const u32 gridSize = gridWidth * gridHeight;
+    for (u32 t = 0; t < blockHeight; t++) {
+        for (u32 s = 0; s < blockWidth; s++) {
+            const u32 gs = (Ds * s * (gridWidth - 1) + 32) >> 6;
+            const u32 gt = (Dt * t * (gridHeight - 1) + 32) >> 6;
+            const u32 fs = gs & 0xF;
+            const u32 ft = gt & 0xF;
+            const u32 w11 = (fs * ft + 8) >> 4;
+            const u32 v0 = (gs >> 4) + (gt >> 4) * gridWidth;
+
+            const std::array<u32, 4> taps{v0, v0 + 1, v0 + gridWidth, v0 + gridWidth + 1};
+            const std::array<u32, 4> weights{16 - fs - ft + w11, fs - w11, ft - w11, w11};
+            const u32 texel = t * blockWidth + s;
+            for (u32 i = 0; i < 4; i++) {
+                const bool inside = taps[i] < gridSize;
+                table.index[texel][i] = static_cast<u8>(inside ? taps[i] : 0);
+                table.weight[texel][i] = static_cast<u8>(inside ? weights[i] : 0);
+            }
+        }
+    }
+}
+
+// Single plane version of UnquantizeTexelWeights, the infill taps are looked up instead of
+// computed for each texel
+static void UnquantizeSinglePlaneWeights(std::span<u8, 144> out,
+                                         const IntegerEncodedVector& weights,
+                                         const TexelWeightParams& params, const u32 blockWidth,
+                                         const u32 blockHeight) {
+    // Consecutive blocks of a texture tend to share their weight grid
+    thread_local WeightInfillTable table;
+    if (table.block_width != blockWidth || table.block_height != blockHeight ||
+        table.grid_width != params.m_Width || table.grid_height != params.m_Height) {
+        BuildWeightInfillTable(table, blockWidth, blockHeight, params.m_Width, params.m_Height);
+    }
+
+    std::array<u8, 144> unquantized{};
+    const size_t gridSize = std::min<size_t>(params.m_Width * params.m_Height, weights.size());
+    for (size_t i = 0; i < gridSize; i++) {
+        unquantized[i] = static_cast<u8>(UnquantizeTexelWeight(weights[i]));
+    }
+
+    const u32 numTexels = blockWidth * blockHeight;
+    for (u32 texel = 0; texel < numTexels; texel++) {
+        const auto& index = table.index[texel];
+        const auto& weight = table.weight[texel];
+        out[texel] = static_cast<u8>(
+            (unquantized[index[0]] * weight[0] + unquantized[index[1]] * weight[1] +
+             unquantized[index[2]] * weight[2] + unquantized[index[3]] * weight[3] + 8) >>
+            4);
+    }
+}
+
 // Transfers a bit as described in C.2.14
 static inline void BitTransferSigned(int& a, int& b) {
     b >>= 1;
@@ -1419,8 +1450,61 @@ static void FillError(std::span<u32> outBuf, u32 blockWidth, u32 blockHeight) {
     }
 }
 
+// Interpolates the endpoints of a single partition block. Equivalent to replicating the endpoints
+// to 16 bits, interpolating and rounding back to 8 bits as DecompressBlock does, which reduces to
+// (t * 8191 + 270336) >> 19 with t = e0 * (64 - w) + e1 * w.
+static void InterpolateSinglePartition(const Pixel& low, const Pixel& high,
+                                       std::span<const u8, 144> weights, u32 numTexels,
+                                       std::span<u32, 12 * 12> outBuf) {
+    // Output channel order, the alpha channel is stored first in a pixel
+    static constexpr std::array<u32, 4> channels{1, 2, 3, 0};
+#ifdef ARCHITECTURE_x86_64
+    alignas(16) std::array<s16, 8> e0;
+    alignas(16) std::array<s16, 8> e1;
+    for (u32 i = 0; i < 8; i++) {
+        e0[i] = low.Component(channels[i % 4]);
+        e1[i] = high.Component(channels[i % 4]);
+    }
+    const __m128i endpoint0 = _mm_load_si128(reinterpret_cast<const __m128i*>(e0.data()));
+    const __m128i endpoint1 = _mm_load_si128(reinterpret_cast<const __m128i*>(e1.data()));
+    const __m128i sixty_four = _mm_set1_epi16(64);
+    const __m128i bias = _mm_set1_epi16(33);
+    const __m128i scale = _mm_set1_epi32((8192 << 16) | 8191);
+
+    // Two texels per vector of weights, the texel count is rounded up to fill whole stores
+    const auto interpolate = [&](u32 weight_a, u32 weight_b) {
+        const __m128i w = _mm_unpacklo_epi64(_mm_set1_epi16(static_cast<s16>(weight_a)),
+                                             _mm_set1_epi16(static_cast<s16>(weight_b)));
+        const __m128i t =
+            _mm_add_epi16(_mm_mullo_epi16(endpoint0, _mm_sub_epi16(sixty_four, w)),
+                          _mm_mullo_epi16(endpoint1, w));
+        const __m128i lo = _mm_srli_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(t, bias), scale), 19);
+        const __m128i hi = _mm_srli_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(t, bias), scale), 19);
+        return _mm_packs_epi32(lo, hi);
+    };
+    for (u32 texel = 0; texel < numTexels; texel += 4) {
+        const __m128i first = interpolate(weights[texel], weights[texel + 1]);
+        const __m128i second = interpolate(weights[texel + 2], weights[texel + 3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outBuf.data() + texel),
+                         _mm_packus_epi16(first, second));
+    }
+#else
+    for (u32 texel = 0; texel < numTexels; texel++) {
+        const u32 weight = weights[texel];
+        u32 pixel = 0;
+        for (u32 i = 0; i < 4; i++) {
+            const u32 t = static_cast<u32>(low.Component(channels[i])) * (64 - weight) +
+                          static_cast<u32>(high.Component(channels[i])) * weight;
+            pixel |= ((t * 8191 + 270336) >> 19) << (i * 8);
+        }
+        outBuf[texel] = pixel;
+    }
+#endif
+}
+
 static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
-                            const u32 blockHeight, std::span<u32, 12 * 12> outBuf) {
+                            const u32 blockHeight, std::span<u32, 12 * 12> outBuf,
+                            bool useFastPaths) {
     InputBitStream strm(inBuf);
     TexelWeightParams weightParams = DecodeBlockInfo(strm);
 
@@ -1613,6 +1697,16 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
     DecodeIntegerSequence(texelWeightValues, weightStream, weightParams.m_MaxWeight,
                           weightParams.GetNumWeightValues());
 
+    // Single partition blocks without a second plane are the bulk of most textures
+    if (useFastPaths && nPartitions == 1 && !weightParams.m_bDualPlane) {
+        std::array<u8, 144> texelWeights{};
+        UnquantizeSinglePlaneWeights(texelWeights, texelWeightValues, weightParams, blockWidth,
+                                     blockHeight);
+        InterpolateSinglePartition(endpoints[0][0], endpoints[0][1], texelWeights,
+                                   blockWidth * blockHeight, outBuf);
+        return;
+    }
+
     // Blocks can be at most 12x12, so we can have as many as 144 weights
     u32 weights[2][144];
     UnquantizeTexelWeights(weights, texelWeightValues, weightParams, blockWidth, blockHeight);
@@ -1651,8 +1745,9 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
         }
 }
 
-void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
-                uint32_t block_width, uint32_t block_height, std::span<uint8_t> output) {
+static void DecompressImpl(std::span<const uint8_t> data, uint32_t width, uint32_t height,
+                           uint32_t depth, uint32_t block_width, uint32_t block_height,
+                           std::span<uint8_t> output, bool use_fast_paths) {
     const u32 rows = Common::DivideUp(height, block_height);
     const u32 cols = Common::DivideUp(width, block_width);
 
@@ -1662,7 +1757,7 @@ void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height,
         const u32 depth_offset = z * height * width * 4;
         for (u32 y_index = 0; y_index < rows; ++y_index) {
             auto decompress_stride = [data, width, height, block_width, block_height, output, rows,
-                                      cols, z, depth_offset, y_index] {
+                                      cols, z, depth_offset, y_index, use_fast_paths] {
                 const u32 y = y_index * block_height;
                 for (u32 x_index = 0; x_index < cols; ++x_index) {
                     const u32 block_index = (z * rows * cols) + (y_index * cols) + x_index;
@@ -1672,7 +1767,8 @@ void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height,
 
                     // Blocks can be at most 12x12
                     std::array<u32, 12 * 12> uncompData;
-                    DecompressBlock(blockPtr, block_width, block_height, uncompData);
+                    DecompressBlock(blockPtr, block_width, block_height, uncompData,
+                                    use_fast_paths);
 
                     u32 decompWidth = std::min(block_width, width - x);
                     u32 decompHeight = std::min(block_height, height - y);
@@ -1690,4 +1786,15 @@ void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height,
     }
 }
 
+void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
+                uint32_t block_width, uint32_t block_height, std::span<uint8_t> output) {
+    DecompressImpl(data, width, height, depth, block_width, block_height, output, true);
+}
+
+void DecompressGeneric(std::span<const uint8_t> data, uint32_t width, uint32_t height,
+                       uint32_t depth, uint32_t block_width, uint32_t block_height,
+                       std::span<uint8_t> output) {
+    DecompressImpl(data, width, height, depth, block_width, block_height, output, false);
+}
+
 } // namespace Tegra::Texture::ASTC
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: 2016 The University of North Carolina at Chapel Hill
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
+#include "common/common_types.h"
+
+namespace Tegra::Texture::ASTC {
+
+/// Reads the bits of ASTC data, starting from the least significant bit of the first byte
+class InputBitStream {
+public:
+    constexpr explicit InputBitStream(std::span<const u8> data, size_t start_offset = 0)
+        : cur_byte{data.data()}, total_bits{data.size()}, next_bit{start_offset % 8} {}
+
+    constexpr size_t GetBitsRead() const {
+        return bits_read;
+    }
+
+    constexpr bool ReadBit() {
+        if (bits_read >= total_bits * 8) {
+            return 0;
+        }
+        const bool bit = ((*cur_byte >> next_bit) & 1) != 0;
+        ++next_bit;
+        while (next_bit >= 8) {
+            next_bit -= 8;
+            ++cur_byte;
+        }
+        ++bits_read;
+        return bit;
+    }
+
+    constexpr u32 ReadBits(std::size_t nBits) {
+        // Read up to a byte at a time, bits past the end of the stream read as zero
+        u32 ret = 0;
+        std::size_t shift = 0;
+        while (shift < nBits && bits_read < total_bits * 8) {
+            const std::size_t count = std::min(nBits - shift, 8 - next_bit);
+            const u32 bits = (*cur_byte >> next_bit) & ((1U << count) - 1);
+            ret |= bits << shift;
+            shift += count;
+            bits_read += count;
+            next_bit += count;
+            if (next_bit >= 8) {
+                next_bit -= 8;
+                ++cur_byte;
+            }
+        }
+        return ret;
+    }
+
+    template <std::size_t nBits>
+    constexpr u32 ReadBits() {
+        return ReadBits(nBits);
+    }
+
+private:
+    const u8* cur_byte;
+    size_t total_bits = 0;
+    size_t next_bit = 0;
+    size_t bits_read = 0;
+};
+
+} // namespace Tegra::Texture::ASTC
@@ -1,13 +1,48 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <utility>
+
 #include <stb_dxt.h>
-#include <string.h>
+
 #include "common/alignment.h"
 #include "video_core/textures/bcn.h"
 #include "video_core/textures/workers.h"
 
+#ifdef ARCHITECTURE_x86_64
+#include <immintrin.h>
+#include "common/x64/cpu_detect.h"
+#elif defined(ARCHITECTURE_arm64)
+#include <arm_neon.h>
+#endif
+
+#ifdef ARCHITECTURE_x86_64
+#ifdef _MSC_VER
+#define BCN_SSE41_TARGET
+#define BCN_AVX2_TARGET
+#define BCN_FLATTEN
+#else
+#define BCN_SSE41_TARGET __attribute__((target("sse4.1")))
+#define BCN_AVX2_TARGET __attribute__((target("avx2")))
+// Inlines the vector operations, which only have the instruction set of the kernel entry point
+#define BCN_FLATTEN __attribute__((flatten))
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+// The kernels are flattened into their entry points, no vector is passed across a call.
+// GCC reports this once the translation unit is compiled, so it cannot be scoped with a push.
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
 namespace Tegra::Texture::BCN {
+namespace {
 
 using BCNCompressor = void(u8* block_output, const u8* block_input, bool any_alpha);
 
@@ -42,13 +77,13 @@ void CompressBCN(std::span<const uint8_t> data, uint32_t width, uint32_t height,
                                         input_colors[j][i][3] = 255;
                                     } else {
                                         any_alpha = true;
-                                        memset(input_colors[j][i], 0, bytes_per_px);
+                                        std::memset(input_colors[j][i], 0, bytes_per_px);
                                     }
                                 } else {
-                                    memcpy(input_colors[j][i], &data[coord], bytes_per_px);
+                                    std::memcpy(input_colors[j][i], &data[coord], bytes_per_px);
                                 }
                             } else {
-                                memset(input_colors[j][i], 0, bytes_per_px);
+                                std::memset(input_colors[j][i], 0, bytes_per_px);
                             }
                         }
                     }
@@ -66,8 +101,742 @@ void CompressBCN(std::span<const uint8_t> data, uint32_t width, uint32_t height,
     }
 }
 
+/// Blocks encoded by each call to a color kernel
+constexpr size_t BATCH_SIZE = 8;
+
+using Block = std::array<std::array<u8, 4>, 16>;
+
+/// RGB texels of a batch of blocks, each channel of a texel is contiguous across the blocks
+struct ColorBatch {
+    alignas(32) std::array<std::array<std::array<float, BATCH_SIZE>, 16>, 3> texels;
+};
+
+/// Color kernel output, indices are split in the ones of the first and last eight texels
+struct EncodedColors {
+    alignas(32) std::array<float, BATCH_SIZE> endpoint0;
+    alignas(32) std::array<float, BATCH_SIZE> endpoint1;
+    alignas(32) std::array<float, BATCH_SIZE> indices_low;
+    alignas(32) std::array<float, BATCH_SIZE> indices_high;
+};
+
+using ColorKernel = void (*)(const ColorBatch& batch, Quality quality, EncodedColors& encoded);
+
+/// Vector of one float, for hosts without a vector kernel
+struct VecScalar {
+    using Float = float;
+    using Mask = bool;
+    static constexpr size_t LANES = 1;
+
+    static Float Load(const float* data) {
+        return *data;
+    }
+    static void Store(float* data, Float value) {
+        *data = value;
+    }
+    static Float Set(float value) {
+        return value;
+    }
+    static Float Add(Float a, Float b) {
+        return a + b;
+    }
+    static Float Sub(Float a, Float b) {
+        return a - b;
+    }
+    static Float Mul(Float a, Float b) {
+        return a * b;
+    }
+    static Float Div(Float a, Float b) {
+        return a / b;
+    }
+    static Float Min(Float a, Float b) {
+        return std::min(a, b);
+    }
+    static Float Max(Float a, Float b) {
+        return std::max(a, b);
+    }
+    static Float Floor(Float value) {
+        return std::floor(value);
+    }
+    static Mask Less(Float a, Float b) {
+        return a < b;
+    }
+    static Float Select(Mask mask, Float a, Float b) {
+        return mask ? a : b;
+    }
+};
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+// Vector types lose their may_alias attribute as template arguments, they are never type punned
+#pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+#ifdef ARCHITECTURE_x86_64
+struct VecSSE41 {
+    using Float = __m128;
+    using Mask = __m128;
+    static constexpr size_t LANES = 4;
+
+    BCN_SSE41_TARGET static Float Load(const float* data) {
+        return _mm_load_ps(data);
+    }
+    BCN_SSE41_TARGET static void Store(float* data, Float value) {
+        _mm_store_ps(data, value);
+    }
+    BCN_SSE41_TARGET static Float Set(float value) {
+        return _mm_set1_ps(value);
+    }
+    BCN_SSE41_TARGET static Float Add(Float a, Float b) {
+        return _mm_add_ps(a, b);
+    }
+    BCN_SSE41_TARGET static Float Sub(Float a, Float b) {
+        return _mm_sub_ps(a, b);
+    }
+    BCN_SSE41_TARGET static Float Mul(Float a, Float b) {
+        return _mm_mul_ps(a, b);
+    }
+    BCN_SSE41_TARGET static Float Div(Float a, Float b) {
+        return _mm_div_ps(a, b);
+    }
+    BCN_SSE41_TARGET static Float Min(Float a, Float b) {
+        return _mm_min_ps(a, b);
+    }
+    BCN_SSE41_TARGET static Float Max(Float a, Float b) {
+        return _mm_max_ps(a, b);
+    }
+    BCN_SSE41_TARGET static Float Floor(Float value) {
+        return _mm_floor_ps(value);
+    }
+    BCN_SSE41_TARGET static Mask Less(Float a, Float b) {
+        return _mm_cmplt_ps(a, b);
+    }
+    BCN_SSE41_TARGET static Float Select(Mask mask, Float a, Float b) {
+        return _mm_blendv_ps(b, a, mask);
+    }
+};
+
+struct VecAVX2 {
+    using Float = __m256;
+    using Mask = __m256;
+    static constexpr size_t LANES = 8;
+
+    BCN_AVX2_TARGET static Float Load(const float* data) {
+        return _mm256_load_ps(data);
+    }
+    BCN_AVX2_TARGET static void Store(float* data, Float value) {
+        _mm256_store_ps(data, value);
+    }
+    BCN_AVX2_TARGET static Float Set(float value) {
+        return _mm256_set1_ps(value);
+    }
+    BCN_AVX2_TARGET static Float Add(Float a, Float b) {
+        return _mm256_add_ps(a, b);
+    }
+    BCN_AVX2_TARGET static Float Sub(Float a, Float b) {
+        return _mm256_sub_ps(a, b);
+    }
+    BCN_AVX2_TARGET static Float Mul(Float a, Float b) {
+        return _mm256_mul_ps(a, b);
+    }
+    BCN_AVX2_TARGET static Float Div(Float a, Float b) {
+        return _mm256_div_ps(a, b);
+    }
+    BCN_AVX2_TARGET static Float Min(Float a, Float b) {
+        return _mm256_min_ps(a, b);
+    }
+    BCN_AVX2_TARGET static Float Max(Float a, Float b) {
+        return _mm256_max_ps(a, b);
+    }
+    BCN_AVX2_TARGET static Float Floor(Float value) {
+        return _mm256_floor_ps(value);
+    }
+    BCN_AVX2_TARGET static Mask Less(Float a, Float b) {
+        return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    }
+    BCN_AVX2_TARGET static Float Select(Mask mask, Float a, Float b) {
+        return _mm256_blendv_ps(b, a, mask);
+    }
+};
+#elif defined(ARCHITECTURE_arm64)
+struct VecNEON {
+    using Float = float32x4_t;
+    using Mask = uint32x4_t;
+    static constexpr size_t LANES = 4;
+
+    static Float Load(const float* data) {
+        return vld1q_f32(data);
+    }
+    static void Store(float* data, Float value) {
+        vst1q_f32(data, value);
+    }
+    static Float Set(float value) {
+        return vdupq_n_f32(value);
+    }
+    static Float Add(Float a, Float b) {
+        return vaddq_f32(a, b);
+    }
+    static Float Sub(Float a, Float b) {
+        return vsubq_f32(a, b);
+    }
+    static Float Mul(Float a, Float b) {
+        return vmulq_f32(a, b);
+    }
+    static Float Div(Float a, Float b) {
+        return vdivq_f32(a, b);
+    }
+    static Float Min(Float a, Float b) {
+        return vminq_f32(a, b);
+    }
+    static Float Max(Float a, Float b) {
+        return vmaxq_f32(a, b);
+    }
+    static Float Floor(Float value) {
+        return vrndmq_f32(value);
+    }
+    static Mask Less(Float a, Float b) {
+        return vcltq_f32(a, b);
+    }
+    static Float Select(Mask mask, Float a, Float b) {
+        return vbslq_f32(mask, a, b);
+    }
+};
+#endif
+
+/// Array of vectors, std::array would drop the attributes of the vector types
+template <class T, size_t N>
+struct VectorArray {
+    T values[N];
+
+    T& operator[](size_t index) {
+        return values[index];
+    }
+    const T& operator[](size_t index) const {
+        return values[index];
+    }
+    T* begin() {
+        return values;
+    }
+    T* end() {
+        return values + N;
+    }
+    const T* begin() const {
+        return values;
+    }
+    const T* end() const {
+        return values + N;
+    }
+};
+
+/**
+ * Encodes the colors of the blocks of a batch, one block per vector lane.
+ * Endpoints start at the bounding box of the block (fast) or at the texels at the extremes of its
+ * principal axis (high), then are refined by least squares. Texels take the palette entry closest
+ * to them.
+ */
+template <class V>
+struct ColorEncoder {
+    using Float = typename V::Float;
+    using Color = VectorArray<Float, 3>;
+    using Texels = VectorArray<Color, 16>;
+
+    struct Endpoints {
+        Float packed0; ///< First endpoint in RGB565
+        Float packed1; ///< Second endpoint in RGB565
+        Color color0;
+        Color color1;
+    };
+
+    struct Match {
+        VectorArray<Float, 16> weights; ///< Weight of the first endpoint in the texel palette entry
+        Float indices_low;
+        Float indices_high;
+        Float error;
+    };
+
+    static void Encode(const ColorBatch& batch, Quality quality, EncodedColors& encoded) {
+        for (size_t base = 0; base < BATCH_SIZE; base += V::LANES) {
+            Texels texels;
+            for (size_t texel = 0; texel < 16; ++texel) {
+                for (size_t channel = 0; channel < 3; ++channel) {
+                    texels[texel][channel] = V::Load(&batch.texels[channel][texel][base]);
+                }
+            }
+            Color color0;
+            Color color1;
+            if (quality == Quality::Fast) {
+                BoundingBox(texels, color0, color1);
+            } else {
+                PrincipalAxis(texels, color0, color1);
+            }
+            Endpoints endpoints = Quantize(color0, color1);
+            Match match = MatchTexels(texels, endpoints);
+            const size_t refinements = quality == Quality::Fast ? 1 : 2;
+            for (size_t refinement = 0; refinement < refinements; ++refinement) {
+                Refine(texels, endpoints, match);
+            }
+            V::Store(&encoded.endpoint0[base], endpoints.packed0);
+            V::Store(&encoded.endpoint1[base], endpoints.packed1);
+            V::Store(&encoded.indices_low[base], match.indices_low);
+            V::Store(&encoded.indices_high[base], match.indices_high);
+        }
+    }
+
+    static void Statistics(const Texels& texels, Color& mean, Color& min, Color& max) {
+        mean = min = max = texels[0];
+        for (size_t texel = 1; texel < 16; ++texel) {
+            for (size_t channel = 0; channel < 3; ++channel) {
+                const Float value = texels[texel][channel];
+                mean[channel] = V::Add(mean[channel], value);
+                min[channel] = V::Min(min[channel], value);
+                max[channel] = V::Max(max[channel], value);
+            }
+        }
+        for (Float& value : mean) {
+            value = V::Mul(value, V::Set(1.0f / 16.0f));
+        }
+    }
+
+    /// Sum of the products of two channels relative to their means
+    static Float Covariance(const Texels& texels, const Color& mean, size_t a, size_t b) {
+        Float sum = V::Set(0.0f);
+        for (const Color& texel : texels) {
+            sum = V::Add(sum, V::Mul(V::Sub(texel[a], mean[a]), V::Sub(texel[b], mean[b])));
+        }
+        return sum;
+    }
+
+    static void BoundingBox(const Texels& texels, Color& color0, Color& color1) {
+        Color mean;
+        Color min;
+        Color max;
+        Statistics(texels, mean, min, max);
+
+        // Inset the box, its corners are rarely the best endpoints
+        for (size_t channel = 0; channel < 3; ++channel) {
+            const Float inset = V::Mul(V::Sub(max[channel], min[channel]), V::Set(1.0f / 16.0f));
+            color0[channel] = V::Sub(max[channel], inset);
+            color1[channel] = V::Add(min[channel], inset);
+        }
+        // Pick the diagonal of the box along which red and blue vary with green
+        for (const size_t channel : {size_t{0}, size_t{2}}) {
+            const auto swap = V::Less(Covariance(texels, mean, channel, 1), V::Set(0.0f));
+            const Float value0 = color0[channel];
+            color0[channel] = V::Select(swap, color1[channel], value0);
+            color1[channel] = V::Select(swap, value0, color1[channel]);
+        }
+    }
+
+    static void PrincipalAxis(const Texels& texels, Color& color0, Color& color1) {
+        Color mean;
+        Color min;
+        Color max;
+        Statistics(texels, mean, min, max);
+
+        VectorArray<Float, 6> covariance;
+        static constexpr std::array<std::pair<size_t, size_t>, 6> CHANNEL_PAIRS{{
+            {0, 0},
+            {0, 1},
+            {0, 2},
+            {1, 1},
+            {1, 2},
+            {2, 2},
+        }};
+        for (size_t i = 0; i < CHANNEL_PAIRS.size(); ++i) {
+            const auto [a, b] = CHANNEL_PAIRS[i];
+            covariance[i] = V::Mul(Covariance(texels, mean, a, b), V::Set(1.0f / 255.0f));
+        }
+
+        // Power iteration from the diagonal of the bounding box
+        Color axis;
+        for (size_t channel = 0; channel < 3; ++channel) {
+            axis[channel] = V::Sub(max[channel], min[channel]);
+        }
+        for (size_t iteration = 0; iteration < 4; ++iteration) {
+            const auto row = [&](size_t c0, size_t c1, size_t c2) {
+                return V::Add(V::Add(V::Mul(axis[0], covariance[c0]),
+                                     V::Mul(axis[1], covariance[c1])),
+                              V::Mul(axis[2], covariance[c2]));
+            };
+            axis = {row(0, 1, 2), row(1, 3, 4), row(2, 4, 5)};
+        }
+
+        // Blocks without a dominant direction are projected on luma
+        const auto abs = [](Float value) { return V::Max(value, V::Sub(V::Set(0.0f), value)); };
+        const Float magnitude = V::Max(V::Max(abs(axis[0]), abs(axis[1])), abs(axis[2]));
+        const auto use_luma = V::Less(magnitude, V::Set(4.0f));
+        static constexpr std::array<float, 3> LUMA{0.299f, 0.587f, 0.114f};
+        for (size_t channel = 0; channel < 3; ++channel) {
+            axis[channel] = V::Select(use_luma, V::Set(LUMA[channel]), axis[channel]);
+        }
+
+        const auto project = [&](const Color& texel) {
+            return V::Add(V::Add(V::Mul(texel[0], axis[0]), V::Mul(texel[1], axis[1])),
+                          V::Mul(texel[2], axis[2]));
+        };
+        Float min_projection = project(texels[0]);
+        Float max_projection = min_projection;
+        color0 = color1 = texels[0];
+        for (size_t texel = 1; texel < 16; ++texel) {
+            const Float projection = project(texels[texel]);
+            const auto is_min = V::Less(projection, min_projection);
+            const auto is_max = V::Less(max_projection, projection);
+            min_projection = V::Select(is_min, projection, min_projection);
+            max_projection = V::Select(is_max, projection, max_projection);
+            for (size_t channel = 0; channel < 3; ++channel) {
+                color1[channel] = V::Select(is_min, texels[texel][channel], color1[channel]);
+                color0[channel] = V::Select(is_max, texels[texel][channel], color0[channel]);
+            }
+        }
+    }
+
+    static Endpoints Quantize(const Color& color0, const Color& color1) {
+        const auto quantize = [](Float value, float max) {
+            const Float clamped = V::Min(V::Max(value, V::Set(0.0f)), V::Set(255.0f));
+            return V::Floor(V::Add(V::Mul(clamped, V::Set(max / 255.0f)), V::Set(0.5f)));
+        };
+        // Bit replication, (q << 3 | q >> 2) and (q << 2 | q >> 4)
+        const auto expand = [](Float value, float scale) {
+            return V::Floor(V::Mul(value, V::Set(scale)));
+        };
+        const auto pack = [&](const Color& color, Float& packed, Color& expanded) {
+            const Float r = quantize(color[0], 31.0f);
+            const Float g = quantize(color[1], 63.0f);
+            const Float b = quantize(color[2], 31.0f);
+            packed = V::Add(V::Add(V::Mul(r, V::Set(2048.0f)), V::Mul(g, V::Set(32.0f))), b);
+            expanded = {expand(r, 33.0f / 4.0f), expand(g, 65.0f / 16.0f), expand(b, 33.0f / 4.0f)};
+        };
+        Endpoints endpoints;
+        pack(color0, endpoints.packed0, endpoints.color0);
+        pack(color1, endpoints.packed1, endpoints.color1);
+        return endpoints;
+    }
+
+    static Match MatchTexels(const Texels& texels, const Endpoints& endpoints) {
+        Color color2;
+        Color color3;
+        for (size_t channel = 0; channel < 3; ++channel) {
+            const Float c0 = endpoints.color0[channel];
+            const Float c1 = endpoints.color1[channel];
+            const Float third = V::Set(1.0f / 3.0f);
+            color2[channel] = V::Floor(V::Mul(V::Add(V::Add(c0, c0), c1), third));
+            color3[channel] = V::Floor(V::Mul(V::Add(V::Add(c1, c1), c0), third));
+        }
+        const std::array<const Color*, 4> palette{&endpoints.color0, &endpoints.color1, &color2,
+                                                  &color3};
+        static constexpr std::array<float, 4> WEIGHTS{1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+
+        const auto distance = [](const Color& a, const Color& b) {
+            Float sum = V::Set(0.0f);
+            for (size_t channel = 0; channel < 3; ++channel) {
+                const Float difference = V::Sub(a[channel], b[channel]);
+                sum = V::Add(sum, V::Mul(difference, difference));
+            }
+            return sum;
+        };
+        Match match;
+        match.indices_low = V::Set(0.0f);
+        match.indices_high = V::Set(0.0f);
+        match.error = V::Set(0.0f);
+        for (size_t texel = 0; texel < 16; ++texel) {
+            Float best_distance = distance(texels[texel], *palette[0]);
+            Float best_index = V::Set(0.0f);
+            Float best_weight = V::Set(WEIGHTS[0]);
+            for (size_t index = 1; index < 4; ++index) {
+                const Float current = distance(texels[texel], *palette[index]);
+                const auto closer = V::Less(current, best_distance);
+                best_distance = V::Select(closer, current, best_distance);
+                best_index = V::Select(closer, V::Set(static_cast<float>(index)), best_index);
+                best_weight = V::Select(closer, V::Set(WEIGHTS[index]), best_weight);
+            }
+            match.weights[texel] = best_weight;
+            match.error = V::Add(match.error, best_distance);
+
+            // Sixteen bits of indices are exact in a float
+            Float& indices = texel < 8 ? match.indices_low : match.indices_high;
+            const float shift = static_cast<float>(1U << (2 * (texel % 8)));
+            indices = V::Add(indices, V::Mul(best_index, V::Set(shift)));
+        }
+        return match;
+    }
+
+    /// Solves the endpoints that minimize the error of the matched texels, kept when they improve
+    static void Refine(const Texels& texels, Endpoints& endpoints, Match& match) {
+        Float aa = V::Set(0.0f);
+        Float ab = V::Set(0.0f);
+        Float bb = V::Set(0.0f);
+        Color a_texels{aa, aa, aa};
+        Color b_texels{aa, aa, aa};
+        for (size_t texel = 0; texel < 16; ++texel) {
+            const Float a = match.weights[texel];
+            const Float b = V::Sub(V::Set(1.0f), a);
+            aa = V::Add(aa, V::Mul(a, a));
+            ab = V::Add(ab, V::Mul(a, b));
+            bb = V::Add(bb, V::Mul(b, b));
+            for (size_t channel = 0; channel < 3; ++channel) {
+                a_texels[channel] = V::Add(a_texels[channel], V::Mul(a, texels[texel][channel]));
+                b_texels[channel] = V::Add(b_texels[channel], V::Mul(b, texels[texel][channel]));
+            }
+        }
+        // The system is singular when every texel has the same index
+        const Float determinant = V::Sub(V::Mul(aa, bb), V::Mul(ab, ab));
+        const auto solvable = V::Less(V::Set(0.5f), determinant);
+        const Float inverse =
+            V::Div(V::Set(1.0f), V::Select(solvable, determinant, V::Set(1.0f)));
+        Color color0;
+        Color color1;
+        for (size_t channel = 0; channel < 3; ++channel) {
+            color0[channel] = V::Mul(
+                V::Sub(V::Mul(bb, a_texels[channel]), V::Mul(ab, b_texels[channel])), inverse);
+            color1[channel] = V::Mul(
+                V::Sub(V::Mul(aa, b_texels[channel]), V::Mul(ab, a_texels[channel])), inverse);
+        }
+        const Endpoints refined = Quantize(color0, color1);
+        const Match refined_match = MatchTexels(texels, refined);
+        const Float refined_error =
+            V::Select(solvable, refined_match.error, V::Set(std::numeric_limits<float>::max()));
+        const auto better = V::Less(refined_error, match.error);
+        endpoints.packed0 = V::Select(better, refined.packed0, endpoints.packed0);
+        endpoints.packed1 = V::Select(better, refined.packed1, endpoints.packed1);
+        match.indices_low = V::Select(better, refined_match.indices_low, match.indices_low);
+        match.indices_high = V::Select(better, refined_match.indices_high, match.indices_high);
+        match.error = V::Select(better, refined_match.error, match.error);
+        for (size_t texel = 0; texel < 16; ++texel) {
+            match.weights[texel] =
+                V::Select(better, refined_match.weights[texel], match.weights[texel]);
+        }
+    }
+};
+
+#ifdef ARCHITECTURE_x86_64
+BCN_SSE41_TARGET BCN_FLATTEN void EncodeColorsSSE41(const ColorBatch& batch, Quality quality,
+                                                    EncodedColors& encoded) {
+    ColorEncoder<VecSSE41>::Encode(batch, quality, encoded);
+}
+
+BCN_AVX2_TARGET BCN_FLATTEN void EncodeColorsAVX2(const ColorBatch& batch, Quality quality,
+                                                  EncodedColors& encoded) {
+    ColorEncoder<VecAVX2>::Encode(batch, quality, encoded);
+}
+#endif
+
+/// Returns the widest color kernel supported by the host
+ColorKernel GetColorKernel() {
+    static const ColorKernel kernel = []() -> ColorKernel {
+#ifdef ARCHITECTURE_x86_64
+        if (Common::GetCPUCaps().avx2) {
+            return &EncodeColorsAVX2;
+        }
+        if (Common::GetCPUCaps().sse4_1) {
+            return &EncodeColorsSSE41;
+        }
+        return &ColorEncoder<VecScalar>::Encode;
+#elif defined(ARCHITECTURE_arm64)
+        return &ColorEncoder<VecNEON>::Encode;
+#else
+        return &ColorEncoder<VecScalar>::Encode;
+#endif
+    }();
+    return kernel;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+/// Endpoint pairs whose two-thirds interpolant reproduces each 8-bit value best, for one channel
+template <u32 BITS>
+const std::array<std::array<u8, 2>, 256>& SingleColorTable() {
+    static const auto table = [] {
+        constexpr u32 max = (1U << BITS) - 1;
+        const auto expand = [](u32 value) {
+            return static_cast<s32>(BITS == 5 ? (value * 33) >> 2 : (value * 65) >> 4);
+        };
+        std::array<std::array<u8, 2>, 256> result{};
+        for (s32 value = 0; value < 256; ++value) {
+            s32 best_error = std::numeric_limits<s32>::max();
+            for (u32 high = 0; high <= max; ++high) {
+                for (u32 low = 0; low <= max; ++low) {
+                    const s32 a = expand(high);
+                    const s32 b = expand(low);
+                    // Among equally close pairs, closer endpoints are less sensitive to how the
+                    // decoder rounds the interpolant
+                    const s32 error = std::abs((2 * a + b) / 3 - value) * 256 + std::abs(a - b);
+                    if (error < best_error) {
+                        best_error = error;
+                        result[value] = {static_cast<u8>(high), static_cast<u8>(low)};
+                    }
+                }
+            }
+        }
+        return result;
+    }();
+    return table;
+}
+
+void WriteColorBlock(u8* dest, u16 color0, u16 color1, u32 indices) {
+    // Four color blocks require the first endpoint to be the greater one
+    if (color0 < color1) {
+        std::swap(color0, color1);
+        indices ^= 0x55555555;
+    } else if (color0 == color1) {
+        indices = 0;
+    }
+    dest[0] = static_cast<u8>(color0);
+    dest[1] = static_cast<u8>(color0 >> 8);
+    dest[2] = static_cast<u8>(color1);
+    dest[3] = static_cast<u8>(color1 >> 8);
+    for (size_t i = 0; i < 4; ++i) {
+        dest[4 + i] = static_cast<u8>(indices >> (i * 8));
+    }
+}
+
+bool IsSingleColor(const Block& block) {
+    return std::all_of(block.begin(), block.end(), [&block](const std::array<u8, 4>& texel) {
+        return texel[0] == block[0][0] && texel[1] == block[0][1] && texel[2] == block[0][2];
+    });
+}
+
+void EncodeSingleColor(u8* dest, const std::array<u8, 4>& color) {
+    const auto& table5 = SingleColorTable<5>();
+    const auto& table6 = SingleColorTable<6>();
+    const auto pack = [&](size_t endpoint) {
+        return static_cast<u16>(table5[color[0]][endpoint] << 11 |
+                                table6[color[1]][endpoint] << 5 | table5[color[2]][endpoint]);
+    };
+    // Every texel takes the two-thirds interpolant
+    WriteColorBlock(dest, pack(0), pack(1), 0xAAAAAAAA);
+}
+
+/// BC3 alpha block spanning the alpha range of the block, for which the index choice is exact
+void EncodeAlphaBlock(u8* dest, const Block& block) {
+    u8 min = 255;
+    u8 max = 0;
+    for (const auto& texel : block) {
+        min = std::min(min, texel[3]);
+        max = std::max(max, texel[3]);
+    }
+    dest[0] = max;
+    dest[1] = min;
+
+    // https://fgiesen.wordpress.com/2009/12/15/dxt5-alpha-block-index-determination/
+    const s32 range = max - min;
+    const s32 bias = (range < 8 ? range - 1 : range / 2 + 2) - min * 7;
+    u64 indices = 0;
+    for (size_t texel = 0; texel < 16; ++texel) {
+        s32 value = block[texel][3] * 7 + bias;
+        s32 index = 0;
+        if (value >= range * 4) {
+            index += 4;
+            value -= range * 4;
+        }
+        if (value >= range * 2) {
+            index += 2;
+            value -= range * 2;
+        }
+        index += value >= range ? 1 : 0;
+
+        // Linear position to index, where 0 and 1 are the endpoints
+        index = -index & 7;
+        index ^= index < 2 ? 1 : 0;
+        indices |= static_cast<u64>(index) << (texel * 3);
+    }
+    for (size_t i = 0; i < 6; ++i) {
+        dest[2 + i] = static_cast<u8>(indices >> (i * 8));
+    }
+}
+
+/// Encodes a row of blocks, texels past the edges of the image replicate the edge texels
+template <bool IS_BC3>
+void CompressRow(std::span<const u8> plane, u32 width, u32 height, u32 block_y, u8* output,
+                 Quality quality, ColorKernel kernel) {
+    constexpr u8 alpha_threshold = 128;
+    constexpr u32 bytes_per_block = IS_BC3 ? 16 : 8;
+    const u32 num_blocks = Common::DivideUp(width, 4U);
+
+    std::array<Block, BATCH_SIZE> blocks;
+    std::array<bool, BATCH_SIZE> has_alpha;
+    ColorBatch batch;
+    EncodedColors encoded;
+    for (u32 first = 0; first < num_blocks; first += BATCH_SIZE) {
+        const u32 count = std::min<u32>(static_cast<u32>(BATCH_SIZE), num_blocks - first);
+        for (u32 lane = 0; lane < BATCH_SIZE; ++lane) {
+            // Pad the batch with the last block
+            const u32 block_x = first + std::min(lane, count - 1);
+            Block& block = blocks[lane];
+            has_alpha[lane] = false;
+            for (u32 texel = 0; texel < 16; ++texel) {
+                const u32 x = std::min(block_x * 4 + texel % 4, width - 1);
+                const u32 y = std::min(block_y * 4 + texel / 4, height - 1);
+                std::memcpy(block[texel].data(), &plane[(y * width + x) * 4], 4);
+                if constexpr (!IS_BC3) {
+                    if (block[texel][3] >= alpha_threshold) {
+                        block[texel][3] = 255;
+                    } else {
+                        has_alpha[lane] = true;
+                        block[texel] = {};
+                    }
+                }
+                for (size_t channel = 0; channel < 3; ++channel) {
+                    batch.texels[channel][texel][lane] = block[texel][channel];
+                }
+            }
+        }
+        kernel(batch, quality, encoded);
+
+        for (u32 lane = 0; lane < count; ++lane) {
+            u8* dest = output + (first + lane) * bytes_per_block;
+            const Block& block = blocks[lane];
+            if constexpr (IS_BC3) {
+                EncodeAlphaBlock(dest, block);
+                dest += 8;
+            }
+            if (has_alpha[lane]) {
+                // Punch-through alpha is rare, the three color mode is left to stb_dxt
+                stb_compress_bc1_block(dest, block[0].data(), 1, STB_DXT_NORMAL);
+            } else if (IsSingleColor(block)) {
+                EncodeSingleColor(dest, block[0]);
+            } else {
+                const u32 indices = static_cast<u32>(encoded.indices_high[lane]) << 16 |
+                                    static_cast<u32>(encoded.indices_low[lane]);
+                WriteColorBlock(dest, static_cast<u16>(encoded.endpoint0[lane]),
+                                static_cast<u16>(encoded.endpoint1[lane]), indices);
+            }
+        }
+    }
+}
+
+template <bool IS_BC3>
+void CompressImage(std::span<const u8> data, u32 width, u32 height, u32 depth,
+                   std::span<u8> output, Quality quality) {
+    constexpr u32 bytes_per_block = IS_BC3 ? 16 : 8;
+    const ColorKernel kernel = GetColorKernel();
+    const u32 num_rows = Common::DivideUp(height, 4U);
+    const u32 bytes_per_row = bytes_per_block * Common::DivideUp(width, 4U);
+    const size_t plane_size = static_cast<size_t>(width) * height * 4;
+
+    RunTasks(static_cast<size_t>(depth) * num_rows, [&](size_t index) {
+        const u32 z = static_cast<u32>(index / num_rows);
+        const u32 block_y = static_cast<u32>(index % num_rows);
+        const std::span<const u8> plane = data.subspan(z * plane_size, plane_size);
+        CompressRow<IS_BC3>(plane, width, height, block_y, output.data() + index * bytes_per_row,
+                            quality, kernel);
+    });
+}
+
+} // Anonymous namespace
+
 void CompressBC1(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
-                 std::span<uint8_t> output) {
+                 std::span<uint8_t> output, Quality quality) {
+    CompressImage<false>(data, width, height, depth, output, quality);
+}
+
+void CompressBC3(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
+                 std::span<uint8_t> output, Quality quality) {
+    CompressImage<true>(data, width, height, depth, output, quality);
+}
+
+void CompressBC1Reference(std::span<const uint8_t> data, uint32_t width, uint32_t height,
+                          uint32_t depth, std::span<uint8_t> output) {
     CompressBCN<8, true>(data, width, height, depth, output,
                          [](u8* block_output, const u8* block_input, bool any_alpha) {
                              stb_compress_bc1_block(block_output, block_input, any_alpha,
@@ -75,8 +844,8 @@ void CompressBC1(std::span<const uint8_t> data, uint32_t width, uint32_t height,
                          });
 }
 
-void CompressBC3(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
-                 std::span<uint8_t> output) {
+void CompressBC3Reference(std::span<const uint8_t> data, uint32_t width, uint32_t height,
+                          uint32_t depth, std::span<uint8_t> output) {
     CompressBCN<16, false>(data, width, height, depth, output,
                            [](u8* block_output, const u8* block_input, bool any_alpha) {
                                stb_compress_bc3_block(block_output, block_input, STB_DXT_NORMAL);
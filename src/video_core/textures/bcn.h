@@ -9,8 +9,23 @@
 
 namespace Tegra::Texture::BCN {
 
-void CompressBC1(std::span<const u8> data, u32 width, u32 height, u32 depth, std::span<u8> output);
+/// Speed and quality tradeoff of the BC1/BC3 encoders
+enum class Quality {
+    Fast, ///< Bounding box endpoints, refined once by least squares
+    High, ///< Principal axis endpoints, refined twice by least squares
+};
 
-void CompressBC3(std::span<const u8> data, u32 width, u32 height, u32 depth, std::span<u8> output);
+void CompressBC1(std::span<const u8> data, u32 width, u32 height, u32 depth, std::span<u8> output,
+                 Quality quality);
+
+void CompressBC3(std::span<const u8> data, u32 width, u32 height, u32 depth, std::span<u8> output,
+                 Quality quality);
+
+/// Encode one block at a time with stb_dxt, the reference of the vectorized encoders
+void CompressBC1Reference(std::span<const u8> data, u32 width, u32 height, u32 depth,
+                          std::span<u8> output);
+
+void CompressBC3Reference(std::span<const u8> data, u32 width, u32 height, u32 depth,
+                          std::span<u8> output);
 
 } // namespace Tegra::Texture::BCN
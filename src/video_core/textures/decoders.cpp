@@ -5,16 +5,36 @@
 #include <cmath>
 #include <cstring>
 #include <span>
+#include <vector>
 
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "common/bit_util.h"
 #include "common/div_ceil.h"
+#include "common/literals.h"
 #include "video_core/gpu.h"
 #include "video_core/textures/decoders.h"
+#include "video_core/textures/workers.h"
+
+#ifdef ARCHITECTURE_x86_64
+#include <immintrin.h>
+#include "common/x64/cpu_detect.h"
+#elif defined(ARCHITECTURE_arm64)
+#include <arm_neon.h>
+#endif
+
+#ifdef ARCHITECTURE_x86_64
+#ifdef _MSC_VER
+#define SWIZZLE_AVX2_TARGET
+#else
+#define SWIZZLE_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
 
 namespace Tegra::Texture {
 namespace {
+using namespace Common::Literals;
+
 template <u32 mask>
 constexpr u32 pdep(u32 value) {
     u32 result = 0;
@@ -33,9 +53,159 @@ void incrpdep(u32& value) {
     value = ((value | ~mask) + swizzled_incr) & mask;
 }
 
+/// Textures smaller than this are swizzled on the calling thread.
+constexpr u64 PARALLEL_SWIZZLE_THRESHOLD = 1_MiB;
+
+/// Approximate amount of linear data swizzled by each worker task.
+constexpr u64 PARALLEL_SWIZZLE_TASK_SIZE = 256_KiB;
+
+/// Size of the contiguous runs of bytes a GOB line is split into.
+constexpr u32 GOB_RUN_SIZE = 16;
+
+/**
+ * Within a GOB, each line of 64 bytes is stored as four contiguous runs of 16 bytes.
+ * Returns the offset within a GOB of the byte at 'x' on the GOB's first line.
+ */
+constexpr u32 GobLineOffset(u32 x) {
+    return (x & 0xf) | ((x & 0x10) << 1) | ((x & 0x20) << 3);
+}
+static_assert(GobLineOffset(GOB_SIZE_X - 1) == pdep<SWIZZLE_X_BITS>(GOB_SIZE_X - 1));
+
+/**
+ * Copies the lines of consecutive GOBs between linear and block linear memory.
+ * When TO_LINEAR is true 'dst' is block linear, otherwise 'src' is block linear.
+ *
+ * @param num_gobs   Number of consecutive GOBs to copy the line of
+ * @param gob_stride Distance in bytes between two horizontally consecutive GOBs
+ */
+using GobLineKernel = void (*)(u8* dst, const u8* src, u32 num_gobs, u32 gob_stride);
+
+#ifdef ARCHITECTURE_x86_64
+template <bool TO_LINEAR>
+void CopyGobLinesSSE2(u8* dst, const u8* src, u32 num_gobs, u32 gob_stride) {
+    const u32 dst_stride = TO_LINEAR ? gob_stride : GOB_SIZE_X;
+    const u32 src_stride = TO_LINEAR ? GOB_SIZE_X : gob_stride;
+    for (u32 gob = 0; gob < num_gobs; ++gob, dst += dst_stride, src += src_stride) {
+        for (u32 x = 0; x < GOB_SIZE_X; x += GOB_RUN_SIZE) {
+            const u32 dst_offset = TO_LINEAR ? GobLineOffset(x) : x;
+            const u32 src_offset = TO_LINEAR ? x : GobLineOffset(x);
+            const __m128i run = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + src_offset));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + dst_offset), run);
+        }
+    }
+}
+
+template <bool TO_LINEAR>
+SWIZZLE_AVX2_TARGET void CopyGobLinesAVX2(u8* dst, const u8* src, u32 num_gobs, u32 gob_stride) {
+    const u32 dst_stride = TO_LINEAR ? gob_stride : GOB_SIZE_X;
+    const u32 src_stride = TO_LINEAR ? GOB_SIZE_X : gob_stride;
+    for (u32 gob = 0; gob < num_gobs; ++gob, dst += dst_stride, src += src_stride) {
+        // Each half of a GOB line is stored as two runs 32 bytes apart.
+        for (u32 x = 0; x < GOB_SIZE_X; x += 2 * GOB_RUN_SIZE) {
+            if constexpr (TO_LINEAR) {
+                const __m256i runs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x));
+                u8* const swizzled = dst + GobLineOffset(x);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(swizzled),
+                                 _mm256_castsi256_si128(runs));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(swizzled + 2 * GOB_RUN_SIZE),
+                                 _mm256_extracti128_si256(runs, 1));
+            } else {
+                const u8* const swizzled = src + GobLineOffset(x);
+                const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(swizzled));
+                const __m128i high = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(swizzled + 2 * GOB_RUN_SIZE));
+                const __m256i runs = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), runs);
+            }
+        }
+    }
+}
+#elif defined(ARCHITECTURE_arm64)
+template <bool TO_LINEAR>
+void CopyGobLinesNEON(u8* dst, const u8* src, u32 num_gobs, u32 gob_stride) {
+    const u32 dst_stride = TO_LINEAR ? gob_stride : GOB_SIZE_X;
+    const u32 src_stride = TO_LINEAR ? GOB_SIZE_X : gob_stride;
+    for (u32 gob = 0; gob < num_gobs; ++gob, dst += dst_stride, src += src_stride) {
+        if constexpr (TO_LINEAR) {
+            const uint8x16x4_t runs = vld1q_u8_x4(src);
+            vst1q_u8(dst + GobLineOffset(0 * GOB_RUN_SIZE), runs.val[0]);
+            vst1q_u8(dst + GobLineOffset(1 * GOB_RUN_SIZE), runs.val[1]);
+            vst1q_u8(dst + GobLineOffset(2 * GOB_RUN_SIZE), runs.val[2]);
+            vst1q_u8(dst + GobLineOffset(3 * GOB_RUN_SIZE), runs.val[3]);
+        } else {
+            uint8x16x4_t runs;
+            runs.val[0] = vld1q_u8(src + GobLineOffset(0 * GOB_RUN_SIZE));
+            runs.val[1] = vld1q_u8(src + GobLineOffset(1 * GOB_RUN_SIZE));
+            runs.val[2] = vld1q_u8(src + GobLineOffset(2 * GOB_RUN_SIZE));
+            runs.val[3] = vld1q_u8(src + GobLineOffset(3 * GOB_RUN_SIZE));
+            vst1q_u8_x4(dst, runs);
+        }
+    }
+}
+#endif
+
+/// Returns the fastest GOB line kernel supported by the host, or null if there is none.
+template <bool TO_LINEAR>
+GobLineKernel GetGobLineKernel() {
+    static const GobLineKernel kernel = []() -> GobLineKernel {
+#ifdef ARCHITECTURE_x86_64
+        if (Common::GetCPUCaps().avx2) {
+            return &CopyGobLinesAVX2<TO_LINEAR>;
+        }
+        return &CopyGobLinesSSE2<TO_LINEAR>;
+#elif defined(ARCHITECTURE_arm64)
+        return &CopyGobLinesNEON<TO_LINEAR>;
+#else
+        return nullptr;
+#endif
+    }();
+    return kernel;
+}
+
+/**
+ * Copies the bytes [x_begin, x_end) of a line between linear and block linear memory.
+ * Whole GOBs are copied with the vector kernel, partial GOBs run by run.
+ *
+ * @param swizzled_line_offset Block linear offset of the line at x = 0
+ * @param linear_line_offset   Linear offset of the line at x = x_begin
+ * @param x_shift Log2 of the distance in bytes between two horizontally consecutive GOBs
+ */
+template <bool TO_LINEAR>
+void SwizzleLine(GobLineKernel kernel, u8* output, const u8* input, u32 swizzled_line_offset,
+                 u32 linear_line_offset, u32 x_begin, u32 x_end, u32 x_shift) {
+    const auto dst_address = [&](u32 x) {
+        return output + (TO_LINEAR ? swizzled_line_offset + ((x >> GOB_SIZE_X_SHIFT) << x_shift) +
+                                         GobLineOffset(x)
+                                   : linear_line_offset + (x - x_begin));
+    };
+    const auto src_address = [&](u32 x) {
+        return input + (TO_LINEAR ? linear_line_offset + (x - x_begin)
+                                  : swizzled_line_offset + ((x >> GOB_SIZE_X_SHIFT) << x_shift) +
+                                        GobLineOffset(x));
+    };
+    const auto copy_runs = [&](u32 begin, u32 end) {
+        for (u32 x = begin; x < end;) {
+            const u32 run_end = std::min(Common::AlignUp(x + 1, GOB_RUN_SIZE), end);
+            std::memcpy(dst_address(x), src_address(x), run_end - x);
+            x = run_end;
+        }
+    };
+
+    const u32 gobs_begin = std::min(Common::AlignUp(x_begin, GOB_SIZE_X), x_end);
+    const u32 num_gobs = (x_end - gobs_begin) >> GOB_SIZE_X_SHIFT;
+    const u32 gobs_end = gobs_begin + (num_gobs << GOB_SIZE_X_SHIFT);
+
+    copy_runs(x_begin, gobs_begin);
+    if (num_gobs > 0) {
+        kernel(dst_address(gobs_begin), src_address(gobs_begin), num_gobs, 1U << x_shift);
+    }
+    copy_runs(gobs_end, x_end);
+}
+
 template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
-void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32 height, u32 depth,
-                 u32 block_height, u32 block_depth, u32 stride) {
+void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32 height,
+                 u32 block_height, u32 block_depth, u32 stride, u32 slice_begin, u32 slice_end,
+                 u32 line_begin, u32 line_end) {
     // The origin of the transformation can be configured here, leave it as zero as the current API
     // doesn't expose it.
     static constexpr u32 origin_x = 0;
@@ -55,11 +225,15 @@ void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32
     const u32 block_depth_mask = (1U << block_depth) - 1;
     const u32 x_shift = GOB_SIZE_SHIFT + block_height + block_depth;
 
-    for (u32 slice = 0; slice < depth; ++slice) {
+    // Pixels of other sizes may straddle a run and are copied whole by the scalar path.
+    const GobLineKernel kernel =
+        std::has_single_bit(BYTES_PER_PIXEL) ? GetGobLineKernel<TO_LINEAR>() : nullptr;
+
+    for (u32 slice = slice_begin; slice < slice_end; ++slice) {
         const u32 z = slice + origin_z;
         const u32 offset_z = (z >> block_depth) * slice_size +
                              ((z & block_depth_mask) << (GOB_SIZE_SHIFT + block_height));
-        for (u32 line = 0; line < height; ++line) {
+        for (u32 line = line_begin; line < line_end; ++line) {
             const u32 y = line + origin_y;
             const u32 swizzled_y = pdep<SWIZZLE_Y_BITS>(y);
 
@@ -67,6 +241,15 @@ void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32
             const u32 offset_y = (block_y >> block_height) * block_size +
                                  ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
 
+            if (kernel) {
+                SwizzleLine<TO_LINEAR>(kernel, output.data(), input.data(),
+                                       offset_z + offset_y + swizzled_y,
+                                       slice * pitch * height + line * pitch,
+                                       origin_x * BYTES_PER_PIXEL,
+                                       (origin_x + width) * BYTES_PER_PIXEL, x_shift);
+                continue;
+            }
+
             u32 swizzled_x = pdep<SWIZZLE_X_BITS>(origin_x * BYTES_PER_PIXEL);
             for (u32 column = 0; column < width;
                  ++column, incrpdep<SWIZZLE_X_BITS, BYTES_PER_PIXEL>(swizzled_x)) {
@@ -110,6 +293,10 @@ void SwizzleSubrectImpl(std::span<u8> output, std::span<const u8> input, u32 wid
     const u32 block_depth_mask = (1U << block_depth) - 1;
     const u32 x_shift = GOB_SIZE_SHIFT + block_height + block_depth;
 
+    // Pixels of other sizes may straddle a run and are copied whole by the scalar path.
+    const GobLineKernel kernel =
+        std::has_single_bit(BYTES_PER_PIXEL) ? GetGobLineKernel<TO_LINEAR>() : nullptr;
+
     u32 unprocessed_lines = num_lines;
     u32 extent_y = std::min(num_lines, height - origin_y);
 
@@ -126,6 +313,15 @@ void SwizzleSubrectImpl(std::span<u8> output, std::span<const u8> input, u32 wid
             const u32 offset_y = (block_y >> block_height) * block_size +
                                  ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
 
+            if (kernel) {
+                SwizzleLine<TO_LINEAR>(kernel, output.data(), input.data(),
+                                       offset_z + offset_y + swizzled_y,
+                                       slice * pitch * height + line * pitch,
+                                       origin_x * BYTES_PER_PIXEL,
+                                       (origin_x + extent_x) * BYTES_PER_PIXEL, x_shift);
+                continue;
+            }
+
             u32 swizzled_x = pdep<SWIZZLE_X_BITS>(origin_x * BYTES_PER_PIXEL);
             for (u32 column = 0; column < extent_x;
                  ++column, incrpdep<SWIZZLE_X_BITS, BYTES_PER_PIXEL>(swizzled_x)) {
@@ -152,13 +348,15 @@ void SwizzleSubrectImpl(std::span<u8> output, std::span<const u8> input, u32 wid
 }
 
 template <bool TO_LINEAR>
-void Swizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixel, u32 width,
-             u32 height, u32 depth, u32 block_height, u32 block_depth, u32 stride_alignment) {
+void SwizzleRange(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixel, u32 width,
+                  u32 height, u32 block_height, u32 block_depth, u32 stride_alignment,
+                  u32 slice_begin, u32 slice_end, u32 line_begin, u32 line_end) {
     switch (bytes_per_pixel) {
 #define BPP_CASE(x)                                                                                \
     case x:                                                                                        \
-        return SwizzleImpl<TO_LINEAR, x>(output, input, width, height, depth, block_height,        \
-                                         block_depth, stride_alignment);
+        return SwizzleImpl<TO_LINEAR, x>(output, input, width, height, block_height, block_depth,  \
+                                         stride_alignment, slice_begin, slice_end, line_begin,     \
+                                         line_end);
         BPP_CASE(1)
         BPP_CASE(2)
         BPP_CASE(3)
@@ -174,6 +372,50 @@ void Swizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixe
     }
 }
 
+template <bool TO_LINEAR>
+void Swizzle(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixel, u32 width,
+             u32 height, u32 depth, u32 block_height, u32 block_depth, u32 stride_alignment) {
+    const u64 line_size = u64{width} * bytes_per_pixel;
+    const u64 slice_size = line_size * height;
+    if (slice_size * depth < PARALLEL_SWIZZLE_THRESHOLD) {
+        SwizzleRange<TO_LINEAR>(output, input, bytes_per_pixel, width, height, block_height,
+                                block_depth, stride_alignment, 0, depth, 0, height);
+        return;
+    }
+
+    // Lines and slices never write to the same bytes, split the work into whole block rows of
+    // a slice, or whole slices when they are small.
+    struct Range {
+        u32 slice_begin;
+        u32 slice_end;
+        u32 line_begin;
+        u32 line_end;
+    };
+    std::vector<Range> ranges;
+    if (slice_size >= PARALLEL_SWIZZLE_TASK_SIZE) {
+        const u32 block_row_lines = GOB_SIZE_Y << block_height;
+        const u64 block_row_size = line_size * block_row_lines;
+        const u32 lines_per_task = static_cast<u32>(
+            std::max<u64>(PARALLEL_SWIZZLE_TASK_SIZE / block_row_size, 1) * block_row_lines);
+        for (u32 slice = 0; slice < depth; ++slice) {
+            for (u32 line = 0; line < height; line += lines_per_task) {
+                ranges.push_back({slice, slice + 1, line, std::min(line + lines_per_task, height)});
+            }
+        }
+    } else {
+        const u32 slices_per_task = static_cast<u32>(PARALLEL_SWIZZLE_TASK_SIZE / slice_size);
+        for (u32 slice = 0; slice < depth; slice += slices_per_task) {
+            ranges.push_back({slice, std::min(slice + slices_per_task, depth), 0, height});
+        }
+    }
+    RunTasks(ranges.size(), [&](size_t index) {
+        const Range& range = ranges[index];
+        SwizzleRange<TO_LINEAR>(output, input, bytes_per_pixel, width, height, block_height,
+                                block_depth, stride_alignment, range.slice_begin, range.slice_end,
+                                range.line_begin, range.line_end);
+    });
+}
+
 } // Anonymous namespace
 
 void UnswizzleTexture(std::span<u8> output, std::span<const u8> input, u32 bytes_per_pixel,
@@ -1,6 +1,9 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <atomic>
+#include <memory>
+
 #include "video_core/textures/workers.h"
 
 namespace Tegra::Texture {
@@ -12,4 +15,38 @@ Common::ThreadWorker& GetThreadWorkers() {
     return workers;
 }
 
+namespace {
+struct TaskCounters {
+    std::atomic<size_t> next_task{};
+    std::atomic<size_t> num_done{};
+};
+
+void RunRemainingTasks(TaskCounters& counters, size_t num_tasks,
+                       const std::function<void(size_t)>& task) {
+    for (size_t index = counters.next_task.fetch_add(1, std::memory_order_relaxed);
+         index < num_tasks; index = counters.next_task.fetch_add(1, std::memory_order_relaxed)) {
+        task(index);
+        if (counters.num_done.fetch_add(1, std::memory_order_acq_rel) + 1 == num_tasks) {
+            counters.num_done.notify_all();
+        }
+    }
+}
+} // Anonymous namespace
+
+void RunTasks(size_t num_tasks, const std::function<void(size_t)>& task) {
+    // Workers may only pick up their runner once all the tasks are done, so the counters are
+    // shared with them. Such runners find no task left and never touch the task function.
+    const auto counters = std::make_shared<TaskCounters>();
+    Common::ThreadWorker& workers{GetThreadWorkers()};
+    for (size_t i = 1; i < num_tasks; ++i) {
+        workers.QueueWork(
+            [counters, num_tasks, &task] { RunRemainingTasks(*counters, num_tasks, task); });
+    }
+    RunRemainingTasks(*counters, num_tasks, task);
+    for (size_t num_done = counters->num_done.load(std::memory_order_acquire);
+         num_done < num_tasks; num_done = counters->num_done.load(std::memory_order_acquire)) {
+        counters->num_done.wait(num_done, std::memory_order_acquire);
+    }
+}
+
 } // namespace Tegra::Texture
@@ -3,10 +3,19 @@
 
 #pragma once
 
+#include <functional>
+
 #include "common/thread_worker.h"
 
 namespace Tegra::Texture {
 
 Common::ThreadWorker& GetThreadWorkers();
 
-}
+/**
+ * Runs task(0) to task(num_tasks - 1) on the texture workers and returns once they are done.
+ * Unrelated work queued on the workers is not waited for, and the calling thread runs tasks too,
+ * so this can be called from one of the workers.
+ */
+void RunTasks(size_t num_tasks, const std::function<void(size_t)>& task);
+
+} // namespace Tegra::Texture
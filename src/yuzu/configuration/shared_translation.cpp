@@ -164,6 +164,15 @@ std::unique_ptr<TranslationMap> InitializeTranslations(QWidget* parent) {
            "the emulator to decompress to an intermediate format any card supports, RGBA8.\n"
            "This option recompresses RGBA8 to either the BC1 or BC3 format, saving VRAM but "
            "negatively affecting image quality."));
+    INSERT(Settings, astc_recompression_quality, tr("ASTC Recompression Quality:"),
+           tr("Fast: Picks the endpoints of each block from its bounding box.\n"
+              "High: Fits the endpoints of each block to its colors, slower to recompress but "
+              "closer to the original texture."));
+    INSERT(Settings, use_astc_disk_cache, QStringLiteral(), QStringLiteral());
+    INSERT(Settings, astc_disk_cache_size, tr("ASTC Disk Cache Size (MiB):"),
+           tr("Stores the ASTC textures decoded or recompressed by the CPU in the cache directory, "
+              "so they are not converted again in the next sessions.\nThe least recently used "
+              "textures are removed once the cache exceeds this size."));
     INSERT(Settings, vram_usage_mode, tr("VRAM Usage Mode:"),
            tr("Selects whether the emulator should prefer to conserve memory or make maximum usage "
               "of available video memory for performance. Has no effect on integrated graphics. "
@@ -320,6 +329,11 @@ std::unique_ptr<ComboboxTranslationMap> ComboboxEnumeration(QWidget* parent) {
              PAIR(AstcRecompression, Bc1, tr("BC1 (Low quality)")),
              PAIR(AstcRecompression, Bc3, tr("BC3 (Medium quality)")),
          }});
+    translations->insert({Settings::EnumMetadata<Settings::AstcRecompressionQuality>::Index(),
+                          {
+                              PAIR(AstcRecompressionQuality, Fast, tr("Fast")),
+                              PAIR(AstcRecompressionQuality, High, tr("High")),
+                          }});
     translations->insert({Settings::EnumMetadata<Settings::VramUsageMode>::Index(),
                           {
                               PAIR(VramUsageMode, Conservative, tr("Conservative")),
@@ -313,6 +313,8 @@ int main(int argc, char** argv) {
     Common::Log::Filter filter;
     filter.ParseFilterString(Settings::values.log_filter.GetValue());
     Common::Log::SetGlobalFilter(filter);
+    Common::Log::SetDeferredFormattingEnabled(
+        Settings::values.deferred_log_formatting.GetValue());
 
     if (!program_args.empty()) {
         Settings::values.program_args = program_args;